@@ -0,0 +1,88 @@
+#include "Benchmark.h"
+
+#include "Utils/Algorithm.h"
+#include "Utils/Text.h"
+#include "Utils/Text/Num.h"
+
+namespace Quasi::Bench {
+    void BenchState::ResumeTiming() {
+        if (timing) return;
+        ClobberMemory();
+        timing = true;
+        begin = Clock::now();
+    }
+
+    void BenchState::PauseTiming() {
+        if (!timing) return;
+        const Clock::time_point end = Clock::now();
+        ClobberMemory();
+        timing = false;
+        elapsedNs += (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+    }
+
+    void BenchRunner::Add(Str name, u64 itemsPerRun, FuncBox<void(BenchState&)> run) {
+        benches.Push({ String { name }, itemsPerRun, std::move(run) });
+    }
+
+    void BenchRunner::RunAll() {
+        results.Clear();
+        for (Benchmark& bench : benches) {
+            if (filter && !bench.name.Contains(filter)) continue;
+            const BenchResult& r = results.Push(Run(bench));
+            Text::PrintLn("{:<40} median {:>12} ns   p99 {:>12} ns", r.name, r.medianNs, r.p99Ns);
+        }
+    }
+
+    BenchResult BenchRunner::Run(Benchmark& bench) const {
+        for (u32 i = 0; i < warmup; ++i) {
+            BenchState state;
+            bench.run(state);
+        }
+
+        Vec<u64> samples = Vec<u64>::WithCap(repetitions);
+        for (u32 i = 0; i < repetitions; ++i) {
+            BenchState state;
+            state.ResumeTiming();
+            bench.run(state);
+            state.PauseTiming();
+            samples.Push(state.ElapsedNs());
+        }
+        samples.Sort(Cmp::Compare<void> {});
+
+        u64 total = 0;
+        for (const u64 s : samples) total += s;
+        const usize p99 = std::min((usize)std::ceil(0.99 * (f64)samples.Length()), samples.Length()) - 1;
+        return {
+            .name = bench.name,
+            .repetitions = repetitions,
+            .itemsPerRun = bench.itemsPerRun,
+            .minNs    = samples.First(),
+            .medianNs = samples[samples.Length() / 2],
+            .p99Ns    = samples[p99],
+            .meanNs   = (f64)total / (f64)samples.Length(),
+        };
+    }
+
+    void BenchRunner::PrintResults() const {
+        Text::PrintLn("{:<40} {:>12} {:>12} {:>12} {:>14}", Str { "benchmark" }, Str { "min ns" }, Str { "median ns" }, Str { "p99 ns" }, Str { "items/s" });
+        for (const BenchResult& r : results) {
+            Text::PrintLn("{:<40} {:>12} {:>12} {:>12} {:>14}", r.name, r.minNs, r.medianNs, r.p99Ns, (u64)r.ItemsPerSecond());
+        }
+    }
+
+    String BenchRunner::ResultsJson() const {
+        String json = "{\n  \"benchmarks\": [\n";
+        for (usize i = 0; i < results.Length(); ++i) {
+            const BenchResult& r = results[i];
+            json += "    { ";
+            json += Text::Format(
+                "\"name\": {}, \"repetitions\": {}, \"items_per_run\": {}, "
+                "\"min_ns\": {}, \"median_ns\": {}, \"p99_ns\": {}, \"mean_ns\": {}, \"items_per_second\": {}",
+                Text::Quote(r.name), r.repetitions, r.itemsPerRun,
+                r.minNs, r.medianNs, r.p99Ns, (u64)r.meanNs, (u64)r.ItemsPerSecond());
+            json += i + 1 < results.Length() ? " },\n" : " }\n";
+        }
+        json += "  ]\n}\n";
+        return json;
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+
+#include "Utils/Func.h"
+#include "Utils/String.h"
+#include "Utils/Vec.h"
+
+namespace Quasi::Bench {
+    // keeps the compiler from removing work whose result is never read
+    template <class T> void DoNotOptimize(const T& value) { asm volatile("" : : "r,m"(value) : "memory"); }
+    inline void ClobberMemory() { asm volatile("" : : : "memory"); }
+
+    // handed to every run of a benchmark, so that setup inside of it can be left out of the timing
+    class BenchState {
+        using Clock = std::chrono::steady_clock;
+
+        Clock::time_point begin;
+        u64 elapsedNs = 0;
+        bool timing = false;
+    public:
+        void ResumeTiming();
+        void PauseTiming();
+        u64 ElapsedNs() const { return elapsedNs; }
+    };
+
+    struct Benchmark {
+        String name;
+        u64 itemsPerRun = 1;
+        FuncBox<void(BenchState&)> run;
+    };
+
+    struct BenchResult {
+        Str name;
+        u32 repetitions;
+        u64 itemsPerRun;
+        u64 minNs, medianNs, p99Ns;
+        f64 meanNs;
+
+        f64 ItemsPerSecond() const { return medianNs ? (f64)itemsPerRun * 1e9 / (f64)medianNs : 0; }
+    };
+
+    // runs every benchmark a few times to warm up the caches, then times each repetition separately.
+    // the median is what should be compared across runs, the p99 shows how noisy the machine was.
+    class BenchRunner {
+        Vec<Benchmark> benches;
+        Vec<BenchResult> results;
+    public:
+        u32 warmup = 3, repetitions = 25;
+        Str filter; // only runs benchmarks with this in their name
+
+        void Add(Str name, u64 itemsPerRun, FuncBox<void(BenchState&)> run);
+
+        void RunAll();
+        Span<const BenchResult> Results() const { return results.AsSpan(); }
+
+        void PrintResults() const;
+        String ResultsJson() const;
+    private:
+        BenchResult Run(Benchmark& bench) const;
+    };
+
+    void RegisterSortBenches   (BenchRunner& runner);
+    void RegisterHashMapBenches(BenchRunner& runner);
+    void RegisterTextBenches   (BenchRunner& runner);
+    void RegisterPhysicsBenches(BenchRunner& runner);
+#ifdef Q_BENCH_GRAPHICS
+    void RegisterCanvasBenches (BenchRunner& runner);
+    void RegisterModelBenches  (BenchRunner& runner);
+#endif
+}
@@ -0,0 +1,73 @@
+#include "Benchmark.h"
+#include "Fixtures.h"
+
+#include "GUI/Canvas.h"
+#include "GLs/GLState.h"
+#include "glpnull.h"
+#include "glprecord.h"
+
+namespace Quasi::Bench {
+    static constexpr u32 SHAPE_COUNT = 4096;
+
+    // only tessellates into a mesh, so nothing here needs a gl context
+    static void AddShapeBench(BenchRunner& runner, Str name, void (*draw)(Graphics::Canvas&, u32)) {
+        runner.Add(name, SHAPE_COUNT, [draw, canvas = Box<Graphics::Canvas>::Build(), mesh = Graphics::UIMesh {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            mesh.Clear();
+            state.ResumeTiming();
+            const auto scope = canvas->RenderTo(mesh);
+            for (u32 i = 0; i < SHAPE_COUNT; ++i) draw(*canvas, i);
+            DoNotOptimize(mesh.vertices.Length());
+        });
+    }
+
+    static Math::fv2 ShapePosition(u32 i) {
+        return { (float)(i % 64) * 16.0f, (float)(i / 64) * 16.0f };
+    }
+
+    // the whole frame down to the gl calls, which go to a null context so only the cpu side is measured
+    static void AddFrameBench(BenchRunner& runner, Str name, bool record) {
+        runner.Add(name, SHAPE_COUNT, [record, gl = Box<GL::NullContext> {}, recorder = Box<GL::Recorder> {}, canvas = Box<Graphics::Canvas> {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            // a fresh context starts out with none of the cached state
+            if (!gl) { gl = Box<GL::NullContext>::Build(); Graphics::GLState::Invalidate(); }
+            gl->MakeCurrent();
+            if (!canvas) canvas = Box<Graphics::Canvas>::Build(Math::iv2 { 1024, 1024 });
+            if (record && !recorder) recorder = Box<GL::Recorder>::Build(GL::NullContext::Table());
+            if (record) { recorder->log.Clear(); recorder->Start(); }
+            state.ResumeTiming();
+            canvas->BeginFrame();
+            for (u32 i = 0; i < SHAPE_COUNT; ++i) canvas->DrawRect(Math::fRect2D::FromSize(ShapePosition(i), { 12, 8 }));
+            canvas->EndFrame();
+            state.PauseTiming();
+            if (record) recorder->Stop();
+            DoNotOptimize(gl->stats.drawCalls);
+        });
+    }
+
+    void RegisterCanvasBenches(BenchRunner& runner) {
+        AddShapeBench(runner, "canvas/rect", [] (Graphics::Canvas& c, u32 i) {
+            c.DrawRect(Math::fRect2D::FromSize(ShapePosition(i), { 12, 8 }));
+        });
+        AddShapeBench(runner, "canvas/rounded-rect", [] (Graphics::Canvas& c, u32 i) {
+            c.DrawRoundedRect(Math::fRect2D::FromSize(ShapePosition(i), { 12, 8 }), 3);
+        });
+        AddShapeBench(runner, "canvas/circle", [] (Graphics::Canvas& c, u32 i) {
+            c.DrawCircle(ShapePosition(i), 6);
+        });
+        AddShapeBench(runner, "canvas/arc", [] (Graphics::Canvas& c, u32 i) {
+            c.DrawArc(ShapePosition(i), 6, Math::Rotor2D { Math::Radians { 0.3f } }, Math::Rotor2D { Math::Radians { 2.5f } });
+        });
+        AddShapeBench(runner, "canvas/line", [] (Graphics::Canvas& c, u32 i) {
+            c.DrawLine(ShapePosition(i), ShapePosition(i) + Math::fv2 { 14, 9 });
+        });
+        AddShapeBench(runner, "canvas/polygon", [] (Graphics::Canvas& c, u32 i) {
+            const Math::fv2 p = ShapePosition(i);
+            const Math::fv2 points[] = { p, p + Math::fv2 { 10, 2 }, p + Math::fv2 { 12, 9 }, p + Math::fv2 { 5, 13 }, p + Math::fv2 { -2, 7 } };
+            c.DrawPolygon(Spans::Vals(points));
+        });
+
+        AddFrameBench(runner, "canvas/frame-null-gl", false);
+        AddFrameBench(runner, "canvas/frame-recorded-gl", true);
+    }
+}
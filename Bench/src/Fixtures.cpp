@@ -0,0 +1,88 @@
+#include "Fixtures.h"
+
+#include "Physics/World2D.h"
+#include "Utils/Text.h"
+#include "Utils/Text/Num.h"
+
+namespace Quasi::Bench::Fixtures {
+    Math::RandomGenerator SeededRandom(u32 seed) {
+        Math::RandomGenerator rand;
+        rand.SetSeed(seed);
+        return rand;
+    }
+
+    Vec<u64> RandomU64s(usize count, u32 seed) {
+        Math::RandomGenerator rand = SeededRandom(seed);
+        Vec<u64> values = Vec<u64>::WithCap(count);
+        for (usize i = 0; i < count; ++i) values.Push((u64)rand.GetRaw() << 32 | rand.GetRaw());
+        return values;
+    }
+
+    Vec<f32> RandomFloats(usize count, u32 seed) {
+        Math::RandomGenerator rand = SeededRandom(seed);
+        Vec<f32> values = Vec<f32>::WithCap(count);
+        for (usize i = 0; i < count; ++i) values.Push(rand.GetExponential(1e-4f, 1e6f) * (rand.GetBool() ? 1.0f : -1.0f));
+        return values;
+    }
+
+    String TextCorpus(usize wordCount, u32 seed) {
+        Math::RandomGenerator rand = SeededRandom(seed);
+        String text;
+        for (usize i = 0; i < wordCount; ++i) {
+            const u32 len = rand.GetIncl(1u, 10u);
+            for (u32 j = 0; j < len; ++j) text += (char)('a' + rand.Get(0, 26));
+            text += i % 12 == 11 ? '\n' : ' ';
+        }
+        return text;
+    }
+
+    String NumberCorpus(usize count, u32 seed) {
+        Math::RandomGenerator rand = SeededRandom(seed);
+        String text;
+        for (usize i = 0; i < count; ++i) {
+            if (rand.GetBool()) text += Text::Format("{}", rand.Get(-1'000'000, 1'000'000));
+            else                text += Text::Format("{}", rand.GetExponential(1e-6, 1e12) * (rand.GetBool() ? 1 : -1));
+            text += ' ';
+        }
+        return text;
+    }
+
+    String GridOBJ(u32 width, u32 height, u32 objectCount) {
+        String obj;
+        const u32 vertsPerObject = (width + 1) * (height + 1);
+        for (u32 o = 0; o < objectCount; ++o) {
+            obj += Text::Format("o grid{}\n", o);
+            for (u32 y = 0; y <= height; ++y) {
+                for (u32 x = 0; x <= width; ++x) {
+                    const float fx = (float)x / (float)width, fy = (float)y / (float)height;
+                    obj += Text::Format("v {} {} {}\n", fx, std::sin(fx * 12.0f) * std::cos(fy * 9.0f) * 0.1f, fy + (float)o);
+                    obj += Text::Format("vt {} {}\n", fx, fy);
+                    obj += "vn 0 1 0\n";
+                }
+            }
+            const u32 base = o * vertsPerObject + 1;
+            for (u32 y = 0; y < height; ++y) {
+                for (u32 x = 0; x < width; ++x) {
+                    const u32 a = base + y * (width + 1) + x, b = a + 1, c = a + width + 1, d = c + 1;
+                    obj += Text::Format("f {}/{}/{} {}/{}/{} {}/{}/{}\n", a, a, a, b, b, b, d, d, d);
+                    obj += Text::Format("f {}/{}/{} {}/{}/{} {}/{}/{}\n", a, a, a, d, d, d, c, c, c);
+                }
+            }
+        }
+        return obj;
+    }
+
+    void BuildPileScene(Physics2D::World& world, u32 bodyCount, u32 seed) {
+        using namespace Physics2D;
+        Math::RandomGenerator rand = SeededRandom(seed);
+        const u32 columns = (u32)std::sqrt((float)bodyCount) + 1;
+
+        world.Clear();
+        world.CreateBody({ .position = { 0, -1 }, .type = BodyType::STATIC }, RectShape { (float)columns * 2, 1 });
+        for (u32 i = 0; i < bodyCount; ++i) {
+            const fv2 position = { ((float)(i % columns) - (float)columns * 0.5f) * 1.1f, (float)(i / columns) * 1.1f + 0.6f };
+            if (rand.GetBool()) world.CreateBody({ .position = position }, CircleShape { rand.Get(0.3f, 0.5f) });
+            else world.CreateBody({ .position = position, .rotAngle = rand.Get(0.0f, 0.3f) }, RectShape { rand.Get(0.2f, 0.45f), rand.Get(0.2f, 0.45f) });
+        }
+    }
+}
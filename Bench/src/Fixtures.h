@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Utils/Math/Vector.h"
+#include "Utils/Math/Random.h"
+#include "Utils/String.h"
+#include "Utils/Vec.h"
+
+namespace Quasi::Physics2D { class World; }
+
+// generated inputs for the benchmarks, seeded so that every run measures the same data
+namespace Quasi::Bench::Fixtures {
+    static constexpr u32 SEED = 0x5EED;
+
+    Math::RandomGenerator SeededRandom(u32 seed = SEED);
+
+    Vec<u64> RandomU64s(usize count, u32 seed = SEED);
+    Vec<f32> RandomFloats(usize count, u32 seed = SEED);
+    // pseudo words separated by spaces and newlines
+    String TextCorpus(usize wordCount, u32 seed = SEED);
+    // whitespace separated ints and floats of varying magnitudes
+    String NumberCorpus(usize count, u32 seed = SEED);
+    // a wavy grid of (width x height) quads with positions, texcoords and normals
+    String GridOBJ(u32 width, u32 height, u32 objectCount = 1);
+    // a static floor with a pile of circles and boxes dropped onto it
+    void BuildPileScene(Physics2D::World& world, u32 bodyCount, u32 seed = SEED);
+}
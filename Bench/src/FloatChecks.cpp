@@ -0,0 +1,190 @@
+#include "Verify.h"
+#include "Fixtures.h"
+
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace Quasi::Bench {
+    static u64 RandomBits64(Math::RandomGenerator& rng) { return (u64)rng.GetRaw() << 32 | rng.GetRaw(); }
+
+    // the digits of the mantissa without the zeros on either side, which is what "shortest" is about
+    static usize SignificantDigits(Str s) {
+        char digits[64];
+        usize n = 0;
+        for (const char c : s) {
+            if (c == 'e' || c == 'E') break;
+            if (c >= '0' && c <= '9' && n < std::size(digits)) digits[n++] = c;
+        }
+        usize begin = 0;
+        while (begin < n && digits[begin] == '0') ++begin;
+        while (n > begin && digits[n - 1] == '0') --n;
+        return n - begin;
+    }
+
+    // "{}" has to print the shortest digits that parse back to the same bits, both through std::from_chars and Text::Parse.
+    // std::to_chars in scientific notation gives the shortest digit count to compare to (plain to_chars prints big integers in full)
+    template <class F, class Bits>
+    static void CheckShortest(VerifyRunner& v, Bits bits, String& out) {
+        const F f = std::bit_cast<F>(bits);
+        if (std::isnan(f)) return;
+        out.Clear();
+        Text::FormatTo(Text::StringWriter::WriteTo(out), "{}", f);
+        const Str s = out;
+
+        F back = 0;
+        const auto [end, err] = std::from_chars(s.Data(), s.Data() + s.Length(), back);
+        v.Expect(err == std::errc {} && end == s.Data() + s.Length() && std::bit_cast<Bits>(back) == bits,
+                 "{:x} formats as \"{}\", which doesnt read back with from_chars", bits, s);
+
+        const Option<F> parsed = Text::Parse<F>(s);
+        v.Expect(parsed && std::bit_cast<Bits>(*parsed) == bits,
+                 "{:x} formats as \"{}\", which doesnt read back with Text::Parse", bits, s);
+
+        char shortest[64];
+        const auto [shortestEnd, _] = std::to_chars(shortest, std::end(shortest), f, std::chars_format::scientific);
+        const Str expected = Str::Slice(shortest, shortestEnd - shortest);
+        v.Expect(SignificantDigits(s) == SignificantDigits(expected),
+                 "{:x} formats as \"{}\", the shortest is \"{}\"", bits, s, expected);
+    }
+
+    // every f32 when exhaustive (about 4 billion, so minutes), otherwise every 4093rd pattern
+    static void CheckF32Shortest(VerifyRunner& v) {
+        String out;
+        const u64 stride = v.exhaustive ? 1 : 4093;
+        for (u64 bits = 0; bits <= 0xFFFF'FFFF; bits += stride)
+            CheckShortest<f32>(v, (u32)bits, out);
+    }
+
+    static void CheckF64Shortest(VerifyRunner& v) {
+        Math::RandomGenerator rng = Fixtures::SeededRandom();
+        String out;
+        const u32 trials = v.exhaustive ? 50'000'000 : 1'000'000;
+        for (u32 trial = 0; trial < trials; ++trial)
+            CheckShortest<f64>(v, RandomBits64(rng), out);
+    }
+
+    static Str Written(const char* buffer, int length) { return Str::Slice(buffer, (usize)length); }
+
+    // the 'e', 'f' and 'g' modes with a precision print the same as printf, correctly rounded at every precision
+    static void CheckPrecision(VerifyRunner& v) {
+        Math::RandomGenerator rng = Fixtures::SeededRandom();
+        String out;
+        char fmt[16], expectedBuffer[512];
+        const u32 trials = v.exhaustive ? 10'000'000 : 300'000;
+        for (u32 trial = 0; trial < trials; ++trial) {
+            const char mode = "efg"[trial % 3];
+            const u32 precision = rng.Get<u32>(0, 25);
+            u64 bits = RandomBits64(rng);
+            // fixed notation prints every integer digit, so it gets exponents that keep the output short
+            if (mode == 'f') bits = (bits & ~(0x7FFull << 52)) | (u64)rng.Get<u32>(1023 - 80, 1023 + 72) << 52;
+            const f64 f = std::bit_cast<f64>(bits);
+            if (!std::isfinite(f)) continue;
+
+            int n = 0;
+            switch (mode) {
+                case 'e': n = std::snprintf(expectedBuffer, sizeof(expectedBuffer), "%.*e", (int)precision, f); break;
+                case 'f': n = std::snprintf(expectedBuffer, sizeof(expectedBuffer), "%.*f", (int)precision, f); break;
+                default:  n = std::snprintf(expectedBuffer, sizeof(expectedBuffer), "%.*g", (int)precision, f); break;
+            }
+            const Str expected = Written(expectedBuffer, n);
+            const Str format = Written(fmt, std::snprintf(fmt, sizeof(fmt), "{:.%u%c}", precision, mode));
+            out.Clear();
+            Text::FormatTo(Text::StringWriter::WriteTo(out), format, f);
+            v.Expect(out == expected, "{:x} with \"{}\" formats as \"{}\", printf gives \"{}\"", bits, format, out, expected);
+        }
+    }
+
+    static usize WriteRandomDigits(Math::RandomGenerator& rng, char* out, usize count) {
+        for (usize i = 0; i < count; ++i) out[i] = (char)('0' + rng.Get<u32>(0, 10));
+        return count;
+    }
+
+    // decimal strings of the kinds that trip up parsers: every digit of a finite double, exact halfway points between two
+    // neighbouring doubles (or floats) and those pushed just above by a last digit, hundreds of digits, tiny and huge exponents,
+    // hex floats and trailing characters that look like they could continue the number. the buffer is null terminated for strtod
+    static Str RandomNumberText(Math::RandomGenerator& rng, char* buffer, usize size) {
+        const auto finiteF64 = [&] {
+            f64 f;
+            do f = std::bit_cast<f64>(RandomBits64(rng)); while (!std::isfinite(f));
+            return f;
+        };
+        int n = 0;
+        switch (rng.Get<u32>(0, 7)) {
+            case 0: n = std::snprintf(buffer, size, "%.17g", finiteF64()); break;
+            case 1: n = std::snprintf(buffer, size, "%.*e", rng.Get<int>(0, 26), finiteF64()); break;
+            case 2: n = std::snprintf(buffer, size, "%a", finiteF64()); break;
+            case 3: case 4: {
+                // long double holds the midpoint of two doubles exactly, and %.1100Le prints all of its digits
+                const f64 low = std::fabs(finiteF64()), high = std::nextafter(low, f64s::INFINITY);
+                if (std::isinf(high)) return "1e309";
+                n = std::snprintf(buffer, size, "%.1100Le", ((long double)low + high) / 2);
+                break;
+            }
+            case 5: {
+                const f32 low = std::fabs(std::bit_cast<f32>(rng.GetRaw())), high = std::nextafter(low, f32s::INFINITY);
+                if (!std::isfinite(high)) return "3.5e38";
+                n = std::snprintf(buffer, size, "%.200e", ((f64)low + high) / 2);
+                break;
+            }
+            default: {
+                // made up digits: integer part, fraction part and exponent each optional, up to 800 or so digits
+                const bool isLong = rng.GetBool(0.1f);
+                if (rng.GetBool(0.3f)) buffer[n++] = '-';
+                n += (int)WriteRandomDigits(rng, buffer + n, rng.Get<usize>(0, isLong ? 800 : 25));
+                if (rng.GetBool(0.7f)) {
+                    buffer[n++] = '.';
+                    n += (int)WriteRandomDigits(rng, buffer + n, rng.Get<usize>(0, isLong ? 400 : 25));
+                }
+                if (rng.GetBool(0.7f))
+                    n += std::snprintf(buffer + n, size - n, rng.GetBool() ? "e%d" : "E%+d", rng.Get<int>(-350, 351));
+                break;
+            }
+        }
+        buffer[n] = '\0';
+        // the digits printed for a halfway point end in zeros, so setting the last one makes it round up instead
+        if (const char* e = std::strchr(buffer, 'e'); e && e - buffer > 60 && rng.GetBool()) buffer[e - buffer - 1] = '1';
+        // trailing characters strtod stops at, some of which only look like the start of an exponent or a fraction.
+        // not after nothing at all though, since strtod skips leading whitespace
+        static constexpr const char* SUFFIXES[] = { "", "", "", "e", "e+", "E-x", ".", "..5", " 1", "x", "p3", "f" };
+        if (n > 0) n += std::snprintf(buffer + n, size - n, "%s", SUFFIXES[rng.Get<usize>(0, std::size(SUFFIXES))]);
+        return Written(buffer, n);
+    }
+
+    template <class F>
+    static void CheckParseOf(VerifyRunner& v, Str s, F expected, const char* strtodEnd) {
+        using Bits = std::conditional_t<sizeof(F) == 4, u32, u64>;
+        const OptionUsize expectedLen = strtodEnd == s.Data() ? nullptr : OptionUsize { (usize)(strtodEnd - s.Data()) };
+        F parsed = 0;
+        const OptionUsize len = Text::ParseUntil<F>(s, parsed);
+        v.Expect(len == expectedLen && (!len || std::bit_cast<Bits>(parsed) == std::bit_cast<Bits>(expected)),
+                 "ParseUntil<f{}>(\"{}\"... ({} bytes)) reads {} bytes as {:x}, strtod reads {} bytes as {:x}",
+                 sizeof(F) * 8, s.First(std::min<usize>(s.Length(), 64)), s.Length(),
+                 len, std::bit_cast<Bits>(parsed), expectedLen, std::bit_cast<Bits>(expected));
+    }
+
+    // Text::ParseUntil reads the same value and the same number of bytes as strtod and strtof, which round correctly in glibc
+    static void CheckParseAgainstStrtod(VerifyRunner& v) {
+        Math::RandomGenerator rng = Fixtures::SeededRandom();
+        char buffer[2048];
+        const u32 trials = v.exhaustive ? 5'000'000 : 200'000;
+        for (u32 trial = 0; trial < trials; ++trial) {
+            const Str s = RandomNumberText(rng, buffer, sizeof(buffer));
+            char* end = nullptr;
+            const f64 d = std::strtod(s.Data(), &end);
+            CheckParseOf<f64>(v, s, d, end);
+            const f32 f = std::strtof(s.Data(), &end);
+            CheckParseOf<f32>(v, s, f, end);
+        }
+    }
+
+    void RegisterFloatChecks(VerifyRunner& runner) {
+        runner.Add("float/f32-shortest", CheckF32Shortest);
+        runner.Add("float/f64-shortest", CheckF64Shortest);
+        runner.Add("float/precision",    CheckPrecision);
+        runner.Add("float/parse-strtod", CheckParseAgainstStrtod);
+    }
+}
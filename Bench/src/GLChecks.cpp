@@ -0,0 +1,185 @@
+#include "Verify.h"
+
+#include "GLs/GLState.h"
+#include "GLs/Shader.h"
+#include "glpnull.h"
+#include "glprecord.h"
+
+namespace Quasi::Bench {
+    // a null context with a recorder in front of it, the log has every call that got past the caches
+    struct RecordedContext {
+        GL::NullContext gl;
+        GL::Recorder recorder { GL::NullContext::Table() };
+
+        RecordedContext() {
+            gl.MakeCurrent();
+            // a fresh context starts out with none of the cached state
+            Graphics::GLState::Invalidate();
+            Graphics::GLState::ResetStats();
+            recorder.Start();
+        }
+        ~RecordedContext() { recorder.Stop(); }
+
+        // leaves out the glGetError polling that QGLCall$ adds in debug builds
+        usize Calls() const { return recorder.log.commands.size() - recorder.log.Count(GL::FuncID::GetError); }
+        usize Calls(GL::FuncID func) const { return recorder.log.Count(func); }
+        // the glUniform* uploads, which dont include the block bindings
+        usize UniformCalls() const {
+            usize count = 0;
+            for (const GL::Command& command : recorder.log.commands)
+                count += command.func != GL::FuncID::UniformBlockBinding && CStr { GL::FuncName(command.func) }.StartsWith("Uniform");
+            return count;
+        }
+    };
+
+    // every setter of GLState once, with the gl call it should turn into
+    static constexpr GL::FuncID BIND_SEQUENCE_CALLS[] = {
+        GL::FuncID::UseProgram, GL::FuncID::BindVertexArray, GL::FuncID::BindBuffer, GL::FuncID::ActiveTexture,
+        GL::FuncID::BindTexture, GL::FuncID::BindFramebuffer, GL::FuncID::Viewport, GL::FuncID::Enable,
+        GL::FuncID::BlendFuncSeparate, GL::FuncID::BlendEquationSeparate, GL::FuncID::DepthFunc,
+        GL::FuncID::CullFace, GL::FuncID::FrontFace, GL::FuncID::PolygonMode,
+    };
+
+    static void BindSequence(Graphics::GraphicsID program, Graphics::GraphicsID buffer) {
+        using namespace Graphics;
+        GLState::UseProgram(program);
+        GLState::BindVertexArray(5);
+        GLState::BindBuffer(GL::ARRAY_BUFFER, buffer);
+        GLState::ActiveTexture(2);
+        GLState::BindTexture(GL::TEXTURE_2D, 9);
+        GLState::BindFramebuffer(GL::FRAMEBUFFER, 4);
+        GLState::Viewport(0, 0, 1280, 720);
+        GLState::SetCapability(GL::DEPTH_TEST, true);
+        GLState::BlendFunc(GL::SRC_ALPHA, GL::ONE_MINUS_SRC_ALPHA, GL::SRC_ALPHA, GL::ONE_MINUS_SRC_ALPHA);
+        GLState::BlendEquation(GL::FUNC_ADD, GL::FUNC_ADD);
+        GLState::DepthFunc(GL::LESS);
+        GLState::CullFace(GL::BACK);
+        GLState::FrontFace(GL::CCW);
+        GLState::PolygonMode(GL::FILL);
+    }
+
+    // the same binds over and over reach gl once each, and only a change (or forgetting a deleted object) lets another through
+    static void CheckRedundantBinds(VerifyRunner& v) {
+        constexpr u32 REPEATS = 16;
+        RecordedContext ctx;
+        for (u32 i = 0; i < REPEATS; ++i) BindSequence(3, 7);
+        for (const GL::FuncID func : BIND_SEQUENCE_CALLS)
+            v.Expect(ctx.Calls(func) == 1, "{} repeated binds made {} {} calls, expected 1", REPEATS, ctx.Calls(func), GL::FuncName(func));
+        v.Expect(ctx.Calls() == std::size(BIND_SEQUENCE_CALLS), "{} repeated bind sequences made {} gl calls, expected {}",
+                 REPEATS, ctx.Calls(), std::size(BIND_SEQUENCE_CALLS));
+        const Graphics::GLState::Stats stats = Graphics::GLState::GetStats();
+        v.Expect(stats.elided == (REPEATS - 1) * std::size(BIND_SEQUENCE_CALLS), "GLState counted {} elided calls, expected {}",
+                 stats.elided, (REPEATS - 1) * std::size(BIND_SEQUENCE_CALLS));
+
+        // switching between two programs goes through every time
+        ctx.recorder.log.Clear();
+        for (u32 i = 0; i < REPEATS; ++i) BindSequence(i % 2 ? 3 : 6, 7);
+        v.Expect(ctx.Calls(GL::FuncID::UseProgram) == REPEATS, "alternating programs made {} UseProgram calls, expected {}",
+                 ctx.Calls(GL::FuncID::UseProgram), REPEATS);
+        v.Expect(ctx.Calls() == REPEATS, "alternating programs made {} gl calls, expected {}", ctx.Calls(), REPEATS);
+
+        // a deleted buffer is unbound by gl, so binding a new one with the same name has to go through
+        ctx.recorder.log.Clear();
+        Graphics::GLState::ForgetBuffer(7);
+        BindSequence(3, 7);
+        v.Expect(ctx.Calls(GL::FuncID::BindBuffer) == 1, "rebinding a forgotten buffer made {} BindBuffer calls, expected 1",
+                 ctx.Calls(GL::FuncID::BindBuffer));
+
+        // binding to an indexed target also binds the generic one
+        ctx.recorder.log.Clear();
+        Graphics::GLState::BindBufferBase(GL::UNIFORM_BUFFER, 0, 11);
+        Graphics::GLState::BindBuffer(GL::UNIFORM_BUFFER, 11);
+        v.Expect(ctx.Calls(GL::FuncID::BindBuffer) == 0, "binding the buffer BindBufferBase just bound made {} BindBuffer calls, expected 0",
+                 ctx.Calls(GL::FuncID::BindBuffer));
+
+        // after Invalidate nothing is known, so everything goes through once more
+        ctx.recorder.log.Clear();
+        Graphics::GLState::Invalidate();
+        for (u32 i = 0; i < REPEATS; ++i) BindSequence(3, 7);
+        v.Expect(ctx.Calls() == std::size(BIND_SEQUENCE_CALLS), "repeated binds after Invalidate made {} gl calls, expected {}",
+                 ctx.Calls(), std::size(BIND_SEQUENCE_CALLS));
+    }
+
+    // StdColored with a tint. it only ever goes to the null context, but the uniforms set below should still be ones it declares
+    static constexpr Str TINTED_SHADER =
+        QShader$(330 core,
+            "layout(location = 0) in vec4 position;\n"
+            "layout(location = 1) in vec4 color;\n"
+            "out vec4 vColor;\n"
+            "uniform mat4 u_projection;\n"
+            "uniform mat4 u_view;\n"
+            "uniform vec4 u_tint;\n"
+            "void main() {\n"
+            "   gl_Position = u_projection * u_view * position;\n"
+            "   vColor = color * u_tint;\n"
+            "}\n",
+            "layout(location = 0) out vec4 glColor;\n"
+            "in vec4 vColor;\n"
+            "void main() {\n"
+            "    glColor = vColor;\n"
+            "}\n"
+        );
+
+    // sets the arguments like GraphicsDevice::DrawWithArgs does, and returns how many uniforms that uploaded
+    static usize DrawUniforms(RecordedContext& ctx, Graphics::Shader& shader, const Graphics::ShaderArgs& args) {
+        ctx.recorder.log.Clear();
+        shader.Bind();
+        shader.SetUniformArgs(args);
+        return ctx.UniformCalls();
+    }
+
+    // every uniform slot of a shader remembers what it was last sent, so a draw only uploads the arguments that changed.
+    // the null context reports no active uniforms, so the slots of u_projection and u_view arent found up front
+    // and SetCamera has nothing to set. they go through ShaderArgs here instead, which uses the same slots
+    static void CheckUniformsPerDraw(VerifyRunner& v) {
+        using namespace Graphics;
+        constexpr u32 DRAWS = 16;
+        RecordedContext ctx;
+        Shader first = ShaderProgram::New(TINTED_SHADER), second = ShaderProgram::New(TINTED_SHADER);
+        const Math::Matrix4x4 projection = Math::Matrix4x4::Identity(), view = Math::Matrix4x4::Identity().TranslateBy({ 1, 2, 3 });
+
+        const ShaderArgs args = { { "u_projection", projection }, { "u_view", view }, { "u_tint", Math::fv4 { 1, 0.5f, 0.25f, 1 } } };
+        usize uploads = DrawUniforms(ctx, first, args);
+        v.Expect(uploads == 3, "the first draw uploaded {} uniforms, expected 3", uploads);
+        for (u32 i = 1; i < DRAWS; ++i) {
+            uploads = DrawUniforms(ctx, first, args);
+            v.Expect(uploads == 0, "draw {} with the same arguments uploaded {} uniforms, expected 0", i, uploads);
+        }
+
+        // only the argument that changed is sent
+        const ShaderArgs tinted = { { "u_projection", projection }, { "u_view", view }, { "u_tint", Math::fv4 { 0, 1, 0, 1 } } };
+        for (u32 i = 0; i < DRAWS; ++i) {
+            uploads = DrawUniforms(ctx, first, i % 2 ? args : tinted);
+            v.Expect(uploads == 1, "draw {} alternating the tint uploaded {} uniforms, expected 1", i, uploads);
+        }
+
+        // each shader has its own slots, so drawing with another one in between doesnt make either send anything again
+        uploads = DrawUniforms(ctx, second, args);
+        v.Expect(uploads == 3, "the first draw with a second shader uploaded {} uniforms, expected 3", uploads);
+        for (u32 i = 0; i < DRAWS; ++i) {
+            uploads = DrawUniforms(ctx, i % 2 ? first : second, args);
+            v.Expect(uploads == 0, "draw {} alternating shaders uploaded {} uniforms, expected 0", i, uploads);
+        }
+
+        // the names of a layout are resolved to slots once, and another order of the same names is another layout.
+        // if the slots were matched by position and type instead, these would swap the two matrices
+        const ShaderArgs reordered = { { "u_view", view }, { "u_projection", projection }, { "u_tint", Math::fv4 { 1, 0.5f, 0.25f, 1 } } };
+        const ShaderArgs reorderedTinted = { { "u_view", view }, { "u_projection", projection }, { "u_tint", Math::fv4 { 0, 1, 0, 1 } } };
+        uploads = DrawUniforms(ctx, first, reordered);
+        v.Expect(uploads == 0, "the same arguments in another order uploaded {} uniforms, expected 0", uploads);
+        for (u32 i = 0; i < DRAWS; ++i) {
+            uploads = DrawUniforms(ctx, first, i % 2 ? args : reorderedTinted);
+            v.Expect(uploads == 1, "draw {} alternating the tint and the argument order uploaded {} uniforms, expected 1", i, uploads);
+        }
+
+        // a value set by name doesnt go through the slot, so the next draw has to send it again
+        first.SetUniformFv4("u_tint", { 1, 1, 1, 1 });
+        uploads = DrawUniforms(ctx, first, args);
+        v.Expect(uploads == 1, "the draw after setting the tint by name uploaded {} uniforms, expected 1", uploads);
+    }
+
+    void RegisterGLChecks(VerifyRunner& runner) {
+        runner.Add("gl/redundant-binds",   CheckRedundantBinds);
+        runner.Add("gl/uniforms-per-draw", CheckUniformsPerDraw);
+    }
+}
@@ -0,0 +1,94 @@
+#include "Benchmark.h"
+#include "Fixtures.h"
+
+#include "Utils/HashMap.h"
+#include "Utils/Text.h"
+#include "Utils/Iter/SplitIter.h"
+
+namespace Quasi::Bench {
+    static constexpr usize MAP_COUNT = 1 << 18;
+
+    template <HashTables::Layout L>
+    static void RegisterLayoutBenches(BenchRunner& runner, Str prefix) {
+        using U64Map    = HashMap<u64, u32, Hashing::DefaultHasher, L>;
+        using StringMap = HashMap<String, u32, Hashing::DefaultHasher, L>;
+
+        runner.Add(Text::Format("{}/u64/insert", prefix), MAP_COUNT, [keys = Vec<u64> {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (keys.IsEmpty()) keys = Fixtures::RandomU64s(MAP_COUNT);
+            state.ResumeTiming();
+            U64Map map;
+            for (usize i = 0; i < keys.Length(); ++i) map.Insert(keys[i], (u32)i);
+            DoNotOptimize(map.Count());
+        });
+
+        runner.Add(Text::Format("{}/u64/lookup-hit", prefix), MAP_COUNT, [keys = Vec<u64> {}, map = U64Map {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (keys.IsEmpty()) {
+                keys = Fixtures::RandomU64s(MAP_COUNT);
+                for (usize i = 0; i < keys.Length(); ++i) map.Insert(keys[i], (u32)i);
+            }
+            state.ResumeTiming();
+            u64 sum = 0;
+            for (const u64 k : keys) sum += *map.Get(k);
+            DoNotOptimize(sum);
+        });
+
+        runner.Add(Text::Format("{}/u64/lookup-miss", prefix), MAP_COUNT, [keys = Vec<u64> {}, misses = Vec<u64> {}, map = U64Map {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (keys.IsEmpty()) {
+                keys = Fixtures::RandomU64s(MAP_COUNT);
+                misses = Fixtures::RandomU64s(MAP_COUNT, Fixtures::SEED + 1);
+                for (usize i = 0; i < keys.Length(); ++i) map.Insert(keys[i], (u32)i);
+            }
+            state.ResumeTiming();
+            usize found = 0;
+            for (const u64 k : misses) found += map.Get(k).HasValue();
+            DoNotOptimize(found);
+        });
+
+        runner.Add(Text::Format("{}/string/insert-lookup", prefix), MAP_COUNT, [words = Vec<String> {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (words.IsEmpty()) {
+                const String corpus = Fixtures::TextCorpus(MAP_COUNT);
+                for (const Str w : corpus.Split(" ")) words.Push(String { w });
+            }
+            state.ResumeTiming();
+            StringMap counts;
+            for (const String& w : words) ++counts[w];
+            DoNotOptimize(counts.Count());
+        });
+
+        // a large string-keyed map looked up by Str, like sprite names or uniform names
+        runner.Add(Text::Format("{}/string/lookup-view", prefix), MAP_COUNT, [names = Vec<String> {}, map = StringMap {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (names.IsEmpty()) {
+                for (usize i = 0; i < MAP_COUNT; ++i) names.Push(Text::Format("sprites/tile_{}.png", i * 7919 % MAP_COUNT));
+                for (usize i = 0; i < names.Length(); ++i) map.Insert(names[i], (u32)i);
+            }
+            state.ResumeTiming();
+            const StringMap& lookup = map;
+            u64 sum = 0;
+            for (const String& n : names) sum += *lookup.Get(n.AsStr());
+            DoNotOptimize(sum);
+        });
+
+        runner.Add(Text::Format("{}/u64/churn", prefix), MAP_COUNT, [keys = Vec<u64> {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (keys.IsEmpty()) keys = Fixtures::RandomU64s(MAP_COUNT);
+            state.ResumeTiming();
+            // keeps a sliding window of 4096 entries, which stresses removal
+            U64Map map;
+            for (usize i = 0; i < keys.Length(); ++i) {
+                map.Insert(keys[i], (u32)i);
+                if (i >= 4096) map.Remove(keys[i - 4096]);
+            }
+            DoNotOptimize(map.Count());
+        });
+    }
+
+    void RegisterHashMapBenches(BenchRunner& runner) {
+        RegisterLayoutBenches<HashTables::Layout::ROBIN_HOOD>(runner, "hashmap");
+        RegisterLayoutBenches<HashTables::Layout::SWISS>(runner, "swissmap");
+    }
+}
@@ -0,0 +1,51 @@
+#include "Verify.h"
+
+#include <atomic>
+#include <latch>
+#include <thread>
+
+#include "Utils/Debug/Logger.h"
+
+namespace Quasi::Bench {
+    static constexpr u32 ENTRIES_PER_THREAD = 100;
+
+    static void PushEntries(Debug::AsyncLogQueue& queue) {
+        for (u32 i = 0; i < ENTRIES_PER_THREAD; ++i)
+            queue.Push({ String { "entry" }, Debug::Severity::INFO, Debug::Timer::Now(), Debug::SourceLoc::current() });
+    }
+
+    // a thread that exits hands its ring back, so threads that come and go one after another reuse the same rings.
+    // whatever an exited thread pushed before it went still reaches the sink
+    static void CheckThreadRings(VerifyRunner& v) {
+        constexpr u32 CONCURRENT = 3;
+        const u32 sequential = v.exhaustive ? 200 : 20;
+        std::atomic<usize> written = 0;
+        Debug::AsyncLogQueue queue { { .overflow = Debug::LogOverflow::BLOCK }, [&] (Span<Debug::LogEntry> batch, usize) {
+            written.fetch_add(batch.Length(), std::memory_order_relaxed);
+        } };
+
+        for (u32 i = 0; i < sequential; ++i) std::thread { [&] { PushEntries(queue); } }.join();
+        queue.Flush();
+        v.Expect(queue.RingCount() == 1, "{} threads logging one after another made {} rings, expected 1", sequential, queue.RingCount());
+        v.Expect(written == sequential * ENTRIES_PER_THREAD, "{} threads logging one after another wrote {} entries, expected {}",
+                 sequential, written.load(), sequential * ENTRIES_PER_THREAD);
+
+        // threads that log at the same time each need a ring, which are all reused afterwards
+        written = 0;
+        std::latch allLogged { CONCURRENT };
+        Vec<std::thread> threads;
+        for (u32 i = 0; i < CONCURRENT; ++i)
+            threads.Push(std::thread { [&] { PushEntries(queue); allLogged.arrive_and_wait(); } });
+        for (std::thread& t : threads) t.join();
+        for (u32 i = 0; i < sequential; ++i) std::thread { [&] { PushEntries(queue); } }.join();
+        queue.Flush();
+        v.Expect(queue.RingCount() == CONCURRENT, "{} threads logging at once and {} after them made {} rings, expected {}",
+                 CONCURRENT, sequential, queue.RingCount(), CONCURRENT);
+        v.Expect(written == (CONCURRENT + sequential) * ENTRIES_PER_THREAD, "{} threads wrote {} entries, expected {}",
+                 CONCURRENT + sequential, written.load(), (CONCURRENT + sequential) * ENTRIES_PER_THREAD);
+    }
+
+    void RegisterLogChecks(VerifyRunner& runner) {
+        runner.Add("log/thread-rings", CheckThreadRings);
+    }
+}
@@ -0,0 +1,40 @@
+#include "Benchmark.h"
+#include "Fixtures.h"
+
+#include "ModelLoading/OBJModelLoader.h"
+#include "ModelLoading/OBJStreamLoader.h"
+
+namespace Quasi::Bench {
+    static constexpr u32 GRID_SIZE = 256, GRID_OBJECTS = 4;
+    static constexpr u64 GRID_FACES = 2 * GRID_SIZE * GRID_SIZE * GRID_OBJECTS;
+
+    void RegisterModelBenches(BenchRunner& runner) {
+        runner.Add("obj/loader", GRID_FACES, [file = String {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (!file) file = Fixtures::GridOBJ(GRID_SIZE, GRID_SIZE, GRID_OBJECTS);
+            state.ResumeTiming();
+            Graphics::OBJModelLoader loader;
+            loader.Load(file);
+            DoNotOptimize(loader.GetModel().objects.Length());
+        });
+
+        runner.Add("obj/stream-loader", GRID_FACES, [file = String {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (!file) file = Fixtures::GridOBJ(GRID_SIZE, GRID_SIZE, GRID_OBJECTS);
+            state.ResumeTiming();
+            Graphics::OBJStreamLoader loader;
+            loader.Load(file);
+            DoNotOptimize(loader.GetModel().objects.Length());
+        });
+
+        runner.Add("obj/stream-loader-mt", GRID_FACES, [file = String {}, jobs = Box<JobSystem> {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (!file) file = Fixtures::GridOBJ(GRID_SIZE, GRID_SIZE, GRID_OBJECTS);
+            if (!jobs) jobs = Box<JobSystem>::Build();
+            state.ResumeTiming();
+            Graphics::OBJStreamLoader loader { *jobs };
+            loader.Load(file);
+            DoNotOptimize(loader.GetModel().objects.Length());
+        });
+    }
+}
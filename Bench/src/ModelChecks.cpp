@@ -0,0 +1,100 @@
+#include "Verify.h"
+#include "Fixtures.h"
+
+#include <bit>
+
+#include "ModelLoading/OBJModelLoader.h"
+#include "ModelLoading/OBJStreamLoader.h"
+
+namespace Quasi::Bench {
+    // only uses what both loaders read the same, see OBJStreamLoader for where they differ
+    static constexpr Str HANDWRITTEN_OBJ =
+        "# a quad, a triangle without texture coordinates and one whose corners go the other way\n"
+        "o quad\n"
+        "v 0 0 0\n"
+        "v 1 0 0\n"
+        "v 1 1 0\n"
+        "v 0 1 0.5\n"
+        "vt 0 0\n"
+        "vt 1 0\n"
+        "vt 1 1\n"
+        "vn 0 0 1\n"
+        "vn 0 0.6 0.8\n"
+        "usemtl not-in-any-library\n"
+        "s 1\n"
+        "f 1/1/1 2/2/1 3/3/1\n"
+        "f 1/1/1 3/3/1 4/1/2\n"
+        "o normals-only\n"
+        "s 0\n"
+        "f 1//1 2//2 3//1\n"
+        "o backwards\n"
+        "f 4/3/2 3/2/1 2/1/1\n";
+
+    static bool SameBits(const Math::fv2& a, const Math::fv2& b) {
+        return std::bit_cast<u64>(a) == std::bit_cast<u64>(b);
+    }
+    static bool SameBits(const Math::fv3& a, const Math::fv3& b) {
+        return SameBits(Math::fv2 { a.x, a.y }, Math::fv2 { b.x, b.y }) && std::bit_cast<u32>(a.z) == std::bit_cast<u32>(b.z);
+    }
+    static bool SameBits(const Graphics::OBJVertex& a, const Graphics::OBJVertex& b) {
+        return SameBits(a.Position, b.Position) && SameBits(a.TextureCoordinate, b.TextureCoordinate) && SameBits(a.Normal, b.Normal);
+    }
+
+    // the vertices of both are deduplicated by their v/vt/vn triple, but OBJModelLoader sorts them by it
+    // while OBJStreamLoader keeps the order they're first used in. so the indices differ,
+    // and instead every triangle has to come out as the same three vertices
+    static void CompareModels(VerifyRunner& v, Str fixture, const Graphics::OBJModel& expected, const Graphics::OBJModel& actual) {
+        if (!v.Expect(expected.objects.Length() == actual.objects.Length(), "{}: OBJModelLoader made {} objects, OBJStreamLoader {}",
+                      fixture, expected.objects.Length(), actual.objects.Length())) return;
+        v.Expect(expected.materials.Length() == actual.materials.Length(), "{}: OBJModelLoader loaded {} materials, OBJStreamLoader {}",
+                 fixture, expected.materials.Length(), actual.materials.Length());
+
+        for (usize o = 0; o < expected.objects.Length(); ++o) {
+            const Graphics::OBJObject& e = expected.objects[o], &a = actual.objects[o];
+            v.Expect(e.name == a.name && e.materialIndex == a.materialIndex && e.smoothShading == a.smoothShading,
+                     "{}: object {} is \"{}\" (material {}, smooth {}) from OBJModelLoader, \"{}\" (material {}, smooth {}) from OBJStreamLoader",
+                     fixture, o, e.name, e.materialIndex, e.smoothShading, a.name, a.materialIndex, a.smoothShading);
+            if (!v.Expect(e.mesh.vertices.Length() == a.mesh.vertices.Length() && e.mesh.indices.Length() == a.mesh.indices.Length(),
+                          "{}: object {} has {} vertices and {} triangles from OBJModelLoader, {} and {} from OBJStreamLoader",
+                          fixture, o, e.mesh.vertices.Length(), e.mesh.indices.Length(), a.mesh.vertices.Length(), a.mesh.indices.Length()))
+                continue;
+
+            const usize vertexCount = a.mesh.vertices.Length();
+            for (usize f = 0; f < e.mesh.indices.Length(); ++f) {
+                const Graphics::Triplet& et = e.mesh.indices[f], &at = a.mesh.indices[f];
+                const bool inRange = at.i < vertexCount && at.j < vertexCount && at.k < vertexCount;
+                v.Expect(inRange &&
+                         SameBits(e.mesh.vertices[et.i], a.mesh.vertices[at.i]) &&
+                         SameBits(e.mesh.vertices[et.j], a.mesh.vertices[at.j]) &&
+                         SameBits(e.mesh.vertices[et.k], a.mesh.vertices[at.k]),
+                         "{}: triangle {} of object {} is {} {} {} from OBJModelLoader, {} {} {} from OBJStreamLoader, which resolve to other vertices",
+                         fixture, f, o, et.i, et.j, et.k, at.i, at.j, at.k);
+            }
+        }
+    }
+
+    static void CheckFixture(VerifyRunner& v, Str fixture, Str obj, JobSystem& jobs) {
+        Graphics::OBJModelLoader reference;
+        reference.Load(obj);
+
+        Graphics::OBJStreamLoader serial, threaded { jobs };
+        serial.Load(obj);
+        threaded.Load(obj);
+        CompareModels(v, fixture, reference.GetModel(), serial.GetModel());
+        CompareModels(v, Text::Format("{} (threaded)", fixture), reference.GetModel(), threaded.GetModel());
+    }
+
+    // OBJStreamLoader reads the files OBJModelLoader can into the same objects, with and without a JobSystem.
+    // the bigger grid spans several chunks, which only match if they're joined back up in order
+    static void CheckStreamMatchesReference(VerifyRunner& v) {
+        JobSystem jobs { 3 };
+        CheckFixture(v, "handwritten", HANDWRITTEN_OBJ, jobs);
+        CheckFixture(v, "grid 8x8x3", Fixtures::GridOBJ(8, 8, 3), jobs);
+        const u32 size = v.exhaustive ? 256 : 64;
+        CheckFixture(v, Text::Format("grid {}x{}x4", size, size), Fixtures::GridOBJ(size, size, 4), jobs);
+    }
+
+    void RegisterModelChecks(VerifyRunner& runner) {
+        runner.Add("obj/stream-matches-reference", CheckStreamMatchesReference);
+    }
+}
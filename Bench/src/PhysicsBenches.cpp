@@ -0,0 +1,27 @@
+#include "Benchmark.h"
+#include "Fixtures.h"
+
+#include "Physics/World2D.h"
+
+namespace Quasi::Bench {
+    static constexpr u32 PILE_BODIES = 1000, PILE_STEPS = 60;
+
+    static void AddPileBench(BenchRunner& runner, Str name, Physics2D::BroadphaseStrategy broadphase, bool threaded) {
+        runner.Add(name, PILE_STEPS, [broadphase, threaded, world = Box<Physics2D::World>::Build(Math::fv2 { 0, -9.8f }), jobs = Box<JobSystem> {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (threaded && !jobs) jobs = Box<JobSystem>::Build();
+            world->jobSystem = threaded ? OptRefs::SomeRef(*jobs) : nullptr;
+            world->SetBroadphase(broadphase);
+            Fixtures::BuildPileScene(*world, PILE_BODIES);
+            state.ResumeTiming();
+            for (u32 i = 0; i < PILE_STEPS; ++i) world->Update(1.0f / 60.0f);
+            DoNotOptimize(world->AwakeBodyCount());
+        });
+    }
+
+    void RegisterPhysicsBenches(BenchRunner& runner) {
+        AddPileBench(runner, "physics/pile/sweep-and-prune", Physics2D::BroadphaseStrategy::SWEEP_AND_PRUNE, false);
+        AddPileBench(runner, "physics/pile/dynamic-tree",    Physics2D::BroadphaseStrategy::DYNAMIC_TREE,    false);
+        AddPileBench(runner, "physics/pile/dynamic-tree-mt", Physics2D::BroadphaseStrategy::DYNAMIC_TREE,    true);
+    }
+}
@@ -0,0 +1,50 @@
+#include "Verify.h"
+#include "Fixtures.h"
+
+#include <bit>
+
+#include "Physics/World2D.h"
+
+namespace Quasi::Bench {
+    static constexpr u32 SCENE_BODIES = 1000;
+
+    static Box<Physics2D::World> SteppedPile(Physics2D::BroadphaseStrategy broadphase, OptRef<JobSystem> jobs, u32 steps) {
+        Box<Physics2D::World> world = Box<Physics2D::World>::Build(Math::fv2 { 0, -9.8f });
+        world->jobSystem = jobs;
+        world->SetBroadphase(broadphase);
+        Fixtures::BuildPileScene(*world, SCENE_BODIES);
+        for (u32 i = 0; i < steps; ++i) world->Update(1.0f / 60.0f);
+        return world;
+    }
+
+    static bool SameBits(float a, float b) { return std::bit_cast<u32>(a) == std::bit_cast<u32>(b); }
+    static bool SameBits(const Math::fv2& a, const Math::fv2& b) { return SameBits(a.x, b.x) && SameBits(a.y, b.y); }
+
+    // the same scene stepped with and without a JobSystem ends up with bit for bit the same bodies,
+    // since every threaded part of a step merges its results in the order a single thread would have made them
+    static void CheckThreadedDeterminism(VerifyRunner& v) {
+        using namespace Physics2D;
+        JobSystem jobs { 3 };
+        const u32 steps = v.exhaustive ? 600 : 120;
+        for (const BroadphaseStrategy broadphase : { BroadphaseStrategy::SWEEP_AND_PRUNE, BroadphaseStrategy::DYNAMIC_TREE }) {
+            const Str name = broadphase == BroadphaseStrategy::SWEEP_AND_PRUNE ? "sweep and prune" : "dynamic tree";
+            const Box<World> serial = SteppedPile(broadphase, nullptr, steps), threaded = SteppedPile(broadphase, OptRefs::SomeRef(jobs), steps);
+            if (!v.Expect(serial->BodyCount() == threaded->BodyCount(), "{}: {} bodies on one thread, {} with a JobSystem",
+                          name, serial->BodyCount(), threaded->BodyCount())) continue;
+
+            for (usize i = 0; i < serial->BodyCount(); ++i) {
+                const Body& a = *serial->BodyAt(i), &b = *threaded->BodyAt(i);
+                v.Expect(a.id == b.id && SameBits(a.position, b.position) && SameBits(a.velocity, b.velocity) &&
+                         SameBits(a.rotation.AsComplex().re, b.rotation.AsComplex().re) &&
+                         SameBits(a.rotation.AsComplex().im, b.rotation.AsComplex().im) &&
+                         SameBits(a.angularVelocity, b.angularVelocity) && a.awake == b.awake,
+                         "{}: after {} steps body {} (#{}) is at {} moving {} on one thread, but body #{} is at {} moving {} with a JobSystem",
+                         name, steps, i, a.id, a.position, a.velocity, b.id, b.position, b.velocity);
+            }
+        }
+    }
+
+    void RegisterPhysicsChecks(VerifyRunner& runner) {
+        runner.Add("physics/threaded-determinism", CheckThreadedDeterminism);
+    }
+}
@@ -0,0 +1,179 @@
+#include "Verify.h"
+#include "Fixtures.h"
+
+#include "Utils/Text/Search.h"
+
+namespace Quasi::Bench {
+    // a bit over three of the widest blocks (32 bytes with avx2), so every block loop runs with every tail length
+    static constexpr usize MAX_SHORT_LEN = 3 * 32 + 8;
+    // the first few letters make up the texts, so that matches are common. one has the top bit set to catch sign mixups
+    static constexpr char ALPHABET[] = { 'a', 'b', '\xE9', 'c', 'z', 'y' };
+    static constexpr u32 TEXT_LETTERS = 4;
+
+    static char RandomLetter(Math::RandomGenerator& rng, u32 letters) { return ALPHABET[rng.Get<u32>(0, letters)]; }
+
+    // the text is placed at a random offset in the buffer, surrounded by more random letters,
+    // so reads past either end show up as wrong results
+    static Str RandomText(Math::RandomGenerator& rng, Vec<char>& buffer, usize len, u32 letters) {
+        buffer.Resize(len + 64);
+        for (char& c : buffer) c = RandomLetter(rng, letters);
+        return Str::Slice(buffer.Data() + rng.Get<usize>(0, 32), len);
+    }
+
+    static Str RandomNeedle(Math::RandomGenerator& rng, Vec<char>& buffer, Str text, usize len, u32 letters) {
+        if (len <= text.Length() && rng.GetBool())
+            return text.Substr(rng.Get<usize>(0, text.Length() - len + 1), len);
+        buffer.Resize(len);
+        for (char& c : buffer) c = RandomLetter(rng, letters);
+        return Str::Slice(buffer.Data(), len);
+    }
+
+    static bool MatchesAt(Str text, usize i, Str needle) {
+        if (i + needle.Length() > text.Length()) return false;
+        for (usize k = 0; k < needle.Length(); ++k) if (text[i + k] != needle[k]) return false;
+        return true;
+    }
+
+    static OptionUsize NaiveFind(Str text, Str needle) {
+        for (usize i = 0; i + needle.Length() <= text.Length(); ++i) if (MatchesAt(text, i, needle)) return i;
+        return nullptr;
+    }
+
+    static OptionUsize NaiveRevFind(Str text, Str needle) {
+        if (needle.Length() > text.Length()) return nullptr;
+        for (usize i = text.Length() - needle.Length() + 1; i --> 0; ) if (MatchesAt(text, i, needle)) return i;
+        return nullptr;
+    }
+
+    // the periodic texts run into thousands of bytes, so failures only show how they start
+    static Str Preview(Str text) { return text.First(std::min<usize>(text.Length(), 48)); }
+
+    static void CheckSubstr(VerifyRunner& v, Str text, Str needle) {
+        const OptionUsize found = Text::FindSubstr(text, needle), expected = NaiveFind(text, needle);
+        v.Expect(found == expected, "FindSubstr(\"{}\"... ({} bytes), \"{}\") = {}, expected {}",
+                 Preview(text), text.Length(), Preview(needle), found, expected);
+        const OptionUsize rfound = Text::RevFindSubstr(text, needle), rexpected = NaiveRevFind(text, needle);
+        v.Expect(rfound == rexpected, "RevFindSubstr(\"{}\"... ({} bytes), \"{}\") = {}, expected {}",
+                 Preview(text), text.Length(), Preview(needle), rfound, rexpected);
+    }
+
+    static void CheckByteSearches(VerifyRunner& v) {
+        Math::RandomGenerator rng = Fixtures::SeededRandom();
+        Vec<char> buffer, set;
+        for (usize len = 0; len <= MAX_SHORT_LEN; ++len) {
+            for (u32 trial = 0; trial < 64; ++trial) {
+                const Str text = RandomText(rng, buffer, len, 1 + trial % TEXT_LETTERS);
+                for (const char c : ALPHABET) {
+                    OptionUsize first = nullptr, last = nullptr;
+                    usize count = 0;
+                    for (usize i = 0; i < len; ++i) {
+                        if (text[i] != c) continue;
+                        if (!first) first = i;
+                        last = i;
+                        ++count;
+                    }
+                    const OptionUsize found = Text::FindByte(text.Data(), len, c), rfound = Text::RevFindByte(text.Data(), len, c);
+                    const usize counted = Text::CountByte(text.Data(), len, c);
+                    v.Expect(found  == first, "FindByte(\"{}\", '{}') = {}, expected {}",    text, c, found,  first);
+                    v.Expect(rfound == last,  "RevFindByte(\"{}\", '{}') = {}, expected {}", text, c, rfound, last);
+                    v.Expect(counted == count, "CountByte(\"{}\", '{}') = {}, expected {}",  text, c, counted, count);
+                }
+
+                // up to 4 bytes take the vector path, more go through a lookup table
+                set.Clear();
+                const u32 setSize = rng.Get<u32>(0, 7);
+                for (u32 i = 0; i < setSize; ++i) set.Push(RandomLetter(rng, std::size(ALPHABET)));
+                OptionUsize first = nullptr, last = nullptr;
+                for (usize i = 0; i < len; ++i) {
+                    if (!set.Contains(text[i])) continue;
+                    if (!first) first = i;
+                    last = i;
+                }
+                const Str setStr = Str::Slice(set.Data(), set.Length());
+                const OptionUsize found = Text::FindByteOf(text.Data(), len, set), rfound = Text::RevFindByteOf(text.Data(), len, set);
+                v.Expect(found  == first, "FindByteOf(\"{}\", \"{}\") = {}, expected {}",    text, setStr, found,  first);
+                v.Expect(rfound == last,  "RevFindByteOf(\"{}\", \"{}\") = {}, expected {}", text, setStr, rfound, last);
+            }
+        }
+    }
+
+    static void CheckSubstrSearches(VerifyRunner& v) {
+        Math::RandomGenerator rng = Fixtures::SeededRandom();
+        Vec<char> textBuffer, needleBuffer;
+        for (usize len = 0; len <= MAX_SHORT_LEN; ++len) {
+            for (u32 trial = 0; trial < 64; ++trial) {
+                const u32 letters = 1 + trial % TEXT_LETTERS;
+                const Str text = RandomText(rng, textBuffer, len, letters);
+                CheckSubstr(v, text, RandomNeedle(rng, needleBuffer, text, rng.Get<usize>(0, 10), letters));
+            }
+        }
+    }
+
+    // texts made of a short pattern repeated, with needles made of the same pattern and a byte changed somewhere.
+    // nearly every position passes the first and last byte filter, so FindSubstr soon switches to two-way
+    static void CheckPeriodicSubstr(VerifyRunner& v) {
+        Math::RandomGenerator rng = Fixtures::SeededRandom();
+        Vec<char> pattern, textBuffer, needleBuffer;
+        const u32 trials = v.exhaustive ? 20000 : 2000;
+        for (u32 trial = 0; trial < trials; ++trial) {
+            pattern.Clear();
+            const usize period = rng.Get<usize>(1, 7);
+            for (usize i = 0; i < period; ++i) pattern.Push(RandomLetter(rng, 2));
+
+            textBuffer.Resize(rng.Get<usize>(MAX_SHORT_LEN, 4096));
+            for (usize i = 0; i < textBuffer.Length(); ++i) textBuffer[i] = pattern[i % period];
+            for (u32 changes = rng.Get<u32>(0, 4); changes; --changes)
+                textBuffer[rng.Get<usize>(0, textBuffer.Length())] = RandomLetter(rng, 3);
+            const Str text = Str::Slice(textBuffer.Data(), textBuffer.Length());
+
+            needleBuffer.Resize(rng.Get<usize>(2, 96));
+            const usize phase = rng.Get<usize>(0, period);
+            for (usize i = 0; i < needleBuffer.Length(); ++i) needleBuffer[i] = pattern[(i + phase) % period];
+            if (rng.GetBool(0.75f))
+                needleBuffer[rng.Get<usize>(0, needleBuffer.Length())] = RandomLetter(rng, 3);
+            CheckSubstr(v, text, Str::Slice(needleBuffer.Data(), needleBuffer.Length()));
+        }
+    }
+
+    static void CheckMultiFinder(VerifyRunner& v) {
+        Math::RandomGenerator rng = Fixtures::SeededRandom();
+        Vec<char> textBuffer, needleBuffers[6];
+        Vec<Str> needles;
+        for (u32 trial = 0; trial < 20000; ++trial) {
+            const u32 letters = 1 + trial % TEXT_LETTERS;
+            const Str text = RandomText(rng, textBuffer, rng.Get<usize>(0, MAX_SHORT_LEN), letters);
+
+            const usize count = rng.Get<usize>(1, std::size(needleBuffers) + 1);
+            needles.Clear();
+            for (usize j = 0; j < count; ++j)
+                needles.Push(RandomNeedle(rng, needleBuffers[j], text, rng.Get<usize>(0, 5), letters));
+
+            // the leftmost (rightmost) position where any needle starts, and the lowest needle index starting there
+            OptionUsize first = nullptr, firstNeedle = nullptr, last = nullptr, lastNeedle = nullptr;
+            for (usize i = 0; i < text.Length(); ++i) {
+                for (usize j = 0; j < count; ++j) {
+                    if (!MatchesAt(text, i, needles[j])) continue;
+                    if (!first) { first = i; firstNeedle = j; }
+                    last = i;
+                    lastNeedle = j;
+                    break;
+                }
+            }
+
+            const Text::MultiFinder finder { needles };
+            const auto [found, foundNeedle] = finder.Find(text);
+            v.Expect(found == first && foundNeedle == firstNeedle, "MultiFinder::Find(\"{}\") in {} needles = ({}, {}), expected ({}, {})",
+                     text, count, found, foundNeedle, first, firstNeedle);
+            const auto [rfound, rfoundNeedle] = finder.RevFind(text);
+            v.Expect(rfound == last && rfoundNeedle == lastNeedle, "MultiFinder::RevFind(\"{}\") in {} needles = ({}, {}), expected ({}, {})",
+                     text, count, rfound, rfoundNeedle, last, lastNeedle);
+        }
+    }
+
+    void RegisterSearchChecks(VerifyRunner& runner) {
+        runner.Add("search/bytes",          CheckByteSearches);
+        runner.Add("search/substr",         CheckSubstrSearches);
+        runner.Add("search/substr-periodic", CheckPeriodicSubstr);
+        runner.Add("search/multi-finder",   CheckMultiFinder);
+    }
+}
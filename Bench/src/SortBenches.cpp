@@ -0,0 +1,98 @@
+#include "Benchmark.h"
+#include "Fixtures.h"
+
+#include "Utils/Algorithm.h"
+#include "Utils/JobSystem.h"
+
+namespace Quasi::Bench {
+    static constexpr usize SORT_COUNT = 1 << 20;
+
+    void RegisterSortBenches(BenchRunner& runner) {
+        runner.Add("sort/u64/random", SORT_COUNT, [data = Vec<u64> {}, work = Vec<u64> {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (data.IsEmpty()) data = Fixtures::RandomU64s(SORT_COUNT);
+            work = data.Clone();
+            state.ResumeTiming();
+            work.Sort(Cmp::Compare<void> {});
+            DoNotOptimize(work.First());
+        });
+
+        runner.Add("sort/u64/nearly-sorted", SORT_COUNT, [data = Vec<u64> {}, work = Vec<u64> {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (data.IsEmpty()) {
+                data = Fixtures::RandomU64s(SORT_COUNT);
+                data.Sort(Cmp::Compare<void> {});
+                // a few swaps, like a list that was sorted last frame
+                for (usize i = 0; i < SORT_COUNT; i += 997) std::swap(data[i], data[(i * 31) % SORT_COUNT]);
+            }
+            work = data.Clone();
+            state.ResumeTiming();
+            work.Sort(Cmp::Compare<void> {});
+            DoNotOptimize(work.First());
+        });
+
+        runner.Add("sort/f32/by-key", SORT_COUNT, [data = Vec<f32> {}, work = Vec<f32> {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (data.IsEmpty()) data = Fixtures::RandomFloats(SORT_COUNT);
+            work = data.Clone();
+            state.ResumeTiming();
+            work.SortByKey([] (float x) { return std::abs(x); });
+            DoNotOptimize(work.First());
+        });
+
+        runner.Add("sort/u64/stable", SORT_COUNT, [data = Vec<u64> {}, work = Vec<u64> {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (data.IsEmpty()) data = Fixtures::RandomU64s(SORT_COUNT);
+            work = data.Clone();
+            state.ResumeTiming();
+            work.SortStable(Cmp::Compare<void> {});
+            DoNotOptimize(work.First());
+        });
+
+        runner.Add("sort/u64/radix", SORT_COUNT, [data = Vec<u64> {}, work = Vec<u64> {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (data.IsEmpty()) data = Fixtures::RandomU64s(SORT_COUNT);
+            work = data.Clone();
+            state.ResumeTiming();
+            work.SortRadix();
+            DoNotOptimize(work.First());
+        });
+
+        runner.Add("sort/f32/radix-by-key", SORT_COUNT, [data = Vec<f32> {}, work = Vec<f32> {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (data.IsEmpty()) data = Fixtures::RandomFloats(SORT_COUNT);
+            work = data.Clone();
+            state.ResumeTiming();
+            work.SortRadixByKey([] (float x) { return std::abs(x); });
+            DoNotOptimize(work.First());
+        });
+
+        // keys behind a pointer, like sorting bodies by their bounding box
+        struct Indirect { float pad[15]; float key; };
+        const auto indirectBench = [&] (Str name, auto sort) {
+            runner.Add(name, SORT_COUNT, [items = Vec<Box<Indirect>> {}, work = Vec<const Indirect*> {}, sort] (BenchState& state) mutable {
+                state.PauseTiming();
+                if (items.IsEmpty()) {
+                    const Vec<f32> keys = Fixtures::RandomFloats(SORT_COUNT);
+                    for (const f32 k : keys) items.Push(Box<Indirect>::Build(Indirect { {}, k }));
+                }
+                work.Clear();
+                for (const Box<Indirect>& i : items) work.Push(i.Data());
+                state.ResumeTiming();
+                sort(work);
+                DoNotOptimize(work.First());
+            });
+        };
+        indirectBench("sort/indirect/by-key",        [] (Vec<const Indirect*>& v) { v.SortByKey      ([] (const Indirect* i) { return i->key; }); });
+        indirectBench("sort/indirect/by-key-cached", [] (Vec<const Indirect*>& v) { v.SortByKeyCached([] (const Indirect* i) { return i->key; }); });
+
+        runner.Add("sort/u64/parallel", SORT_COUNT, [data = Vec<u64> {}, work = Vec<u64> {}, jobs = Box<JobSystem>::Build()] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (data.IsEmpty()) data = Fixtures::RandomU64s(SORT_COUNT);
+            work = data.Clone();
+            state.ResumeTiming();
+            work.SortParallel(*jobs, Cmp::Compare<void> {});
+            DoNotOptimize(work.First());
+        });
+    }
+}
@@ -0,0 +1,104 @@
+#include "Benchmark.h"
+#include "Fixtures.h"
+
+#include "Utils/Text.h"
+#include "Utils/Text/Num.h"
+#include "Utils/Iter/LinesIter.h"
+#include "Utils/Iter/SplitIter.h"
+
+namespace Quasi::Bench {
+    static constexpr usize FORMAT_COUNT = 1 << 16, PARSE_COUNT = 1 << 18;
+
+    void RegisterTextBenches(BenchRunner& runner) {
+        runner.Add("format/int", FORMAT_COUNT, [values = Vec<u64> {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (values.IsEmpty()) values = Fixtures::RandomU64s(FORMAT_COUNT);
+            state.ResumeTiming();
+            usize length = 0;
+            for (const u64 v : values) length += Text::Format("{}", v).Length();
+            DoNotOptimize(length);
+        });
+
+        runner.Add("format/float", FORMAT_COUNT, [values = Vec<f32> {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (values.IsEmpty()) values = Fixtures::RandomFloats(FORMAT_COUNT);
+            state.ResumeTiming();
+            usize length = 0;
+            for (const f32 v : values) length += Text::Format("{}", v).Length();
+            DoNotOptimize(length);
+        });
+
+        runner.Add("format/mixed", FORMAT_COUNT, [values = Vec<f32> {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (values.IsEmpty()) values = Fixtures::RandomFloats(FORMAT_COUNT);
+            state.ResumeTiming();
+            usize length = 0;
+            for (usize i = 0; i < values.Length(); ++i)
+                length += Text::Format("item #{:>6}: {} ({:<8})", i, values[i], Str { "tag" }).Length();
+            DoNotOptimize(length);
+        });
+
+        runner.Add("parse/numbers", PARSE_COUNT, [corpus = String {}, tokens = Vec<Str> {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (tokens.IsEmpty()) {
+                corpus = Fixtures::NumberCorpus(PARSE_COUNT);
+                for (const Str t : corpus.Split(" ")) if (t) tokens.Push(t);
+            }
+            state.ResumeTiming();
+            f64 sum = 0;
+            for (const Str t : tokens) sum += Text::Parse<f64>(t).UnwrapOr(0);
+            DoNotOptimize(sum);
+        });
+
+        runner.Add("parse/ints", PARSE_COUNT, [corpus = String {}, tokens = Vec<Str> {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (tokens.IsEmpty()) {
+                const Vec<u64> values = Fixtures::RandomU64s(PARSE_COUNT);
+                for (const u64 v : values) { corpus += Text::Format("{}", (i32)(v % 2'000'000) - 1'000'000); corpus += ' '; }
+                for (const Str t : corpus.Split(" ")) if (t) tokens.Push(t);
+            }
+            state.ResumeTiming();
+            i64 sum = 0;
+            for (const Str t : tokens) sum += Text::Parse<i32>(t).UnwrapOr(0);
+            DoNotOptimize(sum);
+        });
+
+        runner.Add("str/split-lines", PARSE_COUNT, [corpus = String {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (!corpus) corpus = Fixtures::TextCorpus(PARSE_COUNT);
+            state.ResumeTiming();
+            usize words = 0;
+            for (const Str line : corpus.Lines())
+                for (const Str w : line.Split(" ")) words += !w.IsEmpty();
+            DoNotOptimize(words);
+        });
+
+        runner.Add("str/find", PARSE_COUNT, [corpus = String {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (!corpus) corpus = Fixtures::TextCorpus(PARSE_COUNT);
+            state.ResumeTiming();
+            usize found = 0;
+            Str rest = corpus;
+            while (const OptionUsize i = rest.Find("abc")) {
+                ++found;
+                rest = rest.Skip(*i + 1);
+            }
+            DoNotOptimize(found);
+        });
+
+        runner.Add("str/find-one-of", PARSE_COUNT, [corpus = String {}] (BenchState& state) mutable {
+            state.PauseTiming();
+            if (!corpus) corpus = Fixtures::TextCorpus(PARSE_COUNT);
+            state.ResumeTiming();
+            const Str needles[] = { "qu", "zz", "xy", "jk" };
+            usize found = 0;
+            for (Str rest = corpus;;) {
+                const auto [i, which] = rest.FindOneOf(Spans::Vals(needles));
+                if (!i) break;
+                rest = rest.Skip(*i + needles[*which].Length());
+                ++found;
+            }
+            DoNotOptimize(found);
+        });
+    }
+}
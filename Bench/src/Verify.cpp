@@ -0,0 +1,21 @@
+#include "Verify.h"
+
+namespace Quasi::Bench {
+    void VerifyRunner::Add(Str name, FuncPtr<void, VerifyRunner&> run) {
+        checks.Push({ String { name }, run });
+    }
+
+    u32 VerifyRunner::RunAll() {
+        u32 failedChecks = 0;
+        for (Check& check : checks) {
+            if (filter && !check.name.Contains(filter)) continue;
+            cases = 0;
+            failures = 0;
+            check.run(*this);
+            Text::PrintLn("{:<40} {:>12} cases   {}", check.name, cases, failures ? "FAILED" : "ok");
+            if (failures > MAX_REPORTED) Text::PrintLn("    ... and {} more", failures - MAX_REPORTED);
+            failedChecks += failures != 0;
+        }
+        return failedChecks;
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Utils/Func.h"
+#include "Utils/String.h"
+#include "Utils/Text.h"
+#include "Utils/Text/Num.h"
+#include "Utils/Vec.h"
+
+namespace Quasi::Bench {
+    // correctness checks of the fast paths the benchmarks measure, run by --verify instead of the benchmarks.
+    // most compare against the obvious loop on random inputs seeded like the fixtures, so a failure can be rerun.
+    class VerifyRunner {
+        struct Check {
+            String name;
+            FuncPtr<void, VerifyRunner&> run;
+        };
+
+        Vec<Check> checks;
+        u64 cases = 0, failures = 0; // of the running check
+    public:
+        static constexpr u32 MAX_REPORTED = 8; // failures printed per check, the rest are only counted
+
+        Str filter; // only runs checks with this in their name
+        bool exhaustive = false; // tries every input where that is feasible instead of a sample
+
+        void Add(Str name, FuncPtr<void, VerifyRunner&> run);
+
+        template <class... Ts> bool Expect(bool ok, Str fmt, const Ts&... args) {
+            ++cases;
+            if (ok) return true;
+            if (failures++ < MAX_REPORTED) {
+                Text::Print("    ");
+                Text::PrintLn(fmt, args...);
+            }
+            return false;
+        }
+
+        // returns how many checks failed
+        u32 RunAll();
+    };
+
+    void RegisterSearchChecks (VerifyRunner& runner);
+    void RegisterFloatChecks  (VerifyRunner& runner);
+    void RegisterPhysicsChecks(VerifyRunner& runner);
+    void RegisterLogChecks    (VerifyRunner& runner);
+#ifdef Q_BENCH_GRAPHICS
+    void RegisterGLChecks     (VerifyRunner& runner);
+    void RegisterModelChecks  (VerifyRunner& runner);
+#endif
+}
@@ -0,0 +1,74 @@
+#include "Benchmark.h"
+#include "Verify.h"
+
+#include "Utils/CStr.h"
+#include "Utils/Debug/Profiler.h"
+#include "Utils/Text.h"
+#include "Utils/Text/Num.h"
+
+// usage: quasi_bench [--filter <substring>] [--warmup <n>] [--reps <n>] [--json <path>] [--trace <path>]
+//        quasi_bench --verify <sampled|exhaustive> [--filter <substring>]
+int main(int argc, char** argv) {
+    using namespace Quasi;
+
+    Bench::BenchRunner runner;
+    Bench::VerifyRunner verifier;
+    bool verify = false;
+    CStr jsonPath, tracePath;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const CStr flagArg = argv[i], valueArg = argv[i + 1];
+        const Str flag = flagArg, value = valueArg;
+        if      (flag == "--filter") runner.filter = verifier.filter = value;
+        else if (flag == "--warmup") runner.warmup      = Text::Parse<u32>(value).UnwrapOr(runner.warmup);
+        else if (flag == "--reps")   runner.repetitions = std::max(Text::Parse<u32>(value).UnwrapOr(runner.repetitions), 1u);
+        else if (flag == "--json")   jsonPath = valueArg;
+        else if (flag == "--trace")  tracePath = valueArg;
+        else if (flag == "--verify") { verify = true; verifier.exhaustive = value == "exhaustive"; }
+        else {
+            Text::PrintLn("unknown option {}", flag);
+            return 1;
+        }
+    }
+
+    if (verify) {
+        Bench::RegisterSearchChecks (verifier);
+        Bench::RegisterFloatChecks  (verifier);
+        Bench::RegisterPhysicsChecks(verifier);
+        Bench::RegisterLogChecks    (verifier);
+#ifdef Q_BENCH_GRAPHICS
+        Bench::RegisterGLChecks     (verifier);
+        Bench::RegisterModelChecks  (verifier);
+#endif
+        return verifier.RunAll() ? 1 : 0;
+    }
+
+    Bench::RegisterSortBenches   (runner);
+    Bench::RegisterHashMapBenches(runner);
+    Bench::RegisterTextBenches   (runner);
+    Bench::RegisterPhysicsBenches(runner);
+#ifdef Q_BENCH_GRAPHICS
+    Bench::RegisterCanvasBenches (runner);
+    Bench::RegisterModelBenches  (runner);
+#endif
+
+    // only the last zones of each thread fit in the profiler, so this is mostly useful with --filter
+    if (tracePath) Debug::Profiler::Enable();
+    runner.RunAll();
+    Text::NewLn();
+    runner.PrintResults();
+
+    if (tracePath) {
+        Text::NewLn();
+        Debug::Profiler::Summarize().WriteTo(Text::StringWriter::WriteToConsole());
+        if (!Debug::Profiler::WriteChromeTrace(tracePath)) {
+            Text::PrintLn("couldn't write trace to {}", tracePath);
+            return 1;
+        }
+    }
+
+    if (jsonPath && !Text::WriteFile(jsonPath, runner.ResultsJson())) {
+        Text::PrintLn("couldn't write results to {}", jsonPath);
+        return 1;
+    }
+    return 0;
+}
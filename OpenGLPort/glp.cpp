@@ -31,12 +31,46 @@ namespace GL {
 // #define INTO_UINT_0(X) X
 // #define CAST_IF_ENUM(X) CAT2(INTO_UINT_, PROBE_ENUM(X))(X)
 
+    static const Dispatch* dispatch = nullptr;
+
 #define IMPL_FN(NAME, RET, ARGS) \
-    RET NAME(RUN(DEL_FIRST EMPTY() (CAT2(ARGS_1 ARGS, END)))) \
-    { return gl##NAME(RUN(DEL_FIRST EMPTY() (CAT2(SEND_1 ARGS, END)))); }
+    RET NAME(RUN(DEL_FIRST EMPTY() (CAT2(ARGS_1 ARGS, END)))) { \
+        if (dispatch) return dispatch->NAME(RUN(DEL_FIRST EMPTY() (CAT2(SEND_1 ARGS, END)))); \
+        return gl##NAME(RUN(DEL_FIRST EMPTY() (CAT2(SEND_1 ARGS, END)))); \
+    }
 
     GLPORT_ON_FUNCTIONS(IMPL_FN)
 
+    namespace Driver {
+#define DRIVER_FN(NAME, RET, ARGS) \
+    static RET NAME(RUN(DEL_FIRST EMPTY() (CAT2(ARGS_1 ARGS, END)))) \
+    { return gl##NAME(RUN(DEL_FIRST EMPTY() (CAT2(SEND_1 ARGS, END)))); }
+
+        GLPORT_ON_FUNCTIONS(DRIVER_FN)
+    }
+
+#define DRIVER_ENTRY(NAME, RET, ARGS) &Driver::NAME,
+    static const Dispatch DRIVER_DISPATCH = { GLPORT_ON_FUNCTIONS(DRIVER_ENTRY) };
+
+#define NAME_OF(NAME, RET, ARGS) #NAME,
+    static const char* const FUNC_NAMES[] = { GLPORT_ON_FUNCTIONS(NAME_OF) };
+
+    const char* FuncName(FuncID func) {
+        return func < FuncID::COUNT ? FUNC_NAMES[(unsigned)func] : "?";
+    }
+
+    const Dispatch& DriverDispatch() {
+        return DRIVER_DISPATCH;
+    }
+
+    void SetDispatch(const Dispatch* table) {
+        dispatch = table;
+    }
+
+    const Dispatch* CurrentDispatch() {
+        return dispatch;
+    }
+
     bool Supports(const char* name) {
         return glewIsExtensionSupported(name);
     }
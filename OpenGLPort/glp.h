@@ -8105,6 +8105,26 @@ namespace GL {
 
     GLPORT_ON_FUNCTIONS(DEF_FN)
 
+    // every function as a pointer. calls go straight to the driver unless a table is set with SetDispatch,
+    // which is how they get recorded (see glprecord.h) or sent somewhere without a gpu (see glpnull.h)
+#define DEF_PTR(NAME, RET, ARGS) RET (*NAME)(RUN(DEL_FIRST EMPTY() (CAT2(ARGS_1 ARGS, END))));
+    struct Dispatch {
+        GLPORT_ON_FUNCTIONS(DEF_PTR)
+    };
+
+#define DEF_ID(NAME, RET, ARGS) NAME,
+    enum class FuncID : unsigned short {
+        GLPORT_ON_FUNCTIONS(DEF_ID)
+        COUNT
+    };
+    const char* FuncName(FuncID func);
+
+    // calls into the driver, for tables that forward to it
+    const Dispatch& DriverDispatch();
+    // nullptr goes back to the driver. the table has to stay alive while it is set
+    void SetDispatch(const Dispatch* table);
+    const Dispatch* CurrentDispatch();
+
 #undef COMMA
 #undef EMPTY
 #undef WAIT
@@ -8113,6 +8133,8 @@ namespace GL {
 #undef CAT2
 #undef DEL_FIRST
 #undef DEF_FN
+#undef DEF_PTR
+#undef DEF_ID
 #undef ARGS_1
 #undef ARGS_2
 #undef ARGS_1END
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "glp.h"
+
+// compile time information about the functions, shared by the tables in glprecord.cpp and glpnull.cpp
+namespace GL::Meta {
+#define NAME_VIEW(NAME, RET, ARGS) #NAME,
+    inline constexpr std::string_view NAMES[] = { GLPORT_ON_FUNCTIONS(NAME_VIEW) };
+#undef NAME_VIEW
+
+    constexpr std::string_view NameOf(FuncID func) { return NAMES[(unsigned)func]; }
+
+    constexpr bool StartsWithWord(std::string_view name, std::string_view prefix) {
+        return name.starts_with(prefix) && name.size() > prefix.size() &&
+               name[prefix.size()] >= 'A' && name[prefix.size()] <= 'Z';
+    }
+
+    // calls that only read state back
+    constexpr bool IsQuery(std::string_view name) {
+        return StartsWithWord(name, "Get") || StartsWithWord(name, "Is") || StartsWithWord(name, "Are") ||
+               name == "ReadPixels" || name == "ReadnPixels" ||
+               name.starts_with("CheckFramebufferStatus") || name.starts_with("CheckNamedFramebufferStatus");
+    }
+
+    constexpr bool IsDraw(std::string_view name) {
+        return StartsWithWord(name, "Draw") || StartsWithWord(name, "MultiDraw");
+    }
+
+    template <class... Ts> struct Types {
+        static constexpr std::size_t COUNT = sizeof...(Ts);
+        template <std::size_t I> using At = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+        // whether the last arguments are exactly Us...
+        template <class... Us> static constexpr bool EndsWith() {
+            if constexpr (sizeof...(Us) > COUNT) return false;
+            else return []<std::size_t... I>(std::index_sequence<I...>) {
+                return (std::is_same_v<At<COUNT - sizeof...(Us) + I>, Us> && ...);
+            }(std::index_sequence_for<Us...>{});
+        }
+    };
+
+    // Gen* and Create* that write n new names
+    template <FuncID ID, class... As>
+    constexpr bool MakesNames() {
+        constexpr std::string_view name = NameOf(ID);
+        return (StartsWithWord(name, "Gen") || StartsWithWord(name, "Create")) && Types<As...>::template EndsWith<Isize, Uint*>();
+    }
+}
@@ -0,0 +1,244 @@
+#include "glpnull.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "glpmeta.h"
+
+namespace GL {
+    using namespace Meta;
+
+    struct NullCalls {
+        static NullContext& Begin() {
+            NullContext& ctx = *NullContext::current;
+            ++ctx.stats.calls;
+            return ctx;
+        }
+
+        template <FuncID ID, class R, class... As>
+        static R Default(As... args) {
+            NullContext& ctx = Begin();
+            if constexpr (IsDraw(NameOf(ID))) ++ctx.stats.drawCalls;
+            if constexpr (MakesNames<ID, As...>()) {
+                constexpr std::size_t count = sizeof...(As);
+                const std::tuple<As...> tuple { args... };
+                Uint* names = std::get<count - 1>(tuple);
+                for (Isize i = 0; i < std::get<count - 2>(tuple); ++i) names[i] = ctx.nextName++;
+            }
+            ((void)args, ...);
+            if constexpr (!std::is_void_v<R>) return R {};
+        }
+
+        static std::vector<unsigned char>* Storage(NullContext& ctx, Uint buffer) {
+            const auto it = ctx.buffers.find(buffer);
+            return it != ctx.buffers.end() ? &it->second : nullptr;
+        }
+
+        static std::vector<unsigned char>* BoundStorage(NullContext& ctx, Enum target) {
+            const auto it = ctx.bufferBindings.find(target);
+            return it != ctx.bufferBindings.end() ? Storage(ctx, it->second) : nullptr;
+        }
+
+        static void Allocate(NullContext& ctx, std::vector<unsigned char>* storage, IsizePtr size, const void* data) {
+            if (!storage) return;
+            storage->assign((std::size_t)size, 0);
+            if (data) {
+                std::memcpy(storage->data(), data, (std::size_t)size);
+                ctx.stats.bytesUploaded += (std::size_t)size;
+            }
+        }
+
+        static void Write(NullContext& ctx, std::vector<unsigned char>* storage, IntPtr offset, IsizePtr size, const void* data) {
+            if (!storage || !data || offset < 0 || size < 0 || (std::size_t)(offset + size) > storage->size()) return;
+            std::memcpy(storage->data() + offset, data, (std::size_t)size);
+            ctx.stats.bytesUploaded += (std::size_t)size;
+        }
+
+        static void* Map(std::vector<unsigned char>* storage, IntPtr offset) {
+            return storage && offset >= 0 && (std::size_t)offset <= storage->size() ? storage->data() + offset : nullptr;
+        }
+
+        static Uint NewName() { return Begin().nextName++; }
+
+        static Uint CreateShader(Enum) { return NewName(); }
+        static Uint CreateProgram() { return NewName(); }
+
+        static void BindBuffer(Enum target, Uint buffer) {
+            NullContext& ctx = Begin();
+            ctx.bufferBindings[target] = buffer;
+            // the name only becomes a buffer once bound
+            if (buffer) ctx.buffers.try_emplace(buffer);
+        }
+
+        static void DeleteBuffers(Isize n, const Uint* buffers) {
+            NullContext& ctx = Begin();
+            for (Isize i = 0; i < n; ++i) {
+                ctx.buffers.erase(buffers[i]);
+                for (auto& [target, bound] : ctx.bufferBindings)
+                    if (bound == buffers[i]) bound = 0;
+            }
+        }
+
+        static void CreateBuffers(Isize n, Uint* buffers) {
+            NullContext& ctx = Begin();
+            for (Isize i = 0; i < n; ++i) ctx.buffers.try_emplace(buffers[i] = ctx.nextName++);
+        }
+
+        static void BufferData(Enum target, IsizePtr size, const void* data, Enum) {
+            NullContext& ctx = Begin();
+            Allocate(ctx, BoundStorage(ctx, target), size, data);
+        }
+        static void NamedBufferData(Uint buffer, IsizePtr size, const void* data, Enum) {
+            NullContext& ctx = Begin();
+            Allocate(ctx, Storage(ctx, buffer), size, data);
+        }
+        static void BufferStorage(Enum target, IsizePtr size, const void* data, Bitfield) {
+            NullContext& ctx = Begin();
+            Allocate(ctx, BoundStorage(ctx, target), size, data);
+        }
+        static void NamedBufferStorage(Uint buffer, IsizePtr size, const void* data, Bitfield) {
+            NullContext& ctx = Begin();
+            Allocate(ctx, Storage(ctx, buffer), size, data);
+        }
+
+        static void BufferSubData(Enum target, IntPtr offset, IsizePtr size, const void* data) {
+            NullContext& ctx = Begin();
+            Write(ctx, BoundStorage(ctx, target), offset, size, data);
+        }
+        static void NamedBufferSubData(Uint buffer, IntPtr offset, IsizePtr size, const void* data) {
+            NullContext& ctx = Begin();
+            Write(ctx, Storage(ctx, buffer), offset, size, data);
+        }
+
+        static void* MapBuffer(Enum target, Enum) { return Map(BoundStorage(Begin(), target), 0); }
+        static void* MapBufferRange(Enum target, IntPtr offset, IsizePtr, Bitfield) { return Map(BoundStorage(Begin(), target), offset); }
+        static void* MapNamedBuffer(Uint buffer, Enum) { return Map(Storage(Begin(), buffer), 0); }
+        static void* MapNamedBufferRange(Uint buffer, IntPtr offset, IsizePtr, Bitfield) { return Map(Storage(Begin(), buffer), offset); }
+        static Bool UnmapBuffer(Enum) { Begin(); return 1; }
+        static Bool UnmapNamedBuffer(Uint) { Begin(); return 1; }
+
+        static void GetBufferParameteriv(Enum target, Enum pname, Int* params) {
+            const std::vector<unsigned char>* storage = BoundStorage(Begin(), target);
+            *params = pname == BUFFER_SIZE && storage ? (Int)storage->size() : 0;
+        }
+
+        // everything compiles and links, with empty logs
+        static void GetShaderiv(Uint, Enum pname, Int* params) {
+            Begin();
+            *params = pname == COMPILE_STATUS ? 1 : 0;
+        }
+        static void GetProgramiv(Uint, Enum pname, Int* params) {
+            Begin();
+            *params = pname == LINK_STATUS || pname == VALIDATE_STATUS ? 1 : 0;
+        }
+
+        // the same name always gets the same location, whichever program it is asked from
+        static Int Location(const char* name) {
+            NullContext& ctx = Begin();
+            return ctx.locations.try_emplace(name, (Int)ctx.locations.size()).first->second;
+        }
+        static Int GetUniformLocation(Uint, const char* name) { return Location(name); }
+        static Int GetAttribLocation(Uint, const char* name) { return Location(name); }
+        static Uint GetUniformBlockIndex(Uint, const char*) { Begin(); return INVALID_INDEX; }
+
+        static const Ubyte* GetString(Enum name) {
+            Begin();
+            switch (name) {
+                case VENDOR:                   return (const Ubyte*)"Quasi";
+                case RENDERER:                 return (const Ubyte*)"OpenGLPort null context";
+                case VERSION:                  return (const Ubyte*)"4.6.0";
+                case SHADING_LANGUAGE_VERSION: return (const Ubyte*)"4.60";
+                default:                       return (const Ubyte*)"";
+            }
+        }
+
+        static void GetIntegerv(Enum pname, Int* data) {
+            NullContext& ctx = Begin();
+            switch (pname) {
+                case MAJOR_VERSION:                    *data = 4; break;
+                case MINOR_VERSION:                    *data = 6; break;
+                case MAX_TEXTURE_SIZE:                 *data = 16384; break;
+                case MAX_TEXTURE_IMAGE_UNITS:          *data = 32; break;
+                case MAX_COMBINED_TEXTURE_IMAGE_UNITS: *data = 192; break;
+                case MAX_VERTEX_ATTRIBS:               *data = 16; break;
+                case MAX_UNIFORM_BUFFER_BINDINGS:      *data = 84; break;
+                case UNIFORM_BUFFER_OFFSET_ALIGNMENT:  *data = 256; break;
+                case ARRAY_BUFFER_BINDING:             *data = (Int)ctx.bufferBindings[ARRAY_BUFFER]; break;
+                case ELEMENT_ARRAY_BUFFER_BINDING:     *data = (Int)ctx.bufferBindings[ELEMENT_ARRAY_BUFFER]; break;
+                default:                               *data = 0; break;
+            }
+        }
+
+        static Enum CheckFramebufferStatus(Enum) { Begin(); return FRAMEBUFFER_COMPLETE; }
+        static Enum CheckNamedFramebufferStatus(Uint, Enum) { Begin(); return FRAMEBUFFER_COMPLETE; }
+
+        // syncs are only compared against null
+        static Sync FenceSync(Enum, Bitfield) { return (Sync)(std::uintptr_t)NewName(); }
+        static Enum ClientWaitSync(Sync, Bitfield, Uint64) { Begin(); return ALREADY_SIGNALED; }
+    };
+
+#define NULL_ENTRY(NAME, RET, ARGS) &NullCalls::Default<FuncID::NAME>,
+    static const Dispatch NULL_DISPATCH = [] {
+        // the defaults deduce their signature from the member they initialize
+        Dispatch table = { GLPORT_ON_FUNCTIONS(NULL_ENTRY) };
+
+#define NULL_OVERRIDE(NAME) table.NAME = &NullCalls::NAME;
+        NULL_OVERRIDE(CreateShader)
+        NULL_OVERRIDE(CreateProgram)
+        NULL_OVERRIDE(BindBuffer)
+        NULL_OVERRIDE(DeleteBuffers)
+        NULL_OVERRIDE(CreateBuffers)
+        NULL_OVERRIDE(BufferData)
+        NULL_OVERRIDE(NamedBufferData)
+        NULL_OVERRIDE(BufferStorage)
+        NULL_OVERRIDE(NamedBufferStorage)
+        NULL_OVERRIDE(BufferSubData)
+        NULL_OVERRIDE(NamedBufferSubData)
+        NULL_OVERRIDE(MapBuffer)
+        NULL_OVERRIDE(MapBufferRange)
+        NULL_OVERRIDE(MapNamedBuffer)
+        NULL_OVERRIDE(MapNamedBufferRange)
+        NULL_OVERRIDE(UnmapBuffer)
+        NULL_OVERRIDE(UnmapNamedBuffer)
+        NULL_OVERRIDE(GetBufferParameteriv)
+        NULL_OVERRIDE(GetShaderiv)
+        NULL_OVERRIDE(GetProgramiv)
+        NULL_OVERRIDE(GetUniformLocation)
+        NULL_OVERRIDE(GetAttribLocation)
+        NULL_OVERRIDE(GetUniformBlockIndex)
+        NULL_OVERRIDE(GetString)
+        NULL_OVERRIDE(GetIntegerv)
+        NULL_OVERRIDE(CheckFramebufferStatus)
+        NULL_OVERRIDE(CheckNamedFramebufferStatus)
+        NULL_OVERRIDE(FenceSync)
+        NULL_OVERRIDE(ClientWaitSync)
+#undef NULL_OVERRIDE
+        return table;
+    }();
+#undef NULL_ENTRY
+
+    NullContext::~NullContext() {
+        if (current != this) return;
+        if (CurrentDispatch() == &NULL_DISPATCH) SetDispatch(nullptr);
+        current = nullptr;
+    }
+
+    void NullContext::MakeCurrent() {
+        current = this;
+        SetDispatch(&NULL_DISPATCH);
+    }
+
+    const Dispatch& NullContext::Table() {
+        return NULL_DISPATCH;
+    }
+
+    const std::vector<unsigned char>* NullContext::BufferStorage(Uint buffer) const {
+        const auto it = buffers.find(buffer);
+        return it != buffers.end() ? &it->second : nullptr;
+    }
+
+    Uint NullContext::BoundBuffer(Enum target) const {
+        const auto it = bufferBindings.find(target);
+        return it != bufferBindings.end() ? it->second : 0;
+    }
+}
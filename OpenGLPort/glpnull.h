@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "glp.h"
+
+namespace GL {
+    // a context without a gpu, for running rendering code headless and profiling just its cpu side.
+    // every call is accepted and does nothing, except what code usually checks or reads back:
+    // names are handed out in order, shaders compile and link, framebuffers are complete,
+    // and buffers keep their data so they can be mapped and inspected.
+    class NullContext {
+        Uint nextName = 1;
+        std::unordered_map<Uint, std::vector<unsigned char>> buffers;
+        std::unordered_map<Enum, Uint> bufferBindings;
+        std::unordered_map<std::string, Int> locations;
+
+        inline static NullContext* current = nullptr;
+
+        friend struct NullCalls;
+    public:
+        struct Stats {
+            std::size_t calls = 0, drawCalls = 0, bytesUploaded = 0;
+        };
+        Stats stats;
+
+        NullContext() = default;
+        ~NullContext();
+
+        NullContext(const NullContext&) = delete;
+        NullContext& operator=(const NullContext&) = delete;
+
+        // sets the dispatch to this context's table
+        void MakeCurrent();
+        static NullContext* Current() { return current; }
+        // calls act on whichever context is current, this is what a Recorder can forward to
+        static const Dispatch& Table();
+
+        const std::vector<unsigned char>* BufferStorage(Uint buffer) const;
+        Uint BoundBuffer(Enum target) const;
+        void ResetStats() { stats = {}; }
+    };
+}
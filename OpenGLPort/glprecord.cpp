@@ -0,0 +1,332 @@
+#include "glprecord.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "glpmeta.h"
+
+namespace GL {
+    using namespace Meta;
+
+    // bytes per count of Uniform*v and ProgramUniform*v, 0 for anything else
+    static constexpr std::size_t UniformElementBytes(std::string_view name) {
+        if (name.starts_with("Program")) name.remove_prefix(7);
+        if (!name.starts_with("Uniform")) return 0;
+        name.remove_prefix(7);
+        // vendor suffixes
+        while (!name.empty() && name.back() >= 'A' && name.back() <= 'Z') name.remove_suffix(1);
+
+        std::size_t scalar;
+        if      (name.ends_with("i64v")) { scalar = 8; name.remove_suffix(name.ends_with("ui64v") ? 5 : 4); }
+        else if (name.ends_with("uiv"))  { scalar = 4; name.remove_suffix(3); }
+        else if (name.ends_with("iv") || name.ends_with("fv")) { scalar = 4; name.remove_suffix(2); }
+        else if (name.ends_with("dv"))   { scalar = 8; name.remove_suffix(2); }
+        else return 0;
+
+        const auto isDim = [] (char c) { return c >= '1' && c <= '4'; };
+        if (name.starts_with("Matrix")) {
+            name.remove_prefix(6);
+            if (name.size() == 1 && isDim(name[0])) return scalar * (name[0] - '0') * (name[0] - '0');
+            if (name.size() == 3 && isDim(name[0]) && name[1] == 'x' && isDim(name[2]))
+                return scalar * (name[0] - '0') * (name[2] - '0');
+            return 0;
+        }
+        return name.size() == 1 && isDim(name[0]) ? scalar * (name[0] - '0') : 0;
+    }
+
+    static std::size_t PixelBytes(Enum format, Enum type) {
+        std::size_t channels;
+        switch (format) {
+            case RED: case RED_INTEGER: case ALPHA: case LUMINANCE: case DEPTH_COMPONENT: case STENCIL_INDEX:
+                channels = 1; break;
+            case RG: case RG_INTEGER: case DEPTH_STENCIL:
+                channels = 2; break;
+            case RGB: case BGR: case RGB_INTEGER: case BGR_INTEGER:
+                channels = 3; break;
+            default:
+                channels = 4; break;
+        }
+        switch (type) {
+            case BYTE: case UNSIGNED_BYTE:
+                return channels;
+            case SHORT: case UNSIGNED_SHORT: case HALF_FLOAT:
+                return channels * 2;
+            case INT: case UNSIGNED_INT: case FLOAT:
+                return channels * 4;
+            case FLOAT_32_UNSIGNED_INT_24_8_REV:
+                return 8;
+            // the rest are packed into one value per pixel
+            case UNSIGNED_BYTE_3_3_2: case UNSIGNED_BYTE_2_3_3_REV:
+                return 1;
+            case UNSIGNED_SHORT_5_6_5: case UNSIGNED_SHORT_5_6_5_REV:
+            case UNSIGNED_SHORT_4_4_4_4: case UNSIGNED_SHORT_4_4_4_4_REV:
+            case UNSIGNED_SHORT_5_5_5_1: case UNSIGNED_SHORT_1_5_5_5_REV:
+                return 2;
+            default:
+                return 4;
+        }
+    }
+
+    // rows are padded to the unpack alignment, except the last which may end at the end of the data.
+    // UNPACK_ROW_LENGTH and the skips arent tracked, so images uploaded with those set are copied short
+    static std::size_t ImageBytes(Isize width, Isize height, Isize depth, Enum format, Enum type, Int alignment) {
+        if (width <= 0 || height <= 0 || depth <= 0) return 0;
+        const std::size_t row = (std::size_t)width * PixelBytes(format, type),
+                          align = alignment > 0 ? (std::size_t)alignment : 1,
+                          stride = (row + align - 1) / align * align;
+        return stride * ((std::size_t)height * (std::size_t)depth - 1) + row;
+    }
+
+    static Recorder* active = nullptr;
+
+    struct RecordedCalls {
+        template <FuncID ID, class R, class... As>
+        static R Record(R (*Dispatch::*member)(As...), std::type_identity_t<As>... args) {
+            Recorder& rec = *active;
+            CommandLog& log = rec.log;
+            const std::size_t index = log.commands.size();
+            log.commands.push_back({ .func = ID, .argOffset = (unsigned)log.bytes.size() });
+            (Append(log.bytes, &args, sizeof(As)), ...);
+
+            const std::tuple<As...> tuple { args... };
+            CaptureInput<ID>(rec, index, tuple);
+            TrackState<ID>(rec, tuple);
+
+            if constexpr (std::is_void_v<R>) {
+                (rec.forward->*member)(args...);
+                CaptureOutput<ID>(rec, index, tuple);
+            } else {
+                R result = (rec.forward->*member)(args...);
+                CaptureOutput<ID>(rec, index, tuple);
+                return result;
+            }
+        }
+
+        static void Append(std::vector<unsigned char>& bytes, const void* data, std::size_t size) {
+            const auto* begin = (const unsigned char*)data;
+            bytes.insert(bytes.end(), begin, begin + size);
+        }
+
+        static void Payload(Recorder& rec, std::size_t index, std::size_t arg, const void* data, std::size_t size) {
+            if (!data || !size) return;
+            Command& cmd = rec.log.commands[index];
+            cmd.payloadArg = (unsigned char)arg;
+            cmd.payloadOffset = (unsigned)rec.log.bytes.size();
+            cmd.payloadSize = (unsigned)size;
+            Append(rec.log.bytes, data, size);
+        }
+
+        static void ImagePayload(Recorder& rec, std::size_t index, std::size_t arg, const void* pixels,
+                                 Isize width, Isize height, Isize depth, Enum format, Enum type) {
+            // with a buffer bound, pixels is an offset into it
+            if (rec.pixelUnpackBuffer) return;
+            Payload(rec, index, arg, pixels, ImageBytes(width, height, depth, format, type, rec.unpackAlignment));
+        }
+
+        template <FuncID ID, class... As>
+        static void CaptureInput(Recorder& rec, std::size_t index, const std::tuple<As...>& args) {
+            using Args = Types<As...>;
+            constexpr std::string_view name = NameOf(ID);
+            using std::get;
+
+            if constexpr (ID == FuncID::ShaderSource) {
+                // every string one after another, each ended by a nul
+                const Isize count = get<1>(args);
+                const char* const* strings = get<2>(args);
+                const Int* lengths = get<3>(args);
+                Command& cmd = rec.log.commands[index];
+                cmd.payloadArg = 2;
+                cmd.payloadOffset = (unsigned)rec.log.bytes.size();
+                for (Isize i = 0; i < count; ++i) {
+                    const std::size_t length = lengths && lengths[i] >= 0 ? (std::size_t)lengths[i] : std::strlen(strings[i]);
+                    Append(rec.log.bytes, strings[i], length);
+                    rec.log.bytes.push_back('\0');
+                }
+                cmd.payloadSize = (unsigned)(rec.log.bytes.size() - cmd.payloadOffset);
+            } else if constexpr (ID == FuncID::BufferData || ID == FuncID::NamedBufferData) {
+                Payload(rec, index, 2, get<2>(args), (std::size_t)get<1>(args));
+            } else if constexpr (ID == FuncID::BufferSubData || ID == FuncID::NamedBufferSubData) {
+                Payload(rec, index, 3, get<3>(args), (std::size_t)get<2>(args));
+            } else if constexpr (UniformElementBytes(name) != 0) {
+                constexpr std::size_t count = name.starts_with("Program") ? 2 : 1, value = Args::COUNT - 1;
+                Payload(rec, index, value, get<value>(args), (std::size_t)get<count>(args) * UniformElementBytes(name));
+            } else if constexpr (name.starts_with("Delete") && Args::template EndsWith<Isize, const Uint*>()) {
+                Payload(rec, index, Args::COUNT - 1, get<Args::COUNT - 1>(args), (std::size_t)get<Args::COUNT - 2>(args) * sizeof(Uint));
+            } else if constexpr (ID == FuncID::DrawBuffers) {
+                Payload(rec, index, 1, get<1>(args), (std::size_t)get<0>(args) * sizeof(Enum));
+            } else if constexpr (ID == FuncID::TexParameteriv || ID == FuncID::TexParameterfv) {
+                const Enum pname = get<1>(args);
+                Payload(rec, index, 2, get<2>(args), (pname == TEXTURE_BORDER_COLOR || pname == TEXTURE_SWIZZLE_RGBA ? 4 : 1) * 4);
+            } else if constexpr (ID == FuncID::ClearBufferfv || ID == FuncID::ClearBufferiv || ID == FuncID::ClearBufferuiv) {
+                Payload(rec, index, 2, get<2>(args), (get<0>(args) == COLOR ? 4 : 1) * 4);
+            } else if constexpr (ID == FuncID::TexImage1D) {
+                ImagePayload(rec, index, 7, get<7>(args), get<3>(args), 1, 1, get<5>(args), get<6>(args));
+            } else if constexpr (ID == FuncID::TexImage2D) {
+                ImagePayload(rec, index, 8, get<8>(args), get<3>(args), get<4>(args), 1, get<6>(args), get<7>(args));
+            } else if constexpr (ID == FuncID::TexImage3D) {
+                ImagePayload(rec, index, 9, get<9>(args), get<3>(args), get<4>(args), get<5>(args), get<7>(args), get<8>(args));
+            } else if constexpr (ID == FuncID::TexSubImage1D) {
+                ImagePayload(rec, index, 6, get<6>(args), get<3>(args), 1, 1, get<4>(args), get<5>(args));
+            } else if constexpr (ID == FuncID::TexSubImage2D) {
+                ImagePayload(rec, index, 8, get<8>(args), get<4>(args), get<5>(args), 1, get<6>(args), get<7>(args));
+            } else if constexpr (ID == FuncID::TexSubImage3D) {
+                ImagePayload(rec, index, 10, get<10>(args), get<5>(args), get<6>(args), get<7>(args), get<8>(args), get<9>(args));
+            } else if constexpr (ID == FuncID::ClearTexImage) {
+                Payload(rec, index, 4, get<4>(args), PixelBytes(get<2>(args), get<3>(args)));
+            }
+        }
+
+        // names made by Gen* and Create* are only known after the call
+        template <FuncID ID, class... As>
+        static void CaptureOutput(Recorder& rec, std::size_t index, const std::tuple<As...>& args) {
+            using Args = Types<As...>;
+            if constexpr (MakesNames<ID, As...>()) {
+                Payload(rec, index, Args::COUNT - 1, std::get<Args::COUNT - 1>(args),
+                        (std::size_t)std::get<Args::COUNT - 2>(args) * sizeof(Uint));
+            }
+        }
+
+        template <FuncID ID, class... As>
+        static void TrackState(Recorder& rec, const std::tuple<As...>& args) {
+            if constexpr (ID == FuncID::PixelStorei) {
+                if (std::get<0>(args) == UNPACK_ALIGNMENT) rec.unpackAlignment = std::get<1>(args);
+            } else if constexpr (ID == FuncID::BindBuffer) {
+                if (std::get<0>(args) == PIXEL_UNPACK_BUFFER) rec.pixelUnpackBuffer = std::get<1>(args);
+            }
+        }
+    };
+
+    template <class... As>
+    static std::tuple<As...> UnpackArgs(const unsigned char* bytes) {
+        std::tuple<As...> args;
+        std::apply([&] (As&... arg) { ((std::memcpy(&arg, bytes, sizeof(As)), bytes += sizeof(As)), ...); }, args);
+        return args;
+    }
+
+    template <class T>
+    static void RedirectToPayload(T& arg, const unsigned char* payload, std::size_t size, std::vector<unsigned char>& scratch) {
+        if constexpr (std::is_pointer_v<T> && std::is_object_v<std::remove_pointer_t<T>>) {
+            if constexpr (std::is_const_v<std::remove_pointer_t<T>>) {
+                arg = (T)(const void*)payload;
+            } else {
+                // an output, the recorded contents are only there for Dump
+                scratch.assign(payload, payload + size);
+                arg = (T)(void*)scratch.data();
+            }
+        }
+    }
+
+    template <class T>
+    static void DumpArg(std::string& out, const T& arg, bool isPayload, std::size_t payloadSize) {
+        char buf[32];
+        if constexpr (std::is_pointer_v<T>) {
+            if (isPayload) std::snprintf(buf, sizeof(buf), "<%zu bytes>", payloadSize);
+            else if (!arg) std::snprintf(buf, sizeof(buf), "null");
+            else if constexpr (std::is_function_v<std::remove_pointer_t<T>>) std::snprintf(buf, sizeof(buf), "<function>");
+            else std::snprintf(buf, sizeof(buf), "%p", (const void*)arg);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            std::snprintf(buf, sizeof(buf), "%g", (double)arg);
+        } else if constexpr (std::is_signed_v<T>) {
+            std::snprintf(buf, sizeof(buf), "%lld", (long long)arg);
+        } else {
+            std::snprintf(buf, sizeof(buf), "%llu", (unsigned long long)arg);
+        }
+        out += buf;
+    }
+
+    template <auto MEMBER, FuncID ID> struct Recorded;
+
+    template <class R, class... As, R (*Dispatch::*MEMBER)(As...), FuncID ID>
+    struct Recorded<MEMBER, ID> {
+        static R Call(As... args) {
+            return RecordedCalls::Record<ID>(MEMBER, args...);
+        }
+
+        static void Replay(const CommandLog& log, const Command& cmd, const Dispatch& target, std::vector<unsigned char>& scratch) {
+            if constexpr (IsQuery(NameOf(ID))) return;
+            else {
+                std::tuple<As...> args = UnpackArgs<As...>(log.bytes.data() + cmd.argOffset);
+                const unsigned char* payload = log.bytes.data() + cmd.payloadOffset;
+                if constexpr (ID == FuncID::ShaderSource) {
+                    std::vector<const char*> strings;
+                    for (std::size_t i = 0; i < cmd.payloadSize; i += std::strlen((const char*)payload + i) + 1)
+                        strings.push_back((const char*)payload + i);
+                    std::get<1>(args) = (Isize)strings.size();
+                    std::get<2>(args) = strings.data();
+                    std::get<3>(args) = nullptr;
+                    std::apply(target.*MEMBER, args);
+                    return;
+                } else if (cmd.payloadArg != Command::NO_PAYLOAD) {
+                    [&]<std::size_t... I>(std::index_sequence<I...>) {
+                        ((I == cmd.payloadArg ? RedirectToPayload(std::get<I>(args), payload, cmd.payloadSize, scratch) : void()), ...);
+                    }(std::index_sequence_for<As...>{});
+                }
+                std::apply(target.*MEMBER, args);
+            }
+        }
+
+        static void Dump(const CommandLog& log, const Command& cmd, std::string& out) {
+            const std::tuple<As...> args = UnpackArgs<As...>(log.bytes.data() + cmd.argOffset);
+            out += NameOf(ID);
+            out += '(';
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                ((out += I ? ", " : "", DumpArg(out, std::get<I>(args), I == cmd.payloadArg, cmd.payloadSize)), ...);
+            }(std::index_sequence_for<As...>{});
+            out += ")\n";
+        }
+    };
+
+#define RECORDED_ENTRY(NAME, RET, ARGS) &Recorded<&Dispatch::NAME, FuncID::NAME>::Call,
+    static const Dispatch RECORDING_DISPATCH = { GLPORT_ON_FUNCTIONS(RECORDED_ENTRY) };
+#undef RECORDED_ENTRY
+
+    struct CommandOps {
+        void (*replay)(const CommandLog&, const Command&, const Dispatch&, std::vector<unsigned char>&);
+        void (*dump)(const CommandLog&, const Command&, std::string&);
+    };
+
+#define OPS_ENTRY(NAME, RET, ARGS) { &Recorded<&Dispatch::NAME, FuncID::NAME>::Replay, &Recorded<&Dispatch::NAME, FuncID::NAME>::Dump },
+    static const CommandOps OPS[] = { GLPORT_ON_FUNCTIONS(OPS_ENTRY) };
+#undef OPS_ENTRY
+
+    void CommandLog::Clear() {
+        commands.clear();
+        bytes.clear();
+    }
+
+    std::size_t CommandLog::Count(FuncID func) const {
+        std::size_t count = 0;
+        for (const Command& cmd : commands) count += cmd.func == func;
+        return count;
+    }
+
+    void CommandLog::Replay(const Dispatch& target) const {
+        std::vector<unsigned char> scratch;
+        for (const Command& cmd : commands) OPS[(unsigned)cmd.func].replay(*this, cmd, target, scratch);
+    }
+
+    std::string CommandLog::Dump() const {
+        std::string out;
+        for (const Command& cmd : commands) OPS[(unsigned)cmd.func].dump(*this, cmd, out);
+        return out;
+    }
+
+    Recorder::Recorder(const Dispatch& forward) : forward(&forward) {}
+
+    Recorder::~Recorder() { Stop(); }
+
+    void Recorder::Start() {
+        if (recording) return;
+        previous = CurrentDispatch();
+        active = this;
+        recording = true;
+        SetDispatch(&RECORDING_DISPATCH);
+    }
+
+    void Recorder::Stop() {
+        if (!recording) return;
+        SetDispatch(previous);
+        active = nullptr;
+        recording = false;
+    }
+}
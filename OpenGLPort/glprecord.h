@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "glp.h"
+
+namespace GL {
+    // one recorded call, its arguments are packed back to back in CommandLog::bytes
+    struct Command {
+        static constexpr unsigned char NO_PAYLOAD = 0xFF;
+
+        FuncID func;
+        unsigned char payloadArg = NO_PAYLOAD; // which pointer argument the payload was copied from
+        unsigned argOffset;
+        unsigned payloadOffset = 0, payloadSize = 0;
+    };
+
+    // every call in order. the data of uploads (buffers, textures, uniform arrays, shader sources) is copied,
+    // so the log stays replayable after that memory is gone. other pointers are kept as they were,
+    // which is right for offsets into bound buffers but not for client memory.
+    class CommandLog {
+    public:
+        std::vector<Command> commands;
+        std::vector<unsigned char> bytes;
+
+        void Clear();
+        std::size_t Count(FuncID func) const;
+
+        // calls everything again on another table. queries (Get*, Is*, ReadPixels, ...) are skipped,
+        // and names written by Gen* and Create* go to scratch memory instead of where they went when recorded.
+        // replaying onto a fresh NullContext gives out the same names as the one that was recorded.
+        void Replay(const Dispatch& target) const;
+        // one line per command, like BufferSubData(34962, 0, 64, <64 bytes>)
+        std::string Dump() const;
+    };
+
+    // captures every call into its log, then forwards it to another table
+    class Recorder {
+        const Dispatch* forward;
+        const Dispatch* previous = nullptr;
+        bool recording = false;
+
+        // what texture uploads depend on to know how much to copy
+        Int unpackAlignment = 4;
+        Uint pixelUnpackBuffer = 0;
+
+        friend struct RecordedCalls;
+    public:
+        CommandLog log;
+
+        explicit Recorder(const Dispatch& forward = DriverDispatch());
+        ~Recorder();
+
+        Recorder(const Recorder&) = delete;
+        Recorder& operator=(const Recorder&) = delete;
+
+        // sets the dispatch to record into this, only one recorder can run at a time
+        void Start();
+        // puts back whatever dispatch was set before Start
+        void Stop();
+        bool IsRecording() const { return recording; }
+    };
+}
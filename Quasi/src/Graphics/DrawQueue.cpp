@@ -0,0 +1,72 @@
+#include "DrawQueue.h"
+
+#include "GraphicsDevice.h"
+#include "RenderData.h"
+#include "Utils/Algorithm.h"
+#include "Utils/Debug/Profiler.h"
+
+namespace Quasi::Graphics {
+    static constexpr u64 TRANSLUCENT_BIT = 1ull << 55;
+
+    // the top 24 bits of the float mapped to an unsigned int with the same ordering
+    static u64 DepthBits(float depth) {
+        constexpr u32 SIGN = 0x8000'0000;
+        const u32 bits = __builtin_bit_cast(u32, depth);
+        return ((bits & SIGN) ? ~bits : bits | SIGN) >> 8;
+    }
+
+    u64 DrawQueue::SortKey(const DrawKey& key, GraphicsID shader) {
+        const u64 pass = (u64)key.pass << 56, shaderBits = shader & 0x7FFF, depth = DepthBits(key.depth);
+        if (!key.translucent)
+            return pass | shaderBits << 40 | (u64)key.material << 24 | depth;
+        return pass | TRANSLUCENT_BIT | (~depth & 0xFF'FFFF) << 31 | shaderBits << 16 | key.material;
+    }
+
+    void DrawQueue::Submit(RenderData& r, Shader& s, const DrawKey& key, const ShaderArgs& args, int instances, bool setDefaultShaderArgs) {
+        const u32 argsBegin = argBytes.Length();
+        argBytes.Extend(args.rawBytes.AsSpan());
+        draws.Push({ SortKey(key, s.rendererID), &r, &s, argsBegin, (u32)args.rawBytes.Length(), instances, setDefaultShaderArgs });
+    }
+
+    bool DrawQueue::CanMerge(const QueuedDraw& first, const QueuedDraw& next) const {
+        // only the depth is allowed to differ, and only because the sort already put them next to each other
+        constexpr u64 PASS_MASK = 0xFFull << 56 | TRANSLUCENT_BIT;
+        return first.shader->MergesInstances() &&
+               first.data == next.data && first.shader == next.shader &&
+               first.setDefaultShaderArgs == next.setDefaultShaderArgs &&
+               (first.key & PASS_MASK) == (next.key & PASS_MASK) &&
+               ArgsOf(first).Equals(ArgsOf(next));
+    }
+
+    void DrawQueue::Flush(GraphicsDevice& device) {
+        lastDrawCount = draws.Length();
+        lastMergedCount = 0;
+        if (draws.IsEmpty()) return;
+        QProfile$("DrawQueue::Flush");
+
+        order.Clear();
+        order.Reserve(draws.Length());
+        for (u32 i = 0; i < draws.Length(); ++i) order.Push({ draws[i].key, i });
+        // the radix sort is stable, so equal keys keep the order they were submitted in
+        order.SortRadixByKey([] (const SortEntry& e) { return e.key; });
+
+        for (usize i = 0; i < order.Length();) {
+            QueuedDraw& first = draws[order[i].index];
+            int instances = first.instances;
+            usize next = i + 1;
+            for (; next < order.Length() && CanMerge(first, draws[order[next].index]); ++next)
+                instances += draws[order[next].index].instances;
+            lastMergedCount += (u32)(next - i - 1);
+
+            device.DrawWithArgs(*first.data, *first.shader, ArgsOf(first),
+                next - i == 1 && instances == 1 ? 0 : instances, first.setDefaultShaderArgs);
+            i = next;
+        }
+        draws.Clear();
+        argBytes.Clear();
+    }
+
+    void DrawQueue::Forget(const RenderData& r) {
+        draws.Keep([&] (const QueuedDraw& d) { return d.data != &r; });
+    }
+}
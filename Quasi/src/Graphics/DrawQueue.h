@@ -0,0 +1,59 @@
+#pragma once
+
+#include "GLs/Shader.h"
+#include "Utils/Vec.h"
+
+namespace Quasi::Graphics {
+    class RenderData;
+    class GraphicsDevice;
+
+    // where a queued draw lands in the frame, see DrawQueue
+    struct DrawKey {
+        u8 pass = 0;
+        bool translucent = false;
+        u16 material = 0;
+        // distance from the camera. opaque draws go front to back, translucent ones back to front
+        float depth = 0;
+    };
+
+    // draws recorded over the frame and submitted together by Flush, ordered by a 64-bit key built from
+    // the DrawKey and the shader, so that switches follow what they cost the gpu instead of the order the game issues them in.
+    // nothing is read until Flush: a RenderData has to keep the same meshes until then, and so do arrays passed in ShaderArgs.
+    // consecutive draws of the same RenderData with the same arguments become a single instanced draw
+    // if their shader allows it, see Shader::SetMergesInstances.
+    class DrawQueue {
+        struct QueuedDraw {
+            u64 key;
+            RenderData* data;
+            Shader* shader;
+            u32 argsBegin, argsSize; // in argBytes
+            int instances;
+            bool setDefaultShaderArgs;
+        };
+        struct SortEntry { u64 key; u32 index; };
+
+        Vec<QueuedDraw> draws;
+        // the ShaderArgs of all queued draws one after another, so that queueing one doesnt allocate
+        Vec<byte> argBytes;
+        Vec<SortEntry> order;
+        u32 lastDrawCount = 0, lastMergedCount = 0;
+
+        Bytes ArgsOf(const QueuedDraw& draw) const { return argBytes.AsSpan().Subspan(draw.argsBegin, draw.argsSize); }
+        bool CanMerge(const QueuedDraw& first, const QueuedDraw& next) const;
+    public:
+        // [pass:8][0][shader:15][material:16][depth:24] for opaque draws,
+        // [pass:8][1][depth:24][shader:15][material:16] for translucent ones, since blending needs them in order
+        static u64 SortKey(const DrawKey& key, GraphicsID shader);
+
+        void Submit(RenderData& r, Shader& s, const DrawKey& key, const ShaderArgs& args, int instances, bool setDefaultShaderArgs);
+        void Flush(GraphicsDevice& device);
+        // drops the draws of a RenderData that is about to be deleted
+        void Forget(const RenderData& r);
+        void Clear() { draws.Clear(); argBytes.Clear(); }
+
+        bool IsEmpty() const { return draws.IsEmpty(); }
+        // from the last Flush
+        u32 LastDrawCount() const { return lastDrawCount; }
+        u32 LastMergedCount() const { return lastMergedCount; }
+    };
+}
@@ -3,6 +3,7 @@
 #include "glp.h"
 #include "GraphicsDevice.h"
 #include "RenderData.h"
+#include "GLs/GLState.h"
 #include "GLs/Render.h"
 
 namespace Quasi::Graphics {
@@ -113,7 +114,7 @@ namespace Quasi::Graphics {
     }
 
     void Bloom::RenderToLevel(int level) {
-        GL::Viewport(0, 0, screenDim.x >> level, screenDim.y >> level);
+        GLState::Viewport(0, 0, screenDim.x >> level, screenDim.y >> level);
         GL::DrawArrays(GL::TRIANGLES, 0, 3);
     }
 
@@ -128,7 +129,7 @@ namespace Quasi::Graphics {
 
     void Bloom::SetToRenderTarget() {
         read.BindDrawDest();
-        GL::Viewport(0, 0, screenDim.x, screenDim.y);
+        GLState::Viewport(0, 0, screenDim.x, screenDim.y);
     }
 
     void Bloom::ApplyEffect() {
@@ -163,7 +164,7 @@ namespace Quasi::Graphics {
 
         upsample.Activate(SLOT_UP);
         downsample.Activate(SLOT_DWN);
-        GL::BindVertexArray(GraphicsDevice::GetEmptyVAO().rendererID);
+        GraphicsDevice::GetEmptyVAO().Bind();
 
         write.Bind();
         DrawDown(1);
@@ -218,7 +219,7 @@ namespace Quasi::Graphics {
         DrawUp(0);
         read.Unbind();
         const Math::iv2 actualScreenDim = GraphicsDevice::GetDeviceInstance().GetWindowSize();
-        GL::Viewport(0, 0, actualScreenDim.x, actualScreenDim.y);
+        GLState::Viewport(0, 0, actualScreenDim.x, actualScreenDim.y);
         GL::DrawArrays(GL::TRIANGLES, 0, 3);
 #pragma endregion
 
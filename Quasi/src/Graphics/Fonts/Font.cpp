@@ -20,114 +20,194 @@ namespace Quasi::Graphics {
         int error = FT_Set_Pixel_Sizes(fHand, 0, fontSize);
         GLLogger().Assert(!error, "Font Char size set with err code {}", error);
 
-        f.RenderBitmap();
+        f.metrics = {
+            (int)(fHand->size->metrics.ascender - fHand->size->metrics.descender),
+            (int)fHand->size->metrics.ascender,
+            (int)fHand->size->metrics.descender
+        };
 
         return f;
     }
 
-    void Font::RenderBitmap() {
-        using namespace Math;
+    const Glyph& Font::GetGlyph(u32 codepoint) const {
+        Glyph& glyph = glyphs[FindOrAddGlyph(codepoint)];
+        if (glyph.page != Glyph::NO_PAGE) {
+            pages[glyph.page].lastUsed = ++useClock;
+            pages[glyph.page].usedFrame = FrameStamp;
+        }
+        return glyph;
+    }
 
-        constexpr int LOAD_SDF = FT_LOAD_RENDER | FT_LOAD_TARGET_(FT_RENDER_MODE_SDF); // used for sdf rendering
-        constexpr int SDF_EXTRUDE = 8;
+    u32 Font::FindOrAddGlyph(u32 codepoint) const {
+        u32 index;
+        if (codepoint < ASCII_GLYPHS && asciiLookup[codepoint]) {
+            index = asciiLookup[codepoint] - 1;
+        } else if (const OptRef<const usize> found = glyphLookup.Get(codepoint)) {
+            index = (u32)*found;
+        } else {
+            index = (u32)glyphs.Length();
+            glyphs.Push({});
+            if (codepoint < ASCII_GLYPHS) asciiLookup[codepoint] = index + 1;
+            else glyphLookup.InsertOrAssign(codepoint, index);
+        }
 
-        const FT_GlyphSlot glyphHandle = faceHandle->glyph;
+        if (!glyphs[index].resident && faceHandle) RasterizeGlyph(index, codepoint);
+        return index;
+    }
 
-        struct GlyphInfo { iv2 size; char c; };
-        GlyphInfo glyphInfo[NUM_GLYPHS];
-        for (char charCode = 32; charCode < 127; ++charCode) { // loop through each character
-            // new method: SDFs extrude 8 pixels in all directions, so you can load normally and then add 16
-            // (no need to load twice!)
-            if (const int error = FT_Load_Char(faceHandle.DataMut(), charCode, FT_LOAD_DEFAULT)) {
-                GLLogger().QError$("Loading char with err code {}", error);
-                continue;  /* ignore errors */
-            }
+    void Font::RasterizeGlyph(u32 index, u32 codepoint) const {
+        using namespace Math;
+
+        // sdfs already extrude a few pixels in all directions
+        constexpr int LOAD_SDF = FT_LOAD_RENDER | FT_LOAD_TARGET_(FT_RENDER_MODE_SDF);
+
+        // loading a glyph only changes the face's glyph slot
+        FT_Face face = const_cast<FT_Face>(faceHandle.Data());
+        if (const int error = FT_Load_Char(face, codepoint, LOAD_SDF)) {
+            GLLogger().QError$("Loading char with err code {}", error);
+            glyphs[index] = { .page = Glyph::NO_PAGE, .resident = true }; // dont retry every frame
+            return;
+        }
 
-            glyphInfo[charCode - 32] = {
-                {
-                    (int)glyphHandle->bitmap.width + SDF_EXTRUDE,
-                    (int)glyphHandle->bitmap.rows + SDF_EXTRUDE
-                }, charCode
-            };
+        const FT_GlyphSlot glyphHandle = face->glyph;
+        const iv2 size = { (int)glyphHandle->bitmap.width, (int)glyphHandle->bitmap.rows };
+        Glyph& glyph = glyphs[index];
+        glyph.advance = { (float)glyphHandle->advance.x / 64.0f, (float)glyphHandle->advance.y / 64.0f }; // pen move
+        glyph.offset  = { glyphHandle->bitmap_left, glyphHandle->bitmap_top }; // offset from pen
+        glyph.rect = fRect2D { 0, 0 };
+        glyph.page = Glyph::NO_PAGE;
+        glyph.resident = true;
+        if (size.x == 0 || size.y == 0) return; // whitespace
+
+        if (size.x > ATLAS_PAGE_SIZE || size.y > ATLAS_PAGE_SIZE) {
+            GLLogger().QError$("Glyph {} is too large for the font atlas", codepoint);
+            return;
         }
 
-        Span(glyphInfo).SortByKey([] (const GlyphInfo& info) { return info.size.y; });
+        u32 page;
+        const iv2 pos = AllocateInAtlas(size, page);
+        if (page == Glyph::NO_PAGE) {
+            // tried again once the pages have been drawn
+            glyph.resident = false;
+            atlasFull = true;
+            return;
+        }
 
-        // packing algorithm
-        int minWidth = 0;
-        usize area = 0;
-        for (const auto [size, _] : glyphInfo) {
-            minWidth = std::max(minWidth, size.x);
-            area += size.x * size.y;
+        AtlasPage& p = pages[page];
+        const int pitch = glyphHandle->bitmap.pitch;
+        for (int y = 0; y < size.y; ++y) {
+            Memory::MemCopy(p.pixels.Data() + (pos.y + y) * ATLAS_PAGE_SIZE + pos.x,
+                            glyphHandle->bitmap.buffer + y * pitch, size.x);
         }
-        const int width = std::max((int)std::sqrt(area), minWidth);
+        p.dirtyBegin = std::min(p.dirtyBegin, pos.y);
+        p.dirtyEnd   = std::max(p.dirtyEnd, pos.y + size.y);
+        p.glyphIndices.Push(index);
+        p.lastUsed = ++useClock;
+        p.usedFrame = FrameStamp;
+
+        glyph.page = page;
+        glyph.rect = fRect2D::FromSize((fv2)pos, (fv2)size) / (float)ATLAS_PAGE_SIZE;
+    }
 
+    Math::iv2 Font::AllocateInAtlas(const Math::iv2& size, u32& page) const {
         static constexpr int PADDING = 1;
-        glyphs.ResizeDefault(NUM_GLYPHS);
-        iv2 pen = 0;
-        // proceed to fit the next glyphs, making sure to not exceed the first row
-        for (usize i = 0; i < NUM_GLYPHS; ++i) {
-            const auto& g = glyphInfo[i];
-            if (pen.x + g.size.x > width) {
-                pen.x = 0;
-                // heights are sorted in order, so we can safely add the previous
-                pen.y += glyphInfo[i - 1].size.y + PADDING;
+        page = Glyph::NO_PAGE;
+        if (size.x > ATLAS_PAGE_SIZE || size.y > ATLAS_PAGE_SIZE) return -1;
+
+        // try the most recent page first, older pages are usually full anyways
+        if (!pages.IsEmpty()) {
+            AtlasPage& p = pages.Last();
+            if (p.pen.x + size.x > ATLAS_PAGE_SIZE) { // next shelf
+                p.pen.x = 0;
+                p.pen.y += p.shelfHeight + PADDING;
+                p.shelfHeight = 0;
+            }
+            if (p.pen.y + size.y <= ATLAS_PAGE_SIZE) {
+                const Math::iv2 pos = p.pen;
+                p.pen.x += size.x + PADDING;
+                p.shelfHeight = std::max(p.shelfHeight, size.y);
+                page = (u32)pages.Length() - 1;
+                return pos;
             }
-            // default value for now; will fix in later stages
-            glyphs[g.c - 32] = { fRect2D::FromSize((fv2)pen, (fv2)g.size), 0, 0 };
-            pen.x += g.size.x + PADDING;
         }
-        pen.y += glyphInfo[NUM_GLYPHS - 1].size.y;
-
-        Texture2D::SetPixelStore(PixelStoreParam::UNPACK_ALIGNMENT, 1);
-        atlas = Texture2D::New(nullptr, { width, pen.y },
-            { .format = TextureFormat::RED, .internalformat = TextureIFormat::R_8 }
-        ); // create blank texture
-        atlas.Clear(0);
-        atlas.Bind(); // set this texture to the active one
-        glyphs.Resize(NUM_GLYPHS); // amt of glyphs
-
-        metrics = {
-            (int)(faceHandle->size->metrics.ascender - faceHandle->size->metrics.descender),
-            (int)faceHandle->size->metrics.ascender,
-            (int)faceHandle->size->metrics.descender
-        };
 
-        const fv2 invTextureSize = 1.0f / (fv2)atlas.size;
-        for (char charCode = 32; charCode < 127; ++charCode) { // loop through again, this time drawing textures
-            if (const int error = FT_Load_Char(faceHandle.DataMut(), charCode, LOAD_SDF)) { // loads again
-                GLLogger().QError$("Loading char with err code {}", error);
-                continue;
-            }
+        if (pages.Length() < MAX_ATLAS_PAGES) {
+            AtlasPage& p = pages.Push({});
+            Texture2D::SetPixelStore(PixelStoreParam::UNPACK_ALIGNMENT, 1);
+            p.texture = Texture2D::New(nullptr, { ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE },
+                { .format = TextureFormat::RED, .internalformat = TextureIFormat::R_8 }
+            );
+            Texture2D::SetPixelStore(PixelStoreParam::UNPACK_ALIGNMENT, 4);
+            p.texture.Clear(0);
+            p.pixels.ResizeDefault(ATLAS_PAGE_SIZE * ATLAS_PAGE_SIZE);
+            p.generation = ++generationClock;
+            page = (u32)pages.Length() - 1;
+        } else {
+            page = EvictPage();
+            if (page == Glyph::NO_PAGE) return -1;
+            // make it the last page, so that it gets filled first
+            std::swap(pages[page], pages.Last());
+            for (const u32 i : pages[page].glyphIndices) glyphs[i].page = page;
+            page = (u32)pages.Length() - 1;
+        }
 
-            Glyph& glyph = glyphs[charCode - 32]; // write rendering memory
-            const iv2 size = { (int)glyphHandle->bitmap.width, (int)glyphHandle->bitmap.rows }; // construct size in pixels of the texture
-            atlas.SetSubTexture(glyphHandle->bitmap.buffer, iRect2D::FromSize((iv2)glyph.rect.min, size), { .format = TextureFormat::RED }); // draw the sub texture
+        AtlasPage& p = pages[page];
+        p.pen = { size.x + PADDING, 0 };
+        p.shelfHeight = size.y;
+        return 0;
+    }
 
-            glyph.rect = glyph.rect * invTextureSize; // resize
-            glyph.advance = { (float)glyphHandle->advance.x / 64.0f, (float)glyphHandle->advance.y / 64.0f }; // pen move
-            glyph.offset  = { glyphHandle->bitmap_left, glyphHandle->bitmap_top }; // offset from pen
+    u32 Font::EvictPage() const {
+        // quads that sample a page used this frame havent been drawn yet, and would show whatever replaces it
+        u32 lru = Glyph::NO_PAGE;
+        for (u32 i = 0; i < pages.Length(); ++i) {
+            if (pages[i].usedFrame == FrameStamp) continue;
+            if (lru == Glyph::NO_PAGE || pages[i].lastUsed < pages[lru].lastUsed) lru = i;
         }
-        Texture2D::SetPixelStore(PixelStoreParam::UNPACK_ALIGNMENT, 4);
+        if (lru == Glyph::NO_PAGE) return lru;
+
+        AtlasPage& p = pages[lru];
+        for (const u32 i : p.glyphIndices) glyphs[i].resident = false;
+        p.glyphIndices.Clear();
+        p.generation = ++generationClock;
+        Memory::MemSet(p.pixels.Data(), 0, p.pixels.Length());
+        p.pen = 0;
+        p.shelfHeight = 0;
+        p.dirtyBegin = 0;
+        p.dirtyEnd = ATLAS_PAGE_SIZE;
+        return lru;
     }
 
-    const Glyph& Font::GetGlyphRect(char c) const {
-        return glyphs[c - 32];
+    void Font::UploadGlyphs() const {
+        using namespace Math;
+        Texture2D::SetPixelStore(PixelStoreParam::UNPACK_ALIGNMENT, 1);
+        for (AtlasPage& p : pages) {
+            if (p.dirtyBegin >= p.dirtyEnd) continue;
+            // whole rows are contiguous in memory, so the dirty band can be sent in one go
+            p.texture.SetSubTexture(
+                p.pixels.Data() + p.dirtyBegin * ATLAS_PAGE_SIZE,
+                iRect2D { { 0, p.dirtyBegin }, { ATLAS_PAGE_SIZE, p.dirtyEnd } },
+                { .format = TextureFormat::RED }
+            );
+            p.dirtyBegin = ATLAS_PAGE_SIZE;
+            p.dirtyEnd = 0;
+        }
+        Texture2D::SetPixelStore(PixelStoreParam::UNPACK_ALIGNMENT, 4);
     }
 
     float Font::SpaceWidth() const {
-        return GetGlyphRect(' ').advance.x;
+        return GetGlyph(' ').advance.x;
     }
 
-    float Font::CalcCharWidth(char c) const {
-        if (Chr::IsWhitespace(c)) c = ' ';
-        return GetGlyphRect(c).advance.x;
+    float Font::CalcCharWidth(u32 codepoint) const {
+        if (codepoint < ASCII_GLYPHS && Chr::IsWhitespace((char)codepoint)) codepoint = ' ';
+        return GetGlyph(codepoint).advance.x;
     }
 
     float Font::CalcTextWidth(Str text) const {
         float width = 0;
-        for (const char c : text) {
-            width += CalcCharWidth(c);
+        for (usize i = 0; i < text.Length();) {
+            width += CalcCharWidth(text.Utf8DecodeAt(i));
         }
         return width;
     }
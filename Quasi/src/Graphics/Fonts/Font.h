@@ -3,6 +3,7 @@
 
 #include "FontDevice.h"
 #include "Mesh.h"
+#include "Utils/HashMap.h"
 #include "GLs/Texture.h"
 
 #define Q_USER_FONTS R"(C:\Users\User\AppData\Local\Microsoft\Windows\Fonts\)"
@@ -15,11 +16,15 @@ namespace Quasi::Graphics {
     using FaceHandle = Box<FT_FaceRec_, FontDeleter>;
 
     struct Glyph {
-        // internal coords
+        static constexpr u32 NO_PAGE = -1;
+
+        // internal coords, within its atlas page
         Math::fRect2D rect;
         // render data
         Math::fv2 advance;
         Math::iv2 offset;
+        u32 page = NO_PAGE; // NO_PAGE if there's nothing to draw
+        bool resident = false; // false if it was never rasterized or its page got evicted
     };
 
     class Font {
@@ -30,11 +35,36 @@ namespace Quasi::Graphics {
         struct FontMetrics {
             int fontHeight = 0, ascend = 0, descend = 0;
         };
+
+        static constexpr int ATLAS_PAGE_SIZE = 512;
+        static constexpr u32 MAX_ATLAS_PAGES = 4;
     private:
-        static constexpr u32 NUM_GLYPHS = 127 - 32;
-        Vec<Glyph> glyphs;
+        static constexpr u32 ASCII_GLYPHS = 128;
+
+        // glyphs are packed in shelves, and the pixels are kept on the cpu so that
+        // all the glyphs rasterized during a draw can be uploaded together
+        struct AtlasPage {
+            Texture2D texture;
+            Vec<byte> pixels;
+            Math::iv2 pen = 0;
+            int shelfHeight = 0;
+            int dirtyBegin = ATLAS_PAGE_SIZE, dirtyEnd = 0; // rows that havent been uploaded
+            u64 lastUsed = 0;
+            u64 usedFrame = 0; // the FrameStamp of the last time a glyph was taken from here
+            u64 generation = 0; // new whenever the page starts over with other glyphs, so uvs into the old ones can be told apart
+            Vec<u32> glyphIndices; // glyphs that have to be rasterized again if this page gets evicted
+        };
+
+        // glyphs are rasterized the first time they're used, which doesnt change how the font looks
+        mutable Vec<Glyph> glyphs;
+        mutable HashMap<u32, usize> glyphLookup; // codepoint -> index into glyphs
+        mutable u32 asciiLookup[ASCII_GLYPHS] = {}; // index + 1, or 0 if not added yet
+        mutable Vec<AtlasPage> pages;
+        mutable u64 useClock = 0;
+        mutable u64 generationClock = 0;
+        mutable bool atlasFull = false;
+        inline static u64 FrameStamp = 1;
         FontMetrics metrics;
-        Texture2D atlas;
 
         Font(FT_FaceRec_* fHand, int fontSize) : faceHandle(FaceHandle::Own(fHand)), fontSize(fontSize) {}
     public:
@@ -42,27 +72,42 @@ namespace Quasi::Graphics {
         static Font New(FT_FaceRec_* fHand, int fontSize);
 
         int FontSize() const { return fontSize; }
-        void RenderBitmap();
 
-        const Glyph& GetGlyphRect(char c) const;
+        // rasterizes the glyph if it isnt in the atlas yet
+        const Glyph& GetGlyph(u32 codepoint) const;
+        // sends every glyph rasterized since the last upload to the gpu, one call per page
+        void UploadGlyphs() const;
+        // whether a glyph was left out since the last call, because every page had glyphs that werent drawn yet.
+        // drawing those and starting a new frame frees the pages up again
+        bool TakeAtlasFull() const { const bool full = atlasFull; atlasFull = false; return full; }
+        // pages used before this can be evicted again, called whenever the canvas draws its batch
+        static void NextFrame() { ++FrameStamp; }
+        const Texture2D& GetPage(u32 page) const { return pages[page].texture; }
+        u32 PageCount() const { return (u32)pages.Length(); }
+        // differs from any earlier value once the page has been evicted, or another page was swapped into its place
+        u64 PageGeneration(u32 page) const { return pages[page].generation; }
+        // for quads that sample the page without going through GetGlyph, so it isnt evicted before they're drawn
+        void TouchPage(u32 page) const { pages[page].lastUsed = ++useClock; pages[page].usedFrame = FrameStamp; }
         // Mesh<VertexTexture2D> RenderText(
         //     Str string, int size,
         //     const TextAlign& align = { { 0, f32s::INFINITY } }
         // ) const;
 
         float SpaceWidth() const;
-        float CalcCharWidth(char c) const;
+        float CalcCharWidth(u32 codepoint) const;
         float CalcTextWidth(Str text) const;
-        
-        Texture2D& GetTexture() { return atlas; }
-        const Texture2D& GetTexture() const { return atlas; }
-        
+
         static Font LoadFile (CStr filename, int fontSize);
         static Font LoadBytes(Bytes bytes, int fontSize);
 
         const FontMetrics& GetMetric() const { return metrics; }
 
         friend struct TextRenderer;
+    private:
+        u32 FindOrAddGlyph(u32 codepoint) const;
+        void RasterizeGlyph(u32 index, u32 codepoint) const;
+        Math::iv2 AllocateInAtlas(const Math::iv2& size, u32& page) const;
+        u32 EvictPage() const;
     };
 
     enum TextStyle {
@@ -27,6 +27,8 @@ namespace Quasi::Graphics {
         float letterSpacing = 0; // this is extra offset
         float lineSpacing = 1; // this is a multiplier
 
+        bool operator==(const TextAlign&) const = default;
+
         float GetAdvance(const Glyph& glyph, float scaleRatio) const {
             return glyph.advance.x * scaleRatio + letterSpacing;
         }
@@ -0,0 +1,97 @@
+#include "TextLayoutCache.h"
+
+namespace Quasi::Graphics {
+    void TextLayout::Clear() {
+        glyphs.Clear();
+        lineStarts.Clear();
+        scale = 0;
+    }
+
+    Hashing::Hash TextLayoutKey::GetHashCode() const {
+        const float params[] = { fontSize, align.rect.x, align.rect.y, align.letterSpacing, align.lineSpacing };
+        Hashing::Hash h = text.GetHashCode();
+        h = Hashing::HashCombine(h, Hashing::HashInt((usize)font));
+        h = Hashing::HashCombine(h, Hashing::HashBytes(Spans::Vals(params).AsBytes()));
+        h = Hashing::HashCombine(h, Hashing::HashInt((usize)align.alignment << 1 | flipped));
+        return h;
+    }
+
+    bool TextLayoutCache::Matches(const Entry& entry, const TextLayoutKey& key) {
+        return entry.font == key.font && entry.fontSize == key.fontSize && entry.flipped == key.flipped &&
+               entry.align == key.align && entry.text == key.text;
+    }
+
+    OptRef<const TextLayout> TextLayoutCache::Find(const TextLayoutKey& key) {
+        const OptRef<const u32> i = lookup.Get((u64)key.GetHashCode());
+        if (!i || !Matches(entries[*i], key)) {
+            ++misses;
+            return nullptr;
+        }
+        ++hits;
+        Unlink(*i);
+        PushFront(*i);
+        return entries[*i].layout;
+    }
+
+    TextLayout& TextLayoutCache::Insert(const TextLayoutKey& key) {
+        if (capacity == 0) {
+            uncached.Clear();
+            return uncached;
+        }
+
+        const u64 hash = (u64)key.GetHashCode();
+        u32 i;
+        if (const OptRef<const u32> existing = lookup.Get(hash)) {
+            // a collision or a stale entry, either way it gets replaced
+            i = *existing;
+            Unlink(i);
+        } else if (entries.Length() < capacity) {
+            i = (u32)entries.Length();
+            entries.Push({});
+        } else {
+            // reuse the evicted entry, which keeps its text and glyph buffers around
+            i = tail;
+            Unlink(i);
+            lookup.Remove(entries[i].hash);
+        }
+
+        Entry& e = entries[i];
+        e.hash     = hash;
+        e.text.Clear();
+        e.text.AppendStr(key.text);
+        e.font     = key.font;
+        e.fontSize = key.fontSize;
+        e.align    = key.align;
+        e.flipped  = key.flipped;
+        e.layout.Clear();
+        lookup.InsertOrAssign(hash, i);
+        PushFront(i);
+        return e.layout;
+    }
+
+    void TextLayoutCache::SetCapacity(u32 newCapacity) {
+        capacity = newCapacity;
+        if (entries.Length() > capacity) Clear();
+    }
+
+    void TextLayoutCache::Clear() {
+        entries.Clear();
+        lookup.Clear();
+        head = tail = NONE;
+    }
+
+    void TextLayoutCache::Unlink(u32 i) {
+        Entry& e = entries[i];
+        (e.prev == NONE ? head : entries[e.prev].next) = e.next;
+        (e.next == NONE ? tail : entries[e.next].prev) = e.prev;
+        e.prev = e.next = NONE;
+    }
+
+    void TextLayoutCache::PushFront(u32 i) {
+        Entry& e = entries[i];
+        e.prev = NONE;
+        e.next = head;
+        (head == NONE ? tail : entries[head].prev) = i;
+        head = i;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "TextAlign.h"
+#include "Utils/HashMap.h"
+#include "Utils/String.h"
+
+namespace Quasi::Graphics {
+    class Font;
+
+    // text that has already been wrapped and aligned, so drawing it only has to emit the glyph quads
+    struct TextLayout {
+        struct PlacedGlyph {
+            u32 codepoint;
+            Math::fv2 offset; // pen position, relative to where the text is drawn
+        };
+        Vec<PlacedGlyph> glyphs;
+        Vec<u32> lineStarts; // index of the first glyph of each line
+        float scale = 0;     // the glyph scaling all of the offsets were computed with
+
+        void Clear();
+    };
+
+    // everything that affects the layout of a string
+    struct TextLayoutKey {
+        Str text;
+        const Font* font;
+        float fontSize;
+        TextAlign align;
+        bool flipped;
+
+        Hashing::Hash GetHashCode() const;
+    };
+
+    // least recently used cache of text layouts.
+    // entries are looked up by hash, then checked against the full key, so a collision only counts as a miss.
+    class TextLayoutCache {
+        static constexpr u32 NONE = -1;
+
+        struct Entry {
+            u64 hash;
+            String text;
+            const Font* font;
+            float fontSize;
+            TextAlign align;
+            bool flipped;
+
+            TextLayout layout;
+            u32 prev = NONE, next = NONE; // most recently used is at the head
+        };
+
+        Vec<Entry> entries;
+        HashMap<u64, u32> lookup;
+        u32 head = NONE, tail = NONE;
+        TextLayout uncached; // handed out by Insert when the capacity is 0
+        u32 capacity;
+        u64 hits = 0, misses = 0;
+    public:
+        explicit TextLayoutCache(u32 capacity = 1024) : capacity(capacity) {}
+
+        // returns nullptr if the text has to be laid out again
+        OptRef<const TextLayout> Find(const TextLayoutKey& key);
+        // returns an empty layout to be filled in, evicting the least recently used one if full.
+        // the reference is only valid until the next insert. with a capacity of 0 nothing is kept.
+        TextLayout& Insert(const TextLayoutKey& key);
+
+        void SetCapacity(u32 newCapacity);
+        u32 Capacity() const { return capacity; }
+        usize Count() const { return entries.Length(); }
+        void Clear();
+
+        u64 Hits()   const { return hits; }
+        u64 Misses() const { return misses; }
+        void ResetStats() { hits = misses = 0; }
+    private:
+        static bool Matches(const Entry& entry, const TextLayoutKey& key);
+        void Unlink(u32 i);
+        void PushFront(u32 i);
+    };
+}
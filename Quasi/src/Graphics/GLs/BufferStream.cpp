@@ -0,0 +1,117 @@
+#include "BufferStream.h"
+
+#include <glp.h>
+
+#include "GLDebug.h"
+
+namespace Quasi::Graphics {
+    static bool HasBufferStorage() {
+        static const bool supported = GL::Supports("GL_ARB_buffer_storage");
+        return supported;
+    }
+
+    static constexpr GL::Bitfield PERSISTENT_FLAGS = GL::MAP_WRITE_BIT | GL::MAP_PERSISTENT_BIT | GL::MAP_COHERENT_BIT;
+
+    void BufferStream::Release() {
+        for (void*& fence : fences) {
+            if (fence) QGLCall$(GL::DeleteSync((GL::Sync)fence));
+            fence = nullptr;
+        }
+        // deleting the buffer unmaps it
+        mapped = nullptr;
+        regionSize = 0;
+        region = 0;
+        batchBegin = 0;
+    }
+
+    BufferStream& BufferStream::operator=(BufferStream&& stream) noexcept {
+        Release();
+        mapped = stream.mapped;
+        for (u32 i = 0; i < REGION_COUNT; ++i) {
+            fences[i] = stream.fences[i];
+            stream.fences[i] = nullptr;
+        }
+        target = stream.target;
+        regionSize = stream.regionSize;
+        alignment = stream.alignment;
+        region = stream.region;
+        batchBegin = stream.batchBegin;
+        frame = stream.frame;
+        stream.mapped = nullptr;
+        stream.regionSize = 0;
+        stream.region = 0;
+        stream.batchBegin = 0;
+        return *this;
+    }
+
+    void BufferStream::Create(u32 bufferTarget, u32 size, u32 align) {
+        Release();
+        target = bufferTarget;
+        regionSize = size;
+        alignment = align;
+        frame = CurrentFrame;
+        if (HasBufferStorage()) {
+            QGLCall$(GL::BufferStorage(target, (GL::IsizePtr)size * REGION_COUNT, nullptr, PERSISTENT_FLAGS));
+            mapped = (byte*)QGLCall$(GL::MapBufferRange(target, 0, (GL::IsizePtr)size * REGION_COUNT, PERSISTENT_FLAGS));
+        } else {
+            QGLCall$(GL::BufferData(target, size, nullptr, GL::STREAM_DRAW));
+        }
+    }
+
+    void BufferStream::NextRegion() {
+        batchBegin = 0;
+        if (!mapped) {
+            // the driver hands out new storage and frees the old one once the gpu is done with it
+            QGLCall$(GL::BufferData(target, regionSize, nullptr, GL::STREAM_DRAW));
+            return;
+        }
+
+        // everything reading this region has been issued by now
+        if (fences[region]) QGLCall$(GL::DeleteSync((GL::Sync)fences[region]));
+        fences[region] = QGLCall$(GL::FenceSync(GL::SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+        region = (region + 1) % REGION_COUNT;
+        if (!fences[region]) return;
+
+        // only waits if the gpu is more than REGION_COUNT - 1 regions behind
+        GL::Bitfield flags = 0;
+        for (;;) {
+            const GL::Enum status = QGLCall$(GL::ClientWaitSync((GL::Sync)fences[region], flags, 1'000'000));
+            if (status == GL::ALREADY_SIGNALED || status == GL::CONDITION_SATISFIED || status == GL::WAIT_FAILED) break;
+            flags = GL::SYNC_FLUSH_COMMANDS_BIT;
+        }
+        QGLCall$(GL::DeleteSync((GL::Sync)fences[region]));
+        fences[region] = nullptr;
+    }
+
+    void BufferStream::BeginBatch(u32 usedBytes, u32 reserveBytes) {
+        if (frame != CurrentFrame) {
+            frame = CurrentFrame;
+            NextRegion();
+        } else {
+            batchBegin += usedBytes;
+            batchBegin += (alignment - batchBegin % alignment) % alignment;
+        }
+        // full for this frame. mapped storage is immutable and cant be orphaned, so it takes the next region early instead
+        if (batchBegin != 0 && batchBegin + reserveBytes > regionSize)
+            NextRegion();
+    }
+
+    void BufferStream::Write(u32 byteOffset, Span<const byte> data) {
+        if (batchBegin + byteOffset + data.ByteSize() > regionSize) {
+            // a batch that hasnt been written to yet can still move to the start of a fresh region
+            if (byteOffset == 0 && batchBegin != 0 && data.ByteSize() <= regionSize) {
+                NextRegion();
+            } else {
+                // it would run into the next region, which the gpu may still be reading
+                GLLogger().QError$("Writing {} bytes at {} overflows the stream region of {} bytes.", data.ByteSize(), batchBegin + byteOffset, regionSize);
+                return;
+            }
+        }
+        if (mapped) {
+            Memory::MemCopyNoOverlap(mapped + BatchOffset() + byteOffset, data.Data(), data.ByteSize());
+        } else {
+            QGLCall$(GL::BufferSubData(target, BatchOffset() + byteOffset, (GL::IsizePtr)data.ByteSize(), data.Data()));
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Utils/Span.h"
+
+namespace Quasi::Graphics {
+    // the storage of a streaming VertexBuffer or IndexBuffer, split into REGION_COUNT regions.
+    // every frame gets its own region, so the gpu can keep reading the ones of the frames before while this one is written.
+    // batches within a frame are placed one after another in the frame's region. once it is full,
+    // the next region is taken early, which only waits if the gpu is REGION_COUNT regions behind.
+    // with ARB_buffer_storage the whole buffer stays mapped and a region is only reused once its fence has passed,
+    // otherwise there is only one region, orphaned at the start of each frame and whenever it fills up.
+    // every call expects the buffer to be bound to target.
+    class BufferStream {
+    public:
+        static constexpr u32 REGION_COUNT = 3;
+    private:
+        byte* mapped = nullptr;
+        void* fences[REGION_COUNT] {};
+        u32 target = 0, regionSize = 0, alignment = 1, region = 0;
+        u32 batchBegin = 0; // where the current batch starts in the region
+        u64 frame = 0;
+
+        inline static u64 CurrentFrame = 0;
+
+        void Release();
+        // moves to a fresh region, or fresh storage when not mapped
+        void NextRegion();
+    public:
+        BufferStream() = default;
+        ~BufferStream() { Release(); }
+
+        BufferStream(const BufferStream&) = delete;
+        BufferStream& operator=(const BufferStream&) = delete;
+        BufferStream(BufferStream&& stream) noexcept { *this = std::move(stream); }
+        BufferStream& operator=(BufferStream&& stream) noexcept;
+
+        // called once a frame by GraphicsDevice::Begin, every stream moves on to its next region at its next batch
+        static void NextFrame() { ++CurrentFrame; }
+
+        // allocates the storage of the bound buffer. batches start on multiples of align
+        void Create(u32 bufferTarget, u32 size, u32 align);
+        // ends the batch that used usedBytes, and starts a new one with at least reserveBytes of room
+        void BeginBatch(u32 usedBytes, u32 reserveBytes = 0);
+
+        bool IsStreaming() const { return regionSize != 0; }
+        bool IsMapped() const { return mapped; }
+        u32 RegionSize() const { return regionSize; }
+        u32 RegionOffset() const { return region * regionSize; }
+        // where the current batch starts in the whole buffer
+        u32 BatchOffset() const { return RegionOffset() + batchBegin; }
+        // the rest of the region from the current batch on, empty when not mapped
+        Span<byte> MappedBatch() const {
+            return mapped ? Span<byte>::Slice(mapped + BatchOffset(), regionSize - batchBegin) : Span<byte> {};
+        }
+
+        // byteOffset is relative to the current batch. a batch that doesnt fit anymore as a whole moves to a new region
+        void Write(u32 byteOffset, Span<const byte> data);
+    };
+}
@@ -4,6 +4,7 @@
 
 #include "RenderBuffer.h"
 #include "GLDebug.h"
+#include "GLState.h"
 #include "Texture.h"
 
 namespace Quasi::Graphics {
@@ -16,15 +17,16 @@ namespace Quasi::Graphics {
     }
 
     void FrameBuffer::DestroyObject(GraphicsID id) {
+        GLState::ForgetFramebuffer(id);
         QGLCall$(GL::DeleteFramebuffers(1, &id));
     }
 
     void FrameBuffer::BindObject(GraphicsID id) {
-        QGLCall$(GL::BindFramebuffer(GL::FRAMEBUFFER, id));
+        GLState::BindFramebuffer(GL::FRAMEBUFFER, id);
     }
 
     void FrameBuffer::UnbindObject() {
-        QGLCall$(GL::BindFramebuffer(GL::FRAMEBUFFER, 0));
+        GLState::BindFramebuffer(GL::FRAMEBUFFER, 0);
     }
 
     void FrameBuffer::Attach(const TextureBase& tbase, int target, int mipmapLvl, AttachmentType type) const {
@@ -43,19 +45,19 @@ namespace Quasi::Graphics {
     }
 
     void FrameBuffer::BindReadSrc() const {
-        QGLCall$(GL::BindFramebuffer(GL::READ_FRAMEBUFFER, rendererID));
+        GLState::BindFramebuffer(GL::READ_FRAMEBUFFER, rendererID);
     }
 
     void FrameBuffer::BindDrawDest() const {
-        QGLCall$(GL::BindFramebuffer(GL::DRAW_FRAMEBUFFER, rendererID));
+        GLState::BindFramebuffer(GL::DRAW_FRAMEBUFFER, rendererID);
     }
 
     void FrameBuffer::UnbindDrawDest() {
-        QGLCall$(GL::BindFramebuffer(GL::DRAW_FRAMEBUFFER, 0));
+        GLState::BindFramebuffer(GL::DRAW_FRAMEBUFFER, 0);
     }
 
     void FrameBuffer::UnbindReadSrc() {
-        QGLCall$(GL::BindFramebuffer(GL::READ_FRAMEBUFFER, 0));
+        GLState::BindFramebuffer(GL::READ_FRAMEBUFFER, 0);
     }
 
     FrameBuffer FrameBuffer::Screen() {
@@ -4,7 +4,9 @@
 
 namespace Quasi::Graphics {
     Debug::Logger GLDebugContainer::Logger { Text::StringWriter::WriteToConsole() };
-    Debug::TimeDuration GLDebugContainer::GpuProcessDuration { 0 };
+    Str GLDebugContainer::LastCall;
+    Debug::SourceLoc GLDebugContainer::LastCallLoc;
+    bool GLDebugContainer::UseDebugOutput = false;
 
     Debug::Logger& GLLogger() {
         return GLDebugContainer::Logger;
@@ -19,6 +21,59 @@ namespace Quasi::Graphics {
         GLLogger().SetLocPad(0);
     }
 
+#if Q_GL_CHECKS
+    static Str DebugSourceName(GL::Enum source) {
+        switch (source) {
+            case GL::DEBUG_SOURCE_API:             return "API"_str;
+            case GL::DEBUG_SOURCE_WINDOW_SYSTEM:   return "Window System"_str;
+            case GL::DEBUG_SOURCE_SHADER_COMPILER: return "Shader Compiler"_str;
+            case GL::DEBUG_SOURCE_THIRD_PARTY:     return "Third Party"_str;
+            case GL::DEBUG_SOURCE_APPLICATION:     return "Application"_str;
+            default:                               return "Other"_str;
+        }
+    }
+
+    static void OnDebugMessage(GL::Enum source, GL::Enum type, GL::Uint id, GL::Enum severity, GL::Isize length, const char* message, const void*) {
+        const Str msg = length >= 0 ? Str::Slice(message, (usize)length) : Str { message };
+        const Str funcCall = GLDebugContainer::LastCall.SplitOnce("::")[2_nd];
+        const Debug::SourceLoc& loc = GLDebugContainer::LastCallLoc;
+
+        if (type == GL::DEBUG_TYPE_ERROR) {
+            GLLogger().QError$(
+                { "GL Error 0x{:X04} when calling gl{} (see https://docs.gl/gl4/gl{}): {}", loc },
+                id, funcCall, funcCall.SplitOnce('(')[1_st], msg);
+            return;
+        }
+
+        const Debug::Severity::E level = severity == GL::DEBUG_SEVERITY_HIGH   ? Debug::Severity::ERROR :
+                                         severity == GL::DEBUG_SEVERITY_MEDIUM ? Debug::Severity::WARN  :
+                                         severity == GL::DEBUG_SEVERITY_LOW    ? Debug::Severity::INFO  :
+                                                                                 Debug::Severity::DEBUG;
+        GLLogger().LogFmt(level, { "GL {} message 0x{:X04} after gl{}: {}", loc }, DebugSourceName(source), id, funcCall, msg);
+    }
+#endif
+
+    bool EnableGLDebugOutput() {
+#if Q_GL_CHECKS
+        GL::Int flags = 0;
+        GL::GetIntegerv(GL::CONTEXT_FLAGS, &flags);
+        if (!(flags & GL::CONTEXT_FLAG_DEBUG_BIT) || !GL::Supports("GL_KHR_debug")) {
+            GLLogger().QWarn$("No debug context with KHR_debug, gl errors will be checked after every call.");
+            return false;
+        }
+
+        GL::Enable(GL::DEBUG_OUTPUT);
+        // reported from inside the call that caused it, instead of whenever the driver gets to it
+        GL::Enable(GL::DEBUG_OUTPUT_SYNCHRONOUS);
+        GL::DebugMessageCallback(OnDebugMessage, nullptr);
+        GL::DebugMessageControl(GL::DONT_CARE, GL::DONT_CARE, GL::DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, false);
+        GLDebugContainer::UseDebugOutput = true;
+        return true;
+#else
+        return false;
+#endif
+    }
+
     Str GetErrName(GLErrorCode ec) {
         using enum GLErrorCode;
         switch (ec) {
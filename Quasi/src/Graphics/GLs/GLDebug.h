@@ -7,12 +7,18 @@ namespace Quasi::Graphics {
     // (couldnt get them to work so here's an alternative)
     struct GLDebugContainer {
         static Debug::Logger Logger;
-        static Debug::TimeDuration GpuProcessDuration;
+        // the last call made through QGLCall$, which is what the debug output callback reports errors against
+        static Str LastCall;
+        static Debug::SourceLoc LastCallLoc;
+        // set once KHR_debug reports errors by itself, from then on calls arent polled with glGetError
+        static bool UseDebugOutput;
     };
 
     Debug::Logger& GLLogger();
 
     void InitGLDebugTools();
+    // needs a current context. without a debug context or KHR_debug, errors keep being polled after every call
+    bool EnableGLDebugOutput();
 
     enum class GLErrorCode {
         // taken from https://www.khronos.org/opengl/wiki/OpenGL_Error#Catching_errors_(the_hard_way)
@@ -54,26 +60,30 @@ namespace Quasi::Graphics {
 
     template <class F>
     auto GLCall(F&& f, Str fsig, const Debug::SourceLoc& loc = Debug::SourceLoc::current()) -> decltype(f()) {
+        if (GLDebugContainer::UseDebugOutput) {
+            // the callback is synchronous, so it runs inside f and can tell where the error came from
+            GLDebugContainer::LastCall = fsig;
+            GLDebugContainer::LastCallLoc = loc;
+            return f();
+        }
+        // glGetError waits for the driver to catch up, so this only happens without debug output
         GLClearErr();
         if constexpr (SameAs<void, decltype(f())>) {
-            const auto begin = Debug::Timer::Now();
             f();
-            const Debug::DateTime end = Debug::Timer::Now();
-            GLDebugContainer::GpuProcessDuration += end - begin;
             GLReportFn(fsig, loc);
             return;
         } else {
-            const auto begin = Debug::Timer::Now();
             const auto res = f();
-            const Debug::DateTime end = Debug::Timer::Now();
-            GLDebugContainer::GpuProcessDuration += end - begin;
             GLReportFn(fsig, loc);
             return res;
         }
     }
-#ifdef NDEBUG
+// -DQUASI_GL_CHECKS=OFF defines Q_NO_GL_CHECKS, which leaves only the raw calls like a release build does
+#if defined(NDEBUG) || defined(Q_NO_GL_CHECKS)
+#define Q_GL_CHECKS 0
 #define QGLCall$(X) (X)
 #else
+#define Q_GL_CHECKS 1
 #define QGLCall$(X) GLCall([&]{ return X; }, #X)
 #endif
 }
@@ -0,0 +1,220 @@
+#include "GLState.h"
+
+#include <cstring>
+#include <glp.h>
+
+#include "GLDebug.h"
+
+namespace Quasi::Graphics::GLState {
+    static constexpr u32 UNKNOWN = ~0u;
+    static constexpr u32 MAX_TEXTURE_UNITS = 32;
+
+    enum BufferSlot { ARRAY_BUFFER, ELEMENT_BUFFER, UNIFORM_BUFFER, STORAGE_BUFFER, UNPACK_BUFFER, COPY_READ_BUFFER, COPY_WRITE_BUFFER, BUFFER_SLOTS };
+    enum TextureSlot { TEX_1D, TEX_2D, TEX_3D, TEX_CUBEMAP, TEX_1D_ARRAY, TEX_2D_ARRAY, TEX_RECT, TEX_2D_MULTISAMPLE, TEXTURE_SLOTS };
+    enum CapabilitySlot { CAP_BLEND, CAP_DEPTH, CAP_CULL, CAP_SCISSOR, CAP_STENCIL, CAP_MULTISAMPLE, CAPABILITY_SLOTS };
+
+    // UNKNOWN everywhere means nothing has been set through here yet
+    struct State {
+        u32 program, vao;
+        u32 buffers[BUFFER_SLOTS];
+        u32 activeTexture;
+        u32 textures[MAX_TEXTURE_UNITS][TEXTURE_SLOTS];
+        u32 readFramebuffer, drawFramebuffer;
+        u32 viewport[4];
+        u32 capabilities[CAPABILITY_SLOTS];
+        u32 blendFunc[4], blendEq[2];
+        u32 depthFunc, cullFace, frontFace, polygonMode;
+    };
+
+    static State UnknownState() {
+        State s;
+        std::memset(&s, 0xFF, sizeof(s));
+        return s;
+    }
+
+    static State state = UnknownState();
+    static Stats stats;
+
+    static int BufferSlotOf(u32 target) {
+        switch (target) {
+            case GL::ARRAY_BUFFER:          return ARRAY_BUFFER;
+            case GL::ELEMENT_ARRAY_BUFFER:  return ELEMENT_BUFFER;
+            case GL::UNIFORM_BUFFER:        return UNIFORM_BUFFER;
+            case GL::SHADER_STORAGE_BUFFER: return STORAGE_BUFFER;
+            case GL::PIXEL_UNPACK_BUFFER:   return UNPACK_BUFFER;
+            case GL::COPY_READ_BUFFER:      return COPY_READ_BUFFER;
+            case GL::COPY_WRITE_BUFFER:     return COPY_WRITE_BUFFER;
+            default:                        return -1;
+        }
+    }
+
+    static int TextureSlotOf(u32 target) {
+        switch (target) {
+            case GL::TEXTURE_1D:             return TEX_1D;
+            case GL::TEXTURE_2D:             return TEX_2D;
+            case GL::TEXTURE_3D:             return TEX_3D;
+            case GL::TEXTURE_CUBE_MAP:       return TEX_CUBEMAP;
+            case GL::TEXTURE_1D_ARRAY:       return TEX_1D_ARRAY;
+            case GL::TEXTURE_2D_ARRAY:       return TEX_2D_ARRAY;
+            case GL::TEXTURE_RECTANGLE:      return TEX_RECT;
+            case GL::TEXTURE_2D_MULTISAMPLE: return TEX_2D_MULTISAMPLE;
+            default:                         return -1;
+        }
+    }
+
+    static int CapabilitySlotOf(u32 cap) {
+        switch (cap) {
+            case GL::BLEND:        return CAP_BLEND;
+            case GL::DEPTH_TEST:   return CAP_DEPTH;
+            case GL::CULL_FACE:    return CAP_CULL;
+            case GL::SCISSOR_TEST: return CAP_SCISSOR;
+            case GL::STENCIL_TEST: return CAP_STENCIL;
+            case GL::MULTISAMPLE:  return CAP_MULTISAMPLE;
+            default:               return -1;
+        }
+    }
+
+    // counts the call, and whether it still has to be made
+    static bool Count(bool redundant) {
+        ++(redundant ? stats.elided : stats.issued);
+        return !redundant;
+    }
+
+    // whether shadow has to become value, which it does from here on
+    static bool Changes(u32& shadow, u32 value) {
+        if (!Count(shadow == value)) return false;
+        shadow = value;
+        return true;
+    }
+
+    template <usize N>
+    static bool Changes(u32 (&shadow)[N], const u32 (&values)[N]) {
+        if (!Count(std::memcmp(shadow, values, sizeof(shadow)) == 0)) return false;
+        std::memcpy(shadow, values, sizeof(shadow));
+        return true;
+    }
+
+    static void Untracked() { ++stats.issued; }
+
+    Stats GetStats() { return stats; }
+    void ResetStats() { stats = {}; }
+    void Invalidate() { state = UnknownState(); }
+
+    void UseProgram(GraphicsID program) {
+        if (Changes(state.program, program)) QGLCall$(GL::UseProgram(program));
+    }
+
+    void BindVertexArray(GraphicsID vao) {
+        if (!Changes(state.vao, vao)) return;
+        QGLCall$(GL::BindVertexArray(vao));
+        // the element buffer binding belongs to the vao
+        state.buffers[ELEMENT_BUFFER] = UNKNOWN;
+    }
+
+    void BindBuffer(u32 target, GraphicsID buffer) {
+        const int slot = BufferSlotOf(target);
+        if (slot < 0) Untracked();
+        else if (!Changes(state.buffers[slot], buffer)) return;
+        QGLCall$(GL::BindBuffer(target, buffer));
+    }
+
+    void BindBufferBase(u32 target, u32 index, GraphicsID buffer) {
+        Untracked();
+        QGLCall$(GL::BindBufferBase(target, index, buffer));
+        const int slot = BufferSlotOf(target);
+        if (slot >= 0) state.buffers[slot] = buffer;
+    }
+
+    void ActiveTexture(u32 slot) {
+        if (Changes(state.activeTexture, slot)) QGLCall$(GL::ActiveTexture(GL::TEXTURE0 + slot));
+    }
+
+    void BindTexture(u32 target, GraphicsID texture) {
+        const int slot = TextureSlotOf(target);
+        if (slot < 0 || state.activeTexture >= MAX_TEXTURE_UNITS) Untracked();
+        else if (!Changes(state.textures[state.activeTexture][slot], texture)) return;
+        QGLCall$(GL::BindTexture(target, texture));
+    }
+
+    void BindFramebuffer(u32 target, GraphicsID framebuffer) {
+        switch (target) {
+            case GL::READ_FRAMEBUFFER:
+                if (!Changes(state.readFramebuffer, framebuffer)) return;
+                break;
+            case GL::DRAW_FRAMEBUFFER:
+                if (!Changes(state.drawFramebuffer, framebuffer)) return;
+                break;
+            default:
+                if (!Count(state.readFramebuffer == framebuffer && state.drawFramebuffer == framebuffer)) return;
+                state.readFramebuffer = state.drawFramebuffer = framebuffer;
+        }
+        QGLCall$(GL::BindFramebuffer(target, framebuffer));
+    }
+
+    void Viewport(int x, int y, int width, int height) {
+        if (Changes(state.viewport, { (u32)x, (u32)y, (u32)width, (u32)height }))
+            QGLCall$(GL::Viewport(x, y, width, height));
+    }
+
+    void SetCapability(u32 cap, bool enabled) {
+        const int slot = CapabilitySlotOf(cap);
+        if (slot < 0) Untracked();
+        else if (!Changes(state.capabilities[slot], enabled)) return;
+        if (enabled) QGLCall$(GL::Enable(cap));
+        else         QGLCall$(GL::Disable(cap));
+    }
+
+    void BlendFunc(u32 src, u32 dest, u32 srcAlpha, u32 destAlpha) {
+        if (Changes(state.blendFunc, { src, dest, srcAlpha, destAlpha }))
+            QGLCall$(GL::BlendFuncSeparate(src, dest, srcAlpha, destAlpha));
+    }
+
+    void BlendEquation(u32 eq, u32 eqAlpha) {
+        if (Changes(state.blendEq, { eq, eqAlpha })) QGLCall$(GL::BlendEquationSeparate(eq, eqAlpha));
+    }
+
+    void DepthFunc(u32 func) {
+        if (Changes(state.depthFunc, func)) QGLCall$(GL::DepthFunc(func));
+    }
+
+    void CullFace(u32 face) {
+        if (Changes(state.cullFace, face)) QGLCall$(GL::CullFace(face));
+    }
+
+    void FrontFace(u32 orientation) {
+        if (Changes(state.frontFace, orientation)) QGLCall$(GL::FrontFace(orientation));
+    }
+
+    void PolygonMode(u32 mode) {
+        if (Changes(state.polygonMode, mode)) QGLCall$(GL::PolygonMode(GL::FRONT_AND_BACK, mode));
+    }
+
+    static void Forget(u32& shadow, GraphicsID id, u32 replacement) {
+        if (shadow == id) shadow = replacement;
+    }
+
+    void ForgetProgram(GraphicsID program) {
+        // a deleted program stays in use until another one is
+        Forget(state.program, program, UNKNOWN);
+    }
+
+    void ForgetVertexArray(GraphicsID vao) {
+        if (state.vao != vao) return;
+        state.vao = 0;
+        state.buffers[ELEMENT_BUFFER] = UNKNOWN;
+    }
+
+    void ForgetBuffer(GraphicsID buffer) {
+        for (u32& bound : state.buffers) Forget(bound, buffer, 0);
+    }
+
+    void ForgetTexture(GraphicsID texture) {
+        for (auto& unit : state.textures)
+            for (u32& bound : unit) Forget(bound, texture, 0);
+    }
+
+    void ForgetFramebuffer(GraphicsID framebuffer) {
+        Forget(state.readFramebuffer, framebuffer, 0);
+        Forget(state.drawFramebuffer, framebuffer, 0);
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "GLObject.h"
+
+namespace Quasi::Graphics::GLState {
+    // keeps a copy of the gl state that gets set over and over (bindings, viewport, blend/depth/cull),
+    // so that setting it to what it already is never reaches the driver.
+    // it only knows about changes made through it, so anything that touches gl state behind its back
+    // (raw GL:: calls, imgui, another context) has to be followed by Invalidate.
+    struct Stats {
+        u32 issued = 0, elided = 0;
+    };
+
+    Stats GetStats();
+    void ResetStats();
+    // forgets everything, the next call of each kind always goes through
+    void Invalidate();
+
+    void UseProgram(GraphicsID program);
+    void BindVertexArray(GraphicsID vao);
+    void BindBuffer(u32 target, GraphicsID buffer);
+    // also binds the generic target, like gl does
+    void BindBufferBase(u32 target, u32 index, GraphicsID buffer);
+    void ActiveTexture(u32 slot);
+    void BindTexture(u32 target, GraphicsID texture);
+    void BindFramebuffer(u32 target, GraphicsID framebuffer);
+
+    void Viewport(int x, int y, int width, int height);
+    void SetCapability(u32 cap, bool enabled);
+    void BlendFunc(u32 src, u32 dest, u32 srcAlpha, u32 destAlpha);
+    void BlendEquation(u32 eq, u32 eqAlpha);
+    void DepthFunc(u32 func);
+    void CullFace(u32 face);
+    void FrontFace(u32 orientation);
+    void PolygonMode(u32 mode);
+
+    // call before deleting, gl unbinds deleted objects from the current context
+    void ForgetProgram(GraphicsID program);
+    void ForgetVertexArray(GraphicsID vao);
+    void ForgetBuffer(GraphicsID buffer);
+    void ForgetTexture(GraphicsID texture);
+    void ForgetFramebuffer(GraphicsID framebuffer);
+}
@@ -0,0 +1,85 @@
+#include "GpuTimer.h"
+
+#include <glp.h>
+
+#include "GLDebug.h"
+
+namespace Quasi::Graphics {
+    GpuTimer& GpuTimer::operator=(GpuTimer&& timer) noexcept {
+        Destroy();
+        for (u32 i = 0; i < FRAME_LATENCY; ++i) frames[i] = std::move(timer.frames[i]);
+        passes = std::move(timer.passes);
+        frameTime = timer.frameTime;
+        frameIndex = timer.frameIndex;
+        droppedFrames = timer.droppedFrames;
+        inPass = timer.inPass;
+        timer.inPass = false;
+        return *this;
+    }
+
+    void GpuTimer::ReadBack(FrameQueries& frame) {
+        if (frame.passes.IsEmpty()) return;
+
+        // queries finish in order, so the last one being ready means they all are
+        GL::Int available = 0;
+        QGLCall$(GL::GetQueryObjectiv(frame.pool[frame.passes.Length() - 1], GL::QUERY_RESULT_AVAILABLE, &available));
+        if (!available) {
+            ++droppedFrames;
+            frame.passes.Clear();
+            return;
+        }
+
+        for (Pass& pass : passes) pass.time = {};
+        frameTime = {};
+        for (u32 i = 0; i < frame.passes.Length(); ++i) {
+            GL::Uint64 nanos = 0;
+            QGLCall$(GL::GetQueryObjectui64v(frame.pool[i], GL::QUERY_RESULT, &nanos));
+            passes[frame.passes[i]].time += Debug::TimeDuration { nanos };
+            frameTime += Debug::TimeDuration { nanos };
+        }
+        frame.passes.Clear();
+    }
+
+    void GpuTimer::BeginFrame() {
+        ReadBack(frames[frameIndex % FRAME_LATENCY]);
+    }
+
+    void GpuTimer::EndFrame() {
+        EndPass();
+        ++frameIndex;
+    }
+
+    void GpuTimer::BeginPass(Str name) {
+        EndPass();
+
+        u32 passIndex = 0;
+        while (passIndex < passes.Length() && passes[passIndex].name != name) ++passIndex;
+        if (passIndex == passes.Length()) passes.Push({ String { name } });
+
+        FrameQueries& frame = frames[frameIndex % FRAME_LATENCY];
+        if (frame.passes.Length() == frame.pool.Length()) {
+            GraphicsID query;
+            QGLCall$(GL::GenQueries(1, &query));
+            frame.pool.Push(query);
+        }
+        QGLCall$(GL::BeginQuery(GL::TIME_ELAPSED, frame.pool[frame.passes.Length()]));
+        frame.passes.Push(passIndex);
+        inPass = true;
+    }
+
+    void GpuTimer::EndPass() {
+        if (!inPass) return;
+        QGLCall$(GL::EndQuery(GL::TIME_ELAPSED));
+        inPass = false;
+    }
+
+    void GpuTimer::Destroy() {
+        for (FrameQueries& frame : frames) {
+            if (!frame.pool.IsEmpty())
+                QGLCall$(GL::DeleteQueries((int)frame.pool.Length(), frame.pool.Data()));
+            frame.pool.Clear();
+            frame.passes.Clear();
+        }
+        inPass = false;
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "GLObject.h"
+#include "Utils/Debug/Timer.h"
+#include "Utils/String.h"
+#include "Utils/Vec.h"
+
+namespace Quasi::Graphics {
+    // times parts of a frame on the gpu with GL_TIME_ELAPSED queries.
+    // a frame's results are read FRAME_LATENCY frames later, by which point the gpu is done with them,
+    // so reading them back never waits. time elapsed queries cant nest, so a pass lasts until the next one begins.
+    class GpuTimer {
+    public:
+        static constexpr u32 FRAME_LATENCY = 3;
+
+        struct Pass {
+            String name;
+            Debug::TimeDuration time {}; // from the last frame that was read back
+        };
+    private:
+        struct FrameQueries {
+            Vec<GraphicsID> pool; // grows to the most passes any frame has had
+            Vec<u32> passes;      // which pass each query in use is timing
+        };
+
+        FrameQueries frames[FRAME_LATENCY];
+        Vec<Pass> passes;
+        Debug::TimeDuration frameTime {};
+        u32 frameIndex = 0, droppedFrames = 0;
+        bool inPass = false;
+
+        void ReadBack(FrameQueries& frame);
+    public:
+        GpuTimer() = default;
+        ~GpuTimer() { Destroy(); }
+
+        GpuTimer(const GpuTimer&) = delete;
+        GpuTimer& operator=(const GpuTimer&) = delete;
+        GpuTimer(GpuTimer&& timer) noexcept { *this = std::move(timer); }
+        GpuTimer& operator=(GpuTimer&& timer) noexcept;
+
+        // reads back the frame from FRAME_LATENCY frames ago
+        void BeginFrame();
+        void EndFrame();
+        // ends the pass before it, if there is one
+        void BeginPass(Str name);
+        void EndPass();
+
+        // sum of all passes, FRAME_LATENCY frames behind
+        Debug::TimeDuration FrameTime() const { return frameTime; }
+        Span<const Pass> Passes() const { return passes.AsSpan(); }
+        // frames whose results werent ready in time and were thrown away
+        u32 DroppedFrames() const { return droppedFrames; }
+
+        void Destroy();
+    };
+}
@@ -5,6 +5,7 @@
 #include <glp.h>
 
 #include "GLDebug.h"
+#include "GLState.h"
 
 namespace Quasi::Graphics {
     IndexBuffer::IndexBuffer(GraphicsID id, u32 size) : GLObject(id), bufferSize(size) {}
@@ -17,30 +18,51 @@ namespace Quasi::Graphics {
         return IndexBuffer { id, size };
     }
 
+    IndexBuffer IndexBuffer::NewStreaming(u32 size) {
+        GraphicsID id;
+        QGLCall$(GL::GenBuffers(1, &id));
+        BindObject(id);
+        IndexBuffer ibo { id, size };
+        ibo.stream.Create(GL::ELEMENT_ARRAY_BUFFER, size * sizeof(u32), sizeof(u32));
+        return ibo;
+    }
+
     void IndexBuffer::DestroyObject(GraphicsID id) {
+        GLState::ForgetBuffer(id);
         QGLCall$(GL::DeleteBuffers(1, &id));
     }
 
     void IndexBuffer::BindObject(GraphicsID id) {
-        QGLCall$(GL::BindBuffer(GL::ELEMENT_ARRAY_BUFFER, id));
+        GLState::BindBuffer(GL::ELEMENT_ARRAY_BUFFER, id);
     }
 
     void IndexBuffer::UnbindObject() {
-        QGLCall$(GL::BindBuffer(GL::ELEMENT_ARRAY_BUFFER, 0));
+        GLState::BindBuffer(GL::ELEMENT_ARRAY_BUFFER, 0);
     }
 
-    void IndexBuffer::SetData(Span<const u32> data, u32 dOffset) {
+    void IndexBuffer::SetData(Span<const u32> data, u32 offset) {
         Bind();
-        QGLCall$(GL::BufferSubData(GL::ELEMENT_ARRAY_BUFFER, dOffset, data.ByteSize(), data.Data()));
+        const u32 byteOffset = offset * sizeof(u32);
+        if (IsStreaming())
+            stream.Write(byteOffset, data.AsBytes());
+        else
+            QGLCall$(GL::BufferSubData(GL::ELEMENT_ARRAY_BUFFER, byteOffset, data.ByteSize(), data.Data()));
     }
 
-    void IndexBuffer::ClearData() {
+    void IndexBuffer::ClearData(u32 reserveCount) {
+        if (IsStreaming()) {
+            Bind();
+            stream.BeginBatch(dataOffset * sizeof(u32), reserveCount * sizeof(u32));
+        }
         dataOffset = 0;
     }
 
     void IndexBuffer::AddData(Span<const u32> data) {
         Bind();
-        QGLCall$(GL::BufferSubData(GL::ELEMENT_ARRAY_BUFFER, dataOffset * sizeof(u32), data.ByteSize(), data.Data()));
+        if (IsStreaming())
+            stream.Write(dataOffset * sizeof(u32), data.AsBytes());
+        else
+            QGLCall$(GL::BufferSubData(GL::ELEMENT_ARRAY_BUFFER, dataOffset * sizeof(u32), data.ByteSize(), data.Data()));
         dataOffset += (u32)data.Length();
     }
 }
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "GLObject.h"
+#include "BufferStream.h"
 #include "../Triplet.h"
 #include "Utils/Span.h"
 
@@ -9,25 +10,36 @@ namespace Quasi::Graphics {
     private:
         u32 bufferSize = 0;
         u32 dataOffset = 0;
+        BufferStream stream;
 
         explicit IndexBuffer(GraphicsID id, u32 size);
     public:
         IndexBuffer() = default;
         static IndexBuffer New(u32 size);
+        // for indices that are rewritten every frame, see BufferStream. size is the index count of one region
+        static IndexBuffer NewStreaming(u32 size);
         static void DestroyObject(GraphicsID id);
         static void BindObject(GraphicsID id);
         static void UnbindObject();
 
-        void SetData(Span<const u32> data, u32 dOffset = 0);
-        void SetData(Span<const Triplet> data, u32 dOffset = 0) { SetData(data.Transmute<u32>(), dOffset); }
+        // offset is in indices, like VertexBuffer::SetData takes it in vertices
+        void SetData(Span<const u32> data, u32 offset = 0);
+        void SetData(Span<const Triplet> data, u32 offset = 0) { SetData(data.Transmute<u32>(), offset); }
 
-        void ClearData(); // this doesnt actually clear the dataz, just makes it not
+        void ClearData(u32 reserveCount = 0); // this doesnt actually clear the dataz, just makes it not. streaming buffers start a new batch, see VertexBuffer::ClearData
 
         void AddData(Span<const u32> data);
         void AddData(Span<const Triplet> data) { AddData(data.Transmute<u32>()); }
 
         u32 GetLength() const { return bufferSize; }
         u32 GetUsedLength() const { return dataOffset; }
+        bool IsStreaming() const { return stream.IsStreaming(); }
+        // where the current batch starts, in indices
+        u32 GetFirstIndex() const { return stream.BatchOffset() / sizeof(u32); }
+
+        // see VertexBuffer::MappedBatch
+        Span<u32> MappedBatch() const { return stream.MappedBatch().Transmute<u32>(); }
+        void SetUsedLength(u32 count) { dataOffset = count; }
 
         friend class GraphicsDevice;
     };
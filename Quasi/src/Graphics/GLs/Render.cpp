@@ -1,6 +1,7 @@
 ﻿#include "Render.h"
 #include <glp.h>
 #include "GLDebug.h"
+#include "GLState.h"
 #include "GraphicsDevice.h"
 #include "VertexArray.h"
 #include "../RenderData.h"
@@ -10,18 +11,32 @@ namespace Quasi::Graphics::Render {
         vertexArr.Bind();
         indexBuff.Bind();
         shader.Bind();
-        QGLCall$(GL::DrawElements(GL::TRIANGLES, (int)indexBuff.GetUsedLength(), GL::UNSIGNED_INT, nullptr));
+        QGLCall$(GL::DrawElements(GL::TRIANGLES, (int)indexBuff.GetUsedLength(), GL::UNSIGNED_INT, (void*)(indexBuff.GetFirstIndex() * sizeof(u32))));
     }
 
     void DrawInstanced(const VertexArray& vertexArr, const IndexBuffer& indexBuff, const ShaderProgram& shader, int instances) {
         vertexArr.Bind();
         indexBuff.Bind();
         shader.Bind();
-        QGLCall$(GL::DrawElementsInstanced(GL::TRIANGLES, (int)indexBuff.GetUsedLength(), GL::UNSIGNED_INT, nullptr, instances));
+        QGLCall$(GL::DrawElementsInstanced(GL::TRIANGLES, (int)indexBuff.GetUsedLength(), GL::UNSIGNED_INT, (void*)(indexBuff.GetFirstIndex() * sizeof(u32)), instances));
+    }
+
+    void DrawRange(const VertexArray& vertexArr, const IndexBuffer& indexBuff, const ShaderProgram& shader, u32 firstIndex, u32 indexCount, u32 baseVertex) {
+        vertexArr.Bind();
+        indexBuff.Bind();
+        shader.Bind();
+        QGLCall$(GL::DrawElementsBaseVertex(GL::TRIANGLES, (int)indexCount, GL::UNSIGNED_INT, (void*)(firstIndex * sizeof(u32)), (int)baseVertex));
+    }
+
+    void DrawRangeInstanced(const VertexArray& vertexArr, const IndexBuffer& indexBuff, const ShaderProgram& shader, u32 firstIndex, u32 indexCount, u32 baseVertex, int instances) {
+        vertexArr.Bind();
+        indexBuff.Bind();
+        shader.Bind();
+        QGLCall$(GL::DrawElementsInstancedBaseVertex(GL::TRIANGLES, (int)indexCount, GL::UNSIGNED_INT, (void*)(firstIndex * sizeof(u32)), instances, (int)baseVertex));
     }
 
     void Draw(const RenderData& dat, const ShaderProgram& s) {
-        Draw(dat.varray, dat.ibo, s);
+        DrawRange(dat.varray, dat.ibo, s, dat.ibo.GetFirstIndex(), dat.ibo.GetUsedLength(), dat.vbo.GetBaseVertex());
     }
 
     void Draw(const RenderData& dat) {
@@ -29,7 +44,7 @@ namespace Quasi::Graphics::Render {
     }
 
     void DrawInstanced(const RenderData& dat, const ShaderProgram& s, int instances) {
-        DrawInstanced(dat.varray, dat.ibo, s, instances);
+        DrawRangeInstanced(dat.varray, dat.ibo, s, dat.ibo.GetFirstIndex(), dat.ibo.GetUsedLength(), dat.vbo.GetBaseVertex(), instances);
     }
 
     void DrawInstanced(const RenderData& dat, int instances) {
@@ -48,7 +63,7 @@ namespace Quasi::Graphics::Render {
     }
 
     void SetRenderMode(const RenderMode mode) {
-        QGLCall$(GL::PolygonMode(GL::FRONT_AND_BACK, (uint)mode));
+        GLState::PolygonMode((u32)mode);
     }
 
     void SetPointSize(float size) {
@@ -60,15 +75,15 @@ namespace Quasi::Graphics::Render {
     }
 
     void Enable(const Capability cap) {
-        QGLCall$(GL::Enable((int)cap));
+        GLState::SetCapability((u32)cap, true);
     }
 
     void Disable(const Capability cap) {
-        QGLCall$(GL::Disable((int)cap));
+        GLState::SetCapability((u32)cap, false);
     }
 
     void UseDepthFunc(const CmpOperation op) {
-        QGLCall$(GL::DepthFunc((int)op));
+        GLState::DepthFunc((u32)op);
     }
 
     void UseStencilTest(const CmpOperation op, const int ref, const int mask) {
@@ -92,26 +107,26 @@ namespace Quasi::Graphics::Render {
     }
 
     void UseBlendFunc(const BlendFactor src, const BlendFactor dest) {
-        QGLCall$(GL::BlendFunc((int)src, (int)dest));
+        GLState::BlendFunc((u32)src, (u32)dest, (u32)src, (u32)dest);
     }
 
     void UseBlendFuncSeparate(BlendFactor src, BlendFactor dest, BlendFactor srcAlpha, BlendFactor destAlpha) {
-        QGLCall$(GL::BlendFuncSeparate((int)src, (int)dest, (int)srcAlpha, (int)destAlpha));
+        GLState::BlendFunc((u32)src, (u32)dest, (u32)srcAlpha, (u32)destAlpha);
     }
 
     void UseBlendEq(BlendOp eq) {
-        QGLCall$(GL::BlendEquation((int)eq));
+        GLState::BlendEquation((u32)eq, (u32)eq);
     }
 
     void UseBlendEqSeparate(BlendOp eq, BlendOp eqAlpha) {
-        QGLCall$(GL::BlendEquationSeparate((int)eq, (int)eqAlpha));
+        GLState::BlendEquation((u32)eq, (u32)eqAlpha);
     }
     void SetCullFace(FacingMode facing) {
-        QGLCall$(GL::CullFace((int)facing));
+        GLState::CullFace((u32)facing);
     }
 
     void SetFrontFacing(OrientationMode   orientation) {
-        QGLCall$(GL::FrontFace((int)orientation));
+        GLState::FrontFace((u32)orientation);
     }
 
     void SetColorWrite(BufferMode mode) {
@@ -119,7 +134,7 @@ namespace Quasi::Graphics::Render {
     }
 
     void SetViewport(const Math::iRect2D& viewport) {
-        GL::Viewport(viewport.min.x, viewport.min.y, viewport.Size().x, viewport.Size().y);
+        GLState::Viewport(viewport.min.x, viewport.min.y, viewport.Size().x, viewport.Size().y);
     }
 
     void MemoryBarrier(int barrierBits) {
@@ -159,6 +159,10 @@ namespace Quasi::Graphics {
 namespace Quasi::Graphics::Render {
     void Draw(const VertexArray& vertexArr, const IndexBuffer& indexBuff, const ShaderProgram& shader);
     void DrawInstanced(const VertexArray& vertexArr, const IndexBuffer& indexBuff, const ShaderProgram& shader, int instances);
+    // draws indexCount indices starting from firstIndex, each offset by baseVertex
+    void DrawRange(const VertexArray& vertexArr, const IndexBuffer& indexBuff, const ShaderProgram& shader, u32 firstIndex, u32 indexCount, u32 baseVertex = 0);
+    void DrawRangeInstanced(const VertexArray& vertexArr, const IndexBuffer& indexBuff, const ShaderProgram& shader, u32 firstIndex, u32 indexCount, u32 baseVertex, int instances);
+    // these draw from the current region of streaming buffers
     void Draw(const RenderData& dat, const ShaderProgram& s);
     void Draw(const RenderData& dat);
     void DrawInstanced(const RenderData& dat, const ShaderProgram& s, int instances);
@@ -4,6 +4,7 @@
 #include "Texture.h"
 #include "Utils/Text.h"
 #include "GLDebug.h"
+#include "GLState.h"
 #include "Utils/Iter/LinesIter.h"
 
 namespace Quasi::Graphics {
@@ -32,85 +33,220 @@ namespace Quasi::Graphics {
     }
 
     void ShaderProgram::DestroyObject(GraphicsID id) {
+        GLState::ForgetProgram(id);
         QGLCall$(GL::DeleteProgram(id));
     }
 
     void ShaderProgram::BindObject(GraphicsID id) {
-        QGLCall$(GL::UseProgram(id));
+        GLState::UseProgram(id);
     }
 
     void ShaderProgram::UnbindObject() {
-        QGLCall$(GL::UseProgram(0));
+        GLState::UseProgram(0);
     }
 
     int ShaderProgram::GetUniformLocation(CStr name) const {
         return QGLCall$(GL::GetUniformLocation(rendererID, name.Data()));
     }
 
-    int Shader::GetUniformLocation(CStr name) {
-        if (const auto cachedLoc = uniformCache.Get(name))
-            return *cachedLoc;
+    Shader::Shader(ShaderProgram&& prog) : ShaderProgram(std::move(prog)) {
+        if (rendererID) ReadUniformLayout();
+    }
+
+    void Shader::ReadUniformLayout() {
+        int uniformCount = 0, maxNameLength = 0;
+        QGLCall$(GL::GetProgramiv(rendererID, GL::ACTIVE_UNIFORMS, &uniformCount));
+        QGLCall$(GL::GetProgramiv(rendererID, GL::ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength));
+
+        char* nameBuf = Memory::QAlloca$(char, maxNameLength + 1);
+        uniformSlots.Reserve(uniformCount);
+        for (int i = 0; i < uniformCount; ++i) {
+            int nameLength = 0, size = 0;
+            u32 type = 0;
+            QGLCall$(GL::GetActiveUniform(rendererID, i, maxNameLength + 1, &nameLength, &size, &type, nameBuf));
+            const CStr name = nameBuf;
+            const int location = ShaderProgram::GetUniformLocation(name);
+            // uniforms inside blocks dont have a location
+            if (location == -1) continue;
+            // arrays are listed by their first element, but set by their name
+            AddUniformSlot(name.AsStr().RemoveSuffix("[0]"), location);
+        }
+
+        projectionSlot = FindUniform("u_projection");
+        viewSlot       = FindUniform("u_view");
+
+        const u32 cameraBlock = QGLCall$(GL::GetUniformBlockIndex(rendererID, CAMERA_BLOCK_NAME.Data()));
+        usesCameraBlock = cameraBlock != GL::INVALID_INDEX;
+        if (usesCameraBlock)
+            QGLCall$(GL::UniformBlockBinding(rendererID, cameraBlock, CAMERA_BLOCK_BINDING));
+    }
 
+    usize Shader::AddUniformSlot(Str name, int location) {
+        const usize slot = uniformSlots.Length();
+        uniformSlots.Push({ String { name }, location, {} });
+        slotLookup[String { name }] = slot;
+        return slot;
+    }
+
+    OptionUsize Shader::FindUniform(Str name) const {
+        if (const auto slot = slotLookup.Get(name))
+            return *slot;
+        return nullptr;
+    }
+
+    usize Shader::GetUniformSlot(CStr name) {
+        if (const OptionUsize slot = FindUniform(name))
+            return *slot;
+
+        // elements of arrays and structs arent part of the layout, so they're added when first used
         const int location = ShaderProgram::GetUniformLocation(name);
         GLLogger().Assert(location != -1, "invalid uniform location for '{}'", name);
-        uniformCache[String { name }] = location;
-        return location;
+        return AddUniformSlot(name, location);
     }
 
-    void Shader::SetUniformDyn(CStr name, ShaderUniformType type, Bytes data) {
+    int Shader::GetUniformLocation(CStr name) {
+        UniformSlot& slot = uniformSlots[GetUniformSlot(name)];
+        // the value is set without going through the slot, so it cant be compared against anymore
+        slot.lastValue.Clear();
+        return slot.location;
+    }
+
+    void Shader::SetUniformAt(usize slot, ShaderUniformType type, Bytes data) {
+        UniformSlot& unif = uniformSlots[slot];
+        if (unif.lastValue.AsSpan().Equals(data)) return;
+        unif.lastValue.Clear();
+        unif.lastValue.Extend(data);
+        UploadUniform(unif.location, type, data);
+    }
+
+    void Shader::SetCamera(const Math::Matrix4x4& projection, const Math::Matrix4x4& view) {
         using enum ShaderUniformType;
-        switch (type) {
-            case F_UNIT:    return SetUniformFloat(name, data.ReadFirst<float>());
-            case FV2:       return SetUniformFv2  (name, data.ReadFirst<Math::fv2>());
-            case FV3:       return SetUniformFv3  (name, data.ReadFirst<Math::fv3>());
-            case FV4:       return SetUniformFv4  (name, data.ReadFirst<Math::fv4>());
-            case F_ARRAY:   return SetUniformFloatArr(name, data.Transmute<float>());
-            case FV2_ARRAY: return SetUniformFv2Arr  (name, data.Transmute<Math::fv2>());
-            case FV3_ARRAY: return SetUniformFv3Arr  (name, data.Transmute<Math::fv3>());
-            case FV4_ARRAY: return SetUniformFv4Arr  (name, data.Transmute<Math::fv4>());
-            case I_UNIT:    return SetUniformInt   (name, data.ReadFirst<int>());
-            case IV2:       return SetUniformIv2   (name, data.ReadFirst<Math::iv2>());
-            case IV3:       return SetUniformIv3   (name, data.ReadFirst<Math::iv3>());
-            case IV4:       return SetUniformIv4   (name, data.ReadFirst<Math::iv4>());
-            case I_ARRAY:   return SetUniformIntArr(name, data.Transmute<int>());
-            case IV2_ARRAY: return SetUniformIv2Arr(name, data.Transmute<Math::iv2>());
-            case IV3_ARRAY: return SetUniformIv3Arr(name, data.Transmute<Math::iv3>());
-            case IV4_ARRAY: return SetUniformIv4Arr(name, data.Transmute<Math::iv4>());
-            case U_UNIT:    return SetUniformUint(name, data.ReadFirst<uint>());
-            case UV2:       return SetUniformUv2 (name, data.ReadFirst<Math::uv2>());
-            case UV3:       return SetUniformUv3 (name, data.ReadFirst<Math::uv3>());
-            case UV4:       return SetUniformUv4 (name, data.ReadFirst<Math::uv4>());
-            case U_ARRAY:   return SetUniformUintArr(name, data.Transmute<uint>());
-            case UV2_ARRAY: return SetUniformUv2Arr (name, data.Transmute<Math::uv2>());
-            case UV3_ARRAY: return SetUniformUv3Arr (name, data.Transmute<Math::uv3>());
-            case UV4_ARRAY: return SetUniformUv4Arr (name, data.Transmute<Math::uv4>());
-            case FMAT_2X2:  return SetUniformMat2x2Arr(name, data.Transmute<Math::Matrix2x2>());
-            case FMAT_2X3:  return SetUniformMat2x3Arr(name, data.Transmute<Math::Matrix2x3>());
-            case FMAT_2X4:  return SetUniformMat2x4Arr(name, data.Transmute<Math::Matrix2x4>());
-            case FMAT_3X2:  return SetUniformMat3x2Arr(name, data.Transmute<Math::Matrix3x2>());
-            case FMAT_3X3:  return SetUniformMat3x3Arr(name, data.Transmute<Math::Matrix3x3>());
-            case FMAT_3X4:  return SetUniformMat3x4Arr(name, data.Transmute<Math::Matrix3x4>());
-            case FMAT_4X2:  return SetUniformMat4x2Arr(name, data.Transmute<Math::Matrix4x2>());
-            case FMAT_4X3:  return SetUniformMat4x3Arr(name, data.Transmute<Math::Matrix4x3>());
-            case FMAT_4X4:  return SetUniformMat4x4Arr(name, data.Transmute<Math::Matrix4x4>());
-            default:;
-        }
+        if (usesCameraBlock) return;
+        if (projectionSlot) SetUniformAt(*projectionSlot, FMAT_4X4, Bytes::BytesOf(projection));
+        if (viewSlot)       SetUniformAt(*viewSlot,       FMAT_4X4, Bytes::BytesOf(view));
+    }
+
+    void Shader::SetUniformDyn(CStr name, ShaderUniformType type, Bytes data) {
+        SetUniformAt(GetUniformSlot(name), type, data);
     }
 
     void Shader::SetUniformArgs(const ShaderArgs& args) {
-        Bytes argBytes = args.rawBytes;
+        SetUniformArgs(args.rawBytes);
+    }
+
+    struct PackedArg {
+        ShaderUniformType type;
+        Bytes data;
+        CStr name;
+    };
+
+    // takes one argument off the front of ShaderArgs::rawBytes
+    static PackedArg TakePackedArg(Bytes& argBytes) {
+        const ShaderUniformType type = (ShaderUniformType)argBytes.TakeFirst();
+        Bytes data;
+        if (Shader::IsArrayUnif(type) || Shader::IsMatrixUnif(type)) {
+            const usize byteCount = argBytes.Read<usize>();
+            data = Bytes::Slice(argBytes.Read<const byte*>(), byteCount);
+        } else {
+            data = argBytes.TakeFirst(4 * sizeof(u32));
+        }
+        const CStr name = (const char*)argBytes.Data();
+        argBytes.Advance(name.LengthWithNull());
+        return { type, data, name };
+    }
+
+    bool Shader::MatchesArgLayout(const ArgLayout& layout, Bytes argBytes) {
+        Bytes names = layout.names;
         while (argBytes) {
-            const ShaderUniformType type = (ShaderUniformType)argBytes.TakeFirst();
-            Bytes bytes;
-            if (IsArrayUnif(type) || IsMatrixUnif(type)) {
-                const usize byteCount = argBytes.Read<usize>();
-                bytes = Bytes::Slice(argBytes.Read<const byte*>(), byteCount);
-            } else {
-                bytes = argBytes.TakeFirst(4 * sizeof(u32));
-            }
-            const CStr uname = (const char*)argBytes.Data();
-            SetUniformDyn(uname, type, bytes);
-            argBytes.Advance(uname.LengthWithNull());
+            const PackedArg arg = TakePackedArg(argBytes);
+            if (!names || names.TakeFirst() != (byte)arg.type) return false;
+            const Bytes name = arg.name.AsBytesWithNull();
+            if (names.Length() < name.Length() || !names.TakeFirst(name.Length()).Equals(name)) return false;
+        }
+        return !names;
+    }
+
+    usize Shader::ResolveArgLayout(Bytes argBytes) {
+        // draws mostly repeat the arguments of the one before, so that layout is tried first
+        if (lastArgLayout < argLayouts.Length() && MatchesArgLayout(argLayouts[lastArgLayout], argBytes))
+            return lastArgLayout;
+        for (usize i = 0; i < argLayouts.Length(); ++i)
+            if (MatchesArgLayout(argLayouts[i], argBytes)) return lastArgLayout = i;
+
+        ArgLayout layout;
+        while (argBytes) {
+            const PackedArg arg = TakePackedArg(argBytes);
+            layout.names.Push((byte)arg.type);
+            layout.names.Extend(arg.name.AsBytesWithNull());
+            layout.slots.Push(GetUniformSlot(arg.name));
+        }
+        // once full, the layouts are replaced in turn
+        if (argLayouts.Length() < MAX_ARG_LAYOUTS) {
+            lastArgLayout = argLayouts.Length();
+            argLayouts.Push(std::move(layout));
+        } else {
+            lastArgLayout = replacedArgLayout;
+            replacedArgLayout = (replacedArgLayout + 1) % MAX_ARG_LAYOUTS;
+            argLayouts[lastArgLayout] = std::move(layout);
+        }
+        return lastArgLayout;
+    }
+
+    void Shader::SetUniformArgs(Bytes argBytes) {
+        const usize layout = ResolveArgLayout(argBytes);
+        for (const usize slot : argLayouts[layout].slots) {
+            const PackedArg arg = TakePackedArg(argBytes);
+            SetUniformAt(slot, arg.type, arg.data);
+        }
+    }
+
+    // the byte size of one element of the uniform, see the layout of ShaderUniformType
+    static usize UniformElementSize(ShaderUniformType type) {
+        const u32 t = (u32)type;
+        return sizeof(u32) * (((t >> 2) & 3) + 1) * ((t & 3) + 1);
+    }
+
+    void Shader::UploadUniform(int location, ShaderUniformType type, Bytes data) {
+        using enum ShaderUniformType;
+        const int count = (int)(data.Length() / UniformElementSize(type));
+        const float* fs = (const float*)data.Data();
+        const int*   is = (const int*)  data.Data();
+        const uint*  us = (const uint*) data.Data();
+        switch (type) {
+            case F_UNIT:    return GL::Uniform1f(location, fs[0]);
+            case FV2:       return GL::Uniform2f(location, fs[0], fs[1]);
+            case FV3:       return GL::Uniform3f(location, fs[0], fs[1], fs[2]);
+            case FV4:       return GL::Uniform4f(location, fs[0], fs[1], fs[2], fs[3]);
+            case F_ARRAY:   return GL::Uniform1fv(location, count, fs);
+            case FV2_ARRAY: return GL::Uniform2fv(location, count, fs);
+            case FV3_ARRAY: return GL::Uniform3fv(location, count, fs);
+            case FV4_ARRAY: return GL::Uniform4fv(location, count, fs);
+            case I_UNIT:    return GL::Uniform1i(location, is[0]);
+            case IV2:       return GL::Uniform2i(location, is[0], is[1]);
+            case IV3:       return GL::Uniform3i(location, is[0], is[1], is[2]);
+            case IV4:       return GL::Uniform4i(location, is[0], is[1], is[2], is[3]);
+            case I_ARRAY:   return GL::Uniform1iv(location, count, is);
+            case IV2_ARRAY: return GL::Uniform2iv(location, count, is);
+            case IV3_ARRAY: return GL::Uniform3iv(location, count, is);
+            case IV4_ARRAY: return GL::Uniform4iv(location, count, is);
+            case U_UNIT:    return GL::Uniform1ui(location, us[0]);
+            case UV2:       return GL::Uniform2ui(location, us[0], us[1]);
+            case UV3:       return GL::Uniform3ui(location, us[0], us[1], us[2]);
+            case UV4:       return GL::Uniform4ui(location, us[0], us[1], us[2], us[3]);
+            case U_ARRAY:   return GL::Uniform1uiv(location, count, us);
+            case UV2_ARRAY: return GL::Uniform2uiv(location, count, us);
+            case UV3_ARRAY: return GL::Uniform3uiv(location, count, us);
+            case UV4_ARRAY: return GL::Uniform4uiv(location, count, us);
+            case FMAT_2X2:  return GL::UniformMatrix2fv  (location, count, false, fs);
+            case FMAT_2X3:  return GL::UniformMatrix2x3fv(location, count, false, fs);
+            case FMAT_2X4:  return GL::UniformMatrix2x4fv(location, count, false, fs);
+            case FMAT_3X2:  return GL::UniformMatrix3x2fv(location, count, false, fs);
+            case FMAT_3X3:  return GL::UniformMatrix3fv  (location, count, false, fs);
+            case FMAT_3X4:  return GL::UniformMatrix3x4fv(location, count, false, fs);
+            case FMAT_4X2:  return GL::UniformMatrix4x2fv(location, count, false, fs);
+            case FMAT_4X3:  return GL::UniformMatrix4x3fv(location, count, false, fs);
+            case FMAT_4X4:  return GL::UniformMatrix4fv  (location, count, false, fs);
+            default:;
         }
     }
 
@@ -91,18 +91,65 @@ namespace Quasi::Graphics {
     };
 
     class Shader : public ShaderProgram {
-        HashMap<String, int> uniformCache;
+        // the uniforms of the program are read once on creation, so that per draw arguments
+        // are set by slot. each slot remembers the last value sent, and skips sending it again.
+        struct UniformSlot {
+            String name;
+            int location;
+            Vec<byte> lastValue;
+        };
+        Vec<UniformSlot> uniformSlots;
+        HashMap<String, usize, Hashing::DefaultHasher, HashTables::Layout::SWISS> slotLookup;
+        // the slots that the arguments of one ShaderArgs layout resolve to, so that drawing
+        // with arguments of the same types and names again doesnt look up each name
+        struct ArgLayout {
+            Vec<byte> names; // [utype] [unifName] [NULL] of each argument
+            Vec<usize> slots;
+        };
+        static constexpr usize MAX_ARG_LAYOUTS = 16;
+        Vec<ArgLayout> argLayouts;
+        usize lastArgLayout = 0, replacedArgLayout = 0;
+        OptionUsize projectionSlot, viewSlot;
+        bool usesCameraBlock = false;
+        bool mergesInstances = false;
 
         explicit Shader(GraphicsID id);
     public:
+        // shaders can share the camera by declaring
+        // layout(std140) uniform Camera { mat4 u_projection; mat4 u_view; };
+        // instead of the u_projection and u_view uniforms.
+        static constexpr Str CAMERA_BLOCK_NAME = "Camera";
+        static constexpr u32 CAMERA_BLOCK_BINDING = 0;
+
         Shader() = default;
-        Shader(ShaderProgram&& prog) : ShaderProgram(std::move(prog)) {}
+        Shader(ShaderProgram&& prog);
 
         void SetUniformDyn(CStr name, ShaderUniformType type, Bytes data);
         void SetUniformArgs(const ShaderArgs& args);
+        // the packed bytes of ShaderArgs::rawBytes
+        void SetUniformArgs(Bytes argBytes);
+        void SetUniformAt(usize slot, ShaderUniformType type, Bytes data);
+        static void UploadUniform(int location, ShaderUniformType type, Bytes data);
 
+        OptionUsize FindUniform(Str name) const;
+        usize GetUniformSlot(CStr name);
+        usize UniformCount() const { return uniformSlots.Length(); }
         int GetUniformLocation(CStr name);
 
+        // sets u_projection and u_view, unless they come from the camera block
+        void SetCamera(const Math::Matrix4x4& projection, const Math::Matrix4x4& view);
+        bool UsesCameraBlock() const { return usesCameraBlock; }
+        // opt in for shaders that dont read gl_InstanceID, so that the DrawQueue
+        // can turn equal draws of them into one instanced draw without changing what they look like
+        void SetMergesInstances(bool merges = true) { mergesInstances = merges; }
+        bool MergesInstances() const { return mergesInstances; }
+    private:
+        void ReadUniformLayout();
+        usize AddUniformSlot(Str name, int location);
+        static bool MatchesArgLayout(const ArgLayout& layout, Bytes argBytes);
+        usize ResolveArgLayout(Bytes argBytes);
+    public:
+
 #pragma region Shader Uniform Types
         void SetUniformFloat(CStr name, float x);
         void SetUniformFv2(CStr name, const Math::fv2& v2s);
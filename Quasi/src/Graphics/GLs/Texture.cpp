@@ -4,6 +4,7 @@
 #include "Utils/CStr.h"
 #include "Utils/Vec.h"
 #include "GLDebug.h"
+#include "GLState.h"
 #include "GraphicsDevice.h"
 #include "Image.h"
 #include "vendor/stb_image/stb_image.h"
@@ -14,15 +15,16 @@ namespace Quasi::Graphics {
     }
 
     void TextureBase::DestroyObject(GraphicsID id) {
+        GLState::ForgetTexture(id);
         QGLCall$(GL::DeleteTextures(1, &id));
     }
 
     void TextureBase::BindObject(TextureTarget target, GraphicsID id) {
-        QGLCall$(GL::BindTexture((int)target, id));
+        GLState::BindTexture((u32)target, id);
     }
 
     void TextureBase::UnbindObject(TextureTarget target) {
-        QGLCall$(GL::BindTexture((int)target, 0));
+        GLState::BindTexture((u32)target, 0);
     }
 
     void TextureBase::SetSample(TextureTarget target, TextureSample sample) {
@@ -66,7 +68,7 @@ namespace Quasi::Graphics {
     }
 
     void TextureBase::Activate(TextureTarget target, int slot) const {
-        QGLCall$(GL::ActiveTexture(GL::TEXTURE0 + slot));
+        GLState::ActiveTexture(slot);
         BindObject(target, rendererID);
     }
 
@@ -144,7 +146,7 @@ namespace Quasi::Graphics {
 
     template <TextureTarget Target>
     void TextureObject<Target>::Activate(int slot) {
-        QGLCall$(GL::ActiveTexture(GL::TEXTURE0 + slot));
+        GLState::ActiveTexture(slot);
         Bind();
     }
 
@@ -0,0 +1,40 @@
+#include "UniformBuffer.h"
+
+#include <glp.h>
+
+#include "GLDebug.h"
+#include "GLState.h"
+
+namespace Quasi::Graphics {
+    UniformBuffer::UniformBuffer(GraphicsID id, u32 size) : GLObject(id), bufferSize(size) {}
+
+    UniformBuffer UniformBuffer::New(u32 size) {
+        GraphicsID id;
+        QGLCall$(GL::GenBuffers(1, &id));
+        BindObject(id);
+        QGLCall$(GL::BufferData(GL::UNIFORM_BUFFER, size, nullptr, GL::DYNAMIC_DRAW));
+        return UniformBuffer { id, size };
+    }
+
+    void UniformBuffer::DestroyObject(GraphicsID id) {
+        GLState::ForgetBuffer(id);
+        QGLCall$(GL::DeleteBuffers(1, &id));
+    }
+
+    void UniformBuffer::BindObject(GraphicsID id) {
+        GLState::BindBuffer(GL::UNIFORM_BUFFER, id);
+    }
+
+    void UniformBuffer::UnbindObject() {
+        GLState::BindBuffer(GL::UNIFORM_BUFFER, 0);
+    }
+
+    void UniformBuffer::SetDataBytes(Span<const byte> data, u32 byteOffset) {
+        Bind();
+        QGLCall$(GL::BufferSubData(GL::UNIFORM_BUFFER, (int)byteOffset, (int)data.ByteSize(), data.Data()));
+    }
+
+    void UniformBuffer::BindToSlot(u32 binding) const {
+        GLState::BindBufferBase(GL::UNIFORM_BUFFER, binding, rendererID);
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "GLObject.h"
+#include "Utils/Span.h"
+
+namespace Quasi::Graphics {
+    // a buffer backing a std140 uniform block, shared by every shader that binds the block to the same slot
+    class UniformBuffer : public GLObject<UniformBuffer> {
+        u32 bufferSize = 0;
+
+        explicit UniformBuffer(GraphicsID id, u32 size);
+    public:
+        UniformBuffer() = default;
+        static UniformBuffer New(u32 size);
+        static void DestroyObject(GraphicsID id);
+        static void BindObject(GraphicsID id);
+        static void UnbindObject();
+
+        u32 GetLength() const { return bufferSize; }
+
+        void SetDataBytes(Span<const byte> data, u32 byteOffset = 0);
+        template <class T> void SetData(const T& data, u32 byteOffset = 0) { SetDataBytes(Bytes::BytesOf(data), byteOffset); }
+
+        void BindToSlot(u32 binding) const;
+    };
+}
@@ -2,6 +2,7 @@
 
 #include <glp.h>
 #include "GLDebug.h"
+#include "GLState.h"
 
 namespace Quasi::Graphics {
     VertexArray::VertexArray(GraphicsID id) : GLObject(id) {}
@@ -13,15 +14,16 @@ namespace Quasi::Graphics {
     }
 
     void VertexArray::DestroyObject(const GraphicsID id) {
+        GLState::ForgetVertexArray(id);
         QGLCall$(GL::DeleteVertexArrays(1, &id));
     }
 
     void VertexArray::BindObject(const GraphicsID id) {
-        QGLCall$(GL::BindVertexArray(id));
+        GLState::BindVertexArray(id);
     }
 
     void VertexArray::UnbindObject() {
-        QGLCall$(GL::BindVertexArray(0));
+        GLState::BindVertexArray(0);
     }
 
     void VertexArray::AddBuffer(const VertexBufferLayout& layout) {
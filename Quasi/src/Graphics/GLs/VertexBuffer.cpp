@@ -3,6 +3,7 @@
 #include <glp.h>
 
 #include "GLDebug.h"
+#include "GLState.h"
 
 namespace Quasi::Graphics {
     VertexBuffer::VertexBuffer(GraphicsID id, u32 size) : GLObject(id), bufferSize(size) {}
@@ -15,30 +16,53 @@ namespace Quasi::Graphics {
         return VertexBuffer { id, size };
     }
 
+    VertexBuffer VertexBuffer::NewStreaming(u32 size, u32 vertexSize) {
+        GraphicsID id;
+        QGLCall$(GL::GenBuffers(1, &id));
+        BindObject(id);
+        // a whole number of vertices, so that regions start on a base vertex
+        size -= size % vertexSize;
+        VertexBuffer vbo { id, size };
+        vbo.vertexSize = vertexSize;
+        vbo.stream.Create(GL::ARRAY_BUFFER, size, vertexSize);
+        return vbo;
+    }
+
     void VertexBuffer::DestroyObject(GraphicsID id) {
+        GLState::ForgetBuffer(id);
         QGLCall$(GL::DeleteBuffers(1, &id));
     }
 
     void VertexBuffer::BindObject(GraphicsID id) {
-        QGLCall$(GL::BindBuffer(GL::ARRAY_BUFFER, id));
+        GLState::BindBuffer(GL::ARRAY_BUFFER, id);
     }
 
     void VertexBuffer::UnbindObject() {
-        QGLCall$(GL::BindBuffer(GL::ARRAY_BUFFER, 0));
+        GLState::BindBuffer(GL::ARRAY_BUFFER, 0);
     }
 
-    void VertexBuffer::SetDataBytes(Span<const byte> data) {
+    void VertexBuffer::SetDataBytes(Span<const byte> data, u32 byteOffset) {
         Bind();
-        QGLCall$(GL::BufferSubData(GL::ARRAY_BUFFER, 0, (int)data.ByteSize(), data.Data()));
+        if (IsStreaming())
+            stream.Write(byteOffset, data);
+        else
+            QGLCall$(GL::BufferSubData(GL::ARRAY_BUFFER, (int)byteOffset, (int)data.ByteSize(), data.Data()));
     }
 
-    void VertexBuffer::ClearData() {
+    void VertexBuffer::ClearData(u32 reserveBytes) {
+        if (IsStreaming()) {
+            Bind();
+            stream.BeginBatch(dataOffset, reserveBytes);
+        }
         dataOffset = 0;
     }
 
     void VertexBuffer::AddDataBytes(Span<const byte> data) {
         Bind();
-        QGLCall$(GL::BufferSubData(GL::ARRAY_BUFFER, (int)dataOffset, (int)data.ByteSize(), data.Data()));
+        if (IsStreaming())
+            stream.Write(dataOffset, data);
+        else
+            QGLCall$(GL::BufferSubData(GL::ARRAY_BUFFER, (int)dataOffset, (int)data.ByteSize(), data.Data()));
         dataOffset += data.ByteSize();
     }
 }
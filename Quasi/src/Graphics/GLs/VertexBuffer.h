@@ -1,31 +1,46 @@
 ﻿#pragma once
 
 #include "GLObject.h"
+#include "BufferStream.h"
 #include "Utils/Span.h"
 
 namespace Quasi::Graphics {
     class VertexBuffer : public GLObject<VertexBuffer> {
         u32 dataOffset = 0;
         u32 bufferSize = 0;
+        u32 vertexSize = 1;
+        BufferStream stream;
 
         explicit VertexBuffer(GraphicsID id, u32 size);
     public:
         VertexBuffer() = default;
         static VertexBuffer New(u32 size);
+        // for data that is rewritten every frame, see BufferStream. size is the size of one region
+        static VertexBuffer NewStreaming(u32 size, u32 vertexSize);
         static void DestroyObject(GraphicsID id);
         static void BindObject(GraphicsID id);
         static void UnbindObject();
 
         u32 GetLength() const { return bufferSize; }
+        u32 GetUsedLength() const { return dataOffset; }
+        bool IsStreaming() const { return stream.IsStreaming(); }
+        // where the current batch starts, to be passed as the base vertex of draws
+        u32 GetBaseVertex() const { return stream.BatchOffset() / vertexSize; }
 
-        void SetDataBytes(Span<const byte> data);
-        template <class T> void SetData(Span<const T> data) { SetDataBytes(data.AsBytes()); }
+        void SetDataBytes(Span<const byte> data, u32 byteOffset = 0);
+        template <class T> void SetData(Span<const T> data, u32 offset = 0) { SetDataBytes(data.AsBytes(), offset * sizeof(T)); }
 
-        void ClearData();
+        // streaming buffers start a new batch after the data of this one, with room for at least reserveBytes
+        void ClearData(u32 reserveBytes = 0);
 
         void AddDataBytes(Span<const byte> data);
         template <class T> void AddData(Span<const T> data) { AddDataBytes(data.AsBytes()); }
 
+        // the rest of the region from the current batch on of a mapped streaming buffer, empty otherwise.
+        // written to directly, then how much of it is used is set with SetUsedLength
+        Span<byte> MappedBatch() const { return stream.MappedBatch(); }
+        void SetUsedLength(u32 size) { dataOffset = size; }
+
         friend class GraphicsDevice;
     };
 }
@@ -2,6 +2,9 @@
 
 #include "glp.h"
 #include "GraphicsDevice.h"
+#include "GLs/GLDebug.h"
+#include "GLs/GLState.h"
+#include "Utils/Debug/Profiler.h"
 #include "Fonts/TextAlign.h"
 
 namespace Quasi::Graphics {
@@ -33,16 +36,23 @@ namespace Quasi::Graphics {
         }
     }
 
-    Canvas::Canvas() {}
-    Canvas::Canvas(GraphicsDevice& gd) {
-        const Math::iv2 screenSize = gd.GetWindowSize();
+    static constexpr u32 RETAINED_VERTEX_COUNT = 65536;
 
-        vbo = VertexBuffer::New(16384 * sizeof(UIVertex));
-        ibo = IndexBuffer::New(16384 * 3);
+    Canvas::Canvas() {}
+    Canvas::Canvas(GraphicsDevice& gd) : Canvas(gd.GetWindowSize()) {}
+    Canvas::Canvas(const Math::iv2& screenSize) {
+        vbo = VertexBuffer::NewStreaming(16384 * sizeof(UIVertex), sizeof(UIVertex));
+        ibo = IndexBuffer::NewStreaming(16384 * 3);
         varray = VertexArray::New();
         varray.Bind();
         varray.AddBuffer(vbo, UIVertex::VERTEX_LAYOUT);
 
+        retainedVbo = VertexBuffer::New(RETAINED_VERTEX_COUNT * sizeof(UIVertex));
+        retainedIbo = IndexBuffer::New(RETAINED_VERTEX_COUNT * 3);
+        retainedVarray = VertexArray::New();
+        retainedVarray.Bind();
+        retainedVarray.AddBuffer(retainedVbo, UIVertex::VERTEX_LAYOUT);
+
         screenTexture = Texture2D::New(nullptr, screenSize);
         screenBuffer = FrameBuffer::With(screenTexture);
 
@@ -501,18 +511,46 @@ namespace Quasi::Graphics {
     }
 
     void Canvas::DrawText(Str text, float fontSize, const Math::fv2& pos, const TextAlign& align) {
-        // by default we render in 1/64 pixels; but the user will probably not expect that
         const Font& font = GetCurrentFont();
+        const TextLayoutKey key = { text, &font, fontSize, align, flipText };
+        OptRef<const TextLayout> layout = textLayoutCache.Find(key);
+        if (!layout) {
+            TextLayout& newLayout = textLayoutCache.Insert(key);
+            LayoutText(newLayout, text, fontSize, align, font);
+            layout = newLayout;
+        }
+
+        // everything is rasterized and uploaded before any quad is pushed,
+        // since pushing can draw the batch halfway through the string
+        for (const TextLayout::PlacedGlyph& g : layout->glyphs) font.GetGlyph(g.codepoint);
+        if (font.TakeAtlasFull()) {
+            // every page is sampled by the batch, which has to be drawn before one can be reused
+            ForceDrawCurrentBatch();
+            for (const TextLayout::PlacedGlyph& g : layout->glyphs) font.GetGlyph(g.codepoint);
+            font.TakeAtlasFull();
+        }
+        font.UploadGlyphs();
+
+        Batch batch = NewBatch();
+        batch.SetStroke();
+        for (const auto& [codepoint, offset] : layout->glyphs) {
+            const Glyph& glyph = font.GetGlyph(codepoint);
+            if (glyph.page == Glyph::NO_PAGE) continue;
+            if (recordingGeometry) recordingGeometry->UseFontPage(font, glyph.page);
+            batch.PushGlyph(glyph, layout->scale, pos + offset, font.GetPage(glyph.page));
+        }
+    }
+
+    void Canvas::LayoutText(TextLayout& layout, Str text, float fontSize, const TextAlign& align, const Font& font) const {
+        // by default we render in 1/64 pixels; but the user will probably not expect that
         const float pointScale = fontSize / (float)font.FontSize();
         const float relativeFontSize = pointScale * 64.0f;
         const float lineHeight = (float)font.GetMetric().fontHeight * pointScale * align.lineSpacing;
 
-        const Texture2D& fontAtlas = font.GetTexture();
-        Batch batch = NewBatch();
-        batch.SetStroke();
-        batch.SetTexture(fontAtlas.rendererID);
+        layout.scale = relativeFontSize;
 
-        Math::fv2 pen = pos;
+        // offsets are relative to the drawing position
+        Math::fv2 pen = 0;
 
         // ----------- ascender line             --> pen.y is here (when flipText=true)   +Y (Y up when flipText=false)
         //                                                                                /\  ||
@@ -529,7 +567,8 @@ namespace Quasi::Graphics {
             Str line;
             float width;
         };
-        Vec<Line> lineBreaks;
+        const Memory::ArenaScope scratchScope { scratch };
+        auto lineBreaks = Vec<Line, Memory::AllocatorRef>::WithAllocator(scratch);
         // words should include the whitespace before it, i.e.
         // The, quick brown-fox  jumped! over the   lazy "dog".
         // [--][----][--------][-------][---][--][-----][-----]
@@ -557,7 +596,7 @@ namespace Quasi::Graphics {
                     // make sure the beginning of a line ISN'T whitespace
                     while (Chr::IsWhitespace(text[++i])) {}
                     lineBeg = wordBeg = i;
-                    wordWidth = font.CalcCharWidth(text[i]) * relativeFontSize;
+                    wordWidth = 0.0f; // the first character gets measured on the next iteration
                     --i;
                     continue;
                 } else {
@@ -569,7 +608,9 @@ namespace Quasi::Graphics {
                     --i;
                 }
             }
-            wordWidth += font.CalcCharWidth(c) * relativeFontSize;
+            usize next = i;
+            wordWidth += font.CalcCharWidth(text.Utf8DecodeAt(next)) * relativeFontSize;
+            i = next - 1; // skip the rest of a multibyte character
         }
         {
             const Str lastLine = text.Substr(lineBeg);
@@ -600,20 +641,21 @@ namespace Quasi::Graphics {
         for (const auto [line, width] : lineBreaks) {
             float beginOffset = 0;
             if (!flipText) pen.y -= lineHeight;
+            layout.lineStarts.Push(layout.glyphs.Length());
             switch (horizontalAlignment) {
                 case TextAlign::RIGHT: case TextAlign::CENTER: {
                     beginOffset = (align.rect.x - width) * (horizontalAlignment == TextAlign::CENTER ? 0.5f : 1.0f);
                     [[fallthrough]];
                 }
                 case TextAlign::LEFT: {
-                    DrawTextLine(batch, line, relativeFontSize, { pen.x + beginOffset, pen.y }, align.letterSpacing, font);
+                    LayoutTextLine(layout, line, relativeFontSize, { pen.x + beginOffset, pen.y }, align.letterSpacing, font);
                     break;
                 }
                 case TextAlign::JUSTIFY: {
                     if (i == lineBreaks.Length() - 1) {
-                        DrawTextLine(batch, line, relativeFontSize, pen, align.letterSpacing, font);
+                        LayoutTextLine(layout, line, relativeFontSize, pen, align.letterSpacing, font);
                     } else {
-                        DrawTextJustify(batch, line, relativeFontSize, pen, align.letterSpacing, align.rect.x, font);
+                        LayoutTextJustify(layout, line, relativeFontSize, pen, align.letterSpacing, align.rect.x, font);
                     }
                     break;
                 }
@@ -667,6 +709,20 @@ namespace Quasi::Graphics {
     }
 
     u32 Canvas::Batch::RegTexture(GraphicsID textureID) {
+        // while recording, the slots belong to the chunk and are only bound once it's replayed
+        if (canvas.recordingGeometry) {
+            CachedGeometry& geom = *canvas.recordingGeometry;
+            const OptionUsize slot = Spans::Slice(geom.textures, geom.usedTextures).Find(textureID);
+            if (slot) return (u32)*slot;
+
+            if (geom.usedTextures >= MAX_TEXTURE_SAMPLERS) {
+                GLLogger().QError$("cached geometry cannot use more than {} textures", MAX_TEXTURE_SAMPLERS);
+                return MAX_TEXTURE_SAMPLERS - 1;
+            }
+            geom.textures[geom.usedTextures] = textureID;
+            return geom.usedTextures++;
+        }
+
         OptionUsize samplerSlot = Spans::Slice(canvas.textures, canvas.usedTextures).Find(textureID);
 
         if (samplerSlot) return (u32)*samplerSlot;
@@ -675,8 +731,8 @@ namespace Quasi::Graphics {
             canvas.ForceDrawCurrentBatch();
         canvas.textures[canvas.usedTextures] = textureID;
 
-        GL::ActiveTexture(GL::TEXTURE0 + canvas.usedTextures);
-        GL::BindTexture(GL::TEXTURE_2D, textureID);
+        GLState::ActiveTexture(canvas.usedTextures);
+        GLState::BindTexture(GL::TEXTURE_2D, textureID);
 
         return canvas.usedTextures++;
     }
@@ -1206,43 +1262,42 @@ namespace Quasi::Graphics {
         }
     }
 
-    void Canvas::DrawTextLine(Batch& batch, Str line, float relSize, const Math::fv2& pos, float letterSpacing, const Font& font) {
-        const Texture2D& fontAtlas = font.GetTexture();
+    void Canvas::LayoutTextLine(TextLayout& layout, Str line, float relSize, const Math::fv2& pos, float letterSpacing, const Font& font) {
         Math::fv2 pen = pos;
-        for (const char c : line) {
-            if (Chr::IsWhitespace(c)) {
-                pen.x += font.GetGlyphRect(' ').advance.x * relSize + letterSpacing;
+        for (usize i = 0; i < line.Length();) {
+            const u32 c = line.Utf8DecodeAt(i);
+            if (c < 128 && Chr::IsWhitespace((char)c)) {
+                pen.x += font.SpaceWidth() * relSize + letterSpacing;
                 continue;
             }
-            pen.x += batch.PushGlyph(font.GetGlyphRect(c), relSize, pen, fontAtlas) + letterSpacing;
+            layout.glyphs.Push({ c, pen });
+            pen.x += font.GetGlyph(c).advance.x * relSize + letterSpacing;
         }
     }
 
-    void Canvas::DrawTextJustify(Batch& batch, Str line, float relSize, const Math::fv2& pos, float letterSpacing, float width, const Font& font) {
+    void Canvas::LayoutTextJustify(TextLayout& layout, Str line, float relSize, const Math::fv2& pos, float letterSpacing, float width, const Font& font) {
         float usedWidth = 0;
         int gaps = 0;
         // first pass to calculate widths and spacings
-        for (int i = 0; i < line.Length(); i++) {
+        for (usize i = 0; i < line.Length();) {
             if (Chr::IsWhitespace(line[i])) {
                 gaps++;
                 while (++i < line.Length() && Chr::IsWhitespace(line[i])) {}
-                --i;
             } else {
-                usedWidth += font.GetGlyphRect(line[i]).advance.x * relSize + letterSpacing;
+                usedWidth += font.GetGlyph(line.Utf8DecodeAt(i)).advance.x * relSize + letterSpacing;
             }
         }
         const float wordSpacing = (width - usedWidth) / (float)gaps;
 
-        const Texture2D& fontAtlas = font.GetTexture();
-
         Math::fv2 pen = pos;
-        for (int i = 0; i < line.Length(); i++) {
+        for (usize i = 0; i < line.Length();) {
             if (Chr::IsWhitespace(line[i])) {
                 pen.x += wordSpacing;
                 while (++i < line.Length() && Chr::IsWhitespace(line[i])) {}
-                --i;
             } else {
-                pen.x += batch.PushGlyph(font.GetGlyphRect(line[i]), relSize, pen, fontAtlas) + letterSpacing;
+                const u32 c = line.Utf8DecodeAt(i);
+                layout.glyphs.Push({ c, pen });
+                pen.x += font.GetGlyph(c).advance.x * relSize + letterSpacing;
             }
         }
     }
@@ -1652,6 +1707,175 @@ namespace Quasi::Graphics {
         return { *this, mesh };
     }
 
+    void Canvas::CachedGeometry::Reset() {
+        mesh.Clear();
+        usedTextures = 0;
+        fontPages.Clear();
+        recorded = uploaded = false;
+    }
+
+    void Canvas::CachedGeometry::UseFontPage(const Font& font, u32 page) {
+        for (const FontPage& p : fontPages)
+            if (p.font == &font && p.page == page) return;
+        fontPages.Push({ &font, page, font.PageGeneration(page) });
+    }
+
+    bool Canvas::CachedGeometry::IsStale() const {
+        for (const FontPage& p : fontPages)
+            if (p.font->PageGeneration(p.page) != p.generation) return true;
+        return false;
+    }
+
+    void Canvas::CachedGeometry::TouchFontPages() const {
+        for (const FontPage& p : fontPages) p.font->TouchPage(p.page);
+    }
+
+    Canvas::CacheScope::CacheScope(Canvas& canvas, u64 key, bool invalidate)
+        : canvas(canvas), key(key), prevDestination(canvas.drawMesh), prevRecording(canvas.recordingGeometry) {
+        Box<CachedGeometry>& geom = canvas.cachedGeometry[key];
+        if (!geom) geom = Box<CachedGeometry>::Build();
+        if (invalidate || geom->IsStale()) geom->Reset();
+
+        recording = !geom->recorded;
+        if (!recording) return;
+        canvas.drawMesh = geom->mesh;
+        canvas.recordingGeometry = *geom;
+    }
+
+    Canvas::CacheScope::~CacheScope() {
+        if (recording) {
+            canvas.recordingGeometry->recorded = true;
+            canvas.drawMesh = prevDestination;
+            canvas.recordingGeometry = prevRecording;
+        }
+        canvas.DrawCached(key);
+    }
+
+    Canvas::CacheScope Canvas::BeginCache(u64 key, bool invalidate) {
+        return { *this, key, invalidate };
+    }
+
+    bool Canvas::DrawCached(u64 key) {
+        OptRef<Box<CachedGeometry>> geom = cachedGeometry.Get(key);
+        if (!geom || !(*geom)->recorded || (*geom)->IsStale()) return false;
+        CachedGeometry& g = **geom;
+        if (g.mesh.indices.IsEmpty()) return true;
+        g.TouchFontPages();
+
+        // the fast path draws straight from the retained buffers, which only works when drawing to the screen
+        if (drawMesh || drawingShadow || !UploadCached(g)) {
+            ReplayCached(g, nullptr, 1);
+            return true;
+        }
+
+        ForceDrawCurrentBatch(); // keep the draw order
+        for (u32 i = 0; i < g.usedTextures; ++i) {
+            textures[i] = g.textures[i];
+            GLState::ActiveTexture(i);
+            GLState::BindTexture(GL::TEXTURE_2D, g.textures[i]);
+        }
+        usedTextures = g.usedTextures;
+        Render::DrawRange(retainedVarray, retainedIbo, shaderStd, g.indexOffset, g.mesh.FaceCount() * 3, g.vertexOffset);
+        return true;
+    }
+
+    bool Canvas::DrawCached(u64 key, const Math::Transform2D& xf, const Math::fColor& tint) {
+        const OptRef<const Box<CachedGeometry>> geom = cachedGeometry.Get(key);
+        if (!geom || !(*geom)->recorded || (*geom)->IsStale()) return false;
+        (*geom)->TouchFontPages();
+        ReplayCached(**geom, xf, tint);
+        return true;
+    }
+
+    bool Canvas::IsCached(u64 key) const {
+        const OptRef<const Box<CachedGeometry>> geom = cachedGeometry.Get(key);
+        return geom && (*geom)->recorded && !(*geom)->IsStale();
+    }
+
+    void Canvas::InvalidateCache(u64 key) {
+        // the entry is kept around so the next recording can reuse its region of the retained buffers
+        if (OptRef<Box<CachedGeometry>> geom = cachedGeometry.Get(key)) (*geom)->Reset();
+    }
+
+    void Canvas::ClearCache() {
+        cachedGeometry.Clear();
+        retainedVertexEnd = retainedIndexEnd = 0;
+    }
+
+    void Canvas::ReplayCached(const CachedGeometry& geom, OptRef<const Math::Transform2D> xf, const Math::fColor& tint) {
+        // a chunk replayed into another one passes its pages on, so the outer one goes stale along with it
+        if (recordingGeometry)
+            for (const CachedGeometry::FontPage& p : geom.fontPages) recordingGeometry->UseFontPage(*p.font, p.page);
+
+        // all of the chunk's textures have to fit in the current batch at once
+        if (!recordingGeometry) {
+            u32 missing = 0;
+            for (u32 i = 0; i < geom.usedTextures; ++i)
+                missing += !Spans::Slice(textures, usedTextures).Contains(geom.textures[i]);
+            if (usedTextures + missing > MAX_TEXTURE_SAMPLERS)
+                ForceDrawCurrentBatch();
+        }
+
+        Batch batch = NewBatch();
+        u32 slots[MAX_TEXTURE_SAMPLERS];
+        bool identity = true;
+        for (u32 i = 0; i < geom.usedTextures; ++i) {
+            slots[i] = batch.RegTexture(geom.textures[i]);
+            identity &= slots[i] == i;
+        }
+
+        Vec<UIVertex>& vertices = batch.mesh.vertices;
+        const usize start = vertices.Length();
+        batch.PushIs(geom.mesh.indices, batch.offset);
+        batch.PushVs(geom.mesh.vertices);
+        if (identity && !xf && tint == Math::fColor { 1 }) return;
+
+        const Math::uColor mul = (Math::uColor)tint;
+        for (UIVertex& v : vertices.Skip(start)) {
+            if (xf) v.Position = *xf * v.Position;
+            v.Color *= mul;
+            if (identity) continue;
+            if (const u32 tex = (v.RenderPrim & UIRender::TEXTURE_ID_MASK) / UIRender::TEXTURE_ID) {
+                v.RenderPrim &= ~UIRender::TEXTURE_ID_MASK;
+                v.RenderPrim |= UIRender::TEXTURE_ID * (slots[tex - 1] + 1);
+            }
+            if ((v.RenderPrim & UIRender::PRIMITIVE_TYPE) == UIRender::SDF) {
+                const u32 sdf = (v.RenderPrim & UIRender::SDF_ID_MASK) / UIRender::SDF_ID;
+                v.RenderPrim &= ~UIRender::SDF_ID_MASK;
+                v.RenderPrim |= UIRender::SDF_ID * slots[sdf];
+            }
+        }
+    }
+
+    bool Canvas::UploadCached(CachedGeometry& geom) {
+        if (geom.uploaded) return true;
+        const u32 vCount = geom.mesh.VOff(), iCount = geom.mesh.FaceCount() * 3;
+        if (vCount > RETAINED_VERTEX_COUNT || iCount > RETAINED_VERTEX_COUNT * 3) return false;
+
+        // rerecorded chunks reuse their old region if they still fit in it
+        if (vCount > geom.vertexCapacity || iCount > geom.indexCapacity) {
+            if (retainedVertexEnd + vCount > RETAINED_VERTEX_COUNT || retainedIndexEnd + iCount > RETAINED_VERTEX_COUNT * 3) {
+                // out of space, start over and let every chunk upload itself again when it's next drawn
+                retainedVertexEnd = retainedIndexEnd = 0;
+                for (auto& [_, g] : cachedGeometry) {
+                    g->vertexCapacity = g->indexCapacity = 0;
+                    g->uploaded = false;
+                }
+            }
+            geom.vertexOffset = retainedVertexEnd;
+            geom.indexOffset  = retainedIndexEnd;
+            geom.vertexCapacity = vCount;
+            geom.indexCapacity  = iCount;
+            retainedVertexEnd += vCount;
+            retainedIndexEnd  += iCount;
+        }
+
+        retainedVbo.SetData(geom.mesh.vertices.AsSpan().AsConst(), geom.vertexOffset);
+        retainedIbo.SetData(geom.mesh.indices.AsSpan().AsConst(), geom.indexOffset);
+        geom.uploaded = true;
+        return true;
+    }
+
     Canvas::PushStylesScope::PushStylesScope(Canvas& canvas) : canvas(canvas), originalAttr(canvas.drawAttr) {}
     Canvas::PushStylesScope::~PushStylesScope() {
         canvas.drawAttr = originalAttr;
@@ -1664,16 +1888,18 @@ namespace Quasi::Graphics {
     Canvas::DropShadowScope::DropShadowScope(Canvas& canvas, const Math::fv2& off, float r, const Math::fColor& color)
         : canvas(canvas), offset(off), blurRadius(r), shadowColor(color) {
         canvas.ForceDrawCurrentBatch(); // remove previous meshes
+        canvas.drawingShadow = true;
     }
 
     Canvas::DropShadowScope::~DropShadowScope() {
+        canvas.drawingShadow = false;
         GL::Int prevFramebuff = 0;
         GL::GetIntegerv(GL::DRAW_FRAMEBUFFER_BINDING, &prevFramebuff);
 
         canvas.screenBuffer.BindDrawDest();
         Render::Clear();
         canvas.EndFrame();
-        GL::BindFramebuffer(GL::DRAW_FRAMEBUFFER, prevFramebuff);
+        GLState::BindFramebuffer(GL::DRAW_FRAMEBUFFER, prevFramebuff);
 
         // figure out mesh bounding box
         Math::fRect2D bbox = Math::fRect2D::AntiDomain();
@@ -1727,6 +1953,7 @@ namespace Quasi::Graphics {
     }
 
     void Canvas::Update(float dt) {
+        QProfile$("Canvas::Update");
         (void)dt;
 
         IO::IO& io = GraphicsDevice::GetDeviceInstance().GetIO();
@@ -1773,6 +2000,8 @@ namespace Quasi::Graphics {
     }
 
     void Canvas::BeginFrame() {
+        // whatever the last batch sampled from the font atlases has been drawn
+        Font::NextFrame();
         vbo.ClearData();
         ibo.ClearData();
         worldMesh.Clear();
@@ -1784,10 +2013,11 @@ namespace Quasi::Graphics {
     }
 
     void Canvas::EndFrame(const Shader& alternateShader) {
+        QProfile$("Canvas::EndFrame");
         if (worldMesh.indices.IsEmpty()) return;
 
         vbo.AddData(worldMesh.vertices.AsSpan().AsConst());
         ibo.AddData(worldMesh.indices.AsSpan());
-        Render::Draw(varray, ibo, alternateShader);
+        Render::DrawRange(varray, ibo, alternateShader, ibo.GetFirstIndex(), ibo.GetUsedLength(), vbo.GetBaseVertex());
     }
 }
@@ -5,7 +5,11 @@
 #include "RenderObject.h"
 #include "TextureAtlas.h"
 #include "Fonts/TextAlign.h"
+#include "Fonts/TextLayoutCache.h"
 #include "GLs/FrameBuffer.h"
+#include "Utils/Arena.h"
+#include "Utils/Box.h"
+#include "Utils/HashMap.h"
 
 namespace Quasi::Graphics {
     class Font;
@@ -61,17 +65,57 @@ namespace Quasi::Graphics {
         // TODO: replace this with a better method to fetch fonts
         Font defaultFont = Font::LoadFile(R"(C:\Windows\Fonts\arial.ttf)", 64);
 
+        TextLayoutCache textLayoutCache;
+
         Vec<Ref<Interactable>> interactables;
 
         static constexpr u32 MAX_TEXTURE_SAMPLERS = 8;
         GraphicsID textures[MAX_TEXTURE_SAMPLERS] = {};
         u32 usedTextures = 0;
+    public:
+        // a recorded sequence of draws, which can be replayed every frame without tessellating again.
+        // vertices are kept in world space, and their texture ids refer to the chunk's own texture slots.
+        struct CachedGeometry {
+            UIMesh mesh;
+            GraphicsID textures[MAX_TEXTURE_SAMPLERS] = {};
+            u32 usedTextures = 0;
+
+            // region of the retained buffers this chunk lives in, so that unchanged chunks dont get uploaded again
+            u32 vertexOffset = 0, indexOffset = 0;
+            u32 vertexCapacity = 0, indexCapacity = 0;
+            bool recorded = false, uploaded = false;
+
+            // the atlas pages its glyphs were taken from. an evicted page gets refilled with other glyphs,
+            // so once one of these has moved on the chunk has to be recorded again
+            struct FontPage { const Font* font; u32 page; u64 generation; };
+            Vec<FontPage> fontPages;
+
+            void Reset();
+            void UseFontPage(const Font& font, u32 page);
+            bool IsStale() const;
+            // keeps the pages from being evicted while the replayed quads havent been drawn yet
+            void TouchFontPages() const;
+        };
+    private:
+        VertexArray retainedVarray;
+        VertexBuffer retainedVbo;
+        IndexBuffer retainedIbo;
+        u32 retainedVertexEnd = 0, retainedIndexEnd = 0;
+
+        HashMap<u64, Box<CachedGeometry>> cachedGeometry; // boxed so recording can keep a pointer while other keys get added
+        OptRef<CachedGeometry> recordingGeometry = nullptr;
+        bool drawingShadow = false;
+
+        // temporaries of text layout, rewound after every call
+        mutable Memory::Arena scratch { 4096 };
     public:
         Math::Transform2D transform;
         bool flipText = false;
 
         Canvas();
         Canvas(GraphicsDevice& gd);
+        // doesnt need a window, only a current gl context (or GL::NullContext)
+        explicit Canvas(const Math::iv2& screenSize);
 
         enum ArcMode {
             OPEN, CHORD, CLOSED
@@ -115,6 +159,9 @@ namespace Quasi::Graphics {
 
         // pos = bottom left corner of text, align.rect = box extending to the top-right corner
         void DrawText(Str text, float fontSize, const Math::fv2& pos, const TextAlign& align = {});
+        // layouts of recently drawn text, so unchanged strings skip wrapping and measuring
+        TextLayoutCache& TextCache() { return textLayoutCache; }
+        const TextLayoutCache& TextCache() const { return textLayoutCache; }
 
         void ShowHitboxes();
 
@@ -194,8 +241,9 @@ namespace Quasi::Graphics {
         void DrawSimpleVarRoundRect(const Math::fRect2D& outer, float tr, float br, float tl, float bl, const Math::fColor& color);
         void DrawRectStroke(const Math::fRect2D& rect);
 
-        void DrawTextLine(Batch& batch, Str line, float relSize, const Math::fv2& pos, float letterSpacing, const Font& font);
-        void DrawTextJustify(Batch& batch, Str line, float relSize, const Math::fv2& pos, float letterSpacing, float width, const Font& font);
+        void LayoutText(TextLayout& layout, Str text, float fontSize, const TextAlign& align, const Font& font) const;
+        static void LayoutTextLine(TextLayout& layout, Str line, float relSize, const Math::fv2& pos, float letterSpacing, const Font& font);
+        static void LayoutTextJustify(TextLayout& layout, Str line, float relSize, const Math::fv2& pos, float letterSpacing, float width, const Font& font);
     public:
 
         enum CurveMode {
@@ -253,6 +301,35 @@ namespace Quasi::Graphics {
         };
         DeferRenderScope RenderTo(UIMesh& mesh);
 
+        struct CacheScope {
+            Canvas& canvas;
+            u64 key;
+            OptRef<UIMesh> prevDestination;
+            OptRef<CachedGeometry> prevRecording;
+            bool recording;
+            CacheScope(Canvas& canvas, u64 key, bool invalidate);
+            ~CacheScope();
+
+            // if false, the chunk is already cached and drawing it again can be skipped
+            bool NeedsRecording() const { return recording; }
+        };
+        // everything drawn inside the scope is recorded under key, then drawn when the scope ends.
+        // the key is chosen by the caller, and stays cached until it gets invalidated:
+        //     auto cache = canvas.BeginCache(id, changed);
+        //     if (cache.NeedsRecording()) { ... }
+        CacheScope BeginCache(u64 key, bool invalidate = false);
+        // replays a recorded chunk, returns false if nothing is cached under key
+        // or if its text was taken from atlas pages that have been evicted since
+        bool DrawCached(u64 key);
+        bool DrawCached(u64 key, const Math::Transform2D& xf, const Math::fColor& tint = 1);
+        bool IsCached(u64 key) const;
+        void InvalidateCache(u64 key);
+        void ClearCache();
+    private:
+        void ReplayCached(const CachedGeometry& geom, OptRef<const Math::Transform2D> xf, const Math::fColor& tint);
+        bool UploadCached(CachedGeometry& geom);
+    public:
+
         struct PushStylesScope {
             Canvas& canvas;
             DrawAttributes originalAttr;
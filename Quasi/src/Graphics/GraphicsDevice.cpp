@@ -14,6 +14,8 @@
 
 #include "GLs/Texture.h"
 #include "GLs/GLDebug.h"
+#include "GLs/GLState.h"
+#include "Utils/Debug/Profiler.h"
 
 namespace Quasi::Graphics {
     class RenderData;
@@ -26,6 +28,9 @@ namespace Quasi::Graphics {
     void GraphicsDevice::Quit() {
         DeleteAllRenders(); // delete gl objects
         emptyVAO.Destroy();
+        cameraBuffer.Destroy();
+        gpuTimer.Destroy();
+        drawQueue.Clear();
         glfwSetWindowShouldClose(mainWindow, true);
     }
 
@@ -59,19 +64,29 @@ namespace Quasi::Graphics {
         from.mainWindow = nullptr;
 
         dest.renderOptions = from.renderOptions;
+        dest.cameraBuffer = std::move(from.cameraBuffer);
+        dest.cameraData = from.cameraData;
+        dest.cameraUploaded = from.cameraUploaded;
+        dest.gpuTimer = std::move(from.gpuTimer);
+        dest.drawQueue = std::move(from.drawQueue);
 
         dest.fontDevice = std::move(from.fontDevice);
         dest.ioDevice = std::move(from.ioDevice);
         dest.randDevice = from.randDevice;
+        dest.frameArena = std::move(from.frameArena);
 
         Instance = dest;
     }
 
     void GraphicsDevice::Begin() {
         if (IsClosed()) return;
+        QProfile$("GraphicsDevice::Begin");
 
         frameBeginTime = Debug::Timer::Now();
-        GLDebugContainer::GpuProcessDuration = Debug::Timer::Instant();
+        frameArena.NextFrame();
+        BufferStream::NextFrame();
+        gpuTimer.BeginFrame();
+        gpuTimer.BeginPass("scene");
 
         Render::Clear();
 
@@ -86,10 +101,13 @@ namespace Quasi::Graphics {
         ioDevice.Update();
 
         renderOptions.drawCalls = 0;
+        GLState::ResetStats();
     }
 
     void GraphicsDevice::End() {
         if (IsClosed()) return;
+        QProfile$("GraphicsDevice::End");
+        FlushDraws();
 
         const auto end = Debug::Timer::Now();
         frameDurationTime = end - frameBeginTime;
@@ -102,10 +120,17 @@ namespace Quasi::Graphics {
         glfwPollEvents();
             
 #ifndef Q_NO_IMGUI
+        gpuTimer.BeginPass("imgui");
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        // imgui sets its own state and restores ours with raw gl calls
+        GLState::Invalidate();
 #endif
+        gpuTimer.EndFrame();
 
-        glfwSwapBuffers(mainWindow);
+        {
+            QProfile$("glfwSwapBuffers");
+            glfwSwapBuffers(mainWindow);
+        }
     }
     
     void GraphicsDevice::BindRender(RenderData& render) {
@@ -114,6 +139,7 @@ namespace Quasi::Graphics {
     }
 
     void GraphicsDevice::DeleteRender(u32 index) {
+        drawQueue.Forget(*renders[index]);
         renders[index]->device = nullptr;
         renders.Pop(index);
         for (u32 i = index; i < renders.Length(); ++i)
@@ -121,6 +147,7 @@ namespace Quasi::Graphics {
     }
 
     void GraphicsDevice::DeleteAllRenders() {
+        drawQueue.Clear();
         for (auto& r : renders)
             r->device = nullptr;
         renders.Clear();
@@ -131,27 +158,44 @@ namespace Quasi::Graphics {
     }
 
     void GraphicsDevice::Render(RenderData& r, Shader& s, const ShaderArgs& args, bool setDefaultShaderArgs) {
-        s.Bind();
-        s.SetUniformArgs(args);
-        if (setDefaultShaderArgs) {
-            s.SetUniformMat4x4("u_projection", r.projection);
-            s.SetUniformMat4x4("u_view", r.camera);
-        }
-        Render::Draw(r, s);
-        ++renderOptions.drawCalls;
+        QProfile$("GraphicsDevice::Render");
+        DrawWithArgs(r, s, args.rawBytes, 0, setDefaultShaderArgs);
     }
 
     void GraphicsDevice::RenderInstanced(RenderData& r, int instances, Shader& s, const ShaderArgs& args, bool setDefaultShaderArgs) {
+        QProfile$("GraphicsDevice::RenderInstanced");
+        DrawWithArgs(r, s, args.rawBytes, instances, setDefaultShaderArgs);
+    }
+
+    void GraphicsDevice::DrawWithArgs(RenderData& r, Shader& s, Bytes args, int instances, bool setDefaultShaderArgs) {
         s.Bind();
         s.SetUniformArgs(args);
         if (setDefaultShaderArgs) {
-            s.SetUniformMat4x4("u_projection", r.projection);
-            s.SetUniformMat4x4("u_view", r.camera);
+            if (s.UsesCameraBlock()) SetCamera(r.projection, r.camera);
+            else s.SetCamera(r.projection, r.camera);
         }
-        Render::DrawInstanced(r, s, instances);
+        if (instances) Render::DrawInstanced(r, s, instances);
+        else Render::Draw(r, s);
         ++renderOptions.drawCalls;
     }
 
+    void GraphicsDevice::Submit(RenderData& r, Shader& s, const DrawKey& key, const ShaderArgs& args, int instances, bool setDefaultShaderArgs) {
+        drawQueue.Submit(r, s, key, args, instances, setDefaultShaderArgs);
+    }
+
+    void GraphicsDevice::FlushDraws() {
+        drawQueue.Flush(*this);
+    }
+
+    void GraphicsDevice::SetCamera(const Math::Matrix4x4& projection, const Math::Matrix4x4& view) {
+        const CameraBlock next = { projection, view };
+        if (cameraUploaded && Bytes::BytesOf(cameraData).Equals(Bytes::BytesOf(next))) return;
+        cameraData = next;
+        cameraBuffer.SetData(cameraData);
+        if (!cameraUploaded) cameraBuffer.BindToSlot(Shader::CAMERA_BLOCK_BINDING);
+        cameraUploaded = true;
+    }
+
     void GraphicsDevice::ClearColor(const Math::fColor& color) {
         Render::SetClearColor(color);
     }
@@ -194,10 +238,13 @@ namespace Quasi::Graphics {
 #ifndef Q_NO_IMGUI
         ImGui::Begin("Debug Menu", &ShowDebugMenu);
         const u32 totalUs = Debug::Timer::UnitConvert<Debug::Microsecond>(frameDurationTime),
-                  gpuUs = Debug::Timer::UnitConvert<Debug::Microsecond>(GLDebugContainer::GpuProcessDuration),
-                  cpuUs = totalUs - gpuUs;
-        ImGui::Text("CPU   Time: %d.%03dms", cpuUs   / 1000, cpuUs   % 1000);
-        ImGui::Text("GPU   Time: %d.%03dms", gpuUs   / 1000, gpuUs   % 1000);
+                  gpuUs = Debug::Timer::UnitConvert<Debug::Microsecond>(gpuTimer.FrameTime());
+        ImGui::Text("Frame Time: %d.%03dms", totalUs / 1000, totalUs % 1000);
+        ImGui::Text("GPU   Time: %d.%03dms (%d frames behind)", gpuUs / 1000, gpuUs % 1000, GpuTimer::FRAME_LATENCY);
+        for (const GpuTimer::Pass& pass : gpuTimer.Passes()) {
+            const u32 passUs = Debug::Timer::UnitConvert<Debug::Microsecond>(pass.time);
+            ImGui::Text("    %-8.*s %d.%03dms", (int)pass.name.Length(), pass.name.Data(), passUs / 1000, passUs % 1000);
+        }
         ImGui::Text("Application Averages %.2fms/frame (%.1f FPS)", 1000.0 * ioDevice.DeltaTime(), ioDevice.Framerate());
         ImGui::Text("       Theoretically %.2fms/frame (%.1f FPS)", (float)totalUs / 1000.0f, 1'000'000.0f / (float)totalUs);
 
@@ -266,6 +313,9 @@ namespace Quasi::Graphics {
             }
             ImGui::Text("Total: %d Vertices (bytes), %d Triangles", vCount, tCount);
             ImGui::Text("Draw Calls: %d", renderOptions.drawCalls);
+            ImGui::Text("Queued Draws: %d (%d merged)", drawQueue.LastDrawCount(), drawQueue.LastMergedCount());
+            const GLState::Stats stateChanges = GLState::GetStats();
+            ImGui::Text("State Changes: %d (%d elided)", stateChanges.issued, stateChanges.elided);
             ImGui::EndTabItem();
         }
 
@@ -277,6 +327,7 @@ namespace Quasi::Graphics {
 
     GraphicsDevice GraphicsDevice::Initialize(Math::iv2 winSize, const WindowArgs& windowArgs) {
         InitGLDebugTools();
+        Debug::Profiler::SetThreadName("main");
         /* Initialize the library */
         if (!glfwInit()) {
             GLLogger().QError$("GLFW failed to initialize");
@@ -285,6 +336,9 @@ namespace Quasi::Graphics {
         /* Create a windowed mode window and its OpenGL context */
         glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
         glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+#if Q_GL_CHECKS
+        glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, true);
+#endif
         // glfwWindowHint(GLFW_SAMPLES, 4);
 
         glfwWindowHint(GLFW_RESIZABLE,               windowArgs.resizable);
@@ -333,6 +387,8 @@ namespace Quasi::Graphics {
         }
 
         GLLogger().QInfo$("{}", (const char*)GL::GetString(GL::VERSION));
+        EnableGLDebugOutput();
+        GLState::Invalidate();
 
         Render::EnableBlend();
         Render::UseBlendFunc(BlendFactor::ONE, BlendFactor::INVERT_SRC_ALPHA);
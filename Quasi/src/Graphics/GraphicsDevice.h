@@ -1,11 +1,15 @@
 ﻿#pragma once
 
 #include "RenderObject.h"
+#include "DrawQueue.h"
 #include "Utils/Debug/Timer.h"
 #include "GLs/Render.h"
+#include "GLs/UniformBuffer.h"
+#include "GLs/GpuTimer.h"
 #include "IO/IO.h"
 #include "Utils/Math/Random.h"
 #include "Utils/Box.h"
+#include "Utils/Arena.h"
 #include "Fonts/FontDevice.h"
 
 namespace Quasi::Graphics {
@@ -36,6 +40,13 @@ namespace Quasi::Graphics {
         Vec<RenderHandle> renders;
         VertexArray emptyVAO = VertexArray::New();
 
+        // std140 layout of the Camera block, see Shader::CAMERA_BLOCK_NAME
+        struct CameraBlock {
+            Math::Matrix4x4 projection, view;
+        } cameraData;
+        UniformBuffer cameraBuffer = UniformBuffer::New(sizeof(CameraBlock));
+        bool cameraUploaded = false;
+
         Math::iv2 windowSize;
         GLFWwindow* mainWindow;
 
@@ -49,11 +60,15 @@ namespace Quasi::Graphics {
         FontDevice fontDevice = {};
         IO::IO ioDevice { *this };
         Math::RandomGenerator randDevice {};
+        // scratch memory for the current frame, see Memory::FrameArena
+        Memory::FrameArena frameArena;
 
         friend IO::IO;
 
         Debug::DateTime frameBeginTime;
         Debug::TimeDuration frameDurationTime;
+        GpuTimer gpuTimer;
+        DrawQueue drawQueue;
 
         inline static OptRef<GraphicsDevice> Instance;
         inline static bool ShowDebugMenu = false;
@@ -73,7 +88,8 @@ namespace Quasi::Graphics {
         void Begin();
         void End();
 
-        template <class T> RenderObject<T> CreateNewRender(usize vsize = MAX_VERTEX_COUNT, usize isize = MAX_INDEX_COUNT);
+        // streaming renders are for meshes rebuilt every frame, see RenderData
+        template <class T> RenderObject<T> CreateNewRender(usize vsize = MAX_VERTEX_COUNT, usize isize = MAX_INDEX_COUNT, bool streaming = false);
         void BindRender(RenderData& render);
         void DeleteRender(u32 index);
         void DeleteAllRenders();
@@ -90,6 +106,20 @@ namespace Quasi::Graphics {
             RenderInstanced(GetRender(index), instances, args, setDefaultShaderArgs);
         }
 
+        // queues the draw instead, see DrawQueue. the queue is flushed by End, or earlier with FlushDraws
+        void Submit(RenderData& r, Shader& s, const DrawKey& key, const ShaderArgs& args = {}, int instances = 1, bool setDefaultShaderArgs = true);
+        void Submit(RenderData& r, const DrawKey& key, const ShaderArgs& args = {}, int instances = 1, bool setDefaultShaderArgs = true) {
+            Submit(r, r.shader, key, args, instances, setDefaultShaderArgs);
+        }
+        void FlushDraws();
+    private:
+        // instances is 0 for a plain draw
+        void DrawWithArgs(RenderData& r, Shader& s, Bytes args, int instances, bool setDefaultShaderArgs);
+        friend class DrawQueue;
+    public:
+
+        // uploads the camera block only when it differs from the last one sent
+        void SetCamera(const Math::Matrix4x4& projection, const Math::Matrix4x4& view);
         void ClearColor(const Math::fColor& color);
 
         bool IsClosed() const { return !mainWindow; }
@@ -104,6 +134,10 @@ namespace Quasi::Graphics {
 
         FontDevice& GetFontDevice() { return fontDevice; }
         const FontDevice& GetFontDevice() const { return fontDevice; }
+        Memory::FrameArena& GetFrameArena() { return frameArena; }
+        // every frame starts in the "scene" pass, and imgui is timed as its own
+        void BeginGpuPass(Str name) { gpuTimer.BeginPass(name); }
+        const GpuTimer& GetGpuTimer() const { return gpuTimer; }
 
         void SetDrawMode(RenderMode mode);
         static void RenderInMode(RenderMode mode);
@@ -126,8 +160,8 @@ namespace Quasi::Graphics {
     };
 
     template <class T>
-    RenderObject<T> GraphicsDevice::CreateNewRender(usize vsize, usize isize) {
-        renders.Push(Box<RenderData>::Build(*this, vsize, 3 * isize, sizeof(T), VertexLayoutOf<T>()));
+    RenderObject<T> GraphicsDevice::CreateNewRender(usize vsize, usize isize, bool streaming) {
+        renders.Push(Box<RenderData>::Build(*this, vsize, 3 * isize, sizeof(T), VertexLayoutOf<T>(), streaming));
         BindRender(*renders.Last());
         return *renders.Last();
     }
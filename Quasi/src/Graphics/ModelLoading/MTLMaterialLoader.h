@@ -50,5 +50,6 @@ namespace Quasi::Graphics {
         // String DebugStr() const;
 
         friend class OBJModelLoader;
+        friend class OBJStreamLoader;
     };
 }
@@ -0,0 +1,259 @@
+#include "OBJStreamLoader.h"
+
+#include "Utils/Text.h"
+#include "Utils/Text/Parsing.h"
+
+namespace Quasi::Graphics {
+    Hashing::Hash OBJStreamLoader::Corner::GetHashCode() const {
+        return Hashing::HashCombine(Hashing::HashInt((u32)v | (u64)(u32)t << 32), Hashing::HashInt((u32)n));
+    }
+
+    void OBJStreamLoader::LoadFile(CStr filepath) {
+        Text::SplitDirectory(filepath).TieTo(folder, filename);
+        const String file = Text::ReadFile(filepath).Assert();
+        Load(file);
+    }
+
+    void OBJStreamLoader::Load(Str string) {
+        SplitChunks(string);
+        ForEachChunk(chunks.Length(), 1, [&] (usize begin, usize end) {
+            for (usize i = begin; i < end; ++i) ParseChunk(chunks[i]);
+        });
+        JoinChunks();
+        CollectObjects();
+
+        const usize firstObject = model.objects.Length();
+        for (const ObjectRange& range : objectRanges) {
+            OBJObject& object = model.objects.Push({});
+            object.model = &model;
+            object.name = range.name;
+            object.materialIndex = range.materialIndex;
+            object.smoothShading = range.smoothShading;
+        }
+        ForEachChunk(objectRanges.Length(), 1, [&] (usize begin, usize end) {
+            for (usize i = begin; i < end; ++i) BuildMesh(model.objects[firstObject + i], objectRanges[i]);
+        });
+
+        chunks.Clear();
+        positions.Clear(); texCoords.Clear(); normals.Clear();
+        corners.Clear();
+        objectRanges.Clear();
+    }
+
+    void OBJStreamLoader::LoadMaterialFile(CStr filepath) {
+        const usize len = folder.Length() + filepath.Length() + 2;
+        char* fullpath = Memory::QAlloca$(char, len),
+            * acc = fullpath;
+
+        Memory::MemCopy(acc, folder.Data(), folder.Length()); acc += folder.Length();
+        *acc++ = '\\';
+        Memory::MemCopy(acc, filepath.Data(), filepath.Length());
+        acc[filepath.Length()] = '\0';
+
+        mats.LoadFile(CStr::SliceUnchecked(fullpath, len));
+        model.materials = std::move(mats.materials);
+    }
+
+    OBJModel&& OBJStreamLoader::RetrieveModel() {
+        return std::move(model);
+    }
+
+    void OBJStreamLoader::SplitChunks(Str string) {
+        chunks.Clear();
+        while (string) {
+            usize end = std::min(CHUNK_SIZE, string.Length());
+            // extend the chunk to the end of the line it stops in
+            if (const OptionUsize newline = string.Skip(end).Find('\n'))
+                end += *newline + 1;
+            else end = string.Length();
+            chunks.Push({ .text = string.First(end) });
+            string.Advance(end);
+        }
+    }
+
+    static bool IsBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+    static Str NextToken(Str& line) {
+        usize begin = 0;
+        while (begin < line.Length() && IsBlank(line[begin])) ++begin;
+        usize end = begin;
+        while (end < line.Length() && !IsBlank(line[end])) ++end;
+        const Str token = line.Substr(begin, end - begin);
+        line.Advance(end);
+        return token;
+    }
+
+    static float NextFloat(Str& line) {
+        return Text::Parse<float>(NextToken(line)).UnwrapOr(f32s::NAN);
+    }
+
+    // parses one v/vt/vn index, turning negative ones into an offset from the start of the chunk
+    static int ParseIndex(Str index, usize countInChunk, u32 bit, u32& relativeMask) {
+        if (!index) return 0;
+        const int i = Text::Parse<int>(index).UnwrapOr(0);
+        if (i >= 0) return i;
+        relativeMask |= bit;
+        return (int)countInChunk + i;
+    }
+
+    void OBJStreamLoader::ParseChunk(Chunk& chunk) {
+        Str text = chunk.text;
+        while (text) {
+            const usize lineEnd = text.Find('\n').UnwrapOr(text.Length());
+            Str line = text.First(lineEnd);
+            text.Advance(std::min(lineEnd + 1, text.Length()));
+
+            const Str prefix = NextToken(line);
+            if (!prefix || prefix.Length() > 8) continue;
+            switch (Memory::ReadZeroExtU64Big(prefix.Data(), prefix.Length())) {
+                case "v"_u64: {
+                    const float x = NextFloat(line), y = NextFloat(line), z = NextFloat(line);
+                    chunk.positions.Push({ x, y, z });
+                } break;
+                case "vt"_u64: {
+                    const float u = NextFloat(line), v = NextFloat(line);
+                    chunk.texCoords.Push({ u, v });
+                } break;
+                case "vn"_u64: {
+                    const float x = NextFloat(line), y = NextFloat(line), z = NextFloat(line);
+                    chunk.normals.Push({ x, y, z });
+                } break;
+                case "f"_u64: {
+                    // polygons are split into a fan of triangles around the first corner
+                    Corner first {}, prev {};
+                    u32 firstMask = 0, prevMask = 0, count = 0;
+                    for (Str token = NextToken(line); token; token = NextToken(line), ++count) {
+                        const usize slash1 = token.Find('/').UnwrapOr(token.Length());
+                        const Str vs = token.First(slash1);
+                        Str rest = token.Skip(std::min(slash1 + 1, token.Length()));
+                        const usize slash2 = rest.Find('/').UnwrapOr(rest.Length());
+                        const Str ts = rest.First(slash2), ns = rest.Skip(std::min(slash2 + 1, rest.Length()));
+
+                        u32 mask = 0;
+                        const Corner corner = {
+                            ParseIndex(vs, chunk.positions.Length(), 1, mask),
+                            ParseIndex(ts, chunk.texCoords.Length(), 2, mask),
+                            ParseIndex(ns, chunk.normals.Length(),   4, mask),
+                        };
+
+                        if (count >= 2) {
+                            const Corner tri[3] = { first, prev, corner };
+                            const u32 masks[3] = { firstMask, prevMask, mask };
+                            for (u32 k = 0; k < 3; ++k) {
+                                if (masks[k]) chunk.relativeCorners.Push({ chunk.corners.Length(), masks[k] });
+                                chunk.corners.Push(tri[k]);
+                            }
+                        }
+                        if (count == 0) { first = corner; firstMask = mask; }
+                        prev = corner; prevMask = mask;
+                    }
+                } break;
+                case "o"_u64:      chunk.directives.Push({ Directive::OBJECT,       line.Trim(), chunk.corners.Length() }); break;
+                case "s"_u64:      chunk.directives.Push({ Directive::SMOOTH_SHADE, line.Trim(), chunk.corners.Length() }); break;
+                case "usemtl"_u64: chunk.directives.Push({ Directive::USE_MATERIAL, line.Trim(), chunk.corners.Length() }); break;
+                case "mtllib"_u64: chunk.directives.Push({ Directive::MATERIAL_LIB, line.Trim(), chunk.corners.Length() }); break;
+                default:;
+            }
+        }
+    }
+
+    void OBJStreamLoader::JoinChunks() {
+        usize positionCount = 0, texCoordCount = 0, normalCount = 0, cornerCount = 0;
+        for (Chunk& chunk : chunks) {
+            chunk.positionBase = positionCount; positionCount += chunk.positions.Length();
+            chunk.texCoordBase = texCoordCount; texCoordCount += chunk.texCoords.Length();
+            chunk.normalBase   = normalCount;   normalCount   += chunk.normals  .Length();
+            chunk.cornerBase   = cornerCount;   cornerCount   += chunk.corners  .Length();
+        }
+
+        positions.Resize(positionCount);
+        texCoords.Resize(texCoordCount);
+        normals  .Resize(normalCount);
+        corners  .Resize(cornerCount);
+
+        ForEachChunk(chunks.Length(), 1, [&] (usize begin, usize end) {
+            for (usize i = begin; i < end; ++i) {
+                Chunk& chunk = chunks[i];
+                for (const RelativeCorner& rel : chunk.relativeCorners) {
+                    Corner& c = chunk.corners[rel.corner];
+                    if (rel.mask & 1) c.v += (int)chunk.positionBase + 1;
+                    if (rel.mask & 2) c.t += (int)chunk.texCoordBase + 1;
+                    if (rel.mask & 4) c.n += (int)chunk.normalBase   + 1;
+                }
+
+                Memory::MemCopy(positions.Data() + chunk.positionBase, chunk.positions.Data(), chunk.positions.ByteSize());
+                Memory::MemCopy(texCoords.Data() + chunk.texCoordBase, chunk.texCoords.Data(), chunk.texCoords.ByteSize());
+                Memory::MemCopy(normals  .Data() + chunk.normalBase,   chunk.normals  .Data(), chunk.normals  .ByteSize());
+                Memory::MemCopy(corners  .Data() + chunk.cornerBase,   chunk.corners  .Data(), chunk.corners  .ByteSize());
+
+                chunk.positions.Clear(); chunk.texCoords.Clear(); chunk.normals.Clear();
+                chunk.corners.Clear();
+            }
+        });
+    }
+
+    void OBJStreamLoader::CollectObjects() {
+        // faces before the first object still get one, unlike in OBJModelLoader
+        objectRanges.Clear();
+        objectRanges.Push({ .name = {}, .begin = 0, .end = corners.Length() });
+        for (const Chunk& chunk : chunks) {
+            for (const Directive& d : chunk.directives) {
+                ObjectRange& current = objectRanges.Last();
+                const usize at = chunk.cornerBase + d.corner;
+                switch (d.kind) {
+                    case Directive::OBJECT:
+                        current.end = at;
+                        // an object without faces is dropped, unless it already got them
+                        if (current.begin == current.end) objectRanges.Pop();
+                        objectRanges.Push({ .name = d.arg, .begin = at, .end = corners.Length() });
+                        break;
+                    case Directive::USE_MATERIAL: {
+                        const OptionUsize i = model.materials.FindIf(
+                            [&](const MTLMaterial& m) { return m.name == d.arg; }
+                        );
+                        if (i) current.materialIndex = (int)*i;
+                    } break;
+                    case Directive::SMOOTH_SHADE:
+                        current.smoothShading = d.arg != "0" && d.arg != "off";
+                        break;
+                    case Directive::MATERIAL_LIB: {
+                        String mtllibdir = d.arg;
+                        mtllibdir.AddNullTerm();
+                        LoadMaterialFile(CStr::FromUnchecked(mtllibdir));
+                    } break;
+                }
+            }
+        }
+        if (objectRanges.Last().begin == objectRanges.Last().end) objectRanges.Pop();
+    }
+
+    void OBJStreamLoader::BuildMesh(OBJObject& object, const ObjectRange& range) const {
+        const Span<const Corner> faces = corners.Subspan(range.begin, range.end - range.begin);
+        Vec<OBJVertex>& vertices = object.mesh.vertices;
+        Vec<Triplet>& indices = object.mesh.indices;
+        indices.Reserve(faces.Length() / 3);
+
+        // stores the index + 1, so that a new entry starts out as 0
+        auto lookup = HashMap<Corner, u32>::WithCap(faces.Length() / 2);
+        u32 tri[3];
+        for (usize i = 0; i < faces.Length(); ++i) {
+            const Corner& c = faces[i];
+            u32& slot = lookup[c];
+            if (!slot) {
+                vertices.Push(OBJVertex {
+                    0 < c.v && c.v <= (int)positions.Length() ? positions[c.v - 1] : Math::fv3 {},
+                    0 < c.t && c.t <= (int)texCoords.Length() ? texCoords[c.t - 1] : Math::fv2 {},
+                    0 < c.n && c.n <= (int)normals  .Length() ? normals  [c.n - 1] : Math::fv3 {},
+                });
+                slot = (u32)vertices.Length();
+            }
+            tri[i % 3] = slot - 1;
+            if (i % 3 == 2) indices.Push({ tri[0], tri[1], tri[2] });
+        }
+    }
+
+    void OBJStreamLoader::ForEachChunk(usize count, usize grainSize, Fn<void, usize, usize> auto&& body) {
+        if (jobSystem) jobSystem->ParallelFor(count, grainSize, body);
+        else body(0, count);
+    }
+}
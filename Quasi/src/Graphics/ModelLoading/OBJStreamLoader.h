@@ -0,0 +1,100 @@
+#pragma once
+
+#include "MTLMaterialLoader.h"
+#include "OBJModel.h"
+
+#include "Utils/HashMap.h"
+#include "Utils/JobSystem.h"
+#include "Utils/Math/Vector.h"
+
+namespace Quasi::Graphics {
+    // a loader for large obj files. the file is split into chunks at line boundaries, which are parsed
+    // in parallel straight into position, texcoord and normal arrays. the faces of each object are then
+    // resolved by hashing their v/vt/vn triples, also one object per job.
+    // OBJModelLoader parses the same files, and is kept as the simpler reference implementation.
+    // --verify checks that both make the same objects, but on purpose they differ in that this one
+    // - keeps vertices in the order they're first used, where OBJModelLoader sorts them by their v/vt/vn triple,
+    //   so the indices differ even though every triangle ends up with the same vertices
+    // - splits polygons into a fan of triangles, instead of keeping only the first three corners
+    // - resolves negative (relative) indices
+    // - reads v, vt and vn lines, and faces, that come before the first o line, and puts those faces in an unnamed object
+    // - drops objects without faces
+    // - takes "s off" as off
+    class OBJStreamLoader {
+    public:
+        static constexpr usize CHUNK_SIZE = 1 << 20;
+
+        // 1-based indices into the whole file, 0 if not given
+        struct Corner {
+            int v, t, n;
+
+            bool operator==(const Corner&) const = default;
+            Hashing::Hash GetHashCode() const;
+        };
+    private:
+        // o, usemtl, s and mtllib lines, applying from the given corner onwards
+        struct Directive {
+            enum Kind { OBJECT, USE_MATERIAL, SMOOTH_SHADE, MATERIAL_LIB } kind;
+            Str arg;
+            usize corner;
+        };
+
+        // negative indices are relative to the vertices before them,
+        // so they're stored as an offset in the chunk until the chunks are joined
+        struct RelativeCorner {
+            usize corner;
+            u32 mask; // bit 0: v, bit 1: t, bit 2: n
+        };
+
+        struct Chunk {
+            Str text;
+            Vec<Math::fv3> positions, normals;
+            Vec<Math::fv2> texCoords;
+            Vec<Corner> corners; // 3 per triangle
+            Vec<RelativeCorner> relativeCorners;
+            Vec<Directive> directives;
+            usize positionBase = 0, texCoordBase = 0, normalBase = 0, cornerBase = 0;
+        };
+
+        struct ObjectRange {
+            Str name;
+            usize begin, end;
+            int materialIndex = -1;
+            bool smoothShading = false;
+        };
+
+        Vec<Chunk> chunks;
+        Vec<Math::fv3> positions, normals;
+        Vec<Math::fv2> texCoords;
+        Vec<Corner> corners;
+        Vec<ObjectRange> objectRanges;
+
+        MTLMaterialLoader mats;
+        OBJModel model;
+
+        String folder, filename;
+    public:
+        OptRef<JobSystem> jobSystem = nullptr;
+
+        OBJStreamLoader() = default;
+        explicit OBJStreamLoader(OptRef<JobSystem> jobs) : jobSystem(jobs) {}
+
+        void LoadFile(CStr filepath);
+        // the string must stay alive until loading is done
+        void Load(Str string);
+        void LoadMaterialFile(CStr filepath);
+
+        OBJModel& GetModel() { return model; }
+        const OBJModel& GetModel() const { return model; }
+
+        OBJModel&& RetrieveModel();
+    private:
+        void SplitChunks(Str string);
+        static void ParseChunk(Chunk& chunk);
+        void JoinChunks();
+        void CollectObjects();
+        void BuildMesh(OBJObject& object, const ObjectRange& range) const;
+
+        void ForEachChunk(usize count, usize grainSize, Fn<void, usize, usize> auto&& body);
+    };
+}
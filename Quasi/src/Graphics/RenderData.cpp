@@ -14,6 +14,8 @@ namespace Quasi::Graphics {
 		dest.indexData = std::move(from.indexData);
 		dest.vertexOffset = from.vertexOffset;
 		dest.indexOffset = from.indexOffset;
+		dest.vertexDest = from.vertexDest;
+		dest.indexDest = from.indexDest;
 
 		dest.device = from.device;
 		from.device = nullptr;
@@ -25,10 +27,17 @@ namespace Quasi::Graphics {
 		Destroy();
 	}
 
+	void RenderData::UpdateDestinations() {
+		const Span<byte> vertexRegion = vbo.MappedBatch();
+		const Span<u32>  indexRegion  = ibo.MappedBatch();
+		vertexDest = vertexRegion.IsEmpty() ? vertexData.AsSpanMut() : vertexRegion;
+		indexDest  = indexRegion .IsEmpty() ? indexData .AsSpanMut() : indexRegion;
+	}
+
 	void RenderData::PushIndex(Triplet index) {
-		indexData[indexOffset + 0] = index.i;
-		indexData[indexOffset + 1] = index.j;
-		indexData[indexOffset + 2] = index.k;
+		indexDest[indexOffset + 0] = index.i;
+		indexDest[indexOffset + 1] = index.j;
+		indexDest[indexOffset + 2] = index.k;
 		indexOffset += 3;
 	}
 
@@ -50,14 +59,24 @@ namespace Quasi::Graphics {
 		ibo.Unbind();
 	}
 
+	void RenderData::BufferUnload(u32 vertexBytes, u32 indexCount) {
+		// the whole mesh has to fit in the batch, since it may be written straight into it.
+		// reserving more would make every later batch of the frame look like it doesnt fit and take a new region
+		vbo.ClearData(vertexBytes);
+		ibo.ClearData(indexCount);
+		// streaming buffers are on a new batch now
+		UpdateDestinations();
+	}
+
 	void RenderData::BufferUnload() {
-		vbo.ClearData();
-		ibo.ClearData();
+		BufferUnload(vbo.GetLength(), ibo.GetLength());
 	}
 
 	void RenderData::BufferLoad() {
-		vbo.AddDataBytes(vertexData.First(vertexOffset));
-		ibo.AddData     (indexData .First(indexOffset));
+		if (vertexData) vbo.AddDataBytes(vertexData.First(vertexOffset));
+		else            vbo.SetUsedLength((u32)vertexOffset);
+		if (indexData)  ibo.AddData     (indexData .First(indexOffset));
+		else            ibo.SetUsedLength((u32)indexOffset);
 	}
 
 	void RenderData::Clear() {
@@ -73,6 +92,10 @@ namespace Quasi::Graphics {
 		device->RenderInstanced(*this, instances, replaceShader, args, setDefaultShaderArgs);
 	}
 
+	void RenderData::Submit(Shader& replaceShader, const DrawKey& key, const ShaderArgs& args, int instances, bool setDefaultShaderArgs) {
+		device->Submit(*this, replaceShader, key, args, instances, setDefaultShaderArgs);
+	}
+
 	void RenderData::Destroy() {
 		if (device) {
 			OptRef prev = device; // prevent infinte loop: deleterender -> erase renderdata -> destructor
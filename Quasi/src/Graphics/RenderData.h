@@ -5,6 +5,7 @@
 #include "GLs/IndexBuffer.h"
 #include "GLs/Shader.h"
 #include "GLs/VertexElement.h"
+#include "DrawQueue.h"
 
 namespace Quasi::Graphics {
 	class FrameBuffer;
@@ -28,21 +29,30 @@ namespace Quasi::Graphics {
 	    Math::Matrix3D camera {};
 	    Shader shader = {}; // shader can be null if renderId is 0
 
+		// staging for buffers that arent mapped, BufferLoad uploads them
 		ArrayBox<byte> vertexData;
 		usize vertexOffset = 0;
 		ArrayBox<u32> indexData;
 		usize indexOffset = 0;
+		// where vertices and indices are written, the mapped batches of streaming buffers if they are, otherwise the staging
+		Span<byte> vertexDest;
+		Span<u32> indexDest;
 
 		OptRef<GraphicsDevice> device;
 		usize deviceIndex = 0;
 
 		friend class GraphicsDevice;
 
-		explicit RenderData(GraphicsDevice& gd, usize vsize, usize isize, usize vertSize, const VertexBufferLayout& layout) :
-			varray(VertexArray::New()), vbo(VertexBuffer::New(vsize * vertSize)), ibo(IndexBuffer::New(isize)),
-			vertexData(ArrayBox<byte>::AllocateUninit(vsize * vertSize)), indexData(ArrayBox<u32>::AllocateUninit(isize)), device(gd) {
+		// streaming is for meshes that are rebuilt every frame, it keeps REGION_COUNT copies of the buffers, see BufferStream
+		explicit RenderData(GraphicsDevice& gd, usize vsize, usize isize, usize vertSize, const VertexBufferLayout& layout, bool streaming = false) :
+			varray(VertexArray::New()),
+			vbo(streaming ? VertexBuffer::NewStreaming(vsize * vertSize, vertSize) : VertexBuffer::New(vsize * vertSize)),
+			ibo(streaming ? IndexBuffer::NewStreaming(isize) : IndexBuffer::New(isize)), device(gd) {
 			varray.Bind();
 			varray.AddBuffer(layout);
+			if (vbo.MappedBatch().IsEmpty()) vertexData = ArrayBox<byte>::AllocateUninit(vsize * vertSize);
+			if (ibo.MappedBatch().IsEmpty()) indexData = ArrayBox<u32>::AllocateUninit(isize);
+			UpdateDestinations();
 		}
 
 		RenderData(const RenderData&) = delete;
@@ -53,6 +63,9 @@ namespace Quasi::Graphics {
 		RenderData& operator=(RenderData&& rd) noexcept { Transfer(*this, std::move(rd)); return *this; }
 
 		~RenderData();
+	private:
+		void UpdateDestinations();
+	public:
 
 		template <class T> void PushVertex(const T& vertex);
 		void PushIndex(Triplet index);
@@ -61,17 +74,21 @@ namespace Quasi::Graphics {
 		void Bind() const;
 		void Unbind() const;
 
+		// starts a new batch with room for vertexBytes and indexCount, which get written straight into it when mapped.
+		// without them the batch reserves the whole buffer, since what is added afterwards isnt known yet
+		void BufferUnload(u32 vertexBytes, u32 indexCount);
 		void BufferUnload();
 		void BufferLoad();
 
 		void Clear();
 		template <class T>
 		void Add(const Mesh<T>& mesh) {
-			Memory::MemCopy(vertexData.Data() + vertexOffset, mesh.vertices.Data(), mesh.vertices.ByteSize());
-			Memory::MemCopy(indexData.Data()  + indexOffset,  mesh.indices.Data(),  mesh.indices.ByteSize());
-			// increment indices
-			for (usize i = 0; i < mesh.indices.Length() * 3; ++i) {
-				indexData[indexOffset + i] += vertexOffset / sizeof(T);
+			Memory::MemCopy(vertexDest.Data() + vertexOffset, mesh.vertices.Data(), mesh.vertices.ByteSize());
+			// offset while copying, mapped memory is write-combined and shouldnt be read back
+			const Span<const u32> indices = mesh.indices.AsSpan().template Transmute<u32>();
+			const u32 indexBase = vertexOffset / sizeof(T);
+			for (usize i = 0; i < indices.Length(); ++i) {
+				indexDest[indexOffset + i] = indices[i] + indexBase;
 			}
 			vertexOffset += mesh.vertices.ByteSize();
 			indexOffset  += mesh.indices.Length() * 3;
@@ -85,6 +102,9 @@ namespace Quasi::Graphics {
 		void RenderInstanced(Shader& replaceShader, int instances, const ShaderArgs& args = {}, bool setDefaultShaderArgs = true);
 		void RenderInstanced(int instances, const ShaderArgs& args = {}, bool setDefaultShaderArgs = true) { RenderInstanced(shader, instances, args, setDefaultShaderArgs); }
 
+		void Submit(Shader& replaceShader, const DrawKey& key, const ShaderArgs& args = {}, int instances = 1, bool setDefaultShaderArgs = true);
+		void Submit(const DrawKey& key, const ShaderArgs& args = {}, int instances = 1, bool setDefaultShaderArgs = true) { Submit(shader, key, args, instances, setDefaultShaderArgs); }
+
 		friend class GraphicsDevice;
 		template <IVertex T> friend class Mesh;
 		template <class T> friend class RenderObject;
@@ -92,7 +112,7 @@ namespace Quasi::Graphics {
 
 	template <class T> void RenderData::PushVertex(const T& vertex) {
 		const byte* rawbytes = Memory::TransmutePtr<const byte>(&vertex);
-		Memory::MemCopyNoOverlap(&vertexData[vertexOffset], rawbytes, sizeof(T));
+		Memory::MemCopyNoOverlap(&vertexDest[vertexOffset], rawbytes, sizeof(T));
 		vertexOffset += sizeof(T);
 	}
 }
@@ -50,6 +50,8 @@ namespace Quasi::Graphics {
 		void DrawInstanced(Span<const Mesh<T>> meshes, int instances, const DrawOptions& options = {});
 
     	void BeginContext() { rd->BufferUnload(); rd->Clear(); }
+    	// only reserves as much of a streaming buffer as the meshes take up
+    	void BeginContext(u32 vertexBytes, u32 indexCount) { rd->BufferUnload(vertexBytes, indexCount); rd->Clear(); }
     	void AddMesh(const Mesh<T>& mesh) {
     		rd->Add(mesh);
     	}
@@ -65,6 +67,13 @@ namespace Quasi::Graphics {
     	void DrawContextInstanced(int instances, const DrawOptions& options = {}) {
     		rd->RenderInstanced(Memory::AsMut(options.shader.UnwrapOr(rd->shader)), instances, options.arguments, options.useDefaultArguments);
     	}
+    	// deferred until the device flushes its DrawQueue, so the context has to stay as is until then
+    	void SubmitContext(const DrawKey& key, const DrawOptions& options = {}) {
+    		rd->Submit(Memory::AsMut(options.shader.UnwrapOr(rd->shader)), key, options.arguments, 1, options.useDefaultArguments);
+    	}
+    	void SubmitContextInstanced(int instances, const DrawKey& key, const DrawOptions& options = {}) {
+    		rd->Submit(Memory::AsMut(options.shader.UnwrapOr(rd->shader)), key, options.arguments, instances, options.useDefaultArguments);
+    	}
 
 		void Destroy() { rd->Destroy(); }
 
@@ -75,32 +84,43 @@ namespace Quasi::Graphics {
 	    void UseShaderFromFile(CStr file) { rd->shader = Shader::FromFile(file); }
 	    void UseShaderFromFile(CStr vert, CStr frag, CStr geom = {})
     	{ rd->shader = Shader::FromFile(vert, frag, geom); }
+    private:
+    	static const Mesh<T>& Deref(const Mesh<T>& m) { return m; }
+    	static const Mesh<T>& Deref(const Mesh<T>* m) { return *m; }
+    	void BeginContextFor(const auto& meshes) {
+    		usize vertexBytes = 0, indexCount = 0;
+    		for (const auto& m : meshes) {
+    			vertexBytes += Deref(m).vertices.ByteSize();
+    			indexCount  += Deref(m).indices.Length() * 3;
+    		}
+    		BeginContext((u32)vertexBytes, (u32)indexCount);
+    	}
     };
 
     template <class T>
 	void RenderObject<T>::Draw(Span<const Mesh<T>* const> meshes, const DrawOptions& options) {
-	    BeginContext();
+	    BeginContextFor(meshes);
     	for (auto* m : meshes) rd->Add(*m);
     	EndContext();
     	DrawContext(options);
     }
 	template <class T>
 	void RenderObject<T>::Draw(Span<const Mesh<T>> meshes, const DrawOptions& options) {
-    	BeginContext();
+    	BeginContextFor(meshes);
     	for (auto& m : meshes) rd->Add(m);
     	EndContext();
     	DrawContext(options);
     }
     template <class T>
 	void RenderObject<T>::DrawInstanced(Span<const Mesh<T>* const> meshes, int instances, const DrawOptions& options) {
-    	BeginContext();
+    	BeginContextFor(meshes);
     	for (auto* m : meshes) rd->Add(*m);
     	EndContext();
     	DrawContextInstanced(instances, options);
     }
 	template <class T>
 	void RenderObject<T>::DrawInstanced(Span<const Mesh<T>> meshes, int instances, const DrawOptions& options) {
-    	BeginContext();
+    	BeginContextFor(meshes);
     	for (auto& m : meshes) rd->Add(m);
     	EndContext();
     	DrawContextInstanced(instances, options);
@@ -4,13 +4,13 @@
 
 namespace Quasi::Graphics {
     TextureAtlas::TextureAtlas(Span<ImageView> sprites, bool pixelated, int padding) {
-        sprites.SortByKey([] (const ImageView& sprite) { return sprite.height; });
+        sprites.SortRadixByKey([] (const ImageView& sprite) { return sprite.height; });
         PackSprites(sprites, pixelated, padding);
     }
 
     TextureAtlas::TextureAtlas(Span<ImageView> sprites, Span<const Str> spriteNames, bool pixelated, int padding) {
         Vec<u32> indices = Vecs::Range<u32>(0, sprites.Length());
-        indices.SortByKey([&] (u32 i) { return sprites[i].height; });
+        indices.SortRadixByKey([&] (u32 i) { return sprites[i].height; });
         Algorithm::ApplyRevPermutationInPlace(sprites.AsSpan(), indices.AsSpan());
 
         spriteLookup.Reserve(spriteNames.Length());
@@ -11,7 +11,8 @@ namespace Quasi::Graphics {
     class TextureAtlas {
         Texture2D fullTexture;
         Vec<Math::iRect2D> spritesheet;
-        HashMap<String, u32> spriteLookup;
+        // looked up by Str on every sprite fetch, which is where group probing wins most
+        HashMap<String, u32, Hashing::DefaultHasher, HashTables::Layout::SWISS> spriteLookup;
     public:
         TextureAtlas() = default;
         TextureAtlas(Span<ImageView> sprites, bool pixelated = false, int padding = 1);
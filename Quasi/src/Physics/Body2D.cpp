@@ -1,10 +1,12 @@
 #include "Body2D.h"
 
 #include "Collision2D.h"
+#include "World2D.h"
 
 namespace Quasi::Physics2D {
     void Body::AddMomentum(const fv2& newtonSeconds) {
         velocity += newtonSeconds * invMass;
+        WakeUp();
     }
 
     // void Body::AddForce(const fv2& newton) {
@@ -13,6 +15,7 @@ namespace Quasi::Physics2D {
 
     void Body::AddAngularMomentum(float angMomentum) {
         angularVelocity += angMomentum * invInertia;
+        WakeUp();
     }
 
     // void Body::AddTorque(float torque) {
@@ -33,6 +36,7 @@ namespace Quasi::Physics2D {
         invInertia = inertia > 0 ? 1 / inertia : 0;
         mass = newMass;
         invMass = mass > 0 ? 1 / mass : 0;
+        WakeUp();
     }
 
     Manifold Body::CollideWith(const Body& target) const {
@@ -56,12 +60,22 @@ namespace Quasi::Physics2D {
     }
 
     void Body::Update(float dt) {
+        Integrate(dt);
+        SyncBroadphase();
+    }
+
+    void Body::Integrate(float dt) {
         position += velocity * dt;
         rotation += Radians(angularVelocity * dt);
-        TryUpdateTransforms();
+        UpdateBoundingBox();
     }
 
     void Body::TryUpdateTransforms() {
+        UpdateBoundingBox();
+        SyncBroadphase();
+    }
+
+    void Body::UpdateBoundingBox() {
         if (shapeHasChanged) {
             baseBoundingBox = shape.ComputeBoundingBox();
             inertia = shape.Inertia() * mass;
@@ -77,8 +91,27 @@ namespace Quasi::Physics2D {
         boundingBox = { c - diff, c + diff };
     }
 
+    void Body::SyncBroadphase() {
+        // only reinserts into the tree once the body escapes its fat box
+        if (proxyID != DynamicTree::NULL_NODE)
+            world->broadphaseTree.MoveProxy(proxyID, boundingBox);
+    }
+
     void Body::SetShapeHasChanged() {
         shapeHasChanged = true;
+        WakeUp();
+    }
+
+    void Body::WakeUp() {
+        if (awake) return;
+        Body* b = this;
+        do {
+            Body* next = b->nextInIsland;
+            b->awake = true;
+            b->sleepTime = 0;
+            b->nextInIsland = nullptr;
+            b = next;
+        } while (b && b != this);
     }
 
     void Body::SetTrigger(TriggerFn t) {
@@ -1,5 +1,6 @@
 #pragma once
 #include "Collision2D.h"
+#include "DynamicTree2D.h"
 
 #include "Shape2D.h"
 #include "Utils/Math/Vector.h"
@@ -36,6 +37,12 @@ namespace Quasi::Physics2D {
         BodyType type = BodyType::NONE;
         bool enabled = true;
         bool shapeHasChanged = true;
+        bool awake = true;
+        float sleepTime = 0; // how long the body has been under the world's sleep thresholds
+        u32 id = 0; // unique within its world, used to order things deterministically
+        u32 proxyID = DynamicTree::NULL_NODE;
+        u32 islandIndex = 0;
+        Body* nextInIsland = nullptr; // sleeping bodies are linked in a ring with the rest of their island
 
         Shape shape;
         Ref<World> world;
@@ -45,9 +52,13 @@ namespace Quasi::Physics2D {
             : position(p), rotation(r), mass(m), invMass(m > 0 ? 1 / m : 0), type(type), shape(std::move(shape)),
               world(world) { TryUpdateTransforms(); }
 
-        void AddVelocity       (const fv2& vel) { velocity += vel; }
+        void SetPosition       (const fv2& pos) { position = pos; WakeUp(); }
+        void SetVelocity       (const fv2& vel) { velocity = vel; WakeUp(); }
+        void SetAngularVelocity(float angVel) { angularVelocity = angVel; WakeUp(); }
+
+        void AddVelocity       (const fv2& vel) { velocity += vel; WakeUp(); }
         void AddMomentum       (const fv2& newtonSeconds);
-        void AddAngularVelocity(float angVel) { angularVelocity += angVel; }
+        void AddAngularVelocity(float angVel) { angularVelocity += angVel; WakeUp(); }
         void AddAngularMomentum(float angMomentum);
 
         void AddRelativeVelocity(const fv2& relPosition, const fv2& vel);
@@ -64,7 +75,11 @@ namespace Quasi::Physics2D {
         Pose2D GetTransform() const;
 
         void Update(float dt);
+        // same as Update, but leaves the broadphase alone so that bodies can be integrated in parallel
+        void Integrate(float dt);
         void TryUpdateTransforms();
+        void UpdateBoundingBox();
+        void SyncBroadphase();
         void SetShapeHasChanged();
 
         void SetTrigger(TriggerFn t);
@@ -73,14 +88,16 @@ namespace Quasi::Physics2D {
         bool IsStatic()  const { return type == BodyType::STATIC; }
         bool IsDynamic() const { return type == BodyType::DYNAMIC; }
 
-        void Enable()  { enabled = true; }
+        void Enable()  { enabled = true; WakeUp(); }
         void Disable() { enabled = false; }
 
+        bool IsAwake() const { return awake; }
+        // wakes this body along with the rest of its sleeping island
+        void WakeUp();
+
         fRect2D BoundingBox() const;
 
         friend class World;
-        friend void StaticResolve (Body&, Body&, const Manifold&);
-        friend void DynamicResolve(Body&, Body&, const Manifold&);
     };
 
     struct BodyCreateOptions {
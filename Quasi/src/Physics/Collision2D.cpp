@@ -2,7 +2,6 @@
 
 #include "Body2D.h"
 #include "SeperatingAxisSolver.h"
-#include "Utils/Debug/Logger.h"
 #include "Utils/Math/Geometry.h"
 
 namespace Quasi::Physics2D {
@@ -104,7 +103,7 @@ namespace Quasi::Physics2D {
         const fv2 n = (xf2.pos - xf1.pos) / distsq;
         return Manifold {
             .seperatingNormal = n,
-            .contactPoint = { xf1.pos - n * s2.radius },
+            .contactPoint = { xf1.pos + n * s1.radius },
             .contactDepth = { s1.radius + s2.radius - distsq },
             .contactCount = 1,
         };
@@ -275,200 +274,4 @@ namespace Quasi::Physics2D {
 
         return sat.Collides();
     }
-
-    void StaticResolve(Body& body, Body& target, const Manifold& manifold) {
-        // if (manifold.flipped)
-        //     std::swap(body, target);
-        const bool bodyDyn   = body.IsDynamic(),
-                   targetDyn = target.IsDynamic(),
-                   shareForce = bodyDyn && targetDyn;
-        fv2 sep = manifold.seperatingNormal;
-        switch (manifold.contactCount) {
-            case 0: return;
-            case 1: {
-                sep *= shareForce ? 0.5f * manifold.contactDepth[0] : manifold.contactDepth[0];
-                if (bodyDyn)
-                    body.position -= sep;
-                if (targetDyn)
-                    target.position += sep;
-                break;
-            }
-            case 2: {
-                const float depth = std::max(manifold.contactDepth[0], manifold.contactDepth[1]);
-                sep *= shareForce ? 0.5f * depth : depth;
-                if (bodyDyn)
-                    body.position -= sep;
-                if (targetDyn)
-                    target.position += sep;
-                break;
-            }
-            default:;
-        }
-    }
-
-    void DynamicResolve(Body& body, Body& target, const Manifold& manifold) {
-        constexpr auto TAG = [] (const u32 ccount, bool bdyn, bool tdyn) constexpr -> u32 {
-            return ccount << 2 |
-                   bdyn << 1 |
-                   tdyn;
-        };
-
-        switch (TAG(manifold.contactCount, body.IsDynamic(), target.IsDynamic())) {
-            case TAG(1, true,  true ): DynamicResolveFor<1, true,  true >(body, target, manifold); break;
-            case TAG(1, true,  false): DynamicResolveFor<1, true,  false>(body, target, manifold); break;
-            case TAG(1, false, true ): DynamicResolveFor<1, false, true >(body, target, manifold); break;
-            case TAG(2, true,  true ): DynamicResolveFor<2, true,  true >(body, target, manifold); break;
-            case TAG(2, true,  false): DynamicResolveFor<2, true,  false>(body, target, manifold); break;
-            case TAG(2, false, true ): DynamicResolveFor<2, false, true >(body, target, manifold); break;
-            default: Debug::QError$("bad collision response");
-        }
-    }
-
-    template <u32 ContactCount, bool BDyn, bool TDyn>
-    void DynamicResolveFor(Body& body, Body& target, const Manifold& manifold) {
-        const fv2& normal = manifold.seperatingNormal, tangent = normal.PerpendRight();
-        const float share = ContactCount == 2 ? 0.5f : 1.0f;
-        // this makes contactCount known in compile time for loop unrolling
-
-        // if (relativeVelocity.dot(normal) > 0.0f) { // moving away from each other, dont collide
-        //     return;
-        // }
-
-        constexpr float BODY_RESTITUION = 1.0f;
-        constexpr float STATIC_FRICTION = 0.75f, DYNAMIC_FRICTION = 0.57f;
-
-        fv2   relBody    [ContactCount], relTarget[ContactCount];
-        float velocityMag[ContactCount], jn       [ContactCount];
-
-        fv2 totalImpulse = 0;
-        [[maybe_unused]] float totalBodyAngMtm = 0;
-        [[maybe_unused]] float totalTargetAngMtm = 0;
-        // normal forces
-        for (u32 i = 0; i < ContactCount; ++i) {
-            const fv2& contact = manifold.contactPoint[i];
-
-            relBody  [i] = contact - body.position,
-            relTarget[i] = contact - target.position;
-
-            const fv2 relVel = [&] {
-                if constexpr (BDyn && TDyn) {
-                    const fv2 angularVelBody   = relBody  [i].PerpendLeft() * body.angularVelocity,
-                              angularVelTarget = relTarget[i].PerpendLeft() * target.angularVelocity;
-
-                    return (target.velocity + angularVelTarget) -
-                           (body  .velocity + angularVelBody);
-                } else if constexpr (BDyn) {
-                    return -body.velocity - relBody[i].Perpend() * body.angularVelocity;
-                } else /* targetDyn */ {
-                    return target.velocity + relTarget[i].Perpend() * target.angularVelocity;
-                }
-            } ();
-
-            velocityMag[i] = relVel.Dot(normal);
-            if (velocityMag[i] > 0.0f) {
-                jn[i] = 0;
-                continue;
-            }
-
-            const float denomN = [&] {
-                if constexpr (BDyn && TDyn) {
-                    const float torqueRadiusNBody   = relBody  [i].Cross(normal),
-                                torqueRadiusNTarget = relTarget[i].Cross(normal);
-
-                    return body.invMass + target.invMass +
-                          (torqueRadiusNBody   * torqueRadiusNBody)   * body  .invInertia +
-                          (torqueRadiusNTarget * torqueRadiusNTarget) * target.invInertia;
-                } else if constexpr (BDyn) {
-                    const float torqueRadius = relBody[i].Cross(normal);
-                    return body.invMass + torqueRadius * torqueRadius * body.invInertia;
-                } else /* targetDyn */ {
-                    const float torqueRadius = relTarget[i].Cross(normal);
-                    return target.invMass + torqueRadius * torqueRadius * target.invInertia;
-                }
-            } ();
-
-            jn[i] = -(1.0f + BODY_RESTITUION) * velocityMag[i] * share / denomN;
-
-            const fv2 impulse = jn[i] * normal;
-
-            totalImpulse      += impulse;
-            if constexpr (BDyn) totalBodyAngMtm   -= relBody  [i].Cross(impulse);
-            if constexpr (TDyn) totalTargetAngMtm += relTarget[i].Cross(impulse);
-        }
-
-        if constexpr (BDyn) {
-            body.AddMomentum(-totalImpulse);
-            body.AddAngularMomentum(totalBodyAngMtm);
-        }
-        if constexpr (TDyn) {
-            target.AddMomentum(totalImpulse);
-            target.AddAngularMomentum(totalTargetAngMtm);
-        }
-
-        totalImpulse = 0;
-        totalBodyAngMtm = 0; totalTargetAngMtm = 0;
-        // frictional forces (needs to be separated, order matters)
-        for (u32 i = 0; i < ContactCount; ++i) {
-            const fv2 relVel = [&] {
-                if constexpr (BDyn && TDyn) {
-                    const fv2 angularVelBody   = relBody  [i].PerpendLeft() * body.angularVelocity,
-                              angularVelTarget = relTarget[i].PerpendLeft() * target.angularVelocity;
-
-                    return (target.velocity + angularVelTarget) -
-                           (body  .velocity + angularVelBody);
-                } else if constexpr (BDyn) {
-                    return -body.velocity - relBody[i].Perpend() * body.angularVelocity;
-                } else /* targetDyn */ {
-                    return target.velocity + relTarget[i].Perpend() * target.angularVelocity;
-                }
-            } ();
-
-            const float t = relVel.Dot(tangent);
-
-            if (std::abs(t) <= f32s::DELTA) continue;
-
-            const float denomT = [&] {
-                if constexpr (BDyn && TDyn) {
-                    const float torqueRadiusTBody   = relBody  [i].Cross(tangent),
-                                torqueRadiusTTarget = relTarget[i].Cross(tangent);
-
-                    return body.invMass + target.invMass +
-                          (torqueRadiusTBody   * torqueRadiusTBody)   * body  .invInertia +
-                          (torqueRadiusTTarget * torqueRadiusTTarget) * target.invInertia;
-                } else if constexpr (BDyn) {
-                    const float torqueRadius = relBody[i].Cross(tangent);
-                    return body.invMass + torqueRadius * torqueRadius * body.invInertia;
-                } else /* targetDyn */ {
-                    const float torqueRadius = relTarget[i].Cross(tangent);
-                    return target.invMass + torqueRadius * torqueRadius * target.invInertia;
-                }
-            } ();
-
-            const float jt = -t * share / denomT;
-            const fv2 frictionImpulse = tangent * (
-                std::abs(jt) <= std::abs(jn[i] * STATIC_FRICTION) ?
-                jt : (jt < 0 ? -1.0f : 1.0f) * jn[i] * DYNAMIC_FRICTION
-            ); // static/dynamic friction picking
-
-            totalImpulse      += frictionImpulse;
-            if constexpr (BDyn) totalBodyAngMtm   -= relBody  [i].Cross(frictionImpulse);
-            if constexpr (TDyn) totalTargetAngMtm += relTarget[i].Cross(frictionImpulse);
-        }
-
-        if constexpr (BDyn) {
-            body.AddMomentum(-totalImpulse);
-            body.AddAngularMomentum(totalBodyAngMtm);
-        }
-        if constexpr (TDyn) {
-            target.AddMomentum(totalImpulse);
-            target.AddAngularMomentum(totalTargetAngMtm);
-        }
-    }
-
-    template void DynamicResolveFor<1, true,  true >(Body& body, Body& target, const Manifold& manifold);
-    template void DynamicResolveFor<1, true,  false>(Body& body, Body& target, const Manifold& manifold);
-    template void DynamicResolveFor<1, false, true >(Body& body, Body& target, const Manifold& manifold);
-    template void DynamicResolveFor<2, true,  true >(Body& body, Body& target, const Manifold& manifold);
-    template void DynamicResolveFor<2, true,  false>(Body& body, Body& target, const Manifold& manifold);
-    template void DynamicResolveFor<2, false, true >(Body& body, Body& target, const Manifold& manifold);
 } // Physics2D
\ No newline at end of file
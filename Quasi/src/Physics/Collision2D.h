@@ -31,9 +31,4 @@ namespace Quasi::Physics2D {
     bool OverlapPolygons      (const Shape& s1,       const Pose2D& xf1, const Shape& s2,       const Pose2D& xf2);
     bool OverlapCapsules      (const Shape& s1,       const Pose2D& xf1, const Shape& s2,       const Pose2D& xf2);
     bool OverlapPolygonCapsule(const Shape& s1,       const Pose2D& xf1, const Shape& s2,       const Pose2D& xf2);
-
-    void StaticResolve (Body& body, Body& target, const Manifold& manifold);
-    template <u32 ContactCount, bool BDyn, bool TDyn>
-    void DynamicResolveFor(Body& body, Body& target, const Manifold& manifold);
-    void DynamicResolve(Body& body, Body& target, const Manifold& manifold);
 } // Physics2D::Collision
@@ -0,0 +1,164 @@
+#include "ContactSolver2D.h"
+
+#include "Body2D.h"
+#include "Utils/Debug/Profiler.h"
+
+namespace Quasi::Physics2D {
+    Hashing::Hash ContactKey::GetHashCode() const {
+        return Hashing::HashInt((u64)body << 32 | target);
+    }
+
+    ContactKey Contact::Key() const {
+        return { body->id, target->id };
+    }
+
+    void ContactSolver::BeginStep() {
+        std::swap(contacts, oldContacts);
+        contacts.Clear();
+
+        oldContactLookup.Clear();
+        for (u32 i = 0; i < oldContacts.Length(); ++i)
+            oldContactLookup.InsertOrAssign(oldContacts[i].Key(), i);
+    }
+
+    void ContactSolver::AddContact(Body& body, Body& target, const Manifold& manifold) {
+        // keep a consistent order so that the same pair maps to the same contact every frame
+        const bool swap = target.id < body.id;
+        Contact& contact = contacts.Push({
+            .body   = swap ? &target : &body,
+            .target = swap ? &body : &target,
+            .normal = swap ? -manifold.seperatingNormal : manifold.seperatingNormal,
+            .pointCount = manifold.contactCount,
+        });
+
+        const Pose2D xf = contact.body->GetTransform();
+        for (u32 i = 0; i < contact.pointCount; ++i) {
+            ContactPoint& p = contact.points[i];
+            p.relBody   = manifold.contactPoint[i] - contact.body->position;
+            p.relTarget = manifold.contactPoint[i] - contact.target->position;
+            p.localAnchor = xf.MulInvD(p.relBody);
+            p.depth = manifold.contactDepth[i];
+        }
+
+        if (!warmStarting) return;
+        const OptRef<const u32> old = oldContactLookup.Get(contact.Key());
+        if (!old) return;
+
+        // the points dont have stable ids from clipping, so match them to the closest old point instead
+        const Contact& prev = oldContacts[*old];
+        bool used[2] = { false, false };
+        for (u32 i = 0; i < contact.pointCount; ++i) {
+            ContactPoint& p = contact.points[i];
+            u32 best = -1; float bestDist = f32s::INFINITY;
+            for (u32 j = 0; j < prev.pointCount; ++j) {
+                if (used[j]) continue;
+                const float dist = p.localAnchor.DistSq(prev.points[j].localAnchor);
+                if (dist < bestDist) { best = j; bestDist = dist; }
+            }
+            if (best == (u32)-1) continue;
+            used[best] = true;
+            p.normalImpulse  = prev.points[best].normalImpulse;
+            p.tangentImpulse = prev.points[best].tangentImpulse;
+        }
+    }
+
+    void ContactSolver::RemoveContactsOf(const Body& body) {
+        contacts.Keep([&] (const Contact& c) { return c.body != &body && c.target != &body; });
+    }
+
+    void ContactSolver::Clear() {
+        contacts.Clear();
+        oldContacts.Clear();
+        oldContactLookup.Clear();
+    }
+
+    void ContactSolver::Solve(float dt) {
+        QProfile$("ContactSolver::Solve");
+        if (contacts.IsEmpty() || dt <= 0) return;
+        PreStep(1 / dt);
+        if (warmStarting) WarmStart();
+        for (u32 i = 0; i < velocityIterations; ++i)
+            SolveVelocities();
+    }
+
+    // only dynamic bodies respond to impulses, kinematic bodies still have a mass but act as infinitely heavy
+    static float InvMassOf   (const Body& b) { return b.IsDynamic() ? b.invMass    : 0; }
+    static float InvInertiaOf(const Body& b) { return b.IsDynamic() ? b.invInertia : 0; }
+
+    static fv2 RelativeVelocity(const Body& body, const Body& target, const ContactPoint& p) {
+        return (target.velocity + p.relTarget.PerpendLeft() * target.angularVelocity) -
+               (body  .velocity + p.relBody  .PerpendLeft() * body  .angularVelocity);
+    }
+
+    static void ApplyImpulse(Body& body, Body& target, const ContactPoint& p, const fv2& impulse) {
+        const float mB = InvMassOf(body),   iB = InvInertiaOf(body),
+                    mT = InvMassOf(target), iT = InvInertiaOf(target);
+        body  .velocity        -= impulse * mB;
+        body  .angularVelocity -= p.relBody.Cross(impulse) * iB;
+        target.velocity        += impulse * mT;
+        target.angularVelocity += p.relTarget.Cross(impulse) * iT;
+    }
+
+    void ContactSolver::PreStep(float invDt) {
+        for (Contact& c : contacts) {
+            const Body& body = *c.body, &target = *c.target;
+            const float mB = InvMassOf(body),   iB = InvInertiaOf(body),
+                        mT = InvMassOf(target), iT = InvInertiaOf(target);
+            const fv2 tangent = c.normal.PerpendRight();
+
+            for (u32 i = 0; i < c.pointCount; ++i) {
+                ContactPoint& p = c.points[i];
+                const float rnB = p.relBody.Cross(c.normal),  rnT = p.relTarget.Cross(c.normal),
+                            rtB = p.relBody.Cross(tangent),   rtT = p.relTarget.Cross(tangent);
+                const float kNormal  = mB + mT + rnB * rnB * iB + rnT * rnT * iT,
+                            kTangent = mB + mT + rtB * rtB * iB + rtT * rtT * iT;
+                p.normalMass  = kNormal  > 0 ? 1 / kNormal  : 0;
+                p.tangentMass = kTangent > 0 ? 1 / kTangent : 0;
+
+                // push the bodies apart over a few frames, and bounce only when hitting fast enough
+                const float vn = RelativeVelocity(body, target, p).Dot(c.normal);
+                const float positionBias = baumgarte * invDt * std::max(p.depth - linearSlop, 0.0f);
+                const float bounceBias = vn < -restitutionThreshold ? -restitution * vn : 0;
+                p.bias = std::max(positionBias, bounceBias);
+            }
+        }
+    }
+
+    void ContactSolver::WarmStart() {
+        for (Contact& c : contacts) {
+            const fv2 tangent = c.normal.PerpendRight();
+            for (u32 i = 0; i < c.pointCount; ++i) {
+                const ContactPoint& p = c.points[i];
+                ApplyImpulse(*c.body, *c.target, p, c.normal * p.normalImpulse + tangent * p.tangentImpulse);
+            }
+        }
+    }
+
+    void ContactSolver::SolveVelocities() {
+        for (Contact& c : contacts) {
+            Body& body = *c.body, &target = *c.target;
+            const fv2 tangent = c.normal.PerpendRight();
+
+            // friction first, as the normal constraint is more important to satisfy last
+            for (u32 i = 0; i < c.pointCount; ++i) {
+                ContactPoint& p = c.points[i];
+                const float vt = RelativeVelocity(body, target, p).Dot(tangent);
+                const float maxFriction = friction * p.normalImpulse;
+                const float newImpulse = std::clamp(p.tangentImpulse - vt * p.tangentMass, -maxFriction, maxFriction);
+                const float delta = newImpulse - p.tangentImpulse;
+                p.tangentImpulse = newImpulse;
+                ApplyImpulse(body, target, p, tangent * delta);
+            }
+
+            for (u32 i = 0; i < c.pointCount; ++i) {
+                ContactPoint& p = c.points[i];
+                const float vn = RelativeVelocity(body, target, p).Dot(c.normal);
+                // clamp the accumulated impulse, not the incremental one, so that it can be corrected later
+                const float newImpulse = std::max(p.normalImpulse + (p.bias - vn) * p.normalMass, 0.0f);
+                const float delta = newImpulse - p.normalImpulse;
+                p.normalImpulse = newImpulse;
+                ApplyImpulse(body, target, p, c.normal * delta);
+            }
+        }
+    }
+} // Physics2D
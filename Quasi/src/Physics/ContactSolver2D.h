@@ -0,0 +1,64 @@
+#pragma once
+#include "Manifold2D.h"
+#include "Utils/Vec.h"
+#include "Utils/HashMap.h"
+
+namespace Quasi::Physics2D {
+    using namespace Math;
+
+    class Body;
+
+    // a pair of bodies in contact by their ids, always stored with body < target so that the key
+    // (and the direction of the normal) stays the same across frames and runs
+    struct ContactKey {
+        u32 body, target;
+
+        bool operator==(const ContactKey&) const = default;
+        Hashing::Hash GetHashCode() const;
+    };
+
+    struct ContactPoint {
+        fv2 relBody, relTarget; // offset of the contact from the center of each body
+        fv2 localAnchor;        // contact in body's local space, used to match points across frames
+        float depth;
+        float normalMass, tangentMass, bias;
+        float normalImpulse = 0, tangentImpulse = 0; // accumulated, carried over for warm starting
+    };
+
+    struct Contact {
+        Body* body, *target;
+        fv2 normal; // points from body to target
+        ContactPoint points[2];
+        u32 pointCount = 0;
+
+        ContactKey Key() const;
+    };
+
+    // a sequential impulse solver in the style of box2d-lite.
+    // narrowphase adds contacts every step, which inherit the accumulated impulses of last step's
+    // matching contacts, then all the contacts are solved together over a few velocity iterations.
+    class ContactSolver {
+        Vec<Contact> contacts, oldContacts;
+        HashMap<ContactKey, u32> oldContactLookup;
+    public:
+        u32 velocityIterations = 10;
+        float baumgarte = 0.2f, linearSlop = 0.005f;
+        float friction = 0.6f, restitution = 0.0f, restitutionThreshold = 1.0f;
+        bool warmStarting = true;
+
+        // moves the current contacts into the history, should be called before narrowphase
+        void BeginStep();
+        void AddContact(Body& body, Body& target, const Manifold& manifold);
+        void RemoveContactsOf(const Body& body);
+        void Clear();
+
+        void Solve(float dt);
+
+        Span<const Contact> Contacts() const { return contacts.AsSpan(); }
+        usize ContactCount() const { return contacts.Length(); }
+    private:
+        void PreStep(float invDt);
+        void WarmStart();
+        void SolveVelocities();
+    };
+} // Physics2D
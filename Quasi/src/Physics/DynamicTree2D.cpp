@@ -0,0 +1,193 @@
+#include "DynamicTree2D.h"
+
+namespace Quasi::Physics2D {
+    u32 DynamicTree::CreateProxy(const fRect2D& box, Body* body) {
+        const u32 proxy = AllocateNode();
+        Node& leaf = nodes[proxy];
+        leaf.box = box.Extrude(margin);
+        leaf.body = body;
+        leaf.height = 0;
+        InsertLeaf(proxy);
+        ++proxyCount;
+        return proxy;
+    }
+
+    void DynamicTree::DestroyProxy(u32 proxy) {
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        --proxyCount;
+    }
+
+    bool DynamicTree::MoveProxy(u32 proxy, const fRect2D& box) {
+        if (!NeedsMove(proxy, box)) return false;
+
+        RemoveLeaf(proxy);
+        nodes[proxy].box = box.Extrude(margin);
+        InsertLeaf(proxy);
+        return true;
+    }
+
+    void DynamicTree::Clear() {
+        nodes.Clear();
+        root = NULL_NODE;
+        freeList = NULL_NODE;
+        proxyCount = 0;
+    }
+
+    float DynamicTree::AreaRatio() const {
+        if (root == NULL_NODE) return 0;
+
+        float total = 0;
+        for (const Node& node : nodes) {
+            if (node.height < 0) continue;
+            total += Perimeter(node.box);
+        }
+        return total / Perimeter(nodes[root].box);
+    }
+
+    u32 DynamicTree::AllocateNode() {
+        if (freeList == NULL_NODE) {
+            nodes.Push({});
+            return nodes.Length() - 1;
+        }
+        const u32 node = freeList;
+        freeList = nodes[node].parent;
+        nodes[node] = {};
+        return node;
+    }
+
+    void DynamicTree::FreeNode(u32 node) {
+        nodes[node].parent = freeList;
+        nodes[node].height = -1;
+        nodes[node].body = nullptr;
+        freeList = node;
+    }
+
+    void DynamicTree::InsertLeaf(u32 leaf) {
+        if (root == NULL_NODE) {
+            root = leaf;
+            nodes[root].parent = NULL_NODE;
+            return;
+        }
+
+        // find the best sibling by the surface area heuristic (perimeter in 2d)
+        const fRect2D leafBox = nodes[leaf].box;
+        u32 index = root;
+        while (!nodes[index].IsLeaf()) {
+            const Node& node = nodes[index];
+            const float area = Perimeter(node.box), combinedArea = Perimeter(node.box.Union(leafBox));
+
+            // cost of creating a new parent for this node and the new leaf
+            const float cost = 2 * combinedArea;
+            // minimum cost of pushing the leaf further down the tree
+            const float inheritanceCost = 2 * (combinedArea - area);
+
+            const auto DescendCost = [&] (u32 child) {
+                const Node& c = nodes[child];
+                const float newArea = Perimeter(c.box.Union(leafBox));
+                return (c.IsLeaf() ? newArea : newArea - Perimeter(c.box)) + inheritanceCost;
+            };
+            const float cost1 = DescendCost(node.child1), cost2 = DescendCost(node.child2);
+
+            if (cost < cost1 && cost < cost2) break;
+            index = cost1 < cost2 ? node.child1 : node.child2;
+        }
+
+        const u32 sibling = index, oldParent = nodes[sibling].parent;
+        const u32 newParent = AllocateNode(); // may reallocate, dont hold references past this
+        nodes[newParent].parent = oldParent;
+        nodes[newParent].box    = leafBox.Union(nodes[sibling].box);
+        nodes[newParent].height = nodes[sibling].height + 1;
+        nodes[newParent].child1 = sibling;
+        nodes[newParent].child2 = leaf;
+        nodes[sibling].parent = newParent;
+        nodes[leaf].parent    = newParent;
+
+        if (oldParent != NULL_NODE) {
+            (nodes[oldParent].child1 == sibling ? nodes[oldParent].child1 : nodes[oldParent].child2) = newParent;
+        } else {
+            root = newParent;
+        }
+
+        Refit(nodes[leaf].parent);
+    }
+
+    void DynamicTree::RemoveLeaf(u32 leaf) {
+        if (leaf == root) {
+            root = NULL_NODE;
+            return;
+        }
+
+        const u32 parent = nodes[leaf].parent, grandParent = nodes[parent].parent;
+        const u32 sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+        if (grandParent != NULL_NODE) {
+            // destroy the parent and connect the sibling to the grandparent
+            (nodes[grandParent].child1 == parent ? nodes[grandParent].child1 : nodes[grandParent].child2) = sibling;
+            nodes[sibling].parent = grandParent;
+            FreeNode(parent);
+            Refit(grandParent);
+        } else {
+            root = sibling;
+            nodes[sibling].parent = NULL_NODE;
+            FreeNode(parent);
+        }
+    }
+
+    void DynamicTree::Refit(u32 node) {
+        while (node != NULL_NODE) {
+            node = Balance(node);
+
+            Node& n = nodes[node];
+            const Node& c1 = nodes[n.child1], &c2 = nodes[n.child2];
+            n.height = 1 + std::max(c1.height, c2.height);
+            n.box    = c1.box.Union(c2.box);
+
+            node = n.parent;
+        }
+    }
+
+    // performs a left or right rotation if node a is imbalanced, returns the new root of the subtree
+    u32 DynamicTree::Balance(u32 iA) {
+        Node& a = nodes[iA];
+        if (a.IsLeaf() || a.height < 2) return iA;
+
+        const u32 iB = a.child1, iC = a.child2;
+        Node& b = nodes[iB], &c = nodes[iC];
+        const i32 balance = c.height - b.height;
+
+        // the rotations for c & b are mirrored, so share the code
+        const auto Rotate = [&] (u32 iUp, Node& up, u32 iDown, Node& down, u32& downSlot) {
+            const u32 iF = up.child1, iG = up.child2;
+            Node& f = nodes[iF], &g = nodes[iG];
+
+            // swap a and up
+            up.child1 = iA;
+            up.parent = a.parent;
+            a.parent  = iUp;
+
+            if (up.parent != NULL_NODE) {
+                (nodes[up.parent].child1 == iA ? nodes[up.parent].child1 : nodes[up.parent].child2) = iUp;
+            } else {
+                root = iUp;
+            }
+
+            // the taller grandchild stays with up, the other is given to a
+            const bool keepF = f.height > g.height;
+            const u32 iKeep = keepF ? iF : iG, iGive = keepF ? iG : iF;
+            Node& keep = nodes[iKeep], &give = nodes[iGive];
+            up.child2  = iKeep;
+            downSlot   = iGive;
+            give.parent = iA;
+            a.box    = down.box.Union(give.box);
+            up.box   = a.box.Union(keep.box);
+            a.height  = 1 + std::max(down.height, give.height);
+            up.height = 1 + std::max(a.height, keep.height);
+            return iUp;
+        };
+
+        if (balance > 1)  return Rotate(iC, c, iB, b, a.child2); // rotate c up
+        if (balance < -1) return Rotate(iB, b, iC, c, a.child1); // rotate b up
+        return iA;
+    }
+} // Physics2D
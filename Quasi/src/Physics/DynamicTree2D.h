@@ -0,0 +1,94 @@
+#pragma once
+#include "Utils/Vec.h"
+#include "Utils/Math/Rect.h"
+
+namespace Quasi::Physics2D {
+    using namespace Math;
+
+    class Body;
+
+    // a bounding volume hierarchy of fattened aabbs, based off of box2d's b2DynamicTree.
+    // leaves are 'proxies' which hold a body, and only need to be reinserted
+    // once the body's bounding box escapes its fattened box.
+    class DynamicTree {
+    public:
+        static constexpr u32 NULL_NODE = -1;
+        static constexpr float DEFAULT_MARGIN = 0.1f;
+
+        struct Node {
+            fRect2D box;
+            Body* body = nullptr;
+            u32 parent = NULL_NODE; // also the 'next' pointer while in the free list
+            u32 child1 = NULL_NODE, child2 = NULL_NODE;
+            i32 height = -1; // leaves have height 0, free nodes have height -1
+
+            bool IsLeaf() const { return child1 == NULL_NODE; }
+        };
+    private:
+        Vec<Node> nodes;
+        u32 root = NULL_NODE, freeList = NULL_NODE;
+        usize proxyCount = 0;
+    public:
+        float margin = DEFAULT_MARGIN;
+
+        DynamicTree() = default;
+        DynamicTree(float margin) : margin(margin) {}
+
+        u32 CreateProxy(const fRect2D& box, Body* body);
+        void DestroyProxy(u32 proxy);
+        // returns true if the proxy had to be reinserted
+        bool MoveProxy(u32 proxy, const fRect2D& box);
+        void Clear();
+
+        const fRect2D& FatBoxOf(u32 proxy) const { return nodes[proxy].box; }
+        Body* BodyOf(u32 proxy) const { return nodes[proxy].body; }
+        bool NeedsMove(u32 proxy, const fRect2D& box) const { return !nodes[proxy].box.Contains(box); }
+
+        usize ProxyCount() const { return proxyCount; }
+        i32 Height() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+        float AreaRatio() const;
+
+        // calls onHit(u32 proxy) for every proxy whose fat box overlaps box, stops early if onHit returns false
+        void Query(const fRect2D& box, Fn<bool, u32> auto&& onHit) const;
+    private:
+        u32 AllocateNode();
+        void FreeNode(u32 node);
+        void InsertLeaf(u32 leaf);
+        void RemoveLeaf(u32 leaf);
+        u32 Balance(u32 a);
+        void Refit(u32 node);
+
+        static float Perimeter(const fRect2D& box) { return 2 * (box.Width() + box.Height()); }
+    };
+
+    void DynamicTree::Query(const fRect2D& box, Fn<bool, u32> auto&& onHit) const {
+        if (root == NULL_NODE) return;
+
+        constexpr usize STACK_SIZE = 256;
+        u32 stack[STACK_SIZE];
+        usize top = 0;
+        // the tree is balanced, so this only gets used if it somehow isnt
+        Vec<u32> spill;
+        const auto push = [&] (u32 id) {
+            if (top < STACK_SIZE) stack[top++] = id;
+            else spill.Push(id);
+        };
+
+        push(root);
+        while (top || !spill.IsEmpty()) {
+            u32 id;
+            if (spill.IsEmpty()) id = stack[--top];
+            else { id = spill.Last(); spill.Pop(); }
+
+            const Node& node = nodes[id];
+            if (!node.box.Overlaps(box)) continue;
+
+            if (node.IsLeaf()) {
+                if (!onHit(id)) return;
+            } else {
+                push(node.child1);
+                push(node.child2);
+            }
+        }
+    }
+} // Physics2D
@@ -1,20 +1,25 @@
 #include "World2D.h"
 
 #include "Utils/Algorithm.h"
+#include "Utils/Debug/Profiler.h"
 
 namespace Quasi::Physics2D {
+    static constexpr usize INTEGRATE_GRAIN_SIZE = 256, NARROWPHASE_GRAIN_SIZE = 64, TREE_QUERY_GRAIN_SIZE = 128;
+
     void World::Reserve(usize size) {
         bodies.Reserve(size);
     }
 
     void World::Clear() {
         bodies.Clear();
+        broadphaseTree.Clear();
+        contactSolver.Clear();
     }
 
     Body& World::CreateBody(const BodyCreateOptions& options, Shape shape) {
         const float area = shape.ComputeArea();
         const bool isStatic = options.type == BodyType::STATIC;
-        return *bodies.Push(Box<Body>::Build(
+        Body& body = *bodies.Push(Box<Body>::Build(
             options.position,
             Degrees(options.rotAngle),
             isStatic ? 0 : area * options.density,
@@ -22,6 +27,10 @@ namespace Quasi::Physics2D {
             *this,
             std::move(shape)
         ));
+        body.id = nextBodyID++;
+        if (broadphase == BroadphaseStrategy::DYNAMIC_TREE)
+            body.proxyID = broadphaseTree.CreateProxy(body.boundingBox, &body);
+        return body;
     }
 
     Body& World::CreatePolygon(const BodyCreateOptions& options, Span<const fv2> points) {
@@ -45,49 +54,92 @@ namespace Quasi::Physics2D {
     }
 
     void World::DeleteBody(usize i) {
+        if (stepping) {
+            bodies[i]->enabled = false;
+            pendingDeletes.Push(bodies[i].Data());
+            return;
+        }
+        // the rest of the island may have been resting on this body
+        bodies[i]->WakeUp();
+        if (bodies[i]->proxyID != DynamicTree::NULL_NODE)
+            broadphaseTree.DestroyProxy(bodies[i]->proxyID);
+        contactSolver.RemoveContactsOf(*bodies[i]);
         bodies.Pop(i);
     }
 
     void World::DeleteBody(Ref<Body> body) {
         const OptionUsize i = bodies.FindIf([=] (const Box<Body>& b) { return b.RefEquals(body); });
         if (!i) return;
-        bodies.Pop(*i);
+        DeleteBody(*i);
     }
 
     void World::Update(float dt) {
-        for (Box<Body>& b : bodies) {
-            if (!b->enabled) continue;
+        QProfile$("World::Update");
+        stepping = true;
+        ForEachChunk(bodies.Length(), INTEGRATE_GRAIN_SIZE, [&] (usize begin, usize end) {
+            for (usize i = begin; i < end; ++i) {
+                Body& b = *bodies[i];
+                if (b.enabled && b.awake && b.IsDynamic())
+                    b.velocity += gravity * dt;
+            }
+        });
 
-            if (b->type == BodyType::DYNAMIC)
-                b->velocity += gravity * dt;
-            b->Update(dt);
+        contactSolver.BeginStep();
+        candidatePairs.Clear();
+        switch (broadphase) {
+            case BroadphaseStrategy::SWEEP_AND_PRUNE: SweepAndPrune(); break;
+            case BroadphaseStrategy::DYNAMIC_TREE:    FindTreePairs(); break;
         }
+        CollidePairs();
+        contactSolver.Solve(dt);
+
+        IntegrateBodies(dt);
+
+        if (allowSleeping) UpdateIslands(dt);
 
+        stepping = false;
+        for (Body* b : pendingDeletes) DeleteBody(*b);
+        pendingDeletes.Clear();
+    }
 
-        bodies.SortByKey([&] (const Box<Body>& b) { return b->boundingBox.min.x; });
-        // std::ranges::sort(bodyIndicesSorted, [&](u32 i, u32 j) { return cmpr(bodies[i]) < cmpr(bodies[j]); });
+    void World::IntegrateBodies(float dt) {
+        QProfile$("World::IntegrateBodies");
+        ForEachChunk(bodies.Length(), INTEGRATE_GRAIN_SIZE, [&] (usize begin, usize end) {
+            for (usize i = begin; i < end; ++i) {
+                Body& b = *bodies[i];
+                if (b.enabled && b.awake) b.Integrate(dt);
+            }
+        });
+
+        // the tree isnt thread safe, so the proxies are moved afterwards
+        if (broadphase != BroadphaseStrategy::DYNAMIC_TREE) return;
+        for (Box<Body>& b : bodies) {
+            if (b->enabled && b->awake) b->SyncBroadphase();
+        }
+    }
+
+    void World::ForEachChunk(usize count, usize grainSize, Fn<void, usize, usize> auto&& body) {
+        if (jobSystem) jobSystem->ParallelFor(count, grainSize, body);
+        else body(0, count);
+    }
+
+    void World::SweepAndPrune() {
+        QProfile$("World::SweepAndPrune");
+        bodies.SortRadixByKey([&] (const Box<Body>& b) { return b->boundingBox.min.x; });
 
         // sweep impl
-        // std::vector<std::tuple<Body*, Body*, Collision::Event>> collisionPairs;
-        Vec<Ref<Body>> active;
+        const Memory::ArenaScope scope { stepArena };
+        auto active = Vec<Ref<Body>, Memory::AllocatorRef>::WithAllocator(stepArena);
         for (Box<Body>& b : bodies) {
             if (!b->enabled) continue;
             const float min = b->boundingBox.min.x;
             for (u32 j = 0; j < active.Length();) {
                 Body* c = active[j].Address();
                 if (c->boundingBox.max.x > min) {
-                    const bool bDyn = b->IsDynamic(), cDyn = c->IsDynamic();
-                    if ((bDyn || cDyn) && c->boundingBox.RangeY().Overlaps(b->boundingBox.RangeY())) {
-                        const Manifold manifold = b->CollideWith(*c);
-                        if (manifold.contactCount && std::max(manifold.contactDepth[0], manifold.contactDepth[1]) > f32s::DELTA) {
-                            b->TryCallTrigger(*c, EventType::HIT);
-                            c->TryCallTrigger(*b, EventType::HIT);
-                            StaticResolve (*b, *c, manifold);
-                            DynamicResolve(*b, *c, manifold);
-                            if (bDyn) b->TryUpdateTransforms();
-                            if (cDyn) c->TryUpdateTransforms();
-                        }
-                    }
+                    // at least one of the two has to be moving, static bodies are always awake so check them separately
+                    const bool anyAwake = (!b->IsStatic() && b->awake) || (!c->IsStatic() && c->awake);
+                    if ((b->IsDynamic() || c->IsDynamic()) && anyAwake && c->boundingBox.RangeY().Overlaps(b->boundingBox.RangeY()))
+                        candidatePairs.Push({ b.Data(), c });
                     ++j;
                 } else { // swap and pop
                     std::swap(active[j], active.Last());
@@ -96,26 +148,151 @@ namespace Quasi::Physics2D {
             }
             active.Push(*b);
         }
+    }
+
+    void World::FindTreePairs() {
+        QProfile$("World::FindTreePairs");
+        // the tree cant be modified while it's being queried, so the pairs are collected beforehand.
+        // triggers fired while colliding the pairs may create bodies, deleting them waits until the step is done.
+        if (!jobSystem) return QueryTreePairs(0, bodies.Length(), candidatePairs);
+
+        // every chunk of bodies queries into its own list, which are joined in body order,
+        // so the pairs come out the same as on a single thread
+        const usize chunkCount = (bodies.Length() + TREE_QUERY_GRAIN_SIZE - 1) / TREE_QUERY_GRAIN_SIZE;
+        if (chunkPairs.Length() < chunkCount) chunkPairs.ResizeDefault(chunkCount);
+        jobSystem->ParallelFor(chunkCount, 1, [&] (usize beginChunk, usize endChunk) {
+            for (usize chunk = beginChunk; chunk < endChunk; ++chunk) {
+                chunkPairs[chunk].Clear();
+                QueryTreePairs(chunk * TREE_QUERY_GRAIN_SIZE, std::min((chunk + 1) * TREE_QUERY_GRAIN_SIZE, bodies.Length()), chunkPairs[chunk]);
+            }
+        });
+        for (usize chunk = 0; chunk < chunkCount; ++chunk)
+            candidatePairs.Extend(chunkPairs[chunk].AsSpan().AsConst());
+    }
+
+    void World::QueryTreePairs(usize begin, usize end, Vec<BodyPair>& pairs) {
+        for (usize i = begin; i < end; ++i) {
+            // sleeping bodies dont look for pairs, but can still be found by awake ones
+            Box<Body>& b = bodies[i];
+            if (!b->enabled || b->IsStatic() || !b->awake) continue;
+            Body* body = b.Data();
+            const u32 self = body->proxyID;
+            const bool isKinematic = !body->IsDynamic();
+            broadphaseTree.Query(body->boundingBox, [&] (u32 proxy) {
+                if (proxy == self) return true;
+                Body* target = broadphaseTree.BodyOf(proxy);
+                // awake dynamic bodies find kinematic ones themselves, so those only need to find sleeping ones
+                if (isKinematic && (!target->IsDynamic() || target->awake)) return true;
+                // dynamic-dynamic pairs are found from both sides, keep only one
+                if (!target->enabled || (target->IsDynamic() && target->awake && proxy < self)) return true;
+                if (target->boundingBox.Overlaps(body->boundingBox))
+                    pairs.Push({ body, target });
+                return true;
+            });
+        }
+    }
+
+    void World::CollidePairs() {
+        QProfile$("World::CollidePairs");
+        // each pair writes to its own slot, then the contacts are added in the same order as the pairs were found
+        pairManifolds.Resize(candidatePairs.Length());
+        ForEachChunk(candidatePairs.Length(), NARROWPHASE_GRAIN_SIZE, [&] (usize begin, usize end) {
+            for (usize i = begin; i < end; ++i) {
+                const auto& [body, target] = candidatePairs[i];
+                pairManifolds[i] = body->CollideWith(*target);
+            }
+        });
+
+        for (usize i = 0; i < candidatePairs.Length(); ++i) {
+            if (!pairManifolds[i].contactCount) continue;
+            // a trigger of an earlier pair may have deleted one of them
+            if (!candidatePairs[i].body->enabled || !candidatePairs[i].target->enabled) continue;
+            AddContact(*candidatePairs[i].body, *candidatePairs[i].target, pairManifolds[i]);
+        }
+    }
+
+    void World::AddContact(Body& body, Body& target, const Manifold& manifold) {
+        // resting contacts are still kept, so that their impulses can be warm started next step
+        contactSolver.AddContact(body, target, manifold);
+        body  .WakeUp();
+        target.WakeUp();
+        if (std::max(manifold.contactDepth[0], manifold.contactDepth[1]) > f32s::DELTA) {
+            body  .TryCallTrigger(target, EventType::HIT);
+            target.TryCallTrigger(body,   EventType::HIT);
+        }
+    }
+
+    void World::UpdateIslands(float dt) {
+        QProfile$("World::UpdateIslands");
+        // union-find over the contact graph. static and kinematic bodies dont join islands,
+        // otherwise everything touching the ground would be one island.
+        islands.Clear();
+        islands.Reserve(bodies.Length());
+        for (u32 i = 0; i < bodies.Length(); ++i) {
+            Body& b = *bodies[i];
+            b.islandIndex = i;
+            islands.Push({ i, f32s::INFINITY, nullptr });
+
+            if (!b.awake || !b.IsDynamic()) continue;
+            const bool resting = b.velocity.LenSq() <= sleepVelocity * sleepVelocity &&
+                                 std::abs(b.angularVelocity) <= sleepAngularVelocity;
+            b.sleepTime = resting ? b.sleepTime + dt : 0;
+        }
+
+        for (const Contact& c : contactSolver.Contacts()) {
+            if (!c.body->IsDynamic() || !c.target->IsDynamic()) continue;
+            const u32 a = FindIsland(c.body->islandIndex), b = FindIsland(c.target->islandIndex);
+            if (a != b) islands[a].parent = b;
+        }
 
-        // for (const auto& [base, target, event] : collisionPairs) {
-        //     StaticResolve (*base, *target, event);
-        //     DynamicResolve(*base, *target, event);
-        // }
-
-        // for (uint i = 0; i < BodyCount(); ++i) {
-        //     Body& base = bodies[i];
-        //     fv2 prevPosition = base.position, prevVelocity = base.velocity;
-        //     for (uint j = i + 1; j < BodyCount(); ++j) {
-        //         Body& target = bodies[j];
-        //         if (const Collision::Event event = base.CollideWith(target)) {
-        //             if (event.Seperator().iszero()) continue;
-        //             StaticResolve (base, target, event);
-        //             DynamicResolve(base, target, event);
-        //             if (outCollisions) outCollisions->emplace_back(event);
-        //         }
-        //     }
-        //     base.simTime -= (prevPosition - base.position).len() / prevVelocity.len();
-        // }
+        for (Box<Body>& b : bodies) {
+            if (!b->enabled || !b->awake || !b->IsDynamic()) continue;
+            IslandNode& island = islands[FindIsland(b->islandIndex)];
+            island.minSleepTime = std::min(island.minSleepTime, b->sleepTime);
+        }
+
+        for (Box<Body>& b : bodies) {
+            if (!b->enabled || !b->awake || !b->IsDynamic()) continue;
+            IslandNode& island = islands[FindIsland(b->islandIndex)];
+            if (island.minSleepTime < timeToSleep) continue;
+
+            // link into the island's ring, so waking any body wakes all of them
+            Body* body = b.Data();
+            if (island.sleepRing) {
+                body->nextInIsland = island.sleepRing->nextInIsland;
+                island.sleepRing->nextInIsland = body;
+            } else {
+                body->nextInIsland = body;
+                island.sleepRing = body;
+            }
+            body->awake = false;
+            body->Stop();
+        }
+    }
+
+    u32 World::FindIsland(u32 i) {
+        while (islands[i].parent != i) {
+            islands[i].parent = islands[islands[i].parent].parent; // path halving
+            i = islands[i].parent;
+        }
+        return i;
+    }
+
+    usize World::AwakeBodyCount() const {
+        usize count = 0;
+        for (const Box<Body>& b : bodies) count += !b->IsStatic() && b->awake;
+        return count;
+    }
+
+    void World::SetBroadphase(BroadphaseStrategy strategy) {
+        if (strategy == broadphase) return;
+        broadphase = strategy;
+
+        broadphaseTree.Clear();
+        for (Box<Body>& b : bodies) {
+            b->proxyID = strategy == BroadphaseStrategy::DYNAMIC_TREE ?
+                broadphaseTree.CreateProxy(b->boundingBox, b.Data()) : DynamicTree::NULL_NODE;
+        }
     }
 
     void World::Update(float dt, int simUpdates) {
@@ -1,16 +1,54 @@
 #pragma once
 #include "Body2D.h"
+#include "DynamicTree2D.h"
+#include "ContactSolver2D.h"
+#include "Utils/Arena.h"
+#include "Utils/JobSystem.h"
 
 namespace Quasi::Physics2D {
+    enum class BroadphaseStrategy {
+        SWEEP_AND_PRUNE, // the default, faster for piles of similar bodies that all move every step
+        DYNAMIC_TREE,    // only awake bodies query it, which pays off once most of a large world is asleep
+    };
+
     class World {
     public:
         Vec<Box<Body>> bodies;
         fv2 gravity;
+        DynamicTree broadphaseTree;
+        ContactSolver contactSolver;
+        // when set, integration, the dynamic tree's queries and narrowphase are split across its threads.
+        // the results are merged in pair order, so the simulation doesnt depend on the thread count
+        OptRef<JobSystem> jobSystem = nullptr;
+
+        // islands that stay under these thresholds for timeToSleep seconds are put to sleep
+        bool allowSleeping = true;
+        float sleepVelocity = 0.05f, sleepAngularVelocity = 0.035f, timeToSleep = 0.5f;
+    private:
+        struct BodyPair { Body* body, *target; };
+        struct IslandNode {
+            u32 parent;
+            float minSleepTime;
+            Body* sleepRing;
+        };
+
+        BroadphaseStrategy broadphase = BroadphaseStrategy::SWEEP_AND_PRUNE;
+        u32 nextBodyID = 0;
+        Vec<BodyPair> candidatePairs;
+        Vec<Vec<BodyPair>> chunkPairs; // pairs found by each chunk of bodies, kept so their memory is reused
+        Vec<Manifold> pairManifolds;
+        Vec<IslandNode> islands;
+        // bodies deleted by triggers are only disabled until the step is done, since its pairs still point to them
+        bool stepping = false;
+        Vec<Body*> pendingDeletes;
+        // temporaries that only live for a single step
+        Memory::Arena stepArena;
     public:
         World() = default;
         World(const fv2& gravity) : gravity(gravity) {}
     public:
         usize BodyCount() const { return bodies.Length(); }
+        usize AwakeBodyCount() const;
         void Reserve(usize size);
         void Clear();
 
@@ -22,7 +60,20 @@ namespace Quasi::Physics2D {
         void Update(float dt);
         void Update(float dt, int simUpdates);
 
+        BroadphaseStrategy GetBroadphase() const { return broadphase; }
+        void SetBroadphase(BroadphaseStrategy strategy);
+
         OptRef<Body> BodyAt(usize i);
         OptRef<const Body> BodyAt(usize i) const;
+    private:
+        void SweepAndPrune();
+        void FindTreePairs();
+        void QueryTreePairs(usize begin, usize end, Vec<BodyPair>& pairs);
+        void IntegrateBodies(float dt);
+        void CollidePairs();
+        void AddContact(Body& body, Body& target, const Manifold& manifold);
+        void ForEachChunk(usize count, usize grainSize, Fn<void, usize, usize> auto&& body);
+        void UpdateIslands(float dt);
+        u32 FindIsland(u32 i);
     };
 } // Physics
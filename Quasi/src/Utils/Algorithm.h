@@ -840,6 +840,137 @@ namespace Quasi::Algorithm {
             }
         }
 
+        // stable top down merge sort. only the left half of each merge is moved out,
+        // so the scratch buffer is half the length, and merges of already ordered halves are skipped.
+        namespace MergeSort {
+            constexpr usize INSERTION_THRESHOLD = 20;
+
+            template <class T> void MergeSortRec(T* begin, usize len, T* scratch, Comparator<T> auto&& cmp);
+
+            template <class T>
+            void MergeSort(Span<T> span, Comparator<T> auto&& cmp) {
+                const usize len = span.Length();
+                if (len <= INSERTION_THRESHOLD) return SmallSort::SmallSortFallback(span, cmp);
+
+                const usize scratchLen = len / 2;
+                if (sizeof(T) * scratchLen <= MAX_STACK_ARRAY_SIZE) {
+                    T* scratch = Memory::QAlloca$(T, scratchLen);
+                    return MergeSortRec(span.Data(), len, scratch, cmp);
+                }
+                T* scratch = Memory::AllocateArrayUninit<T>(scratchLen);
+                MergeSortRec(span.Data(), len, scratch, cmp);
+                Memory::FreeRaw(scratch);
+            }
+
+            template <class T>
+            void MergeSortRec(T* begin, usize len, T* scratch, Comparator<T> auto&& cmp) {
+                if (len <= INSERTION_THRESHOLD) return SmallSort::SmallSortFallback(Spans::Slice(begin, len), cmp);
+
+                const usize mid = len / 2;
+                MergeSortRec(begin,       mid,       scratch, cmp);
+                MergeSortRec(begin + mid, len - mid, scratch, cmp);
+                if (cmp(begin[mid], begin[mid - 1]) >= 0) return;
+
+                Memory::RangeRelocate(scratch, begin, mid);
+                T* left = scratch, *leftEnd = scratch + mid, *right = begin + mid, *rightEnd = begin + len, *dest = begin;
+                while (left != leftEnd && right != rightEnd) {
+                    // ties are taken from the left, which keeps it stable
+                    if (cmp(*right, *left) < 0) Memory::RelocateAt(dest++, right++);
+                    else                        Memory::RelocateAt(dest++, left++);
+                }
+                // whatever is left of the right half is already in place
+                Memory::RangeRelocate(dest, left, leftEnd - left);
+            }
+        }
+
+        // lsd radix sort, one byte per pass. keys are extracted once and carried along with the values,
+        // and passes where every key has the same byte are skipped.
+        namespace RadixSort {
+            constexpr usize COMPARISON_THRESHOLD = 64;
+
+            // maps the key to an unsigned int with the same ordering
+            template <RadixKey K>
+            auto IntoRadixBits(K key) {
+                if constexpr (Floating<K>) {
+                    using Bits = typename NumInfo<K>::EquivalentInt;
+                    constexpr Bits SIGN = (Bits)1 << (sizeof(Bits) * 8 - 1);
+                    const Bits bits = __builtin_bit_cast(Bits, key);
+                    // negatives are flipped entirely so that they sort in reverse. -0 lands right before +0,
+                    // and nans end up on the far end of their sign
+                    return (bits & SIGN) ? (Bits)~bits : (Bits)(bits | SIGN);
+                } else if constexpr (Signed<K>) {
+                    using Bits = IntoUnsigned<K>;
+                    return (Bits)((Bits)key ^ (Bits)1 << (sizeof(Bits) * 8 - 1));
+                } else {
+                    return key;
+                }
+            }
+
+            template <RadixKey K>
+            K FromRadixBits(decltype(IntoRadixBits(K {})) bits) {
+                using Bits = decltype(bits);
+                constexpr Bits SIGN = (Bits)1 << (sizeof(Bits) * 8 - 1);
+                if constexpr (Floating<K>) {
+                    return __builtin_bit_cast(K, (bits & SIGN) ? (Bits)(bits & ~SIGN) : (Bits)~bits);
+                } else if constexpr (Signed<K>) {
+                    return (K)(Bits)(bits ^ SIGN);
+                } else {
+                    return bits;
+                }
+            }
+
+            // when the values are the keys themselves, only the keys are shuffled around and written back at the end
+            template <bool CARRY_VALUES, class T>
+            void RadixSort(Span<T> span, FnArgs<const T&> auto&& keyf) {
+                using Bits = decltype(IntoRadixBits(keyf(span[0])));
+                constexpr usize PASSES = sizeof(Bits);
+
+                const usize len = span.Length();
+                if (len < COMPARISON_THRESHOLD) {
+                    return MergeSort::MergeSort(span, [&] (const T& lhs, const T& rhs) {
+                        return Cmp::Between(IntoRadixBits(keyf(lhs)), IntoRadixBits(keyf(rhs)));
+                    });
+                }
+
+                Bits* const keyBuffer = Memory::AllocateArrayUninit<Bits>(len * 2);
+                Bits* keys = keyBuffer, *keysOut = keyBuffer + len;
+                usize counts[PASSES][256] = {};
+                for (usize i = 0; i < len; ++i) {
+                    const Bits key = IntoRadixBits(keyf(span[i]));
+                    keys[i] = key;
+                    for (usize p = 0; p < PASSES; ++p) ++counts[p][(usize)(key >> (p * 8)) & 0xFF];
+                }
+
+                T* const data = span.Data(), *const scratch = CARRY_VALUES ? Memory::AllocateArrayUninit<T>(len) : nullptr;
+                T* in = data, *out = scratch;
+                for (usize p = 0; p < PASSES; ++p) {
+                    usize* offsets = counts[p];
+                    if (offsets[(usize)(keys[0] >> (p * 8)) & 0xFF] == len) continue;
+
+                    for (usize b = 0, sum = 0; b < 256; ++b) {
+                        const usize count = offsets[b];
+                        offsets[b] = sum;
+                        sum += count;
+                    }
+                    for (usize i = 0; i < len; ++i) {
+                        const usize j = offsets[(usize)(keys[i] >> (p * 8)) & 0xFF]++;
+                        keysOut[j] = keys[i];
+                        if constexpr (CARRY_VALUES) Memory::RelocateAt(&out[j], &in[i]);
+                    }
+                    std::swap(keys, keysOut);
+                    std::swap(in, out);
+                }
+
+                if constexpr (CARRY_VALUES) {
+                    if (in != data) Memory::RangeRelocate(data, in, len);
+                    Memory::FreeRaw(scratch);
+                } else {
+                    for (usize i = 0; i < len; ++i) data[i] = FromRadixBits<T>(keys[i]);
+                }
+                Memory::FreeRaw(keyBuffer);
+            }
+        }
+
         template <IsMut T>
         void Sort(Span<T> span, Comparator<T> auto&& cmp) {
             if (span.Length() < 2) return;
@@ -971,18 +1102,22 @@ namespace Quasi::Algorithm {
     // permutes the array where srcIndices tells each element from which to take from
     template <class T, Integer N>
     void ApplyRevPermutationInPlace(Span<T> array, Span<N> srcIndices) {
-        for (usize i = 0; i < array.Length(); ++i) {
-            N j = srcIndices[i];
-            if (bool done = Signed<N> ? (j < 0) : (j > NumInfo<IntoSigned<N>>::MAX)) continue;
-            const N initial = i;
-            while (j != initial) { // walk the cycle until we reach an already completed item
+        const auto isDone = [] (N j) { return Signed<N> ? (j < 0) : (j > NumInfo<IntoSigned<N>>::MAX); };
+        for (usize start = 0; start < array.Length(); ++start) {
+            N j = srcIndices[start];
+            if (isDone(j)) continue;
+            if ((usize)j == start) { srcIndices[start] ^= -1; continue; }
+            // rotates the cycle through one temporary, instead of swapping down it
+            T tmp = std::move(array[start]);
+            usize i = start;
+            while ((usize)j != start) {
+                array[i] = std::move(array[j]);
                 srcIndices[i] ^= -1; // mark as done
-                std::swap(array[i], array[j]);
                 i = j;
                 j = srcIndices[i];
             }
+            array[i] = std::move(tmp);
             srcIndices[i] ^= -1;
-            i = initial;
         }
         // preserve the original permutation
         for (N& j : srcIndices) j ^= -1;
@@ -1036,6 +1171,54 @@ namespace Quasi {
         return Sort([&] (const auto& lhs, const auto& rhs) { return Cmp::Between(keyf(lhs), keyf(rhs)); });
     }
 
+    template <class T, class S>
+    void IContinuous<T, S>::SortByKeyCached(FnArgs<const T&> auto&& keyf) requires IsMut<T> {
+        using K = RemQual<decltype(keyf(std::declval<const T&>()))>;
+        struct KeyIndex { K key; u32 index; };
+
+        const usize len = Length();
+        if (len < 2) return;
+        // ApplyRevPermutationInPlace marks finished indices by flipping their top bit
+        if (len > NumInfo<i32>::MAX) return SortStableByKey(keyf);
+
+        Vec<KeyIndex> keys = Vec<KeyIndex>::WithCap(len);
+        for (usize i = 0; i < len; ++i) keys.Push({ keyf(AsSpan()[i]), (u32)i });
+        if constexpr (RadixKey<K>) {
+            keys.SortRadixByKey([] (const KeyIndex& k) { return k.key; });
+        } else {
+            // the indices are unique, so breaking ties with them makes this stable
+            keys.Sort([] (const KeyIndex& lhs, const KeyIndex& rhs) {
+                const Comparison c = Cmp::Between(lhs.key, rhs.key);
+                return c != Cmp::EQUAL ? c : Cmp::Between(lhs.index, rhs.index);
+            });
+        }
+
+        Vec<u32> srcIndices = Vec<u32>::WithCap(len);
+        for (const KeyIndex& k : keys) srcIndices.Push(k.index);
+        return Algorithm::ApplyRevPermutationInPlace(AsSpan(), srcIndices.AsSpan());
+    }
+
+    template <class T, class S>
+    void IContinuous<T, S>::SortStable(Comparator<T> auto&& cmp) requires IsMut<T> {
+        return Algorithm::SortingDetails::MergeSort::MergeSort(AsSpan(), cmp);
+    }
+
+    template <class T, class S>
+    void IContinuous<T, S>::SortStableByKey(FnArgs<const T&> auto&& keyf) requires IsMut<T> {
+        return SortStable([&] (const auto& lhs, const auto& rhs) { return Cmp::Between(keyf(lhs), keyf(rhs)); });
+    }
+
+    template <class T, class S>
+    void IContinuous<T, S>::SortRadix() requires IsMut<T> && RadixKey<T> {
+        return Algorithm::SortingDetails::RadixSort::RadixSort<false>(AsSpan(), [] (T x) { return x; });
+    }
+
+    template <class T, class S>
+    void IContinuous<T, S>::SortRadixByKey(FnArgs<const T&> auto&& keyf) requires IsMut<T> {
+        static_assert(RadixKey<RemQual<decltype(keyf(std::declval<const T&>()))>>, "radix sort keys must be integers or floats");
+        return Algorithm::SortingDetails::RadixSort::RadixSort<true>(AsSpan(), keyf);
+    }
+
     template <class T, class S>
     bool IContinuous<T, S>::IsSorted(Comparator<T> auto&& cmp) const {
         return Algorithm::SortingDetails::IsSorted(AsSpan(), cmp);
@@ -1068,17 +1251,16 @@ namespace Quasi {
         return Algorithm::RotatePtr(Length() - num, DataEnd() - num, num);
     }
 
-    template <class T>
-    void Vec<T>::RemoveDupKeys(FnArgs<const T&> auto&& keyf) {
+    template <class T, class A>
+    void Vec<T, A>::RemoveDupKeys(FnArgs<const T&> auto&& keyf) {
         if (size <= 1) return;
         usize slow = 0; auto slowKey = keyf(data[0]);
         for (usize i = 1; i < size; ++i) {
             auto fastKey = keyf(data[i]);
             if (slowKey != fastKey) {
-                if (++slow == i) continue;
-                Memory::ConstructMoveAt(&data[slow], std::move(data[i]));
-            }
-            data[i].~T();
+                if (++slow != i) Memory::RelocateAt(&data[slow], &data[i]);
+                slowKey = std::move(fastKey);
+            } else data[i].~T();
         }
         size = slow + 1;
     }
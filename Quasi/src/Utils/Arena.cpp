@@ -0,0 +1,123 @@
+#include "Arena.h"
+
+namespace Quasi::Memory {
+    static constexpr usize MAX_ALIGN = alignof(std::max_align_t);
+
+    static constexpr usize AlignUp(usize x, usize align) { return (x + align - 1) & -align; }
+
+    Arena::~Arena() {
+        Release();
+    }
+
+    Arena::Arena(Arena&& arena) noexcept
+        : first(arena.first), current(arena.current), cursor(arena.cursor), end(arena.end), chunkSize(arena.chunkSize) {
+        arena.first = arena.current = nullptr;
+        arena.cursor = arena.end = nullptr;
+    }
+
+    Arena& Arena::operator=(Arena&& arena) noexcept {
+        this->~Arena();
+        Memory::ConstructMoveAt(this, std::move(arena));
+        return *this;
+    }
+
+    void* Arena::AllocateSlow(usize size, usize align) {
+        // reuse the chunks left over from before the last reset if they are big enough,
+        // otherwise a new chunk is linked in right after the current one
+        Chunk* next = current ? current->next : first;
+        if (!next || next->size < size + align) {
+            Chunk* chunk = (Chunk*)AllocateRaw(sizeof(Chunk) + std::max(chunkSize, AlignUp(size + align, MAX_ALIGN)));
+            chunk->next = next;
+            chunk->size = std::max(chunkSize, AlignUp(size + align, MAX_ALIGN));
+            (current ? current->next : first) = chunk;
+            next = chunk;
+        }
+        EnterChunk(next);
+        return Allocate(size, align);
+    }
+
+    void Arena::EnterChunk(Chunk* chunk) {
+        current = chunk;
+        cursor = chunk->Begin();
+        end = chunk->End();
+    }
+
+    void Arena::Rewind(Marker marker) {
+        if (!marker.chunk) return Reset();
+        current = marker.chunk;
+        cursor = marker.cursor;
+        end = marker.chunk->End();
+    }
+
+    void Arena::Reset() {
+        if (first) EnterChunk(first);
+    }
+
+    void Arena::Release() {
+        for (Chunk* chunk = first; chunk; ) {
+            Chunk* const next = chunk->next;
+            FreeRaw(chunk);
+            chunk = next;
+        }
+        first = current = nullptr;
+        cursor = end = nullptr;
+    }
+
+    usize Arena::BytesUsed() const {
+        if (!current) return 0;
+        usize used = cursor - current->Begin();
+        for (Chunk* chunk = first; chunk != current; chunk = chunk->next) used += chunk->size;
+        return used;
+    }
+
+    usize Arena::BytesReserved() const {
+        usize reserved = 0;
+        for (Chunk* chunk = first; chunk; chunk = chunk->next) reserved += chunk->size;
+        return reserved;
+    }
+
+    Pool::Pool(usize blockSize, usize blocksPerPage)
+        : blockSize(AlignUp(std::max(blockSize, sizeof(FreeBlock)), MAX_ALIGN)), blocksPerPage(std::max<usize>(blocksPerPage, 1)) {}
+
+    Pool::~Pool() {
+        Release();
+    }
+
+    Pool::Pool(Pool&& pool) noexcept
+        : freeList(pool.freeList), pages(pool.pages), blockSize(pool.blockSize), blocksPerPage(pool.blocksPerPage) {
+        pool.freeList = nullptr;
+        pool.pages = nullptr;
+    }
+
+    Pool& Pool::operator=(Pool&& pool) noexcept {
+        this->~Pool();
+        Memory::ConstructMoveAt(this, std::move(pool));
+        return *this;
+    }
+
+    void Pool::AddPage() {
+        // the page header is padded so that every block stays max aligned
+        static constexpr usize HEADER_SIZE = AlignUp(sizeof(Page), MAX_ALIGN);
+        Page* page = (Page*)AllocateRaw(HEADER_SIZE + blockSize * blocksPerPage);
+        page->next = pages;
+        pages = page;
+
+        byte* blocks = (byte*)page + HEADER_SIZE;
+        // linked in reverse so blocks are handed out in address order
+        for (usize i = blocksPerPage; i --> 0; ) {
+            FreeBlock* block = (FreeBlock*)(blocks + i * blockSize);
+            block->next = freeList;
+            freeList = block;
+        }
+    }
+
+    void Pool::Release() {
+        for (Page* page = pages; page; ) {
+            Page* const next = page->next;
+            FreeRaw(page);
+            page = next;
+        }
+        pages = nullptr;
+        freeList = nullptr;
+    }
+}
@@ -0,0 +1,166 @@
+#pragma once
+#include <cstddef>
+
+#include "Memory.h"
+
+namespace Quasi::Memory {
+    // a linear allocator. allocations bump a pointer through a list of chunks,
+    // and everything is freed at once by Reset() or Rewind(), without touching the global heap.
+    // chunks are kept around after a reset, so a warmed up arena doesnt allocate at all.
+    class Arena final : public IAllocator {
+        struct Chunk {
+            Chunk* next;
+            usize size;
+
+            byte* Begin() { return (byte*)(this + 1); }
+            byte* End()   { return Begin() + size; }
+        };
+        static_assert(sizeof(Chunk) % alignof(std::max_align_t) == 0);
+
+        Chunk* first = nullptr, *current = nullptr;
+        byte* cursor = nullptr, *end = nullptr;
+        usize chunkSize;
+    public:
+        static constexpr usize DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+        // a saved position of the arena, see Mark() and Rewind()
+        struct Marker {
+            Chunk* chunk;
+            byte* cursor;
+        };
+
+        explicit Arena(usize chunkSize = DEFAULT_CHUNK_SIZE) : chunkSize(chunkSize) {}
+        ~Arena() override;
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+        Arena(Arena&& arena) noexcept;
+        Arena& operator=(Arena&& arena) noexcept;
+
+        void* Allocate(usize size, usize align) override {
+            const usize padding = -(usize)cursor & (align - 1);
+            if (padding + size > (usize)(end - cursor)) return AllocateSlow(size, align);
+            byte* mem = cursor + padding;
+            cursor = mem + size;
+            return mem;
+        }
+        // only the most recent allocation is actually given back, which lets short-lived temporaries be reused
+        void Free(void* mem, usize size) override {
+            if ((byte*)mem + size == cursor) cursor = (byte*)mem;
+        }
+        // the most recent allocation is resized in place if the chunk has room
+        void* Reallocate(void* mem, usize size, usize newSize, usize align) override {
+            if (mem && (byte*)mem + size == cursor && newSize <= (usize)(end - (byte*)mem)) {
+                cursor = (byte*)mem + newSize;
+                return mem;
+            }
+            return IAllocator::Reallocate(mem, size, newSize, align);
+        }
+
+        template <class T> T* Create(auto&&... args) {
+            T* obj = (T*)Allocate(sizeof(T), alignof(T));
+            Memory::ConstructAt(obj, std::forward<decltype(args)>(args)...);
+            return obj;
+        }
+        template <class T> T* AllocateArrayUninit(usize count) {
+            return (T*)Allocate(count * sizeof(T), alignof(T));
+        }
+
+        Marker Mark() const { return { current, cursor }; }
+        // frees everything allocated after the marker was made
+        void Rewind(Marker marker);
+        // frees everything, but keeps the chunks for later
+        void Reset();
+        // frees everything and gives the chunks back to the heap
+        void Release();
+
+        usize BytesUsed() const;
+        usize BytesReserved() const;
+    private:
+        void* AllocateSlow(usize size, usize align);
+        void EnterChunk(Chunk* chunk);
+    };
+
+    // rewinds the arena at the end of the scope, i.e. QWith$(ArenaScope scope { arena }) { ... }
+    struct ArenaScope {
+        Arena& arena;
+        Arena::Marker marker;
+
+        ArenaScope(Arena& arena) : arena(arena), marker(arena.Mark()) {}
+        ~ArenaScope() { arena.Rewind(marker); }
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+    };
+
+    // a pair of arenas that are swapped every frame. memory allocated during a frame
+    // stays valid through the next one, so results can be handed over to the next frame without copying.
+    class FrameArena final : public IAllocator {
+        Arena arenas[2];
+        u32 frame = 0;
+    public:
+        explicit FrameArena(usize chunkSize = Arena::DEFAULT_CHUNK_SIZE) : arenas { Arena { chunkSize }, Arena { chunkSize } } {}
+
+        void* Allocate(usize size, usize align) override { return Current().Allocate(size, align); }
+        void Free(void* mem, usize size) override { Current().Free(mem, size); }
+        void* Reallocate(void* mem, usize size, usize newSize, usize align) override { return Current().Reallocate(mem, size, newSize, align); }
+
+        Arena& Current()  { return arenas[frame]; }
+        Arena& Previous() { return arenas[frame ^ 1]; }
+        u32 FrameParity() const { return frame; }
+
+        // call once at the start of each frame. everything from two frames ago is freed in O(1).
+        void NextFrame() { frame ^= 1; Current().Reset(); }
+    };
+
+    // hands out blocks of a single size from a free list, for objects that are created and destroyed often.
+    class Pool final : public IAllocator {
+        struct FreeBlock { FreeBlock* next; };
+        struct Page { Page* next; };
+
+        FreeBlock* freeList = nullptr;
+        Page* pages = nullptr;
+        usize blockSize, blocksPerPage;
+    public:
+        Pool(usize blockSize, usize blocksPerPage = 256);
+        ~Pool() override;
+
+        Pool(const Pool&) = delete;
+        Pool& operator=(const Pool&) = delete;
+        Pool(Pool&& pool) noexcept;
+        Pool& operator=(Pool&& pool) noexcept;
+
+        template <class T> static Pool For(usize blocksPerPage = 256) { return { sizeof(T), blocksPerPage }; }
+
+        // size must be at most the block size, and align at most alignof(std::max_align_t)
+        void* Allocate(usize size, usize align) override {
+            if (!freeList) AddPage();
+            FreeBlock* block = freeList;
+            freeList = block->next;
+            return block;
+        }
+        void Free(void* mem, usize size) override {
+            if (!mem) return;
+            FreeBlock* block = (FreeBlock*)mem;
+            block->next = freeList;
+            freeList = block;
+        }
+
+        template <class T> T* Create(auto&&... args) {
+            T* obj = (T*)Allocate(sizeof(T), alignof(T));
+            Memory::ConstructAt(obj, std::forward<decltype(args)>(args)...);
+            return obj;
+        }
+        template <class T> void Destroy(T* obj) {
+            if (!obj) return;
+            obj->~T();
+            Free(obj, sizeof(T));
+        }
+
+        usize BlockSize() const { return blockSize; }
+        // frees every block and gives the pages back to the heap
+        void Release();
+    private:
+        void AddPage();
+    };
+}
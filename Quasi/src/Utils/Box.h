@@ -134,6 +134,10 @@ namespace Quasi {
         template <class _T, class _A> friend struct Box;
     };
 
+    namespace Memory {
+        template <class T, class A> constexpr bool EnableTrivialRelocate<Box<T, A>> = TrivialCopy<A>;
+    }
+
     namespace Boxs {
         template <class T>
         Box<T> New(T val) { return Box<T>::New(std::move(val)); }
@@ -15,6 +15,9 @@ namespace Quasi {
     concept Comparator = Fn<F, Cmp::Comparison, const T&, const T&>;
     template <class F, class T>
     concept EqualPred  = Fn<F, bool, const T&, const T&>;
+    // keys that can be radix sorted by their bits
+    template <class T>
+    concept RadixKey = (Integer<T> && !SameAs<T, bool>) || SameAs<T, f32> || SameAs<T, f64>;
 
     namespace Cmp {
         enum Comparison : int {
@@ -10,6 +10,7 @@ namespace Quasi {
     template <class T, usize N> struct Array;
     struct Str;
     struct StrMut;
+    class JobSystem;
 
     template <class T>
     struct BufferIterator : IIterator<T, BufferIterator<T>> {
@@ -212,12 +213,14 @@ namespace Quasi {
         bool RevContainsIf(Predicate<T> auto&& pred) const { return RevFindIf(pred).HasValue(); }
 
         OptionUsize Find   (Span<const T> target) const {
+            if (target.Length() > Length()) return nullptr;
             for (usize i = 0; i <= Length() - target.Length(); ++i)
                 if (Subspan(i, target.Length()) == target) return i;
             return nullptr;
         }
         OptionUsize RevFind(Span<const T> target) const {
-            for (usize i = Length() - target.Length(); i --> 0; )
+            if (target.Length() > Length()) return nullptr;
+            for (usize i = Length() - target.Length() + 1; i --> 0; )
                 if (Subspan(i, target.Length()) == target) return i;
             return nullptr;
         }
@@ -227,10 +230,20 @@ namespace Quasi {
         template <Comparator<T> Cmpr>
         void Sort(Cmpr&& cmp = Cmpr {}) requires IsMut<T>;
         void SortByKey(FnArgs<const T&> auto&& keyf) requires IsMut<T>;
+        // calls keyf once per element and sorts the keys on the side, then moves each element once.
+        // for keys that are expensive or behind a pointer. this is stable
+        void SortByKeyCached(FnArgs<const T&> auto&& keyf) requires IsMut<T>;
 
-        // void SortStable() TODO i cant be bothered to do this
-        // void SortStableBy(Fn<bool, const T&, const T&> auto&& cmp)
-        // void SortStableByKey(auto&& keyf)
+        template <Comparator<T> Cmpr>
+        void SortStable(Cmpr&& cmp = Cmpr {}) requires IsMut<T>;
+        void SortStableByKey(FnArgs<const T&> auto&& keyf) requires IsMut<T>;
+        // stable and linear time, for integer and float keys
+        void SortRadix() requires IsMut<T> && RadixKey<T>;
+        void SortRadixByKey(FnArgs<const T&> auto&& keyf) requires IsMut<T>;
+        // splits the sort across the job system, defined in JobSystem.h. cmp is called from several threads at once
+        template <Comparator<T> Cmpr>
+        void SortParallel(JobSystem& jobs, Cmpr&& cmp = Cmpr {}) requires IsMut<T>;
+        void SortParallelByKey(JobSystem& jobs, FnArgs<const T&> auto&& keyf) requires IsMut<T>;
 
         template <Comparator<T> Cmpr>
         bool IsSorted(Cmpr&& cmp = Cmpr {}) const;
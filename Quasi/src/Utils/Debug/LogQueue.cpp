@@ -0,0 +1,187 @@
+#include "LogQueue.h"
+
+#include <bit>
+#include <csignal>
+#include <exception>
+
+#include "Logger.h"
+
+namespace Quasi::Debug {
+    struct AsyncLogQueue::Ring {
+        Vec<LogEntry> slots;
+        alignas(64) std::atomic<usize> head = 0; // next entry to read, only moved by the consumer
+        alignas(64) std::atomic<usize> tail = 0; // next entry to write, only moved by the owning thread
+        bool released = false; // the owning thread has exited, guarded by registerLock
+
+        explicit Ring(usize capacity) {
+            slots.Reserve(capacity);
+            for (usize i = 0; i < capacity; ++i) slots.Push({});
+        }
+    };
+
+    struct LocalRingRef {
+        u64 queueId;
+        void* ring;
+    };
+
+    // ids are never reused, so a thread can't pick up the ring of a queue that has since been destroyed
+    static std::atomic<u64> nextQueueId = 1;
+
+    static std::mutex liveQueuesLock;
+    static Vec<AsyncLogQueue*> liveQueues;
+
+    // the rings of the calling thread, which are released to their queues when it exits
+    struct LocalRings {
+        Vec<LocalRingRef> refs;
+        ~LocalRings() { AsyncLogQueue::ReleaseRings(refs); }
+    };
+    static thread_local LocalRings localRings;
+
+    AsyncLogQueue::AsyncLogQueue(const AsyncLogOptions& options, Sink sink)
+        : sink(std::move(sink)), options(options),
+          ringMask(std::bit_ceil(std::max<usize>(options.ringCapacity, 2)) - 1),
+          id(nextQueueId.fetch_add(1, std::memory_order_relaxed)) {
+        {
+            std::lock_guard guard { liveQueuesLock };
+            liveQueues.Push(this);
+        }
+        writer = std::thread { [this] { WriterLoop(); } };
+    }
+
+    AsyncLogQueue::~AsyncLogQueue() {
+        {
+            std::lock_guard guard { sleepLock };
+            stopping = true;
+        }
+        wakeCondition.notify_all();
+        writer.join();
+        {
+            std::lock_guard guard { liveQueuesLock };
+            if (const OptionUsize i = liveQueues.Find(this)) {
+                liveQueues[*i] = liveQueues.Last();
+                liveQueues.Pop();
+            }
+        }
+        Flush();
+    }
+
+    AsyncLogQueue::Ring& AsyncLogQueue::LocalRing() {
+        for (const LocalRingRef& ref : localRings.refs)
+            if (ref.queueId == id) return *(Ring*)ref.ring;
+
+        std::lock_guard guard { registerLock };
+        Ring* ring = nullptr;
+        // the entries an exited thread left behind are still drained, this thread just writes after them
+        for (Box<Ring>& r : rings)
+            if (r->released) { ring = r.DataMut(); break; }
+        if (ring) ring->released = false;
+        else ring = rings.Push(Box<Ring>::Build(ringMask + 1)).DataMut();
+        localRings.refs.Push({ id, ring });
+        return *ring;
+    }
+
+    void AsyncLogQueue::ReleaseRings(Span<const LocalRingRef> refs) {
+        if (refs.IsEmpty()) return;
+        // the queue can't be destroyed while it's still live and liveQueuesLock is held
+        std::lock_guard liveGuard { liveQueuesLock };
+        for (AsyncLogQueue* queue : liveQueues) {
+            for (const LocalRingRef& ref : refs) {
+                if (ref.queueId != queue->id) continue;
+                std::lock_guard guard { queue->registerLock };
+                ((Ring*)ref.ring)->released = true;
+            }
+        }
+    }
+
+    bool AsyncLogQueue::Push(LogEntry&& entry) {
+        Ring& ring = LocalRing();
+        const usize t = ring.tail.load(std::memory_order_relaxed);
+        while (t - ring.head.load(std::memory_order_acquire) > ringMask) {
+            if (options.overflow == LogOverflow::DROP || stopping.load(std::memory_order_relaxed)) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            wakeCondition.notify_one();
+            std::this_thread::yield();
+        }
+        ring.slots[t & ringMask] = std::move(entry);
+        ring.tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    usize AsyncLogQueue::RingCount() {
+        std::lock_guard guard { registerLock };
+        return rings.Length();
+    }
+
+    void AsyncLogQueue::Flush() {
+        std::lock_guard guard { drainLock };
+        DrainLocked();
+    }
+
+    void AsyncLogQueue::WriterLoop() {
+        const std::chrono::milliseconds interval { options.flushIntervalMs };
+        std::unique_lock guard { sleepLock };
+        while (!stopping) {
+            wakeCondition.wait_for(guard, interval, [&] { return stopping.load(); });
+            guard.unlock();
+            Flush();
+            guard.lock();
+        }
+    }
+
+    void AsyncLogQueue::DrainLocked() {
+        {
+            std::lock_guard guard { registerLock };
+            for (Box<Ring>& ring : rings) {
+                const usize h = ring->head.load(std::memory_order_relaxed),
+                            t = ring->tail.load(std::memory_order_acquire);
+                for (usize i = h; i < t; ++i) batch.Push(std::move(ring->slots[i & ringMask]));
+                ring->head.store(t, std::memory_order_release);
+            }
+        }
+
+        const usize droppedNow = dropped.exchange(0, std::memory_order_relaxed);
+        if (batch.IsEmpty() && !droppedNow) return;
+        sink(batch.AsSpan(), droppedNow);
+        batch.Clear();
+    }
+
+    void AsyncLogQueue::CrashFlush() {
+        // the crash may have happened while this queue was being drained or registered to
+        if (!drainLock.try_lock()) return;
+        if (registerLock.try_lock()) {
+            registerLock.unlock();
+            DrainLocked();
+        }
+        drainLock.unlock();
+    }
+
+    void AsyncLogQueue::FlushAllForCrash() {
+        if (!liveQueuesLock.try_lock()) return;
+        for (AsyncLogQueue* queue : liveQueues) queue->CrashFlush();
+        liveQueuesLock.unlock();
+        std::fflush(stdout);
+        std::fflush(stderr);
+    }
+
+    static std::terminate_handler previousTerminate = nullptr;
+
+    void AsyncLogQueue::InstallCrashHandlers() {
+        static std::once_flag installed;
+        std::call_once(installed, [] {
+            for (const int sig : { SIGSEGV, SIGABRT, SIGFPE, SIGILL }) {
+                std::signal(sig, +[] (int s) {
+                    FlushAllForCrash();
+                    std::signal(s, SIG_DFL);
+                    std::raise(s);
+                });
+            }
+            previousTerminate = std::set_terminate(+[] {
+                FlushAllForCrash();
+                if (previousTerminate) previousTerminate();
+                std::abort();
+            });
+        });
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "Utils/Box.h"
+#include "Utils/Func.h"
+#include "Utils/Vec.h"
+
+namespace Quasi::Debug {
+    struct LogEntry;
+    struct LocalRingRef;
+
+    // what a thread does when its ring is full
+    enum class LogOverflow {
+        DROP,  // the entry is thrown away and counted
+        BLOCK, // the thread waits for the writer to catch up
+    };
+
+    struct AsyncLogOptions {
+        u32 ringCapacity = 1024; // entries per thread, rounded up to a power of 2
+        LogOverflow overflow = LogOverflow::DROP;
+        u32 flushIntervalMs = 2;
+    };
+
+    // every thread that logs gets its own single-producer ring, so pushing an entry never takes a lock.
+    // when a thread exits its ring is handed to the next thread that starts logging.
+    // a background thread drains all the rings and hands each batch to the sink.
+    // entries keep their order within a thread, but not across threads.
+    class AsyncLogQueue {
+    public:
+        using Sink = FuncBox<void(Span<LogEntry> batch, usize dropped)>;
+    private:
+        struct Ring;
+
+        Sink sink;
+        AsyncLogOptions options;
+        usize ringMask;
+        u64 id;
+
+        std::mutex registerLock; // guards rings, only taken the first time a thread logs and when it exits
+        Vec<Box<Ring>> rings;
+
+        std::mutex drainLock; // whoever holds this is the consumer of every ring
+        Vec<LogEntry> batch;
+        std::atomic<usize> dropped = 0;
+
+        std::thread writer;
+        std::mutex sleepLock;
+        std::condition_variable wakeCondition;
+        std::atomic<bool> stopping = false;
+    public:
+        AsyncLogQueue(const AsyncLogOptions& options, Sink sink);
+        ~AsyncLogQueue();
+
+        AsyncLogQueue(const AsyncLogQueue&) = delete;
+        AsyncLogQueue& operator=(const AsyncLogQueue&) = delete;
+
+        // returns false if the entry was dropped
+        bool Push(LogEntry&& entry);
+        // writes out everything pushed so far on the calling thread
+        void Flush();
+        usize DroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+        // the rings made so far, which is at most how many threads have logged at once
+        usize RingCount();
+
+        // flushes every live queue on SIGSEGV, SIGABRT, SIGFPE, SIGILL and std::terminate.
+        // this is best effort, as flushing allocates and isnt signal safe.
+        static void InstallCrashHandlers();
+    private:
+        Ring& LocalRing();
+        void WriterLoop();
+        void DrainLocked();
+        void CrashFlush();
+
+        static void FlushAllForCrash();
+        // hands the rings of an exiting thread back to the queues that are still live
+        static void ReleaseRings(Span<const LocalRingRef> refs);
+        friend struct LocalRings;
+    };
+}
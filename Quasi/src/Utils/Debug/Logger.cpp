@@ -44,7 +44,6 @@ namespace Quasi::Debug {
         output.Write(log);
         output.SetColor(Text::RESET);
         output.Write('\n');
-        fflush(stdout);
     }
 
     Str Logger::FmtFile(Str fullname) const {
@@ -64,16 +63,59 @@ namespace Quasi::Debug {
 
     void Logger::ConsoleLog(const Severity::E sv, const Str s, const SourceLoc& loc) {
         FmtLog(logOut, s, sv, Timer::Now(), loc);
+        fflush(stdout);
     }
 
     void Logger::Log(const Severity::E sv, const Str s, const SourceLoc& loc) {
+        if (asyncQueue && Overrides(sv)) return LogOwned(sv, String { s }, loc);
+        LogNoOut(sv, s, loc);
+        if (Overrides(sv)) ConsoleLog(sv, s, loc);
+        BreakOn(sv);
+    }
+
+    void Logger::LogOwned(const Severity::E sv, String&& s, const SourceLoc& loc) {
+        if (!asyncQueue) return Log(sv, s, loc);
         LogNoOut(sv, s, loc);
-        ConsoleLog(sv, s, loc);
+        if (Overrides(sv)) asyncQueue->Push({ std::move(s), sv, Timer::Now(), loc });
+        BreakOn(sv);
+    }
+
+    void Logger::BreakOn(const Severity::E sv) {
         if (Overrides(breakLevel, sv)) {
+            Flush();
             DebugBreak();
         }
     }
 
+    void Logger::EnableAsync(const AsyncLogOptions& options) {
+        if (asyncQueue) return;
+        asyncQueue = Box<AsyncLogQueue>::Build(options, [this] (Span<LogEntry> batch, usize dropped) {
+            WriteBatch(batch, dropped);
+        });
+        AsyncLogQueue::InstallCrashHandlers();
+    }
+
+    void Logger::DisableAsync() {
+        asyncQueue = nullptr;
+    }
+
+    void Logger::Flush() {
+        if (asyncQueue) asyncQueue->Flush();
+        fflush(stdout);
+    }
+
+    void Logger::WriteBatch(Span<LogEntry> batch, usize dropped) {
+        // everything is formatted into one buffer, so the sink is written to and flushed once per batch
+        const Text::StringWriter out = Text::StringWriter::WriteTo(batchOut);
+        if (dropped)
+            FmtLog(out, Text::Format("{} log entries were dropped", dropped), Severity::WARN, Timer::Now(), SourceLoc::current());
+        for (const LogEntry& entry : batch)
+            FmtLog(out, entry);
+        logOut.Write(batchOut);
+        fflush(stdout);
+        batchOut.Clear();
+    }
+
     void Logger::AssertMsg(const bool assert, Str msg, const SourceLoc& loc) {
         if (!assert) {
             Log(Severity::ERROR, Text::Format("Assertion failed: {}", msg), loc);
@@ -148,6 +190,7 @@ namespace Quasi::Text {
     }
 }
 
+#ifdef _WIN32
 #include <windows.h>
 
 void Quasi::Debug::Logger::WinEnableANSI() {
@@ -158,3 +201,7 @@ void Quasi::Debug::Logger::WinEnableANSI() {
     dwMode |= ENABLE_VIRTUAL_TERMINAL_PROCESSING;
     SetConsoleMode(hConsole, dwMode);
 }
+#else
+// other terminals take ansi codes as they are
+void Quasi::Debug::Logger::WinEnableANSI() {}
+#endif
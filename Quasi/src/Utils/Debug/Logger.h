@@ -5,6 +5,7 @@
 #include "Utils/Text.h"
 #include "Utils/Text/Num.h"
 #include "Timer.h"
+#include "LogQueue.h"
 
 namespace Quasi::Debug {
     void DebugBreak();
@@ -66,6 +67,10 @@ namespace Quasi::Debug {
         bool recordLogs : 1 = false;
         u32 lPad = 50;
 
+        // set while async, the logger must not be moved until it is disabled again
+        Box<AsyncLogQueue> asyncQueue;
+        String batchOut;
+
     public:
         static Logger InternalLog;
         static Logger NulLog;
@@ -88,6 +93,15 @@ namespace Quasi::Debug {
         void SetRecordLogs(const bool flag) { recordLogs = flag; }
         void SetLocPad(const u32 pad) { lPad = pad; }
 
+        // moves formatting and writing onto a background thread, see AsyncLogQueue
+        void EnableAsync(const AsyncLogOptions& options = {});
+        // writes out what is left and joins the background thread.
+        // the queue is destroyed without waiting on anyone still pushing to it,
+        // so every other thread that logs with this logger has to have stopped first
+        void DisableAsync();
+        bool IsAsync() const { return (bool)asyncQueue; }
+        void Flush();
+
         void FmtLog(Text::StringWriter output, const LogEntry& log) const;
         void FmtLog(Text::StringWriter output, Str log, Severity::E severity, DateTime time, const SourceLoc& fileLoc) const;
         Str FmtFile(Str fullname) const;
@@ -95,13 +109,17 @@ namespace Quasi::Debug {
         void LogNoOut  (Severity::E sv, Str s, const SourceLoc& loc = SourceLoc::current());
         void ConsoleLog(Severity::E sv, Str s, const SourceLoc& loc = SourceLoc::current());
         void Log       (Severity::E sv, Str s, const SourceLoc& loc = SourceLoc::current());
+        void LogOwned  (Severity::E sv, String&& s, const SourceLoc& loc = SourceLoc::current());
+        // whether a log of this severity does anything, so that it can be skipped before formatting
+        bool WantsLog  (Severity::E sv) const { return Overrides(sv) || recordLogs || Overrides(breakLevel, sv); }
 
         void AssertMsg(bool assert, Str msg, const SourceLoc& loc = SourceLoc::current());
 
         void WriteAllLogs(Text::StringWriter out, Severity::E filter = Severity::OFF);
 
         template <class ...Ts> void LogFmt(Severity::E s, const FmtStr& fmt, const Ts&... args) {
-            this->Log(s, Text::Format(fmt.fmt, args...), fmt.loc);
+            if (!WantsLog(s)) return;
+            this->LogOwned(s, Text::Format(fmt.fmt, args...), fmt.loc);
         }
 
         template <class ...Ts> void Assert(bool assert, const FmtStr& fmt, const Ts&... args) {
@@ -130,6 +148,9 @@ namespace Quasi::Debug {
         static Logger& GetInternalLog();
 
         static void WinEnableANSI();
+    private:
+        void WriteBatch(Span<LogEntry> batch, usize dropped);
+        void BreakOn(Severity::E sv);
     };
 
     inline void SetFilter(Severity::E s) { Logger::GetInternalLog().SetFilter(s); }
@@ -140,6 +161,9 @@ namespace Quasi::Debug {
     inline void SetShortenFile(const bool flag) { Logger::GetInternalLog().SetShortenFile(flag); }
     inline void SetIncludeFunc(const bool flag) { Logger::GetInternalLog().SetIncludeFunc(flag); }
     inline void SetLocPad(const int pad) { Logger::GetInternalLog().SetLocPad(pad); }
+    inline void EnableAsync(const AsyncLogOptions& options = {}) { Logger::GetInternalLog().EnableAsync(options); }
+    inline void DisableAsync() { Logger::GetInternalLog().DisableAsync(); }
+    inline void Flush() { Logger::GetInternalLog().Flush(); }
 
     inline void Log(Severity::E sv, Str s, const SourceLoc& loc = SourceLoc::current()) { Logger::GetInternalLog().Log(sv, s, loc); }
 
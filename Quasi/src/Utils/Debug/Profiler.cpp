@@ -0,0 +1,266 @@
+#include "Profiler.h"
+
+#include <chrono>
+#include <cstring>
+#include <mutex>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define Q_PROFILE_RDTSC
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define Q_PROFILE_RDTSC
+#endif
+
+#include "Utils/Algorithm.h"
+#include "Utils/Box.h"
+#include "Utils/Text.h"
+#include "Utils/Text/Num.h"
+
+namespace Quasi::Debug {
+    struct ProfileSlot {
+        const char* name;
+        u64 begin, end;
+        u32 depth;
+    };
+
+    struct ProfileRing {
+        Vec<ProfileSlot> slots;
+        alignas(64) std::atomic<u64> written = 0; // total zones ever written, only moved by the owning thread
+        std::atomic<u64> clearedAt = 0;           // zones before this are ignored
+        String name;                              // guarded by ringsLock
+        u32 index;
+
+        ProfileRing(u32 index) : index(index) {
+            slots.Reserve(Profiler::RING_CAPACITY);
+            for (usize i = 0; i < Profiler::RING_CAPACITY; ++i) slots.Push({});
+        }
+    };
+
+    static std::mutex ringsLock;
+    static Vec<Box<ProfileRing>> rings;
+    static thread_local ProfileRing* localRing = nullptr;
+    static thread_local u32 localDepth = 0;
+    static thread_local String localName; // held until the thread's first zone
+
+    static u64 Ticks() {
+#ifdef Q_PROFILE_RDTSC
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    static u64 SteadyNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // the tick rate is measured between enabling and collecting
+    static std::once_flag originFlag;
+    static u64 originTicks = 0, originNanos = 0;
+
+    struct TickConverter {
+        u64 origin;
+        f64 nanosPerTick;
+
+        u64 operator()(u64 ticks) const {
+            return ticks > origin ? (u64)((f64)(ticks - origin) * nanosPerTick) : 0;
+        }
+
+        static TickConverter Current() {
+#ifdef Q_PROFILE_RDTSC
+            const u64 ticks = Ticks(), nanos = SteadyNanos();
+            const f64 rate = ticks > originTicks && nanos > originNanos ?
+                (f64)(nanos - originNanos) / (f64)(ticks - originTicks) : 1.0;
+            return { originTicks, rate };
+#else
+            return { originTicks, 1.0 };
+#endif
+        }
+    };
+
+    // zone and thread names are plain text, but json only allows a few escapes
+    static String JsonQuote(Str str) {
+        String quoted = String::WithCap(str.Length() + 2);
+        quoted += '"';
+        for (const char c : str) {
+            if (c == '"' || c == '\\') { quoted += '\\'; quoted += c; }
+            else if ((u8)c < 0x20) quoted += Text::Format("\\u{:04x}", (u32)c);
+            else quoted += c;
+        }
+        quoted += '"';
+        return quoted;
+    }
+
+    void Profiler::Enable(bool on) {
+        std::call_once(originFlag, [] { originTicks = Ticks(); originNanos = SteadyNanos(); });
+        enabled.store(on, std::memory_order_relaxed);
+    }
+
+    ProfileRing& Profiler::LocalRing() {
+        if (localRing) return *localRing;
+
+        std::lock_guard guard { ringsLock };
+        ProfileRing& ring = *rings.Push(Box<ProfileRing>::Build((u32)rings.Length()));
+        ring.name = localName.IsEmpty() ? Text::Format("thread {}", ring.index) : std::move(localName);
+        localRing = &ring;
+        return ring;
+    }
+
+    void Profiler::SetThreadName(Str name) {
+        // rings are big, so threads that never record dont get one
+        if (!localRing) { localName = String::FromStr(name); return; }
+        std::lock_guard guard { ringsLock };
+        localRing->name = String::FromStr(name);
+    }
+
+    Vec<String> Profiler::ThreadNames() {
+        std::lock_guard guard { ringsLock };
+        Vec<String> names = Vec<String>::WithCap(rings.Length());
+        for (const Box<ProfileRing>& ring : rings) names.Push(ring->name.Clone());
+        return names;
+    }
+
+    u64 Profiler::BeginZone() {
+        ++localDepth;
+        return Ticks();
+    }
+
+    void Profiler::EndZone(const char* name, u64 begin) {
+        const u64 end = Ticks();
+        ProfileRing& ring = LocalRing();
+        const u64 w = ring.written.load(std::memory_order_relaxed);
+        ring.slots[w & (RING_CAPACITY - 1)] = { name, begin, end, --localDepth };
+        ring.written.store(w + 1, std::memory_order_release);
+    }
+
+    Vec<ProfileEvent> Profiler::Collect() {
+        const TickConverter toNanos = TickConverter::Current();
+        Vec<ProfileEvent> events;
+        Vec<ProfileSlot> snapshot;
+
+        std::lock_guard guard { ringsLock };
+        for (Box<ProfileRing>& ring : rings) {
+            const u64 written = ring->written.load(std::memory_order_acquire),
+                      from = std::max(written - std::min<u64>(written, RING_CAPACITY), ring->clearedAt.load(std::memory_order_relaxed));
+            snapshot.Clear();
+            for (u64 i = from; i < written; ++i) snapshot.Push(ring->slots[i & (RING_CAPACITY - 1)]);
+
+            // anything the owner wrapped around to while copying might be torn
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const u64 rewritten = ring->written.load(std::memory_order_relaxed);
+            const usize torn = rewritten - from > RING_CAPACITY ? std::min<u64>(rewritten - from - RING_CAPACITY, written - from) : 0;
+            for (usize i = torn; i < snapshot.Length(); ++i) {
+                const ProfileSlot& slot = snapshot[i];
+                events.Push({ Str::Slice(slot.name, std::strlen(slot.name)), toNanos(slot.begin), toNanos(slot.end), slot.depth, ring->index });
+            }
+        }
+
+        events.Sort([] (const ProfileEvent& lhs, const ProfileEvent& rhs) {
+            if (lhs.thread  != rhs.thread)  return Cmp::Between(lhs.thread,  rhs.thread);
+            if (lhs.beginNs != rhs.beginNs) return Cmp::Between(lhs.beginNs, rhs.beginNs);
+            return Cmp::Between(lhs.depth, rhs.depth);
+        });
+        return events;
+    }
+
+    void Profiler::Clear() {
+        std::lock_guard guard { ringsLock };
+        for (Box<ProfileRing>& ring : rings)
+            ring->clearedAt.store(ring->written.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+
+    ProfileSummary Profiler::Summarize() {
+        const Vec<ProfileEvent> events = Collect();
+        return ProfileSummary::Build(events.AsSpan(), ThreadNames());
+    }
+
+    String Profiler::ChromeTraceJson() {
+        const Vec<ProfileEvent> events = Collect();
+        const Vec<String> names = ThreadNames();
+
+        String json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        for (u32 i = 0; i < names.Length(); ++i) {
+            json += Text::Format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},\"args\":{{\"name\":{}}}}},\n",
+                                 i, JsonQuote(names[i]));
+        }
+        // chrome wants microseconds, the fraction keeps the nanoseconds
+        for (const ProfileEvent& e : events) {
+            const u64 dur = e.endNs - e.beginNs;
+            json += Text::Format("{{\"name\":{},\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{}.{:03},\"dur\":{}.{:03}}},\n",
+                                 JsonQuote(e.name), e.thread, e.beginNs / 1000, e.beginNs % 1000, dur / 1000, dur % 1000);
+        }
+        // the last entry's trailing comma
+        if (names || events) { json.Pop(); json.Pop(); }
+        json += "\n]}\n";
+        return json;
+    }
+
+    bool Profiler::WriteChromeTrace(CStr fname) {
+        return Text::WriteFile(fname, ChromeTraceJson());
+    }
+
+    ProfileSummary ProfileSummary::Build(Span<const ProfileEvent> events, Vec<String> threadNames) {
+        struct Open { u32 node; u32 depth; u64 endNs; };
+
+        ProfileSummary summary;
+        summary.threadNames = std::move(threadNames);
+        Vec<Open> stack;
+        u32 thread = ~0u;
+        for (const ProfileEvent& e : events) {
+            if (e.thread != thread) {
+                thread = e.thread;
+                summary.roots.Push((u32)summary.nodes.Length());
+                summary.nodes.Push({ .name = e.thread < summary.threadNames.Length() ? summary.threadNames[e.thread].AsStr() : Str { "thread" } });
+                stack.Clear();
+                stack.Push({ summary.roots.Last(), 0, ~0ull });
+            }
+            // the enclosing zone might be missing if it was overwritten or is still open
+            while (stack.Length() > 1 && (stack.Last().depth > e.depth || stack.Last().endNs < e.endNs))
+                stack.Pop();
+
+            const u32 parent = stack.Last().node;
+            const Vec<u32>& siblings = summary.nodes[parent].children;
+            const OptionUsize existing = siblings.FindIf([&] (u32 c) { return summary.nodes[c].name == e.name; });
+            const u32 child = existing ? siblings[*existing] : (u32)summary.nodes.Length();
+            if (!existing) {
+                summary.nodes[parent].children.Push(child);
+                summary.nodes.Push({ .name = e.name });
+            }
+            ProfileNode& node = summary.nodes[child];
+            ++node.calls;
+            node.totalNs += e.endNs - e.beginNs;
+            stack.Push({ child, e.depth + 1, e.endNs });
+        }
+
+        // children always come after their parents, so going backwards sees them first
+        for (usize i = summary.nodes.Length(); i --> 0;) {
+            ProfileNode& node = summary.nodes[i];
+            u64 childTotal = 0;
+            for (const u32 c : node.children) childTotal += summary.nodes[c].totalNs;
+            if (!node.calls) node.totalNs = childTotal;
+            node.selfNs = node.totalNs > childTotal ? node.totalNs - childTotal : 0;
+        }
+        return summary;
+    }
+
+    void ProfileSummary::WriteTo(Text::StringWriter out) const {
+        out.Write("{:<48} {:>8} {:>14} {:>14} {:>14}\n", Str { "zone" }, Str { "calls" }, Str { "total us" }, Str { "self us" }, Str { "avg us" });
+        for (const u32 root : roots) WriteNode(out, root, 0);
+    }
+
+    void ProfileSummary::WriteNode(Text::StringWriter out, u32 i, u32 indent) const {
+        const ProfileNode& node = nodes[i];
+        String label;
+        for (u32 j = 0; j < indent; ++j) label += "  ";
+        label += node.name;
+        const f64 totalUs = (f64)node.totalNs / 1000.0, selfUs = (f64)node.selfNs / 1000.0;
+        out.Write("{:<48} {:8} {:>14.3f} {:>14.3f} {:>14.3f}\n", label, node.calls,
+                  totalUs, selfUs, node.calls ? totalUs / (f64)node.calls : 0.0);
+
+        // heaviest first
+        Vec<u32> children = node.children.Clone();
+        children.SortByKey([&] (u32 c) { return ~nodes[c].totalNs; });
+        for (const u32 c : children) WriteNode(out, c, indent + 1);
+    }
+}
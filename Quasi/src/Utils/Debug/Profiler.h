@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+
+#include "Utils/CStr.h"
+#include "Utils/String.h"
+#include "Utils/Vec.h"
+#include "Utils/Text/StringWriter.h"
+
+namespace Quasi::Debug {
+    struct ProfileRing;
+
+    // a finished zone, with times in nanoseconds since the profiler was first enabled
+    struct ProfileEvent {
+        Str name;
+        u64 beginNs, endNs;
+        u32 depth;  // how many zones of the same thread were open around it
+        u32 thread; // index into Profiler::ThreadNames
+    };
+
+    struct ProfileNode {
+        Str name;
+        u64 calls = 0, totalNs = 0, selfNs = 0;
+        Vec<u32> children; // indices into ProfileSummary::nodes
+    };
+
+    // the zones merged by call path, one root per thread
+    struct ProfileSummary {
+        Vec<ProfileNode> nodes;
+        Vec<u32> roots;
+        Vec<String> threadNames; // the roots' names point into these
+
+        static ProfileSummary Build(Span<const ProfileEvent> events, Vec<String> threadNames);
+
+        void WriteTo(Text::StringWriter out) const;
+    private:
+        void WriteNode(Text::StringWriter out, u32 node, u32 indent) const;
+    };
+
+    // every thread records its zones into its own ring, which overwrites the oldest zones once full.
+    // recording is a timestamp read on entry and a ring write on exit, nothing is locked or allocated after the first zone.
+    // timestamps come from rdtsc on x86 and steady_clock elsewhere, and are converted to nanoseconds when collected.
+    class Profiler {
+        inline static std::atomic<bool> enabled = false;
+    public:
+        static constexpr usize RING_CAPACITY = 1 << 16; // zones kept per thread
+
+        static void Enable(bool on = true);
+        static void Disable() { Enable(false); }
+        static bool IsEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+        static void SetThreadName(Str name);
+        static Vec<String> ThreadNames();
+
+        // every zone still in the rings, sorted by thread, then begin time, then depth.
+        // this can run while other threads record, zones that were overwritten while copying are left out.
+        static Vec<ProfileEvent> Collect();
+        static void Clear();
+
+        static ProfileSummary Summarize();
+        // chrome's trace event format, which loads into chrome://tracing and perfetto
+        static String ChromeTraceJson();
+        static bool WriteChromeTrace(CStr fname);
+
+        // used by ProfileZone
+        static u64 BeginZone();
+        static void EndZone(const char* name, u64 begin);
+    private:
+        static ProfileRing& LocalRing();
+    };
+
+    // times its scope, use QProfile$ so that it can be compiled out
+    class ProfileZone {
+        const char* name;
+        u64 begin;
+    public:
+        explicit ProfileZone(const char* name)
+            : name(Profiler::IsEnabled() ? name : nullptr), begin(this->name ? Profiler::BeginZone() : 0) {}
+        ~ProfileZone() { if (name) Profiler::EndZone(name, begin); }
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+    };
+
+    // NAME has to be a string literal, or otherwise outlive the profiler
+#ifdef Q_NO_PROFILE
+    #define QProfile$(NAME) Q_NOOP()
+#else
+    #define QProfile$(NAME) const Quasi::Debug::ProfileZone Q_UNIQUE_ID(_profileZone) { NAME }
+#endif
+}
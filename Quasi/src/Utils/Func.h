@@ -141,7 +141,8 @@ namespace Quasi {
         FuncRef<O(Is...)> FromRaw(void* user, O(*fptr)(void*, Is...)) { return FuncRef<O(Is...)>::FromRaw(user, fptr); }
     }
 
-    template <class T> struct Vec;
+    namespace Memory { struct GlobalAllocator; }
+    template <class T, class A = Memory::GlobalAllocator> struct Vec;
 
     namespace Combinate {
         struct Identity {
@@ -1,4 +1,8 @@
 #pragma once
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "Hash.h"
 #include "Utils/Debug/Logger.h"
 
@@ -162,6 +166,10 @@ namespace Quasi {
     namespace HashTables {
         static constexpr usize MaxLoadFactorPer100 = 80;
         inline void AbortOverflowError() { Debug::QCritical$("hashmap encountered overflow"); }
+
+        // what a HashSet passes and gets back where a HashMap has its values
+        struct NoValue {};
+        template <class V> using ValueOrNone = IfElse<std::is_void_v<V>, NoValue, V>;
     }
 
     // A highly optimized hashmap implementation, using the Robin Hood algorithm.
@@ -196,6 +204,15 @@ namespace Quasi {
         using PairType = KeyValuePair<Key, Value>;
         using HasherType = Hasher;
     private:
+        // sets go through the same code as maps, with NoValue standing in for the value they dont have
+        static constexpr bool IsSet = std::is_void_v<Value>;
+        using ValueArg = HashTables::ValueOrNone<Value>;
+
+        static PairType MakePair(Key&& k, ValueArg&& v) {
+            if constexpr (IsSet) return { std::move(k) };
+            else return { std::move(k), std::move(v) };
+        }
+
         // make sure we have 8 elements, needed to quickly rehash mInfo
         static constexpr usize InitialNumElements = sizeof(u64);
         static constexpr u32   InitialInfoBitPos = 5;
@@ -235,9 +252,9 @@ namespace Quasi {
         private:
             IfElse<IsFlat, PairType, PairType*> data;
         public:
-            explicit Node(HashTable&,   Key k, Value v) requires IsFlat : data { std::move(k), std::move(v) } {}
-            explicit Node(HashTable& t, Key k, Value v) requires (!IsFlat) : data(t.Allocate()) {
-                new (data) PairType(std::move(k), std::move(v));
+            explicit Node(HashTable&,   Key k, ValueArg v) requires IsFlat : data(MakePair(std::move(k), std::move(v))) {}
+            explicit Node(HashTable& t, Key k, ValueArg v) requires (!IsFlat) : data(t.Allocate()) {
+                new (data) PairType(MakePair(std::move(k), std::move(v)));
             }
             Node(HashTable&, Node&& n) : data(std::move(n.data)) {}
 
@@ -261,15 +278,15 @@ namespace Quasi {
 
             Key&       GetKey()       { return operator->()->key; }
             const Key& GetKey() const { return operator->()->key; }
-            Value&       GetValue()       { return operator->()->value; }
-            const Value& GetValue() const { return operator->()->value; }
+            ValueArg&       GetValue()       { return operator->()->value; }
+            const ValueArg& GetValue() const { return operator->()->value; }
 
             operator PairType&()             { return operator*(); }
             operator const PairType&() const { return operator*(); }
             operator Key&()                  { return GetKey(); }
             operator const Key&()      const { return GetKey(); }
-            operator Value&()                { return GetValue(); }
-            operator const Value&()    const { return GetValue(); }
+            operator ValueArg&()             { return GetValue(); }
+            operator const ValueArg&() const { return GetValue(); }
         };
 
         static void DestroyNodesNoDeallocate(HashTable& m) {
@@ -547,31 +564,32 @@ namespace Quasi {
             return true;
         }
 
-        Value& operator[](const Key& key) {
+        ValueArg& operator[](const Key& key) {
             const auto [index, result] = InsertKeyAndPrepareSlot(key);
             switch (result) {
                 case InsertResult::New: case InsertResult::Overwrite:
-                    InitOrWriteNode(index, key, Value {}, result);
+                    InitOrWriteNode(index, key, ValueArg {}, result);
                 default:;
             }
             return kvData[index].GetValue();
         }
-        Value& operator[](Key&& key) {
+        ValueArg& operator[](Key&& key) {
             const auto [index, result] = InsertKeyAndPrepareSlot(key);
             switch (result) {
                 case InsertResult::New: case InsertResult::Overwrite:
-                    InitOrWriteNode(index, std::move(key), Value {}, result);
+                    InitOrWriteNode(index, std::move(key), ValueArg {}, result);
                 default:;
             }
             return kvData[index].GetValue();
         }
-        OptRef<const Value> operator[](const Key& key) const { return Get(key); }
-        OptRef<const Value> Get(const Key& key) const {
+        OptRef<const ValueArg> operator[](const Key& key) const { return Get(key); }
+        OptRef<const ValueArg> Get(const Key& key) const {
             const OptionUsize i = FindIndexOf(key);
             return i ? OptRefs::SomeRef(kvData[*i].GetValue()) : nullptr;
         }
-        OptRef<const Value> operator[](const auto& kview) const { return Get(kview); }
-        OptRef<const Value> Get(const auto& kview) const {
+        OptRef<ValueArg> Get(const Key& key) { return QGetterMut$(Get, key); }
+        OptRef<const ValueArg> operator[](const auto& kview) const { return Get(kview); }
+        OptRef<const ValueArg> Get(const auto& kview) const {
             const OptionUsize i = FindIndexOf(kview);
             return i ? OptRefs::SomeRef(kvData[*i].GetValue()) : nullptr;
         }
@@ -711,7 +729,7 @@ namespace Quasi {
 
         enum class InsertResult { Found, New, Overwrite, OverflowError };
 
-        void InitOrWriteNode(usize index, Key k, Value v, InsertResult r) {
+        void InitOrWriteNode(usize index, Key k, ValueArg v, InsertResult r) {
             switch (r) {
                 case InsertResult::New:
                     new (&kvData[index]) Node(*this, std::move(k), std::move(v));
@@ -774,20 +792,20 @@ namespace Quasi {
     private:
         // tries to insert a new value and returns a reference, unless one already exists
         template <class Kfwd>
-        OptRef<PairType> TryInsertInternal(Kfwd&& k, Value v) {
+        OptRef<PairType> TryInsertInternal(Kfwd&& k, ValueArg v) {
             const auto [i, result] = InsertKeyAndPrepareSlot(k);
             InitOrWriteNode(i, std::forward<Kfwd>(k), std::move(v), result);
-            return result == InsertResult::Found ? nullptr : *kvData[i];
+            return result == InsertResult::Found ? nullptr : OptRefs::SomeRef(*kvData[i]);
         }
 
         // sets the value even if it was found,
         // and returns true if the value is new or false if it was overwritten
         template <class Kfwd>
-        Tuple<PairType&, bool> InsertOrAssignInternal(Kfwd&& k, Value v) {
+        Tuple<PairType&, bool> InsertOrAssignInternal(Kfwd&& k, ValueArg v) {
             const auto [i, result] = InsertKeyAndPrepareSlot(k);
             switch (result) {
                 case InsertResult::Found:
-                    kvData[i].GetValue() = std::move(v);
+                    if constexpr (!IsSet) kvData[i].GetValue() = std::move(v);
                 break;
                 case InsertResult::New:
                     new (&kvData[i]) Node(*this, std::forward<Kfwd>(k), std::move(v));
@@ -802,7 +820,7 @@ namespace Quasi {
         // returns the previous value associated with the key, unless there wasn't any to begin with
         // also writes the new value to the associated key
         template <class Kfwd>
-        Option<Value> ReplaceInternal(Kfwd&& k, Value v) {
+        Option<ValueArg> ReplaceInternal(Kfwd&& k, ValueArg v) {
             const auto [i, result] = InsertKeyAndPrepareSlot(k);
             switch (result) {
                 case InsertResult::Found:
@@ -818,21 +836,26 @@ namespace Quasi {
             return nullptr;
         }
     public:
-        OptRef<PairType> TryInsert(const Key& k, Value v) { return TryInsertInternal(k,            std::move(v)); }
-        OptRef<PairType> TryInsert(Key&& k,      Value v) { return TryInsertInternal(std::move(k), std::move(v)); }
-        Tuple<PairType&, bool> InsertOrAssign(const Key& k, Value v) { return InsertOrAssignInternal(k,            std::move(v)); }
-        Tuple<PairType&, bool> InsertOrAssign(Key&&      k, Value v) { return InsertOrAssignInternal(std::move(k), std::move(v)); }
-        PairType& Insert(const Key& k, Value v) { return InsertOrAssignInternal(k,            std::move(v))[1_st]; }
-        PairType& Insert(Key&&      k, Value v) { return InsertOrAssignInternal(std::move(k), std::move(v))[1_st]; }
-        Option<Value> Replace(const Key& k, Value v) { return ReplaceInternal(k,            std::move(v)); }
-        Option<Value> Replace(Key&&      k, Value v) { return ReplaceInternal(std::move(k), std::move(v)); }
+        OptRef<PairType> TryInsert(const Key& k, ValueArg v) { return TryInsertInternal(k,            std::move(v)); }
+        OptRef<PairType> TryInsert(Key&& k,      ValueArg v) { return TryInsertInternal(std::move(k), std::move(v)); }
+        Tuple<PairType&, bool> InsertOrAssign(const Key& k, ValueArg v) { return InsertOrAssignInternal(k,            std::move(v)); }
+        Tuple<PairType&, bool> InsertOrAssign(Key&&      k, ValueArg v) { return InsertOrAssignInternal(std::move(k), std::move(v)); }
+        PairType& Insert(const Key& k, ValueArg v) { return InsertOrAssignInternal(k,            std::move(v))[1_st]; }
+        PairType& Insert(Key&&      k, ValueArg v) { return InsertOrAssignInternal(std::move(k), std::move(v))[1_st]; }
+        Option<ValueArg> Replace(const Key& k, ValueArg v) { return ReplaceInternal(k,            std::move(v)); }
+        Option<ValueArg> Replace(Key&&      k, ValueArg v) { return ReplaceInternal(std::move(k), std::move(v)); }
+        // for sets, which only have the key to insert
+        OptRef<PairType> TryInsert(const Key& k) requires IsSet { return TryInsertInternal(k,            ValueArg {}); }
+        OptRef<PairType> TryInsert(Key&& k)      requires IsSet { return TryInsertInternal(std::move(k), ValueArg {}); }
+        PairType& Insert(const Key& k) requires IsSet { return InsertOrAssignInternal(k,            ValueArg {})[1_st]; }
+        PairType& Insert(Key&&      k) requires IsSet { return InsertOrAssignInternal(std::move(k), ValueArg {})[1_st]; }
 
         // removes the key in the map
         bool Remove(const Key& k) {
             const OptionUsize i = FindIndexOf(k);
             if (!i) return false;
 
-            ShiftDown(i);
+            ShiftDown(*i);
             --elmCount;
             return true;
         }
@@ -855,12 +878,12 @@ namespace Quasi {
         }
 
         // removes the key value pair, and returns the value as well
-        Option<Value> Take(const Key& k) {
+        Option<ValueArg> Take(const Key& k) {
             const OptionUsize i = FindIndexOf(k);
             if (!i) return nullptr;
 
-            Value val = std::move(kvData[*i].GetValue());
-            ShiftDown(i);
+            ValueArg val = std::move(kvData[*i].GetValue());
+            ShiftDown(*i);
             --elmCount;
             return val;
         }
@@ -871,7 +894,7 @@ namespace Quasi {
             if (!i) return nullptr;
 
             PairType kvpair = std::move(*kvData[*i]);
-            ShiftDown(i);
+            ShiftDown(*i);
             --elmCount;
             return kvpair;
         }
@@ -893,8 +916,8 @@ namespace Quasi {
         }
 
         TableIter<const Key>   Keys()   const { return TableIter<const Key>  ::FromFwd(kvData, KvEnd(), infoData); }
-        TableIter<const Value> Values() const { return TableIter<const Value>::FromFwd(kvData, KvEnd(), infoData); }
-        TableIter<Value>       ValuesMut()    { return TableIter<Value>      ::FromFwd(kvData, KvEnd(), infoData); }
+        TableIter<const ValueArg> Values() const { return TableIter<const ValueArg>::FromFwd(kvData, KvEnd(), infoData); }
+        TableIter<ValueArg>       ValuesMut()    { return TableIter<ValueArg>      ::FromFwd(kvData, KvEnd(), infoData); }
 
         // reserves space for the specified number of elements. Makes sure the old data fits.
         // exactly the same as reserve(c).
@@ -1106,9 +1129,625 @@ namespace Quasi {
         friend ICollection<KeyValuePair<Key, Value>, HashTable>;
     };
 
-    template <class K, class V, class Hasher = Hashing::DefaultHasher>
-    struct HashMap : HashTable<sizeof(KeyValuePair<K, V>) <= sizeof(usize) * 6, K, V, Hasher> {};
+    namespace HashTables {
+        // each slot of a swiss table has a control byte, which is either empty, deleted,
+        // or for full slots, the lowest 7 bits of the hash.
+        static constexpr u8 CtrlEmpty = 0x80, CtrlDeleted = 0xFE;
+        static constexpr bool IsFull(u8 ctrl) { return ctrl < 0x80; }
+
+        // a set of slots within a group, one bit per slot (or one per byte for the scalar group)
+        template <class Bits, u32 Width, u32 Shift>
+        struct GroupMask {
+            Bits bits;
+
+            explicit operator bool() const { return bits != 0; }
+            u32 First() const { return (u32)std::countr_zero(bits) >> Shift; }
+            // the number of unset slots below the first set one, or above the last set one
+            u32 TrailingZeros() const { return First(); }
+            u32 LeadingZeros() const { return (u32)(std::countl_zero(bits) - (sizeof(Bits) * 8 - (Width << Shift))) >> Shift; }
+
+            // iterating yields the index of each set slot
+            GroupMask& operator++() { bits &= bits - 1; return *this; }
+            u32 operator*() const { return First(); }
+            GroupMask begin() const { return *this; }
+            GroupMask end() const { return { 0 }; }
+            bool operator!=(const GroupMask& other) const { return bits != other.bits; }
+        };
+
+#ifdef __SSE2__
+        // 16 control bytes, matched with a single sse2 compare each
+        struct ControlGroup {
+            static constexpr usize Width = 16;
+            using Mask = GroupMask<u32, Width, 0>;
+            __m128i ctrl;
+
+            explicit ControlGroup(const u8* p) : ctrl(_mm_loadu_si128((const __m128i*)p)) {}
+
+            Mask Match(u8 h2) const { return { (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8((char)h2), ctrl)) }; }
+            Mask MatchEmpty() const { return Match(CtrlEmpty); }
+            Mask MatchNonFull() const { return { (u32)_mm_movemask_epi8(ctrl) }; }
+            Mask MatchFull() const { return { ~(u32)_mm_movemask_epi8(ctrl) & 0xFFFF }; }
+        };
+#else
+        // 8 control bytes packed in a u64, matched with bit tricks.
+        // Match can give false positives next to a real match, which the key comparison filters out.
+        struct ControlGroup {
+            static constexpr usize Width = 8;
+            using Mask = GroupMask<u64, Width, 3>;
+            static constexpr u64 Lsbs = 0x0101010101010101, Msbs = 0x8080808080808080;
+            u64 ctrl;
+
+            explicit ControlGroup(const u8* p) : ctrl(Memory::ReadU64(p)) {}
+
+            Mask Match(u8 h2) const {
+                const u64 x = ctrl ^ (Lsbs * h2);
+                return { (x - Lsbs) & ~x & Msbs };
+            }
+            // empty is 0b10000000, deleted is 0b11111110
+            Mask MatchEmpty() const { return { ctrl & ~(ctrl << 6) & Msbs }; }
+            Mask MatchNonFull() const { return { ctrl & Msbs }; }
+            Mask MatchFull() const { return { ~ctrl & Msbs }; }
+        };
+#endif
+
+        // what an unallocated table points to, so lookups need no special case
+        alignas(16) inline constexpr u8 EmptyGroup[ControlGroup::Width] = {
+            CtrlEmpty, CtrlEmpty, CtrlEmpty, CtrlEmpty, CtrlEmpty, CtrlEmpty, CtrlEmpty, CtrlEmpty,
+#ifdef __SSE2__
+            CtrlEmpty, CtrlEmpty, CtrlEmpty, CtrlEmpty, CtrlEmpty, CtrlEmpty, CtrlEmpty, CtrlEmpty,
+#endif
+        };
+    }
+
+    // A hashmap that probes a whole group of slots at a time, based on abseil's swiss tables.
+    // https://abseil.io/about/design/swisstables
+    //
+    // This implementation uses the following memory layout:
+    //
+    // [Pair, Pair, ... Pair | ctrl, ctrl, ... ctrl | ctrl mirror ]
+    //
+    // * Pair: the key value pairs are stored flat, there are always 2^n of them (at least a group's worth).
+    //
+    // * ctrl: one control byte per pair, see HashTables::CtrlEmpty. A lookup matches the 7 hash
+    //   bits against every control byte in a group at once, and only compares keys on a match.
+    //   Probing stops at the first group with an empty slot, so removed slots become tombstones
+    //   unless no probe could have passed through them.
+    //
+    // * ctrl mirror: a copy of the first group's control bytes, so a group starting near the end
+    //   can be loaded without wrapping around.
+    //
+    // the public interface is the same as HashTable's, so either can back a HashMap.
+    template <class Key, class Value, class Hasher>
+    struct SwissTable : ICollection<KeyValuePair<Key, Value>, SwissTable<Key, Value, Hasher>> {
+        using KeyType = Key;
+        using ValueType = Value;
+        using PairType = KeyValuePair<Key, Value>;
+        using HasherType = Hasher;
+    private:
+        // sets go through the same code as maps, with NoValue standing in for the value they dont have
+        static constexpr bool IsSet = std::is_void_v<Value>;
+        using ValueArg = HashTables::ValueOrNone<Value>;
+
+        static PairType MakePair(Key&& k, ValueArg&& v) {
+            if constexpr (IsSet) return { std::move(k) };
+            else return { std::move(k), std::move(v) };
+        }
+
+        using Group = HashTables::ControlGroup;
+        static constexpr usize MinCapacity = Group::Width;
+        static constexpr u64   HashMultiplier = 0xc4ceb9fe1a85ec53;
+
+        PairType* slots      = nullptr;
+        u8*       ctrl       = const_cast<u8*>(HashTables::EmptyGroup);
+        usize     elmCount   = 0;
+        usize     mask       = 0;
+        usize     growthLeft = 0; // how many empty slots can still be filled before resizing
+        [[no_unique_address]] Hasher hasher;
+
+        usize Capacity() const { return slots ? mask + 1 : 0; }
+        // keeps 1/8 of the slots empty, so probing always ends
+        static usize GrowthFor(usize capacity) { return capacity - capacity / 8; }
+
+        u64 HashOf(const auto& key) const {
+            u64 h = (u64)hasher(key);
+            h *= HashMultiplier;
+            h ^= h >> 33;
+            return h;
+        }
+        static usize H1(u64 h) { return (usize)(h >> 7); }
+        static u8    H2(u64 h) { return (u8)(h & 0x7F); }
+
+        void SetCtrl(usize i, u8 c) {
+            ctrl[i] = c;
+            // writes to the mirror when i is in the first group, otherwise just writes to i again
+            ctrl[((i - Group::Width) & mask) + Group::Width] = c;
+        }
+
+        enum class Field { PAIR, KEY, VALUE };
+
+        // generic iterator for keys, values, valuesmut, pairs, and pairsmut
+        template <class T, Field F>
+        struct TableIter : IIterator<T&, TableIter<T, F>> {
+            friend IIterator<T&, TableIter>;
+        private:
+            using SlotPtr = AddConstIf<PairType, T>*;
+            friend struct SwissTable;
+            SlotPtr slot = nullptr;
+            const PairType* slotEnd = nullptr;
+            const u8* ctrl = nullptr;
+
+            TableIter(SlotPtr s, const PairType* end, const u8* c) : slot(s), slotEnd(end), ctrl(c) {}
+        public:
+            using Item = T&;
+
+            TableIter() = default;
+            TableIter(const TableIter&) = default;
+            TableIter(TableIter&&) = default;
+            // Iter<T> -> Iter<const T>
+            TableIter(const TableIter<RemConst<T>, F>& other) requires IsConst<T>
+                : slot(other.slot), slotEnd(other.slotEnd), ctrl(other.ctrl) {}
+
+            static TableIter FromFwd(SlotPtr s, const PairType* end, const u8* c) {
+                TableIter it { s, end, c };
+                it.FastForward();
+                return it;
+            }
+
+            void FastForward() {
+                while (slot != slotEnd) {
+                    // the group may read into the mirror, so anything past the end is ignored
+                    const auto full = Group { ctrl }.MatchFull();
+                    const usize skip = full ? full.First() : Group::Width;
+                    if (skip >= (usize)(slotEnd - slot)) {
+                        slot += slotEnd - slot;
+                        return;
+                    }
+                    slot += skip;
+                    ctrl += skip;
+                    if (full) return;
+                }
+            }
+
+            Item CurrentImpl() const {
+                if constexpr (F == Field::KEY)        return slot->key;
+                else if constexpr (F == Field::VALUE) return slot->value;
+                else return *slot;
+            }
+            void AdvanceImpl() {
+                ++slot;
+                ++ctrl;
+                FastForward();
+            }
+            bool CanNextImpl() const { return slot != slotEnd; }
+        };
+
+        using PairIter = TableIter<const PairType, Field::PAIR>;
+    public:
+        // Creates an empty hash map. Nothing is allocated yet, this happens at the first insert.
+        SwissTable(Hasher h = {}) : hasher(std::move(h)) {}
+
+        SwissTable(Collection<PairType> auto&& kvpairs, Hasher h = {}) : hasher(std::move(h)) {
+            Insert(kvpairs);
+        }
+
+        SwissTable(IList<PairType> initlist, Hasher h = {}) : hasher(std::move(h)) {
+            Insert(Spans::FromIList(initlist));
+        }
+
+        static SwissTable WithCap(usize cap, Hasher h = {}) {
+            SwissTable st = { std::move(h) };
+            st.Reserve(cap);
+            return st;
+        }
+
+        SwissTable(SwissTable&& t) noexcept
+            : slots(t.slots), ctrl(t.ctrl), elmCount(t.elmCount), mask(t.mask), growthLeft(t.growthLeft),
+              hasher(std::move(t.hasher)) {
+            t.Init();
+        }
+
+        SwissTable& operator=(SwissTable&& t) noexcept {
+            if (&t == this) return *this;
+            Destroy();
+            slots      = t.slots;
+            ctrl       = t.ctrl;
+            elmCount   = t.elmCount;
+            mask       = t.mask;
+            growthLeft = t.growthLeft;
+            hasher     = std::move(t.hasher);
+            t.Init();
+            return *this;
+        }
+
+        SwissTable(const SwissTable& t) : hasher(t.hasher) {
+            CloneTable(t);
+        }
+
+        // Creates a copy of the given map. Copy constructor of each entry is used.
+        SwissTable& operator=(const SwissTable& t) {
+            if (&t == this) return *this;
+            Destroy();
+            Init();
+            hasher = t.hasher;
+            CloneTable(t);
+            return *this;
+        }
+
+        // Destroys the map and all it's contents.
+        ~SwissTable() { Destroy(); }
+
+        // Clears all data, without resizing.
+        void Clear() {
+            if (!slots) return;
+            DestroySlots();
+            Memory::MemSet(ctrl, HashTables::CtrlEmpty, Capacity() + Group::Width);
+            elmCount = 0;
+            growthLeft = GrowthFor(Capacity());
+        }
+
+        const Hasher& GetHasher() const { return hasher; }
+        Hasher&       GetHasher()       { return hasher; }
+
+        usize Count()   const { return elmCount; }
+        static usize MaxCount() { return u64s::MAX; }
+        bool IsEmpty()  const { return elmCount == 0; }
+        explicit operator bool() const { return elmCount != 0; }
+
+        static float MaxLoadFactor() { return 7.0F / 8.0F; }
+        float LoadFactor() const { return slots ? (float)Count() / (float)Capacity() : 0.0F; }
+        usize GetMask() const { return mask; }
+
+        // Checks if both tables contain the same entries. Order is irrelevant.
+        bool operator==(const SwissTable& other) const {
+            if (Count() != other.Count()) return false;
+
+            for (const auto& otherEntry : other) {
+                if (!Contains(otherEntry.key))
+                    return false;
+            }
+
+            return true;
+        }
+
+        ValueArg& operator[](const Key& key) {
+            const auto [index, result] = InsertKeyAndPrepareSlot(key);
+            InitOrWriteNode(index, key, ValueArg {}, result);
+            return slots[index].value;
+        }
+        ValueArg& operator[](Key&& key) {
+            const auto [index, result] = InsertKeyAndPrepareSlot(key);
+            InitOrWriteNode(index, std::move(key), ValueArg {}, result);
+            return slots[index].value;
+        }
+        OptRef<const ValueArg> operator[](const Key& key) const { return Get(key); }
+        OptRef<const ValueArg> Get(const Key& key) const {
+            const OptionUsize i = FindIndexOf(key);
+            return i ? OptRefs::SomeRef(slots[*i].value) : nullptr;
+        }
+        OptRef<ValueArg> Get(const Key& key) { return QGetterMut$(Get, key); }
+        OptRef<const ValueArg> operator[](const auto& kview) const { return Get(kview); }
+        OptRef<const ValueArg> Get(const auto& kview) const {
+            const OptionUsize i = FindIndexOf(kview);
+            return i ? OptRefs::SomeRef(slots[*i].value) : nullptr;
+        }
+
+    private:
+        OptionUsize FindIndexOf(const auto& key) const { return FindIndexOf(key, HashOf(key)); }
+        // for callers that need the hash afterwards too, so the key is only hashed once
+        OptionUsize FindIndexOf(const auto& key, u64 h) const {
+            const u8 h2 = H2(h);
+            usize pos = H1(h) & mask, step = 0;
+            while (true) {
+                const Group group { ctrl + pos };
+                for (const u32 i : group.Match(h2)) {
+                    const usize index = (pos + i) & mask;
+                    if (key == slots[index].key) [[likely]]
+                        return index;
+                }
+                if (group.MatchEmpty()) [[likely]]
+                    return nullptr;
+                // triangular probing, which visits every group once the table is a power of 2
+                step += Group::Width;
+                pos = (pos + step) & mask;
+            }
+        }
+
+        usize FindFirstNonFull(u64 h) const {
+            usize pos = H1(h) & mask, step = 0;
+            while (true) {
+                if (const auto free = Group { ctrl + pos }.MatchNonFull())
+                    return (pos + free.First()) & mask;
+                step += Group::Width;
+                pos = (pos + step) & mask;
+            }
+        }
+
+        void EraseAt(usize index) {
+            slots[index].~PairType();
+            --elmCount;
+
+            // if there was an empty slot within a group's reach on both sides,
+            // no probe ever went past this slot, so it can just be empty again
+            const usize before = (index - Group::Width) & mask;
+            const auto emptyAfter  = Group { ctrl + index  }.MatchEmpty(),
+                       emptyBefore = Group { ctrl + before }.MatchEmpty();
+            const bool wasNeverFull = emptyBefore && emptyAfter &&
+                emptyAfter.TrailingZeros() + emptyBefore.LeadingZeros() < Group::Width;
+            SetCtrl(index, wasNeverFull ? HashTables::CtrlEmpty : HashTables::CtrlDeleted);
+            growthLeft += wasNeverFull;
+        }
+    public:
+        void Insert(const Collection<PairType> auto& collection) {
+            for (auto&& kv : collection)
+                Insert(kv.key, kv.value);
+        }
+
+        void Insert(IList<PairType> ilist) {
+            for (const auto& kv : ilist)
+                Insert(kv.key, kv.value);
+        }
+
+        // Overwrite is never returned, it's kept so both tables have the same interface
+        enum class InsertResult { Found, New, Overwrite, OverflowError };
+
+        void InitOrWriteNode(usize index, Key k, ValueArg v, InsertResult r) {
+            if (r == InsertResult::New)
+                new (&slots[index]) PairType(MakePair(std::move(k), std::move(v)));
+        }
+
+        // Finds key, and if not already present claims a slot for it, updating the control byte and
+        // number of inserted elements, so the only operation left to do is construct the pair in that slot.
+        Tuple<usize, InsertResult> InsertKeyAndPrepareSlot(const Key& key) {
+            const u64 h = HashOf(key);
+            if (const OptionUsize i = FindIndexOf(key, h))
+                return { *i, InsertResult::Found };
+
+            usize index = FindFirstNonFull(h);
+            // reusing a tombstone doesn't take up any more room
+            if (growthLeft == 0 && ctrl[index] == HashTables::CtrlEmpty) [[unlikely]] {
+                RehashAndGrowIfNecessary();
+                index = FindFirstNonFull(h);
+            }
+            growthLeft -= ctrl[index] == HashTables::CtrlEmpty;
+            SetCtrl(index, H2(h));
+            ++elmCount;
+            return { index, InsertResult::New };
+        }
+
+    private:
+        // tries to insert a new value and returns a reference, unless one already exists
+        template <class Kfwd>
+        OptRef<PairType> TryInsertInternal(Kfwd&& k, ValueArg v) {
+            const auto [i, result] = InsertKeyAndPrepareSlot(k);
+            InitOrWriteNode(i, std::forward<Kfwd>(k), std::move(v), result);
+            return result == InsertResult::Found ? nullptr : OptRefs::SomeRef(slots[i]);
+        }
+
+        // sets the value even if it was found,
+        // and returns true if the value is new or false if it was overwritten
+        template <class Kfwd>
+        Tuple<PairType&, bool> InsertOrAssignInternal(Kfwd&& k, ValueArg v) {
+            const auto [i, result] = InsertKeyAndPrepareSlot(k);
+            if (result == InsertResult::Found) { if constexpr (!IsSet) slots[i].value = std::move(v); }
+            else InitOrWriteNode(i, std::forward<Kfwd>(k), std::move(v), result);
+            return { slots[i], result != InsertResult::Found };
+        }
+
+        // returns the previous value associated with the key, unless there wasn't any to begin with
+        // also writes the new value to the associated key
+        template <class Kfwd>
+        Option<ValueArg> ReplaceInternal(Kfwd&& k, ValueArg v) {
+            const auto [i, result] = InsertKeyAndPrepareSlot(k);
+            if (result == InsertResult::Found) {
+                std::swap(slots[i].value, v);
+                return v;
+            }
+            InitOrWriteNode(i, std::forward<Kfwd>(k), std::move(v), result);
+            return nullptr;
+        }
+    public:
+        OptRef<PairType> TryInsert(const Key& k, ValueArg v) { return TryInsertInternal(k,            std::move(v)); }
+        OptRef<PairType> TryInsert(Key&& k,      ValueArg v) { return TryInsertInternal(std::move(k), std::move(v)); }
+        Tuple<PairType&, bool> InsertOrAssign(const Key& k, ValueArg v) { return InsertOrAssignInternal(k,            std::move(v)); }
+        Tuple<PairType&, bool> InsertOrAssign(Key&&      k, ValueArg v) { return InsertOrAssignInternal(std::move(k), std::move(v)); }
+        PairType& Insert(const Key& k, ValueArg v) { return InsertOrAssignInternal(k,            std::move(v))[1_st]; }
+        PairType& Insert(Key&&      k, ValueArg v) { return InsertOrAssignInternal(std::move(k), std::move(v))[1_st]; }
+        Option<ValueArg> Replace(const Key& k, ValueArg v) { return ReplaceInternal(k,            std::move(v)); }
+        Option<ValueArg> Replace(Key&&      k, ValueArg v) { return ReplaceInternal(std::move(k), std::move(v)); }
+        // for sets, which only have the key to insert
+        OptRef<PairType> TryInsert(const Key& k) requires IsSet { return TryInsertInternal(k,            ValueArg {}); }
+        OptRef<PairType> TryInsert(Key&& k)      requires IsSet { return TryInsertInternal(std::move(k), ValueArg {}); }
+        PairType& Insert(const Key& k) requires IsSet { return InsertOrAssignInternal(k,            ValueArg {})[1_st]; }
+        PairType& Insert(Key&&      k) requires IsSet { return InsertOrAssignInternal(std::move(k), ValueArg {})[1_st]; }
+
+        // removes the key in the map
+        bool Remove(const Key& k) {
+            const OptionUsize i = FindIndexOf(k);
+            if (!i) return false;
+            EraseAt(*i);
+            return true;
+        }
+
+        // removes the entry under the iterator, which then moves on to the next entry
+        void RemoveAt(PairIter& iter) {
+            EraseAt(iter.slot - slots);
+            iter.Advance();
+        }
+
+        void KeepEntries(Predicate<PairType> auto&& pred) {
+            for (usize i = 0; i < Capacity(); ++i) {
+                if (HashTables::IsFull(ctrl[i]) && !pred(slots[i]))
+                    EraseAt(i);
+            }
+        }
+
+        // removes the key value pair, and returns the value as well
+        Option<ValueArg> Take(const Key& k) {
+            const OptionUsize i = FindIndexOf(k);
+            if (!i) return nullptr;
+
+            ValueArg val = std::move(slots[*i].value);
+            EraseAt(*i);
+            return val;
+        }
+
+        // removes the key value pair, and returns the pair as well
+        Option<PairType> TakeEntry(const Key& k) {
+            const OptionUsize i = FindIndexOf(k);
+            if (!i) return nullptr;
+
+            PairType kvpair = std::move(slots[*i]);
+            EraseAt(*i);
+            return kvpair;
+        }
+
+        bool Contains(const Key& key) const {
+            return FindIndexOf(key).HasValue();
+        }
+        bool Contains(const auto& kview) const {
+            return FindIndexOf(kview).HasValue();
+        }
+    protected:
+        PairIter                          IterImpl() const { return PairIter::FromFwd(slots, slots + Capacity(), ctrl); }
+        TableIter<PairType, Field::PAIR>  IterMutImpl()    { return TableIter<PairType, Field::PAIR>::FromFwd(slots, slots + Capacity(), ctrl); }
+    public:
+        PairIter IterStartingAt(const Key& k) const {
+            const OptionUsize i = FindIndexOf(k);
+            if (!i) return {};
+            return { &slots[*i], slots + Capacity(), &ctrl[*i] };
+        }
+
+        TableIter<const Key,   Field::KEY>   Keys()   const { return TableIter<const Key,   Field::KEY>  ::FromFwd(slots, slots + Capacity(), ctrl); }
+        TableIter<const ValueArg, Field::VALUE> Values() const { return TableIter<const ValueArg, Field::VALUE>::FromFwd(slots, slots + Capacity(), ctrl); }
+        TableIter<ValueArg,       Field::VALUE> ValuesMut()    { return TableIter<ValueArg,       Field::VALUE>::FromFwd(slots, slots + Capacity(), ctrl); }
+
+        // reserves space for the specified number of elements, always reallocating, which also clears out tombstones.
+        void Rehash(usize c) {
+            Resize(CapacityFor(std::max(c, elmCount)));
+        }
+
+        // reserves space for the specified number of elements. Makes sure the old data fits.
+        void Reserve(usize c) {
+            const usize newCapacity = CapacityFor(std::max(c, elmCount));
+            if (newCapacity > Capacity()) Resize(newCapacity);
+        }
+
+        // If possible reallocates the map to a smaller one, or frees it if there's nothing left.
+        void Compact() {
+            if (!elmCount) {
+                Destroy();
+                Init();
+                return;
+            }
+            const usize newCapacity = CapacityFor(elmCount);
+            if (newCapacity < Capacity()) Resize(newCapacity);
+        }
+
+        static usize CapacityFor(usize count) {
+            usize capacity = MinCapacity;
+            while (GrowthFor(capacity) < count && capacity != 0)
+                capacity *= 2;
+            if (capacity == 0) [[unlikely]]
+                HashTables::AbortOverflowError();
+            return capacity;
+        }
+
+        // one byte of control per slot plus the mirrored group
+        static usize GetTotalBytes(usize capacity) {
+            return capacity * sizeof(PairType) + capacity + Group::Width;
+        }
+    private:
+        void RehashAndGrowIfNecessary() {
+            if (!slots) {
+                Resize(MinCapacity);
+            } else if (elmCount <= Capacity() * 25 / 32) {
+                // mostly tombstones, so rehashing at the same size is enough to make room
+                Resize(Capacity());
+            } else {
+                Resize(Capacity() * 2);
+            }
+        }
+
+        void Resize(usize newCapacity) {
+            PairType* oldSlots = slots;
+            const u8* oldCtrl = ctrl;
+            const usize oldCapacity = Capacity();
+
+            slots = (PairType*)Memory::AllocateRaw(GetTotalBytes(newCapacity));
+            ctrl = reinterpret_cast<u8*>(slots + newCapacity);
+            mask = newCapacity - 1;
+            Memory::MemSet(ctrl, HashTables::CtrlEmpty, newCapacity + Group::Width);
+            growthLeft = GrowthFor(newCapacity) - elmCount;
+
+            for (usize i = 0; i < oldCapacity; ++i) {
+                if (!HashTables::IsFull(oldCtrl[i])) continue;
+                const u64 h = HashOf(oldSlots[i].key);
+                const usize index = FindFirstNonFull(h);
+                SetCtrl(index, H2(h));
+                new (&slots[index]) PairType(std::move(oldSlots[i]));
+                oldSlots[i].~PairType();
+            }
+
+            if (oldSlots) Memory::FreeRaw(oldSlots);
+        }
+
+        void CloneTable(const SwissTable& t) {
+            if (!t.slots) return;
+            const usize capacity = t.Capacity();
+            slots = (PairType*)Memory::AllocateRaw(GetTotalBytes(capacity));
+            ctrl = reinterpret_cast<u8*>(slots + capacity);
+            mask = t.mask;
+            elmCount = t.elmCount;
+            growthLeft = t.growthLeft;
+            Memory::RangeCopy(ctrl, t.ctrl, capacity + Group::Width);
+            for (usize i = 0; i < capacity; ++i) {
+                if (HashTables::IsFull(ctrl[i]))
+                    new (&slots[i]) PairType(t.slots[i]);
+            }
+        }
+
+        void DestroySlots() {
+            if constexpr (!TrivialDestruct<PairType>) {
+                for (usize i = 0; i < Capacity(); ++i) {
+                    if (HashTables::IsFull(ctrl[i]))
+                        slots[i].~PairType();
+                }
+            }
+        }
+
+        void Destroy() {
+            if (!slots) return;
+            DestroySlots();
+            Memory::FreeRaw(slots);
+        }
+
+        void Init() {
+            slots      = nullptr;
+            ctrl       = const_cast<u8*>(HashTables::EmptyGroup);
+            elmCount   = 0;
+            mask       = 0;
+            growthLeft = 0;
+        }
+
+        friend ICollection<KeyValuePair<Key, Value>, SwissTable>;
+    };
+
+    namespace HashTables {
+        // which table backs a HashMap or HashSet
+        enum class Layout {
+            ROBIN_HOOD, // HashTable, probing one info byte at a time
+            SWISS,      // SwissTable, probing a group of control bytes at a time
+        };
+
+        template <Layout L, class K, class V, class Hasher>
+        using TableFor = IfElse<L == Layout::SWISS,
+            SwissTable<K, V, Hasher>,
+            HashTable<sizeof(KeyValuePair<K, V>) <= sizeof(usize) * 6, K, V, Hasher>>;
+    }
+
+    template <class K, class V, class Hasher = Hashing::DefaultHasher, HashTables::Layout L = HashTables::Layout::ROBIN_HOOD>
+    struct HashMap : HashTables::TableFor<L, K, V, Hasher> {};
 
-    template <class K, class Hasher = Hashing::DefaultHasher>
-    struct HashSet : HashTable<sizeof(K) <= sizeof(usize) * 6, K, void, Hasher> {};
+    template <class K, class Hasher = Hashing::DefaultHasher, HashTables::Layout L = HashTables::Layout::ROBIN_HOOD>
+    struct HashSet : HashTables::TableFor<L, K, void, Hasher> {};
 }
\ No newline at end of file
@@ -1,6 +1,6 @@
 #include "LinesIter.h"
 
-#include "Utils/Bitwise.h"
+#include "Utils/Text/Search.h"
 
 namespace Quasi::Iter {
     Str LinesIter::CurrentImpl() const {
@@ -13,19 +13,7 @@ namespace Quasi::Iter {
             return;
         }
         source.Advance(i + 1);
-        for (i = 0; i + 8 < source.Length(); i += 8) {
-            u64 bytes = Memory::ReadU64(source.Data() + i);
-            bytes ^= '\n' * 0x0101010101010101;
-            if (const u32 position = Bitwise::PlaceOfNullByte(bytes); position != 8) {
-                i += position;
-                return;
-            }
-        }
-        for (; i < source.Length(); ++i) {
-            if (source[i] == '\n') {
-                return;
-            }
-        }
+        i = Text::FindByte(source.Data(), source.Length(), '\n').UnwrapOr(source.Length());
     }
 
     bool LinesIter::CanNextImpl() const {
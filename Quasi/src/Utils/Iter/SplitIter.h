@@ -18,9 +18,7 @@ namespace Quasi::Iter {
                 return;
             }
             source.Advance(i + separator.Length());
-            for (i = 0; i < source.Length(); ++i) {
-                if (source.Skip(i).StartsWith(separator)) return;
-            }
+            i = source.Find(separator).UnwrapOr(source.Length());
         }
         bool CanNextImpl() const { return !source.IsEmpty(); }
     public:
@@ -0,0 +1,108 @@
+#include "JobSystem.h"
+
+#include "Debug/Profiler.h"
+#include "Text.h"
+#include "Text/Num.h"
+
+namespace Quasi {
+    static thread_local const JobSystem* currentSystem = nullptr;
+    static thread_local u32 currentQueue = 0;
+
+    void JobSystem::WorkQueue::Push(const Job& job) {
+        std::lock_guard guard { lock };
+        jobs.Push(job);
+    }
+
+    bool JobSystem::WorkQueue::Pop(Job& out) {
+        std::lock_guard guard { lock };
+        if (head >= jobs.Length()) return false;
+        out = jobs.Take();
+        if (head == jobs.Length()) { jobs.Clear(); head = 0; }
+        return true;
+    }
+
+    bool JobSystem::WorkQueue::Steal(Job& out) {
+        std::lock_guard guard { lock };
+        if (head >= jobs.Length()) return false;
+        out = jobs[head++];
+        if (head == jobs.Length()) { jobs.Clear(); head = 0; }
+        return true;
+    }
+
+    JobSystem::JobSystem(u32 threadCount) {
+        queues.Reserve(threadCount + 1);
+        for (u32 i = 0; i <= threadCount; ++i)
+            queues.Push(Box<WorkQueue>::Build());
+
+        workers.Reserve(threadCount);
+        for (u32 i = 1; i <= threadCount; ++i)
+            workers.Push(std::thread { [this, i] { WorkerLoop(i); } });
+    }
+
+    JobSystem::~JobSystem() {
+        {
+            std::lock_guard guard { sleepLock };
+            stopping = true;
+        }
+        wakeCondition.notify_all();
+        for (std::thread& t : workers) t.join();
+    }
+
+    u32 JobSystem::DefaultThreadCount() {
+        const u32 cores = std::thread::hardware_concurrency();
+        return cores > 1 ? cores - 1 : 0;
+    }
+
+    void JobSystem::Dispatch(JobFn fn, usize count, usize grainSize) {
+        grainSize = std::max<usize>(grainSize, 1);
+        const usize jobCount = (count + grainSize - 1) / grainSize;
+        std::atomic<usize> remaining = jobCount;
+
+        const u32 queue = CurrentQueue();
+        // counted before pushing so that a worker never sees a negative amount of jobs
+        pendingJobs += jobCount;
+        for (usize begin = 0; begin < count; begin += grainSize)
+            queues[queue]->Push({ fn, begin, std::min(begin + grainSize, count), &remaining });
+
+        // taking the lock makes sure no worker is between checking for work and going to sleep
+        { std::lock_guard guard { sleepLock }; }
+        wakeCondition.notify_all();
+
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            if (!TryRunOne(queue)) std::this_thread::yield();
+        }
+    }
+
+    bool JobSystem::TryRunOne(u32 queue) {
+        Job job;
+        bool found = queues[queue]->Pop(job);
+        for (u32 i = 1; !found && i < queues.Length(); ++i)
+            found = queues[(queue + i) % queues.Length()]->Steal(job);
+        if (!found) return false;
+
+        --pendingJobs;
+        {
+            QProfile$("JobSystem::Job");
+            job.fn(job.begin, job.end);
+        }
+        job.remaining->fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    void JobSystem::WorkerLoop(u32 queue) {
+        currentSystem = this;
+        currentQueue = queue;
+        Debug::Profiler::SetThreadName(Text::Format("job worker {}", queue));
+        while (true) {
+            if (TryRunOne(queue)) continue;
+
+            std::unique_lock guard { sleepLock };
+            wakeCondition.wait(guard, [this] { return stopping || pendingJobs > 0; });
+            if (stopping) return;
+        }
+    }
+
+    u32 JobSystem::CurrentQueue() const {
+        return currentSystem == this ? currentQueue : 0;
+    }
+} // Quasi
@@ -0,0 +1,160 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "Algorithm.h"
+#include "Box.h"
+#include "Func.h"
+#include "Vec.h"
+
+namespace Quasi {
+    // a pool of worker threads, each of which owns a deque of jobs.
+    // workers push and pop from the back of their own deque, and steal from the front of others once theirs runs out.
+    // the thread that dispatches work (which usually isnt a worker) helps out until its jobs are done.
+    class JobSystem {
+    public:
+        using JobFn = FuncRef<void(usize begin, usize end)>;
+
+        struct Job {
+            JobFn fn;
+            usize begin, end;
+            std::atomic<usize>* remaining;
+        };
+    private:
+        struct WorkQueue {
+            std::mutex lock;
+            Vec<Job> jobs;
+            usize head = 0; // jobs before this have been stolen
+
+            void Push(const Job& job);
+            bool Pop(Job& out);
+            bool Steal(Job& out);
+        };
+
+        Vec<std::thread> workers;
+        Vec<Box<WorkQueue>> queues; // queues[0] is shared by all threads outside of the pool
+        std::mutex sleepLock;
+        std::condition_variable wakeCondition;
+        std::atomic<usize> pendingJobs = 0;
+        std::atomic<bool> stopping = false;
+    public:
+        explicit JobSystem(u32 threadCount = DefaultThreadCount());
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        // one less than the core count, as the dispatching thread also does work
+        static u32 DefaultThreadCount();
+        u32 ThreadCount() const { return (u32)workers.Length(); }
+
+        // calls body(begin, end) over [0, count) in chunks of grainSize, returns once every chunk is done
+        void ParallelFor(usize count, usize grainSize, Fn<void, usize, usize> auto&& body) {
+            if (count == 0) return;
+            if (workers.IsEmpty() || count <= grainSize) return (void)body(0, count);
+            Dispatch(JobFn(body), count, grainSize);
+        }
+    private:
+        void Dispatch(JobFn fn, usize count, usize grainSize);
+        bool TryRunOne(u32 queue);
+        void WorkerLoop(u32 queue);
+        u32 CurrentQueue() const;
+    };
+
+    namespace Algorithm::SortingDetails::SampleSort {
+        constexpr usize PARALLEL_THRESHOLD = 1 << 14;
+        constexpr usize OVERSAMPLING = 16;
+
+        // splits the values into buckets around sampled splitters, then sorts each bucket on its own.
+        // the buckets are classified and scattered in blocks, so every step runs across the pool.
+        template <class T>
+        void SampleSort(Span<T> span, JobSystem& jobs, Comparator<T> auto&& cmp) {
+            const usize len = span.Length();
+            if (len < PARALLEL_THRESHOLD || jobs.ThreadCount() == 0) return Sort(span, cmp);
+
+            // a few buckets per thread, so that uneven buckets still balance out
+            const usize bucketCount = std::min<usize>(4 * (jobs.ThreadCount() + 1), 256),
+                        blockCount  = bucketCount,
+                        blockLen    = (len + blockCount - 1) / blockCount;
+            T* const data = span.Data();
+
+            // the sample is taken at a random spot within evenly sized strides, which avoids
+            // picking only the peaks of periodic inputs. its pointers are only used before anything moves
+            const usize sampleCount = bucketCount * OVERSAMPLING;
+            Vec<const T*> sample = Vec<const T*>::WithCap(sampleCount);
+            u64 rng = len * 0x9E3779B97F4A7C15;
+            for (usize i = 0; i < sampleCount; ++i) {
+                rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+                const usize begin = i * len / sampleCount, end = (i + 1) * len / sampleCount;
+                sample.Push(&data[begin + rng % (end - begin)]);
+            }
+            sample.Sort([&] (const T* lhs, const T* rhs) { return cmp(*lhs, *rhs); });
+            Vec<const T*> splitters = Vec<const T*>::WithCap(bucketCount - 1);
+            for (usize b = 1; b < bucketCount; ++b) splitters.Push(sample[b * OVERSAMPLING - 1]);
+
+            Vec<u8> bucketOf;
+            bucketOf.Resize(len, 0);
+            Vec<usize> offsets;
+            offsets.Resize(blockCount * bucketCount, 0);
+
+            jobs.ParallelFor(blockCount, 1, [&] (usize beginBlock, usize endBlock) {
+                for (usize block = beginBlock; block < endBlock; ++block) {
+                    usize* counts = &offsets[block * bucketCount];
+                    for (usize i = block * blockLen; i < std::min((block + 1) * blockLen, len); ++i) {
+                        // the number of splitters that arent greater than the value
+                        usize lo = 0, hi = splitters.Length();
+                        while (lo < hi) {
+                            const usize mid = (lo + hi) / 2;
+                            if (cmp(data[i], *splitters[mid]) < 0) hi = mid; else lo = mid + 1;
+                        }
+                        bucketOf[i] = (u8)lo;
+                        ++counts[lo];
+                    }
+                }
+            });
+
+            // bucket major prefix sum, so each block scatters into its own part of every bucket
+            Vec<usize> bucketStarts = Vec<usize>::WithCap(bucketCount + 1);
+            usize sum = 0;
+            for (usize b = 0; b < bucketCount; ++b) {
+                bucketStarts.Push(sum);
+                for (usize block = 0; block < blockCount; ++block) {
+                    const usize count = offsets[block * bucketCount + b];
+                    offsets[block * bucketCount + b] = sum;
+                    sum += count;
+                }
+            }
+            bucketStarts.Push(len);
+
+            T* const scratch = Memory::AllocateArrayUninit<T>(len);
+            jobs.ParallelFor(blockCount, 1, [&] (usize beginBlock, usize endBlock) {
+                for (usize block = beginBlock; block < endBlock; ++block) {
+                    usize* dests = &offsets[block * bucketCount];
+                    for (usize i = block * blockLen; i < std::min((block + 1) * blockLen, len); ++i)
+                        Memory::RelocateAt(&scratch[dests[bucketOf[i]]++], &data[i]);
+                }
+            });
+
+            jobs.ParallelFor(bucketCount, 1, [&] (usize beginBucket, usize endBucket) {
+                for (usize b = beginBucket; b < endBucket; ++b) {
+                    const usize begin = bucketStarts[b], count = bucketStarts[b + 1] - begin;
+                    Sort(Spans::Slice(&scratch[begin], count), cmp);
+                    Memory::RangeRelocate(&data[begin], &scratch[begin], count);
+                }
+            });
+            Memory::FreeRaw(scratch);
+        }
+    }
+
+    template <class T, class S>
+    void IContinuous<T, S>::SortParallel(JobSystem& jobs, Comparator<T> auto&& cmp) requires IsMut<T> {
+        return Algorithm::SortingDetails::SampleSort::SampleSort(AsSpan(), jobs, cmp);
+    }
+
+    template <class T, class S>
+    void IContinuous<T, S>::SortParallelByKey(JobSystem& jobs, FnArgs<const T&> auto&& keyf) requires IsMut<T> {
+        return SortParallel(jobs, [&] (const auto& lhs, const auto& rhs) { return Cmp::Between(keyf(lhs), keyf(rhs)); });
+    }
+} // Quasi
@@ -11,6 +11,21 @@ namespace Quasi {
         return ::operator delete (mem);
     }
 
+    void* Memory::IAllocator::Reallocate(void* mem, usize size, usize newSize, usize align) {
+        void* newMem = Allocate(newSize, align);
+        if (mem) MemCopyNoOverlap(newMem, mem, std::min(size, newSize));
+        Free(mem, size);
+        return newMem;
+    }
+
+    // operator new has no realloc, so this always copies
+    void* Memory::GlobalAllocator::Reallocate(void* mem, usize size, usize newSize, usize align) const {
+        void* newMem = AllocateRaw(newSize);
+        if (mem) MemCopyNoOverlap(newMem, mem, std::min(size, newSize));
+        FreeRaw(mem);
+        return newMem;
+    }
+
     u16 Memory::ReadU16Big(const void* bytes) {
         const auto b = (const byte*)bytes;
         return (u16)b[0] << 8 | (u16)b[1];
@@ -36,6 +36,47 @@ namespace Quasi::Memory {
     template <class T> void FreeNoDestruct(T* mem) { ::operator delete(mem); }
     template <class T> void FreeArrayNoDestruct(T* mem) { ::operator delete[](mem); }
 
+    // Free() gets the size that was allocated, so arenas and pools dont need a header per allocation.
+    // see Arena.h for the implementations.
+    class IAllocator {
+    public:
+        virtual ~IAllocator() = default;
+        virtual void* Allocate(usize size, usize align) = 0;
+        virtual void Free(void* mem, usize size) = 0;
+        // moves the memory to a block of newSize bytes, which may be the same block if the allocator can grow it in place
+        virtual void* Reallocate(void* mem, usize size, usize newSize, usize align);
+    };
+
+    // the default allocator of Vec, which just goes to the global heap.
+    // it has no state, so containers using it dont grow in size
+    struct GlobalAllocator {
+        void* Allocate(usize size, usize align) const { return AllocateRaw(size); }
+        void Free(void* mem, usize size) const { FreeRaw(mem); }
+        void* Reallocate(void* mem, usize size, usize newSize, usize align) const;
+    };
+
+    // a copyable handle to an allocator, which refers to the global heap when null
+    struct AllocatorRef {
+        IAllocator* allocator = nullptr;
+
+        AllocatorRef() = default;
+        AllocatorRef(IAllocator& allocator) : allocator(&allocator) {}
+
+        void* Allocate(usize size, usize align) const { return allocator ? allocator->Allocate(size, align) : AllocateRaw(size); }
+        void Free(void* mem, usize size) const { if (allocator) allocator->Free(mem, size); else FreeRaw(mem); }
+        void* Reallocate(void* mem, usize size, usize newSize, usize align) const {
+            return allocator ? allocator->Reallocate(mem, size, newSize, align) : GlobalAllocator {}.Reallocate(mem, size, newSize, align);
+        }
+        bool IsGlobal() const { return !allocator; }
+    };
+
+    template <class A> concept IsGlobalAllocator = SameAs<A, GlobalAllocator>;
+
+    // whether moving a T to a new address and forgetting the old one is the same as copying its bytes.
+    // true for trivially copyable types, and owning handles without self pointers (Vec, String, Box) opt in.
+    template <class T> constexpr bool EnableTrivialRelocate = TrivialCopy<T>;
+    template <class T> concept TrivialRelocate = EnableTrivialRelocate<RemConst<T>>;
+
     template <class T> void ConstructAt(T* dest, auto&&... args) {
         new (dest) T(std::forward<decltype(args)>(args)...);
     }
@@ -195,10 +236,38 @@ namespace Quasi::Memory {
     }
 
     template <class T> constexpr void RangeDestruct(T* data, usize count) {
+        if constexpr (TrivialDestruct<T>) return;
         T* dataEnd = data + count;
         for (; data < dataEnd; ++data) data->~T();
     }
 
+    // moves the value to uninitialized memory and destructs the original
+    template <class T> void RelocateAt(T* out, T* in) {
+        if constexpr (TrivialRelocate<T>) {
+            __builtin_memcpy((void*)out, (const void*)in, sizeof(T));
+        } else {
+            ConstructMoveAt(out, std::move(*in));
+            in->~T();
+        }
+    }
+
+    // moves the values to uninitialized memory and destructs the originals. the ranges may overlap
+    template <class T> void RangeRelocate(T* out, T* in, usize count) {
+        if constexpr (TrivialRelocate<T>) {
+            __builtin_memmove((void*)out, (const void*)in, count * sizeof(T));
+        } else if (out < in) {
+            for (usize i = 0; i < count; ++i) {
+                ConstructMoveAt(&out[i], std::move(in[i]));
+                in[i].~T();
+            }
+        } else {
+            for (usize i = count; i --> 0; ) {
+                ConstructMoveAt(&out[i], std::move(in[i]));
+                in[i].~T();
+            }
+        }
+    }
+
 #define Q_GETTER_MUT(FN, ...) (decltype(this->FN(__VA_ARGS__)))(Memory::AsConstPtr(this))->FN(__VA_ARGS__)
 #define QGetterMut$ Q_GETTER_MUT
 
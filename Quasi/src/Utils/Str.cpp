@@ -6,6 +6,7 @@
 #include "CStr.h"
 #include "Iter/LinesIter.h"
 #include "Iter/SplitIter.h"
+#include "Text/Search.h"
 #include "Text/StringWriter.h"
 
 namespace Quasi {
@@ -17,7 +18,7 @@ namespace Quasi {
         Option<char> TryFromDigitRadix(u32 digit, u32 radix) { return digit < radix ? Options::Some(FromHexDigit(digit)) : nullptr; }
 
         u32         ToDigit      (char digit) { return (u32)(digit - '0'); }
-        u32         ToHexDigit   (char digit) { return IsNumeric(digit) ? digit - '0' : IsUpper(digit) ? digit - 'A' : digit - 'a'; }
+        u32         ToHexDigit   (char digit) { return IsNumeric(digit) ? digit - '0' : IsUpper(digit) ? digit - 'A' + 10 : digit - 'a' + 10; }
         Option<u32> TryToDigit   (char digit) { return IsDigit(digit)    ? Options::Some(ToDigit(digit))    : nullptr; }
         Option<u32> TryToHexDigit(char digit) { return IsHexDigit(digit) ? Options::Some(ToHexDigit(digit)) : nullptr; }
         Option<u32> TryToDigitRadix(char digit, u32 radix) { return IsDigitRadix(digit, radix) ? Options::Some(ToHexDigit(digit)) : nullptr; }
@@ -98,12 +99,12 @@ namespace Quasi {
 
         Set::Set(Span<const char> chars) {
             for (const char c : chars) {
-                bitmask[(uchar)c / 64] |= 1 << ((uchar)c & 63);
+                bitmask[(uchar)c / 64] |= 1ull << ((uchar)c & 63);
             }
         }
 
         bool Set::operator()(char c) const {
-            return bitmask[(uchar)c / 64] & 1 << ((uchar)c & 63);
+            return bitmask[(uchar)c / 64] >> ((uchar)c & 63) & 1;
         }
         bool Set::operator()(Str str) const { return operator()(str[0]); }
     }
@@ -121,13 +122,7 @@ namespace Quasi {
     strdef Iter::SplitIter<Str> strcls::Split(Str sep) const { return Iter::SplitIter<Str>::New(AsStr(), sep); }
     strdef Iter::LinesIter strcls::Lines() const { return Iter::LinesIter::New(AsStr()); }
     strdef usize strcls::CountLines() const { return CountChars('\n') + 1; }
-    strdef usize strcls::CountChars(char c) const {
-        usize zeroCount = 0;
-        for (usize i = 0; i < this->Length(); ++i) {
-            zeroCount += this->Data()[i] == c;
-        }
-        return zeroCount;
-    }
+    strdef usize strcls::CountChars(char c) const { return Text::CountByte(this->Data(), this->Length(), c); }
 
     strdef usize strcls::Utf8Length() const {
         // from https://stackoverflow.com/questions/4063146/getting-the-actual-length-of-a-utf-8-encoded-stdstring
@@ -137,6 +132,30 @@ namespace Quasi {
         return utf8len;
     }
 
+    strdef u32 strcls::Utf8DecodeAt(usize& i) const {
+        static constexpr u32 REPLACEMENT = 0xFFFD;
+        const uchar* s = (const uchar*)this->Data();
+        const usize len = this->Length();
+        const uchar lead = s[i++];
+        if (lead < 0x80) return lead;
+
+        // lead byte determines how many continuation bytes follow, and the smallest code point allowed
+        u32 count, codepoint, minimum;
+        if      ((lead & 0xE0) == 0xC0) { count = 1; codepoint = lead & 0x1F; minimum = 0x80; }
+        else if ((lead & 0xF0) == 0xE0) { count = 2; codepoint = lead & 0x0F; minimum = 0x800; }
+        else if ((lead & 0xF8) == 0xF0) { count = 3; codepoint = lead & 0x07; minimum = 0x10000; }
+        else return REPLACEMENT;
+
+        for (u32 k = 0; k < count; ++k) {
+            if (i >= len || (s[i] & 0xC0) != 0x80) return REPLACEMENT;
+            codepoint = codepoint << 6 | (s[i++] & 0x3F);
+        }
+        // overlong encodings, surrogates and anything past the unicode range
+        if (codepoint < minimum || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+            return REPLACEMENT;
+        return codepoint;
+    }
+
     strdef Str              strcls::AsStr()      const        { return Str   ::Slice(this->Data(), this->Length()); }
     strdef StrMut           strcls::AsStrMut()   requires mut { return StrMut::Slice(this->Data(), this->Length()); }
     strdef Span<const char> strcls::AsSpan()     const        { return Span<const char>::Slice(this->Data(), this->Length()); }
@@ -215,75 +234,50 @@ namespace Quasi {
     strdef bool strcls::operator==(const String& other) const { return Equals(other); }
     strdef bool strcls::operator==(const char* other) const { return Equals(other); }
 
-    strdef Comparison strcls::Cmp(Str other) const {
+    // big endian reads order the same way as comparing byte by byte
+    static Comparison CmpBytes(const char* lhs, const char* rhs, usize len) {
         usize i = 0;
-        for (; i < this->Length(); i += 8) {
-            const auto cmp = Cmp::Between(Memory::ReadU64Native(this->Data() + i), Memory::ReadU64Native(other.Data() + i));
-            if (cmp != Cmp::EQUAL) return cmp;
-        }
-        for (usize j = 0; j < (this->Length() & 7); ++j) {
-            const auto cmp = Cmp::Between(At(i - 8 + j), other.At(i - 8 + j));
-            if (cmp != Cmp::EQUAL) return cmp;
+        for (; i + 8 <= len; i += 8) {
+            const u64 l = Memory::ReadU64Big(lhs + i), r = Memory::ReadU64Big(rhs + i);
+            if (l != r) return Cmp::Between(l, r);
         }
-        return Cmp::Between(this->Length(), other.Length());
+        for (; i < len; ++i)
+            if (lhs[i] != rhs[i]) return Cmp::Between((uchar)lhs[i], (uchar)rhs[i]);
+        return Cmp::EQUAL;
+    }
+
+    strdef Comparison strcls::Cmp(Str other) const {
+        const Comparison cmp = CmpBytes(this->Data(), other.Data(), std::min(this->Length(), other.Length()));
+        return cmp != Cmp::EQUAL ? cmp : Cmp::Between(this->Length(), other.Length());
     }
     strdef Comparison strcls::CmpSized(Str other) const {
         if (this->Length() != other.Length()) return Cmp::Between(this->Length(), other.Length());
-        usize i = 0;
-        for (; i < this->Length(); i += 8) {
-            const auto cmp = Cmp::Between(Memory::ReadU64(this->Data() + i), Memory::ReadU64(other.Data() + i));
-            if (cmp != Cmp::EQUAL) return cmp;
-        }
-        for (usize j = 0; j < (this->Length() & 7); ++j) {
-            const auto cmp = Cmp::Between(At(i - 8 + j), other.At(i - 8 + j));
-            if (cmp != Cmp::EQUAL) return cmp;
-        }
-        return Cmp::EQUAL;
+        return CmpBytes(this->Data(), other.Data(), this->Length());
     }
     strdef Comparison strcls::operator<=>(Str other) const { return Cmp(other); }
 
     strdef void  strcls::Reverse() requires mut { AsSpanMut().Reverse(); }
 
-    strdef OptionUsize strcls::Find   (char c)  const { for (usize i = 0; i < this->Length(); ++i) if (At(i) == c) return i; return nullptr; }
-    strdef OptionUsize strcls::RevFind(char c)  const { for (usize i = this->Length(); i --> 0; )  if (At(i) == c) return i; return nullptr; }
+    strdef OptionUsize strcls::Find   (char c)  const { return Text::FindByte   (this->Data(), this->Length(), c); }
+    strdef OptionUsize strcls::RevFind(char c)  const { return Text::RevFindByte(this->Data(), this->Length(), c); }
     strdef bool    strcls::Contains   (char c)  const { return Find   (c).HasValue(); }
     strdef bool    strcls::RevContains(char c)  const { return RevFind(c).HasValue(); }
-    strdef OptionUsize strcls::Find   (Str str) const {
-        for (usize i = 0; i + str.Length() < this->Length(); ++i)
-            if (Substr(i, str.Length()) == str) return i;
-        return nullptr;
-    }
-    strdef OptionUsize strcls::RevFind(Str str) const {
-        for (usize i = this->Length() + 1; --i >= str.Length(); )
-            if (Substr(i - str.Length(), str.Length()) == str) return i;
-        return nullptr;
-    }
+    strdef OptionUsize strcls::Find   (Str str) const { return Text::FindSubstr   (AsStr(), str); }
+    strdef OptionUsize strcls::RevFind(Str str) const { return Text::RevFindSubstr(AsStr(), str); }
     strdef bool  strcls::Contains   (Str str) const { return Find   (str) != -1; }
     strdef bool  strcls::RevContains(Str str) const { return RevFind(str) != -1; }
     strdef Tuple<OptionUsize, OptionUsize> strcls::FindOneOf(Span<const char> anyc) const {
-        const OptionUsize i = FindIf(Chr::Set { anyc });
+        const OptionUsize i = Text::FindByteOf(this->Data(), this->Length(), anyc);
         return { i, i ? anyc.Find(At(*i)) : nullptr };
     }
     strdef Tuple<OptionUsize, OptionUsize> strcls::RevFindOneOf(Span<const char> anyc) const {
-        const OptionUsize i = RevFindIf(Chr::Set { anyc });
+        const OptionUsize i = Text::RevFindByteOf(this->Data(), this->Length(), anyc);
         return { i, i ? anyc.Find(At(*i)) : nullptr };
     }
     strdef OptionUsize strcls::ContainsOneOf   (Span<const char> anyc) const { const auto [i, m] = FindOneOf(anyc);    return i.And(m); }
     strdef OptionUsize strcls::RevContainsOneOf(Span<const char> anyc) const { const auto [i, m] = RevFindOneOf(anyc); return i.And(m); }
-    strdef Tuple<OptionUsize, OptionUsize> strcls::FindOneOf(Span<const Str> anystr) const {
-        for (usize i = 0; i < this->Length(); ++i) {
-            for (usize j = 0; j < anystr.Length(); ++j)
-                if (Skip(i).StartsWith(anystr[j])) return { i, j };
-        }
-        return { nullptr, nullptr };
-    }
-    strdef Tuple<OptionUsize, OptionUsize> strcls::RevFindOneOf(Span<const Str> anystr) const {
-        for (usize i = this->Length(); i --> 0; ) {
-            for (usize j = 0; j < anystr.Length(); ++j)
-                if (Skip(i).StartsWith(anystr[j])) return { i, j };
-        }
-        return { nullptr, nullptr };
-    }
+    strdef Tuple<OptionUsize, OptionUsize> strcls::FindOneOf   (Span<const Str> anystr) const { return Text::MultiFinder { anystr }.Find   (AsStr()); }
+    strdef Tuple<OptionUsize, OptionUsize> strcls::RevFindOneOf(Span<const Str> anystr) const { return Text::MultiFinder { anystr }.RevFind(AsStr()); }
     strdef OptionUsize strcls::ContainsOneOf   (Span<const Str> anystr) const { const auto [i, m] = FindOneOf(anystr);    return i.And(m); }
     strdef OptionUsize strcls::RevContainsOneOf(Span<const Str> anystr) const { const auto [i, m] = RevFindOneOf(anystr); return i.And(m); }
 
@@ -294,7 +288,7 @@ namespace Quasi {
     strdef OptionUsize strcls::StartsWithOneOf(Span<const char> anyprefix) const { return this->Length() >= 1 ? anyprefix.Find(this->First()) : -1; }
     strdef OptionUsize strcls::EndsWithOneOf  (Span<const char> anysuffix) const { return this->Length() >= 1 ? anysuffix.Find(this->Last())  : -1; }
     strdef OptionUsize strcls::StartsWithOneOf(Span<const Str> anyprefix)  const { for (usize i = 0; i < anyprefix.Length(); ++i) if (StartsWith(anyprefix[i])) return i; return nullptr; }
-    strdef OptionUsize strcls::EndsWithOneOf  (Span<const Str> anysuffix)  const { for (usize i = 0; i < anysuffix.Length(); ++i) if (StartsWith(anysuffix[i])) return i; return nullptr; }
+    strdef OptionUsize strcls::EndsWithOneOf  (Span<const Str> anysuffix)  const { for (usize i = 0; i < anysuffix.Length(); ++i) if (EndsWith  (anysuffix[i])) return i; return nullptr; }
 
 
     strdef Str strcls::Trim     () const { return TrimIf     (Chr::IsWhitespace); }
@@ -322,16 +316,16 @@ namespace Quasi {
     strdef Str strcls::RemoveSuffix(Str suffix)  const { return Trunc(EndsWith(suffix)   ? suffix.Length() : 0); }
     strdef Str strcls::RemovePrefixOneOf(Span<const char> prefix) const { return Skip ((bool)StartsWithOneOf(prefix)); }
     strdef Str strcls::RemoveSuffixOneOf(Span<const char> suffix) const { return Trunc((bool)EndsWithOneOf  (suffix)); }
-    strdef Str strcls::RemovePrefixOneOf(Span<const Str> prefix)  const { return Skip (StartsWithOneOf(prefix) ? prefix.Length() : 0); }
-    strdef Str strcls::RemoveSuffixOneOf(Span<const Str> suffix)  const { return Trunc(EndsWithOneOf  (suffix) ? suffix.Length() : 0); }
+    strdef Str strcls::RemovePrefixOneOf(Span<const Str> prefix)  const { const OptionUsize i = StartsWithOneOf(prefix); return Skip (i ? prefix[*i].Length() : 0); }
+    strdef Str strcls::RemoveSuffixOneOf(Span<const Str> suffix)  const { const OptionUsize i = EndsWithOneOf  (suffix); return Trunc(i ? suffix[*i].Length() : 0); }
     strdef StrMut strcls::RemovePrefixMut(char prefix) requires mut { return SkipMut (StartsWith(prefix)); }
     strdef StrMut strcls::RemoveSuffixMut(char suffix) requires mut { return TruncMut(EndsWith(suffix));   }
     strdef StrMut strcls::RemovePrefixMut(Str prefix)  requires mut { return SkipMut (StartsWith(prefix) ? prefix.Length() : 0); }
     strdef StrMut strcls::RemoveSuffixMut(Str suffix)  requires mut { return TruncMut(EndsWith(suffix)   ? suffix.Length() : 0); }
     strdef StrMut strcls::RemovePrefixOneOfMut(Span<const char> prefix) requires mut { return SkipMut ((bool)StartsWithOneOf(prefix)); }
     strdef StrMut strcls::RemoveSuffixOneOfMut(Span<const char> suffix) requires mut { return TruncMut((bool)EndsWithOneOf  (suffix)); }
-    strdef StrMut strcls::RemovePrefixOneOfMut(Span<const Str> prefix)  requires mut { return SkipMut (StartsWithOneOf(prefix) ? prefix.Length() : 0); }
-    strdef StrMut strcls::RemoveSuffixOneOfMut(Span<const Str> suffix)  requires mut { return TruncMut(EndsWithOneOf  (suffix) ? suffix.Length() : 0); }
+    strdef StrMut strcls::RemovePrefixOneOfMut(Span<const Str> prefix)  requires mut { const OptionUsize i = StartsWithOneOf(prefix); return SkipMut (i ? prefix[*i].Length() : 0); }
+    strdef StrMut strcls::RemoveSuffixOneOfMut(Span<const Str> suffix)  requires mut { const OptionUsize i = EndsWithOneOf  (suffix); return TruncMut(i ? suffix[*i].Length() : 0); }
 
     strdef Iter::SplitIter<Str> strcls::Split(Str sep) {
         return Iter::SplitIter<Str>::New(AsStr(), sep);
@@ -80,6 +80,8 @@ namespace Quasi {
         usize CountChars(char c) const;
         // counts the number of code points
         usize Utf8Length() const;
+        // decodes the code point starting at byte i and moves i past it, invalid sequences become U+FFFD
+        u32 Utf8DecodeAt(usize& i) const;
 
         Str              AsStr()      const;
         StrMut           AsStrMut()   requires mut;
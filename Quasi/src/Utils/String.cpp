@@ -12,6 +12,17 @@ namespace Quasi {
         }
     }
 
+    String String::WithCap(usize cap, Memory::IAllocator& allocator) {
+        return Large { 1, cap | Large::ALLOCATOR_FLAG, AllocateString(cap, allocator) };
+    }
+
+    String String::FromStr(Str str, Memory::IAllocator& allocator) {
+        String string = WithCap(str.Length(), allocator);
+        Memory::MemCopyNoOverlap(string.large.data, str.Data(), str.Length());
+        string.large.SetSize(str.Length());
+        return string;
+    }
+
     String String::FromChars(Vec<char> chars) {
         if (chars.Length() <= Small::MAXLEN) {
             String string;
@@ -73,7 +84,7 @@ namespace Quasi {
 
     String::~String() {
         if (IsLargeString()) {
-            Memory::FreeRaw(large.data);
+            FreeLarge();
         }
     }
 
@@ -82,6 +93,8 @@ namespace Quasi {
     }
 
     void String::OptimizeAsSmall() {
+        // keeps the allocator's buffer, otherwise growing again would go to the heap
+        if (large.HasAllocator()) return;
         char* string = large.data;
         const usize size = large.GetSize();
         Memory::MemCopyNoOverlap(small.data, string, size);
@@ -99,8 +112,29 @@ namespace Quasi {
 
     void String::MoveBuffer(char* dest, usize cap) {
         Memory::MemCopyNoOverlap(dest, large.data, large.GetSize());
-        Memory::FreeRaw(large.data);
+        FreeLarge();
         large.data = dest;
+        large.SetCap(cap);
+    }
+
+    char* String::AllocateLike(usize size) const {
+        return large.HasAllocator() ? AllocateString(size, *large.GetAllocator()) : AllocateString(size);
+    }
+
+    void String::FreeLarge() {
+        if (large.HasAllocator())
+            large.GetAllocator()->Free(large.data - sizeof(Memory::IAllocator*), sizeof(Memory::IAllocator*) + large.GetCap() * sizeof(char));
+        else
+            Memory::FreeRaw(large.data);
+    }
+
+    void String::MoveToHeap() {
+        if (IsSmallString() || !large.HasAllocator()) return;
+        const usize cap = large.GetCap();
+        char* heap = AllocateString(cap);
+        Memory::MemCopyNoOverlap(heap, large.data, large.GetSize());
+        FreeLarge();
+        large.data = heap;
         large.cap = cap;
     }
 
@@ -108,6 +142,17 @@ namespace Quasi {
         return (char*)Memory::AllocateRaw(size * sizeof(char));
     }
 
+    char* String::AllocateString(usize size, Memory::IAllocator& allocator) {
+        // the allocator is stored right before the characters
+        auto** header = (Memory::IAllocator**)allocator.Allocate(sizeof(Memory::IAllocator*) + size * sizeof(char), alignof(Memory::IAllocator*));
+        *header = &allocator;
+        return (char*)(header + 1);
+    }
+
+    OptRef<Memory::IAllocator> String::GetAllocator() const {
+        return IsLargeString() && large.HasAllocator() ? OptRefs::SomeRef(*large.GetAllocator()) : nullptr;
+    }
+
     bool String::CanFit(usize amount) const {
         return Length() + amount <= Capacity();
     }
@@ -119,7 +164,7 @@ namespace Quasi {
     const char* String::DataImpl()   const { return IsSmallString() ? &small.data[0]   : large.data; }
     char*       String::DataImpl()         { return IsSmallString() ? &small.data[0]   : large.data; }
     usize       String::LengthImpl() const { return IsSmallString() ?  small.GetSize() : large.GetSize(); }
-    usize       String::Capacity()   const { return IsSmallString() ? Small::MAXLEN    : large.cap; }
+    usize       String::Capacity()   const { return IsSmallString() ? Small::MAXLEN    : large.GetCap(); }
 
     void String::Reserve(usize extra) {
         if (IsSmallString()) {
@@ -128,9 +173,9 @@ namespace Quasi {
                 return CopyToLarge(AllocateString(newCap), newCap);
             }
         } else {
-            if (large.GetSize() + extra > large.cap) {
-                const usize newCap = std::max<usize>(GrowCap(large.cap), large.GetSize() + extra);
-                return MoveBuffer(AllocateString(newCap), newCap);
+            if (large.GetSize() + extra > large.GetCap()) {
+                const usize newCap = std::max<usize>(GrowCap(large.GetCap()), large.GetSize() + extra);
+                return MoveBuffer(AllocateLike(newCap), newCap);
             }
         }
     }
@@ -139,9 +184,9 @@ namespace Quasi {
         if (IsSmallString() && small.GetSize() + extra > Small::MAXLEN) {
             const usize newCap = small.GetSize() + extra;
             return CopyToLarge(AllocateString(newCap), newCap);
-        } else if (IsLargeString() && large.GetSize() + extra > large.cap) {
+        } else if (IsLargeString() && large.GetSize() + extra > large.GetCap()) {
             const usize newCap = large.GetSize() + extra;
-            return MoveBuffer(AllocateString(newCap), newCap);
+            return MoveBuffer(AllocateLike(newCap), newCap);
         }
     }
 
@@ -158,15 +203,16 @@ namespace Quasi {
                 small.SetSize(size);
             }
         } else {
-            if (size > large.cap) {
-                const usize newCap = std::max<usize>(GrowCap(large.cap), size), original = large.GetSize();
-                MoveBuffer(AllocateString(newCap), newCap);
+            if (size > large.GetCap()) {
+                const usize newCap = std::max<usize>(GrowCap(large.GetCap()), size), original = large.GetSize();
+                MoveBuffer(AllocateLike(newCap), newCap);
                 Memory::MemSet(large.data + original, 0, size - original);
-            } else if (size > Small::MAXLEN) {
+            } else if (size > Small::MAXLEN || large.HasAllocator()) {
                 large.SetSize(size);
             } else {
                 char buf[24] { 0 };
                 Memory::MemCopy(buf, large.data, size);
+                FreeLarge();
                 Memory::MemCopy(small.data, buf, size);
                 small.SetSize(size);
             }
@@ -178,6 +224,7 @@ namespace Quasi {
     }
 
     Nullable<char*> String::ReleaseLargeString() {
+        MoveToHeap();
         if (IsLargeString()) {
             char* string = large.data;
             large.data = nullptr;
@@ -187,6 +234,7 @@ namespace Quasi {
     }
 
     Option<Vec<char>> String::IntoLargeString() {
+        MoveToHeap();
         if (IsLargeString()) {
             char* string = large.data;
             const usize size = large.GetSize(), cap = large.cap;
@@ -210,6 +258,7 @@ namespace Quasi {
     }
 
     Vec<char> String::IntoChars() {
+        MoveToHeap();
         if (IsLargeString()) {
             char* string = large.data;
             const usize size = large.GetSize(), cap = large.cap;
@@ -228,6 +277,7 @@ namespace Quasi {
     }
 
     ArrayBox<char> String::IntoBox() {
+        MoveToHeap();
         if (IsLargeString()) {
             char* string = large.data;
             const usize size = large.GetSize();
@@ -303,7 +353,8 @@ namespace Quasi {
         if (IsSmallString()) {
             return small.data[(small.sizePackedFlag -= 2) >> 1];
         } else {
-            const char last = large.data[(small.sizePackedFlag -= 2) >> 1];
+            large.sizePackedFlag -= 2;
+            const char last = large.data[large.GetSize()];
             if (large.GetSize() <= Small::MAXLEN)
                 OptimizeAsSmall();
             return last;
@@ -312,19 +363,19 @@ namespace Quasi {
     char String::Pop(usize index) {
         if (IsSmallString()) {
             const char out = small.data[index];
-            Memory::MemCopy(&small.data[index], &small.data[index + 1], small.GetSize() - index);
+            Memory::MemCopy(&small.data[index], &small.data[index + 1], small.GetSize() - index - 1);
             small.sizePackedFlag -= 2;
             return out;
         } else {
             const char out = large.data[index];
-            if (large.GetSize() - 1 <= Small::MAXLEN) {
+            if (large.GetSize() - 1 <= Small::MAXLEN && !large.HasAllocator()) {
                 char* str = large.data;
                 const usize size = large.GetSize();
                 SetEmptyUnsafe();
                 Memory::MemCopyNoOverlap( small.data,         str,            index);
                 Memory::MemCopyNoOverlap(&small.data[index], &str[index + 1], size - index - 1);
                 Memory::FreeRaw(str);
-                small.SetSize(size);
+                small.SetSize(size - 1);
             } else {
                 Memory::MemCopy(&large.data[index], &large.data[index + 1], large.GetSize() - index - 1);
                 large.sizePackedFlag -= 2;
@@ -378,13 +429,13 @@ namespace Quasi {
 
     void String::ShrinkToFit() {
         if (IsSmallString()) return;
-        MoveBuffer(AllocateString(large.GetSize()), large.GetSize());
+        MoveBuffer(AllocateLike(large.GetSize()), large.GetSize());
     }
 
     void String::ShrinkTo(usize mincap) {
         if (IsSmallString()) return;
         const usize size = std::max(large.GetSize(), mincap);
-        MoveBuffer(AllocateString(size), size);
+        MoveBuffer(AllocateLike(size), size);
     }
 
     void String::Truncate(usize len) {
@@ -423,7 +474,7 @@ namespace Quasi {
         if (sum.IsSmallString())
             sum.small.SetSize(Length() + rhs.Length());
         else
-            sum.large.SetSize(sum.large.cap);
+            sum.large.SetSize(sum.large.GetCap());
         return sum;
     }
 
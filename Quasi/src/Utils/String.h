@@ -19,8 +19,12 @@ namespace Quasi {
         // when long, it becomes a Vec<char>
         // since we store the last bit in the struct as the short or long mask,
         // many size operations require extra math (x2)
+        // the top bit of CAPC is set when the buffer came from an allocator instead of the heap,
+        // in which case the allocator is stored right before DATA.
 
         struct Large {
+            static constexpr usize ALLOCATOR_FLAG = (usize)1 << (sizeof(usize) * 8 - 1);
+
             usize sizePackedFlag = 1;
             usize cap = 0;
             char* data = nullptr;
@@ -28,6 +32,11 @@ namespace Quasi {
             usize GetSize() const { return sizePackedFlag >> 1; }
             void SetSize(usize x) { sizePackedFlag =  x * 2 + 1; }
             void AddSize(usize x) { sizePackedFlag += x * 2; }
+
+            usize GetCap() const { return cap & ~ALLOCATOR_FLAG; }
+            void SetCap(usize x) { cap = x | (cap & ALLOCATOR_FLAG); }
+            bool HasAllocator() const { return cap & ALLOCATOR_FLAG; }
+            Memory::IAllocator* GetAllocator() const { return ((Memory::IAllocator**)data)[-1]; }
         };
         struct Small {
             static constexpr usize MAXLEN = sizeof(usize) / sizeof(char) * 3 - 1;
@@ -56,6 +65,10 @@ namespace Quasi {
 
         static String Empty() { return {}; }
         static String WithCap(usize cap);
+        // strings from an allocator are always large, so that they remember where to grow from.
+        // copying them or converting them into Vec<char>s moves the contents back to the heap
+        static String WithCap(usize cap, Memory::IAllocator& allocator);
+        static String FromStr(Str str, Memory::IAllocator& allocator);
         static String FromChars(Vec<char> chars);
         static String FromChars(Span<const char> chars);
         static String FromStr(Str str);
@@ -84,8 +97,14 @@ namespace Quasi {
         // assumes small strings
         void CopyToLarge(char* dest, usize size);
         void MoveBuffer(char* dest, usize cap);
+        // assumes large strings, allocates from the same place as the current buffer
+        char* AllocateLike(usize size) const;
+        void FreeLarge();
+        void MoveToHeap();
     public:
         static char* AllocateString(usize size);
+        static char* AllocateString(usize size, Memory::IAllocator& allocator);
+        OptRef<Memory::IAllocator> GetAllocator() const;
 
         bool CanFit(usize amount) const;
         void TryGrow(usize amount);
@@ -145,7 +164,7 @@ namespace Quasi {
             if (IsSmallString())
                 small.sizePackedFlag = slow * 2;
             else {
-                large.sizePackedFlag = slow * 2;
+                large.SetSize(slow);
                 if (slow <= Small::MAXLEN)
                     OptimizeAsSmall();
             }
@@ -178,6 +197,11 @@ namespace Quasi {
         String& operator+=(Str rhs);
     };
 
+    // the small buffer is stored inline without pointing to itself, so strings can be moved as bytes
+    namespace Memory {
+        template <> constexpr bool EnableTrivialRelocate<String> = true;
+    }
+
     template <class Char, class Super>
     String StringHolder<Char, Super>::ReplaceIf(Fn<usize, Str> auto&& pred, Str to) const {
         String repl;
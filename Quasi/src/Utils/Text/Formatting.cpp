@@ -16,6 +16,7 @@ namespace Quasi::Text {
             const char c = fmt[i];
             if (c != '{' && c != '}') { ++i; continue; }
             if (i + 1 < fmt.Length() && fmt[i + 1] == c) {
+                writeLen += output.Write(fmt.Substr(prev, i - prev));
                 writeLen += output.Write(c);
                 i = (prev = i + 2);
                 continue;
@@ -177,7 +177,7 @@ namespace Quasi::Text {
         }
     };
 
-    template <class T>          struct Formatter<Vec<T>>      : Formatter<Span<const T>> {};
+    template <class T, class A> struct Formatter<Vec<T, A>>   : Formatter<Span<const T>> {};
     template <class T, usize N> struct Formatter<Array<T, N>> : Formatter<Span<const T>> {};
 
     template <class... Ts> struct Formatter<Tuple<Ts...>> {
@@ -1,5 +1,10 @@
 #include "Num.h"
 
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "PowerTable.h"
 #include "Utils/Bitwise.h"
 #include "Utils/Debug/Logger.h"
 
@@ -275,24 +280,20 @@ namespace Quasi::Text {
         // utilizes u64s to optimize string comparisons
         constexpr u64 CLEAR_CASE = 0xDFDFDFDFDFDFDFDF;
         if (string.Length() < 3) return nullptr;
-        if (string.Length() < 8) {
-            u64 first3 = string[0] << 16 | string[1] << 8 | string[0];
-            first3 &= CLEAR_CASE;
-            if (first3 == "INF"_u64) {
-                out = (F)f32s::INFINITY;
-            } else if (first3 == "NAN"_u64) {
-                out = (F)f32s::NAN;
-            } else return nullptr;
-            return 3;
-        } else {
-            u64 first8 = Memory::ReadU64Big(string.Data());
-            first8 &= CLEAR_CASE;
+        if (string.Length() >= 8) {
+            const u64 first8 = Memory::ReadU64Big(string.Data()) & CLEAR_CASE;
             if (first8 == "INFINITY"_u64) {
-                out = (F)f32s::INFINITY;
+                out = NumInfo<F>::INFINITY;
                 return 8;
             }
         }
-        return nullptr;
+        const u64 first3 = ((u64)(u8)string[0] << 16 | (u64)(u8)string[1] << 8 | (u8)string[2]) & CLEAR_CASE;
+        if (first3 == "INF"_u64) {
+            out = NumInfo<F>::INFINITY;
+        } else if (first3 == "NAN"_u64) {
+            out = NumInfo<F>::NAN;
+        } else return nullptr;
+        return 3;
     }
 
     template OptionUsize NumberConversion::ParseNanOrInf<f32>(Str string, Out<f32&> out);
@@ -524,261 +525,410 @@ namespace Quasi::Text {
             x += 0x2A2A2A2A'2A2A2A2A;
             Memory::WriteU64Big(x, &strbuf[(1 - i) * 8]);
 
-            x >>= 32;
-            if (!x) break;
+            num >>= 32;
+            if (!num) break;
         }
         sw.Write(Str::Slice(strbuf + (u64s::BITS / 4) - hexDigits, hexDigits));
     }
 
-    char* NumberConversion::AddSign(f64 f, char* out, bool alwaysShowSign) {
-        if (f < 0) {
-            *out = '-';
-            return ++out;
-        }
-        if (alwaysShowSign) {
-            *out = '+';
-            return ++out;
-        }
-        return out;
+    u64 NumberConversion::MulHigh64(u64 a, u64 b, u64& low) {
+#ifdef __SIZEOF_INT128__
+        __extension__ using u128 = unsigned __int128; // keeps -pedantic quiet
+        const u128 product = (u128)a * b;
+        low = (u64)product;
+        return (u64)(product >> 64);
+#else
+        const u64 aLo = (u32)a, aHi = a >> 32, bLo = (u32)b, bHi = b >> 32;
+        const u64 ll = aLo * bLo, lh = aLo * bHi, hl = aHi * bLo, hh = aHi * bHi;
+        const u64 mid = (ll >> 32) + (u32)lh + (u32)hl;
+        low = mid << 32 | (u32)ll;
+        return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
     }
 
-    char* NumberConversion::WriteFltDecimal(f64 f, char* out, u32 precision) {
-        if (precision == ~0) {
-            // builtin 3-digit max precision
-            u32 dig3 = f64s::FastToIntUnsigned(f * 1000);
-            if (dig3 == 0) {
-                return out;
-            } else {
-                dig3 = U64ToBCD4(dig3);
-                const u32 empty = u32s::CountRightZeros(dig3) / 8;
-                dig3 <<= 8;
-                dig3 |= 0x30'30'30'00;
-                *out++ = '.';
-                Memory::WriteU32Big(dig3, out);
-                out += 3 - empty;
-            }
-        } else {
-            *out++ = '.';
-            u32 p = 0;
-            for (; p < precision; p += 2) {
-                f64 dig2;
-                f64s::SeparateDecimal(f * 100, dig2, f);
-
-                u32 i = (u32)std::floor(dig2);
-                i = U64ToBCD2(i);
-                Memory::WriteU16Big(i | 0x3030, out);
-                out += 2;
-            }
-            if (p < precision) {
-                *out++ = (char)(0x30 | (u32)std::floor(f * 10));
-            }
+    // see https://drive.google.com/file/d/1IEeATSVnEE6TkrHlCYNY2GjaraBjOT4f (Giulietti, The Schubfach way to render doubles)
+    // and https://github.com/abolz/Drachennest/blob/master/src/schubfach_64.cc
+    namespace NumberConversion {
+        static int FloorLog2Pow10(int e)              { return (e * 1741647) >> 19; }
+        static int FloorLog10Pow2(int e)              { return (e * 1262611) >> 22; }
+        static int FloorLog10ThreeQuartersPow2(int e) { return (e * 1262611 - 524031) >> 22; }
+
+        // (g * cp) >> 128, with the lowest bit set if anything that got shifted out was nonzero
+        static u64 RoundToOdd(const u64 g[2], u64 cp) {
+            u64 xLo, yLo;
+            const u64 xHi = MulHigh64(g[1], cp, xLo);
+            const u64 yHi = MulHigh64(g[0], cp, yLo);
+            const u64 mid = yLo + xHi;
+            const u64 hi = yHi + (mid < yLo);
+            return hi | (mid > 1);
         }
-        return out;
-    }
 
-    char* NumberConversion::WriteFltSci(f64 f, char* out, u32 precision, char e, int log10) {
-        if (f == 0) {
-            if (precision == ~0) {
-                *out++ = '0';
-                return out;
+        // c * 2^q, where the rounding interval is [v - ulp/2, v + ulp/2], or [v - ulp/4, v + ulp/2] at powers of 2
+        static DecimalFloat ShortestDecimal(u64 c, int q, bool lowerBoundaryCloser) {
+            const bool isEven = c % 2 == 0;
+            const int k = lowerBoundaryCloser ? FloorLog10ThreeQuartersPow2(q) : FloorLog10Pow2(q);
+            const int h = q + FloorLog2Pow10(-k) + 1;
+
+            // 10^-k rounded up, it is only exact for 0 <= -k <= 55
+            const u64* pow10 = POW5_128[-k - POW5_128_MIN_EXP];
+            u64 g[2] = { pow10[0], pow10[1] };
+            if (-k < 0 || -k > 55) g[0] += ++g[1] == 0;
+
+            const u64 cbl = 4 * c - 2 + lowerBoundaryCloser, cb = 4 * c, cbr = 4 * c + 2;
+            const u64 vbl = RoundToOdd(g, cbl << h),
+                      vb  = RoundToOdd(g, cb  << h),
+                      vbr = RoundToOdd(g, cbr << h);
+            const u64 lower = vbl + !isEven, upper = vbr - !isEven;
+
+            const u64 s = vb / 4;
+            if (s >= 10) {
+                // try one digit less first
+                const u64 sp = s / 10;
+                const bool upInside = lower <= 40 * sp, wpInside = 40 * sp + 40 <= upper;
+                if (upInside != wpInside) return { sp + wpInside, k + 1 };
             }
-            Memory::WriteU16(".0"_u16, out);
-            out += 2;
-            while (precision --> 0)
-                *out++ = '0';
-            return out;
-        }
+            const bool uInside = lower <= 4 * s, wInside = 4 * s + 4 <= upper;
+            if (uInside != wInside) return { s + wInside, k };
 
-        f64 mant, mantDec;
-
-        if (log10 == i32s::MIN) {
-            f64 ilog;
-            f64s::SeparateDecimal(f64s::Log10(f), ilog, mant);
-            mant = f64s::Exp10(mant);
-        } else {
-            mant = f * f64s::Exp10(-log10);
+            const u64 mid = 4 * s + 2;
+            const bool roundUp = vb > mid || (vb == mid && (s & 1) != 0);
+            return { s + roundUp, k };
         }
-        f64s::SeparateDecimal(mant, mant, mantDec);
-
-        *out = (char)('0' | (u32)std::floor(mant));
-        out = WriteFltDecimal(mantDec, ++out, precision);
-        // ...E+... or ...E-...
-        Memory::WriteU16(e << 8 | (log10 < 0 ? '-' : '+'), out);
-        out += 2;
-        log10 = std::abs(log10);
-
-        {
-            u32 eStr = U64ToBCD4(log10);
-            const u32 empty = u32s::CountLeftZeros(eStr) / 8;
-            eStr <<= empty * 8;
-            eStr |= 0x30303030;
-            Memory::MemCopyNoOverlap(out, (const char*)&eStr, 4 - empty);
-            out += 4 - empty;
+
+        static DecimalFloat RemoveTrailingZeros(DecimalFloat d) {
+            if (d.digits == 0) return { 0, 0 };
+            while (d.digits % 10 == 0) { d.digits /= 10; ++d.exponent; }
+            return d;
         }
+    }
 
-        return out;
+    NumberConversion::DecimalFloat NumberConversion::ShortestDecimal(f64 f) {
+        const u64 bits = f64s::BitsOf(f);
+        const u64 mantissa = bits & f64s::MANTISSA_MASK;
+        const u32 exponent = (u32)((bits & f64s::EXPONENT_MASK) >> f64s::MANTISSA_BITS);
+        if (exponent == 0 && mantissa == 0) return { 0, 0 };
+        return RemoveTrailingZeros(exponent == 0 ?
+            ShortestDecimal(mantissa, -1074, false) :
+            ShortestDecimal(mantissa | (1ull << 52), (int)exponent - 1075, mantissa == 0 && exponent > 1));
     }
 
-    char* NumberConversion::WriteFltFxd(f64 f, char* out, u32 width, u32 precision, int log10, char pad) {
-        if (f == 0) {
-            const u32 w = width > 1 ? width - 1 : 0;
-            Memory::MemSet(out, pad, w);
-            out += w;
-            *out++ = '0';
+    NumberConversion::DecimalFloat NumberConversion::ShortestDecimal(f32 f) {
+        const u32 bits = f32s::BitsOf(f);
+        const u32 mantissa = bits & f32s::MANTISSA_MASK;
+        const u32 exponent = (bits & f32s::EXPONENT_MASK) >> f32s::MANTISSA_BITS;
+        if (exponent == 0 && mantissa == 0) return { 0, 0 };
+        // the double sized table is more than precise enough for floats
+        return RemoveTrailingZeros(exponent == 0 ?
+            ShortestDecimal(mantissa, -149, false) :
+            ShortestDecimal(mantissa | (1u << 23), (int)exponent - 150, mantissa == 0 && exponent > 1));
+    }
 
-            if (precision == ~0) return out;
+    namespace NumberConversion {
+        // the digits of a float, the value being 0.d1d2d3... * 10^pointPos. digits past count are 0.
+        // 800 digits is enough for the longest exact expansion of a double (767 significant digits)
+        struct FloatDigits {
+            char digits[800];
+            u32 count = 0;
+            int pointPos = 0;
 
-            *out++ = '.';
-            Memory::MemSet(out, pad, precision);
+            char At(int i) const { return 0 <= i && i < (int)count ? digits[i] : '0'; }
+        };
 
-            return out + precision;
-        } else if (f < 1) { // log will be negative
-            const u32 w = width > 1 ? width - 1 : 0;
-            Memory::MemSet(out, pad, w);
-            out += w;
-            *out++ = '0';
-        } else {
-            log10 = (log10 == i32s::MIN ? (int)std::floor(f64s::Log10(f)) : log10) + 1;
+        // just enough of a big integer for converting floats exactly, all on the stack
+        template <u32 MAX_LIMBS>
+        struct BigUInt {
+            u32 limbs[MAX_LIMBS]; // little endian
+            u32 size = 0;
+
+            explicit BigUInt(u64 x) {
+                limbs[0] = (u32)x; limbs[1] = (u32)(x >> 32);
+                size = (x >> 32) ? 2 : x ? 1 : 0;
+            }
 
-            if (log10 < width) {
-                Memory::MemSet(out, pad, width - log10);
-                out += width - log10;
+            bool IsZero() const { return size == 0; }
+            void Trim() { while (size && !limbs[size - 1]) --size; }
+
+            void ShiftLeft(u32 bits) {
+                if (!size) return;
+                const u32 limbShift = bits / 32, bitShift = bits % 32;
+                limbs[size + limbShift] = 0;
+                for (u32 i = size; i --> 0; ) {
+                    const u64 shifted = (u64)limbs[i] << bitShift;
+                    limbs[i + limbShift + 1] |= (u32)(shifted >> 32);
+                    limbs[i + limbShift] = (u32)shifted;
+                }
+                for (u32 i = 0; i < limbShift; ++i) limbs[i] = 0;
+                size += limbShift + 1;
+                Trim();
+            }
+
+            void MulSmall(u32 m) {
+                u64 carry = 0;
+                for (u32 i = 0; i < size; ++i) {
+                    const u64 x = (u64)limbs[i] * m + carry;
+                    limbs[i] = (u32)x;
+                    carry = x >> 32;
+                }
+                if (carry) limbs[size++] = (u32)carry;
             }
 
-            if (log10 > 4) {
-                f64 frac;
-                const f64 div10 = f64s::Exp10(-f64s::FastToFloatUnsigned(log10 - 4));
-                f *= div10;
+            void AddSmall(u32 a) {
+                u64 carry = a;
+                for (u32 i = 0; carry && i < size; ++i) {
+                    const u64 x = (u64)limbs[i] + carry;
+                    limbs[i] = (u32)x;
+                    carry = x >> 32;
+                }
+                if (carry) limbs[size++] = (u32)carry;
+            }
 
-                for (; log10 > 4; log10 -= 4) {
-                    f64s::SeparateDecimal(f, f, frac);
+            void MulPow5(u32 e) {
+                for (; e >= 13; e -= 13) MulSmall(1'220'703'125); // 5^13, the largest power that fits in a u32
+                if (e) MulSmall((u32)(Math::POWERS_OF_10[e] >> e));
+            }
 
-                    u32 topDigits = f64s::FastToIntUnsigned(f);
-                    topDigits = U64ToBCD4(topDigits);
-                    topDigits |= 0x30303030;
-                    Memory::WriteU32Big(topDigits, out);
-                    out += 4;
+            static int Compare(const BigUInt& a, const BigUInt& b) {
+                if (a.size != b.size) return a.size < b.size ? -1 : 1;
+                for (u32 i = a.size; i --> 0; )
+                    if (a.limbs[i] != b.limbs[i]) return a.limbs[i] < b.limbs[i] ? -1 : 1;
+                return 0;
+            }
 
-                    f = frac * 10000;
+            u32 DivRemSmall(u32 d) {
+                u64 rem = 0;
+                for (u32 i = size; i --> 0; ) {
+                    const u64 x = rem << 32 | limbs[i];
+                    limbs[i] = (u32)(x / d);
+                    rem = x % d;
                 }
-                f *= f64s::Exp10(-f64s::FastToFloatUnsigned(4 - log10));
+                Trim();
+                return (u32)rem;
             }
-            u32 d = std::floor(f);
-            d = U64ToBCD4(d);
-            d |= 0x30303030;
-            d <<= (-8 * log10) & 31;
-            d = Memory::ByteSwap32(d);
-            Memory::MemCopyNoOverlap(out, (const char*)&d, log10);
-            out += log10;
-
-            [[maybe_unused]] f64 ignore;
-            f64s::SeparateDecimal(f, ignore, f);
-        }
 
-        out = WriteFltDecimal(f, out, precision);
+            // removes and returns the bits at or above bit, which have to fit in a u32
+            u32 TakeHighBits(u32 bit) {
+                const u32 limb = bit / 32, shift = bit % 32;
+                if (limb >= size) return 0;
+                u32 high = limbs[limb] >> shift;
+                if (shift && limb + 1 < size) high |= limbs[limb + 1] << (32 - shift);
+                limbs[limb] &= ((u32)1 << shift) - 1;
+                size = limb + 1;
+                Trim();
+                return high;
+            }
+        };
 
-        return out;
-    }
+        // printing doubles exactly needs up to 1078 bits
+        using SmallBigInt = BigUInt<40>;
 
-    char* NumberConversion::WriteFltGen(f64 f, char* out, u32 width, u32 precision, char e) {
-        const int log = (int)f64s::Log10(f);
-        if (log > (int)width) {
-            return WriteFltSci(f, out, precision, e);
-        } else {
-            return WriteFltFxd(f, out, width, precision, log);
+        static void ShortestDigits(DecimalFloat d, FloatDigits& out) {
+            out.count = U64FullToString(d.digits, out.digits);
+            out.pointPos = (int)out.count + d.exponent;
         }
-    }
 
-    usize NumberConversion::FormatFltSci(StringWriter sw, f64 f, const FloatFormatter::FormatOptions& options) {
-        // -_.___E+____
-        // break down:
-        // sign (1)
-        // first digit (1)
-        // decimal point (1)
-        // decimals (options.precision or 3 if none specified (~0)) -> add 4 for ~0
-        // E+ (2)
-        // exponent (max 4)
-        char* strbuf = Memory::QAlloca$(char, 1 + 1 + 1 + (options.precision + 4) + 2 + 4);
-        const char* end = WriteFltSci(
-            std::abs(f),
-            AddSign(f, strbuf, options.showSign),
-            options.precision,
-            options.mode == FloatFormatter::FormatOptions::SCI_CAP ? 'E' : 'e'
-        );
-        return Formatter<Str>::FormatTo(sw,
-            Str::Slice(strbuf, end - strbuf),
-            { options.width, options.alignment, options.pad, false }
-        );
-    }
+        // rounds f (finite, non-negative) half to even, either to decimals after the point or to significant digits
+        static void ExactDigits(f64 f, bool toSignificant, int n, FloatDigits& out) {
+            const u64 bits = f64s::BitsOf(f);
+            const u64 mantissa = bits & f64s::MANTISSA_MASK;
+            const u32 exponent = (u32)((bits & f64s::EXPONENT_MASK) >> f64s::MANTISSA_BITS);
+            const u64 c = exponent ? mantissa | (1ull << 52) : mantissa;
+            const int q = exponent ? (int)exponent - 1075 : -1074;
+
+            if (c == 0) {
+                out.digits[0] = '0';
+                out.count = 1;
+                out.pointPos = 1;
+                return;
+            }
 
-    usize NumberConversion::FormatFltFxd(StringWriter sw, f64 f, const FloatFormatter::FormatOptions& options) {
-        // -___.___
-        // sign (1)
-        // digits (max(log10, width))
-        // decimal point (1)
-        // decimals (~0 -> 3, anything else -> itself)
-        const int log10 = (int)f64s::Log10(std::abs(f));
-        const u32 w = log10 <= 0 ? 1 : (log10 + 1);
-        char* strbuf = Memory::QAlloca$(char, 1 + std::max(w, options.width) + 1 + (options.precision + 4));
-        const char* end = WriteFltFxd(
-            std::abs(f),
-            AddSign(f, strbuf, options.showSign),
-            options.width,
-            options.precision,
-            log10,
-            options.pad
-        );
-        return Formatter<Str>::FormatTo(sw,
-            Str::Slice(strbuf, end - strbuf),
-            { options.width, options.alignment, options.pad, false }
-        );
-    }
+            // integer part
+            const u32 fracBits = q < 0 ? (u32)-q : 0;
+            SmallBigInt integer { fracBits >= 64 ? 0 : c >> fracBits };
+            if (q > 0) integer.ShiftLeft(q);
+            out.count = 0;
+            while (!integer.IsZero()) {
+                // 9 digits at a time, written backwards and reversed at the end
+                u32 chunk = integer.DivRemSmall(1'000'000'000);
+                for (u32 i = 0; i < 9 && (chunk || !integer.IsZero()); ++i) {
+                    out.digits[out.count++] = (char)('0' + chunk % 10);
+                    chunk /= 10;
+                }
+            }
+            std::reverse(out.digits, out.digits + out.count);
+            out.pointPos = (int)out.count;
+
+            // fractional part, one digit per multiplication by 10
+            SmallBigInt frac { fracBits == 0 ? 0 : fracBits >= 64 ? c : c & (((u64)1 << fracBits) - 1) };
+            u32 roundDigit = 0;
+            bool sticky = false;
+            if (toSignificant && (int)out.count > n) {
+                roundDigit = out.digits[n] - '0';
+                for (u32 i = n + 1; i < out.count; ++i) sticky |= out.digits[i] != '0';
+                sticky |= !frac.IsZero();
+                out.count = n;
+            } else {
+                for (int index = 1; !frac.IsZero(); ++index) {
+                    frac.MulSmall(10);
+                    const u32 digit = frac.TakeHighBits(fracBits);
+                    const bool keep = toSignificant ? (int)out.count < n : index <= n;
+                    if (!keep) {
+                        roundDigit = digit;
+                        sticky = !frac.IsZero();
+                        break;
+                    }
+                    // leading zeros just move the decimal point
+                    if (out.count == 0 && digit == 0) { --out.pointPos; continue; }
+                    out.digits[out.count++] = (char)('0' + digit);
+                }
+            }
 
-    usize NumberConversion::FormatFloating(StringWriter sw, f64 f, const FloatFormatter::FormatOptions& options) {
-        using enum FloatFormatter::FormatOptions::Mode;
+            const bool lastIsOdd = out.count && (out.digits[out.count - 1] & 1);
+            if (roundDigit > 5 || (roundDigit == 5 && (sticky || lastIsOdd))) {
+                i32 i = (i32)out.count - 1;
+                for (; i >= 0 && out.digits[i] == '9'; --i) out.digits[i] = '0';
+                if (i >= 0) ++out.digits[i];
+                else {
+                    // 999 -> 1000, which moves the point instead
+                    Memory::MemCopy(out.digits + 1, out.digits, out.count);
+                    out.digits[0] = '1';
+                    ++out.pointPos;
+                    if (!toSignificant || out.count == 0) ++out.count;
+                }
+            }
 
-        static constexpr char NaNString[] = "NaN%",
-                              InfString[] = "-Infinity%";
+            if (out.count == 0) {
+                out.digits[0] = '0';
+                out.count = 1;
+                out.pointPos = 1;
+            }
+        }
 
-        if (f == f64s::NAN) {
-            return Formatter<Str>::FormatTo(sw,
-                Str::Slice(NaNString, 3 + options.mode == PERCENTAGE),
-                { options.width, options.alignment, options.pad, false }
-            );
+        static usize FixedLength(const FloatDigits& d, u32 fracDigits) {
+            return (usize)std::max(d.pointPos, 1) + (fracDigits ? fracDigits + 1 : 0);
         }
-        if (f64s::IsInf(f)) {
-            const bool isPositive = f > 0;
-            return Formatter<Str>::FormatTo(sw,
-                Str::Slice(InfString + isPositive, 9 - isPositive + options.mode == PERCENTAGE),
-                { options.width, options.alignment, options.pad, false }
-            );
+
+        static char* WriteFixed(const FloatDigits& d, u32 fracDigits, char* out) {
+            if (d.pointPos <= 0) *out++ = '0';
+            for (int i = 0; i < d.pointPos; ++i) *out++ = d.At(i);
+            if (fracDigits) {
+                *out++ = '.';
+                for (u32 i = 0; i < fracDigits; ++i) *out++ = d.At(d.pointPos + (int)i);
+            }
+            return out;
+        }
+
+        static usize SciLength(u32 fracDigits) {
+            return 1 + (fracDigits ? fracDigits + 1 : 0) + 2 + 3;
         }
 
-        switch (options.mode) {
-            case SCIENTIFIC:
-            case SCI_CAP:
-                return FormatFltSci(sw, f, options);
-            case FIXED: {
-                return FormatFltFxd(sw, f, options);
+        static char* WriteSci(const FloatDigits& d, u32 fracDigits, char e, char* out) {
+            const bool isZero = d.count == 1 && d.digits[0] == '0';
+            *out++ = d.At(0);
+            if (fracDigits) {
+                *out++ = '.';
+                for (u32 i = 0; i < fracDigits; ++i) *out++ = d.At(1 + (int)i);
             }
-            case GENERAL:
-            case GEN_CAP: {
-                if (std::abs(f) > f64s::Exp10(options.width) ||
-                    std::abs(f) < f64s::Exp10(-options.precision)) {
-                    FloatFormatter::FormatOptions fopt = options;
-                    fopt.mode = options.mode == GEN_CAP ? SCI_CAP : SCIENTIFIC;
-                    return FormatFltSci(sw, f, fopt);
-                } else {
-                    return FormatFltFxd(sw, f, options);
-                }
+            const int exp10 = isZero ? 0 : d.pointPos - 1;
+            *out++ = e;
+            *out++ = exp10 < 0 ? '-' : '+';
+            const u32 absExp = (u32)std::abs(exp10);
+            if (absExp >= 100) *out++ = (char)('0' + absExp / 100);
+            Memory::WriteU16Big((u16)(U64ToBCD2(absExp % 100) | 0x3030), out);
+            return out + 2;
+        }
+
+        template <Floating F>
+        static usize FormatFloatingImpl(StringWriter sw, F f, const FloatFormatter::FormatOptions& options) {
+            using enum FloatFormatter::FormatOptions::Mode;
+
+            const bool negative = NumInfo<F>::IsSignedNegative(f);
+            const char sign = negative ? '-' : options.showSign ? '+' : '\0';
+            const bool percent = options.mode == PERCENTAGE;
+
+            if (NumInfo<F>::IsNaN(f) || NumInfo<F>::IsInf(f)) {
+                static constexpr char NaNString[] = "NaN%", InfString[] = "-Infinity%";
+                const Str str = NumInfo<F>::IsNaN(f) ?
+                    Str::Slice(NaNString, 3 + percent) :
+                    Str::Slice(InfString + !negative, 9 - !negative + percent);
+                return Formatter<Str>::FormatTo(sw, str, { options.width, options.alignment, options.pad, false });
             }
-            case PERCENTAGE: {
-                return FormatFltFxd(sw, f * 100, options);
+
+            f = std::abs(f);
+            if (percent) f *= 100;
+
+            FloatDigits digits;
+            const bool hasPrecision = options.precision != ~0u;
+            const auto shortest = [&] { ShortestDigits(ShortestDecimal(f), digits); };
+            // digits written after the point, without precision this is however many the shortest form needs
+            const auto shortestFixedDigits = [&] { return (u32)std::max((int)digits.count - digits.pointPos, 0); };
+
+            bool scientific = false, trimZeros = false;
+            u32 fracDigits = 0;
+            switch (options.mode) {
+                case FIXED: case PERCENTAGE:
+                    if (hasPrecision) { ExactDigits(f, false, (int)options.precision, digits); fracDigits = options.precision; }
+                    else { shortest(); fracDigits = shortestFixedDigits(); }
+                    break;
+                case SCIENTIFIC: case SCI_CAP:
+                    scientific = true;
+                    if (hasPrecision) { ExactDigits(f, true, (int)options.precision + 1, digits); fracDigits = options.precision; }
+                    else { shortest(); fracDigits = digits.count - 1; }
+                    break;
+                case GENERAL: case GEN_CAP:
+                    // like python, fixed notation is used for exponents in [-4, precision), and trailing zeros are removed
+                    if (hasPrecision) {
+                        const int p = std::max((int)options.precision, 1);
+                        ExactDigits(f, true, p, digits);
+                        const int exp10 = digits.pointPos - 1;
+                        scientific = f != 0 && (exp10 < -4 || exp10 >= p);
+                        fracDigits = (u32)(scientific ? p - 1 : std::max(p - 1 - exp10, 0));
+                        trimZeros = true;
+                    } else {
+                        shortest();
+                        const int exp10 = digits.pointPos - 1;
+                        scientific = f != 0 && (exp10 < -4 || exp10 >= 16);
+                        fracDigits = scientific ? digits.count - 1 : shortestFixedDigits();
+                    }
+                    break;
+                default: return 0;
+            }
+            if (trimZeros) {
+                const int firstFrac = scientific ? 1 : digits.pointPos;
+                while (fracDigits && digits.At(firstFrac + (int)fracDigits - 1) == '0') --fracDigits;
             }
-            default: return 0;
+
+            const usize bodyLen = scientific ? SciLength(fracDigits) : FixedLength(digits, fracDigits);
+            char* strbuf = Memory::QAlloca$(char, 1 + bodyLen + 1);
+            char* end = strbuf;
+            if (sign) *end++ = sign;
+            const char e = options.mode == SCI_CAP || options.mode == GEN_CAP ? 'E' : 'e';
+            end = scientific ? WriteSci(digits, fracDigits, e, end) : WriteFixed(digits, fracDigits, end);
+            if (percent) *end++ = '%';
+
+            const usize len = end - strbuf;
+            if (options.shouldPadZero && options.width > len) {
+                // zeros go between the sign and the digits
+                const usize signLen = sign ? 1 : 0;
+                sw.Write(Str::Slice(strbuf, signLen));
+                sw.WriteRepeat('0', options.width - len);
+                sw.Write(Str::Slice(strbuf + signLen, len - signLen));
+                return options.width;
+            }
+            return Formatter<Str>::FormatTo(sw,
+                Str::Slice(strbuf, len),
+                { options.width, options.alignment, options.pad, false }
+            );
         }
     }
 
+    usize NumberConversion::FormatFloating(StringWriter sw, f32 f, const FloatFormatter::FormatOptions& options) {
+        return FormatFloatingImpl(sw, f, options);
+    }
+
+    usize NumberConversion::FormatFloating(StringWriter sw, f64 f, const FloatFormatter::FormatOptions& options) {
+        return FormatFloatingImpl(sw, f, options);
+    }
+
     usize Formatter<bool>::FormatTo(StringWriter sw, bool input, const FormatOptions& options) {
         return Formatter<Str>::FormatTo(sw, input ? "true"_str : "false"_str, options);
     }
@@ -950,13 +1100,14 @@ namespace Quasi::Text {
                 case 'f': options.mode = FormatOptions::FIXED;      return options;
                 case 'G': options.mode = FormatOptions::GEN_CAP;    return options;
                 case 'g': options.mode = FormatOptions::GENERAL;    return options;
+                case '%': options.mode = FormatOptions::PERCENTAGE; return options;
                 default: {
                     if (opt.IsEmpty()) return options;
                     // Parse fill and alignment.
                     const char align = opt[1];
                     Debug::Assert("<^>"_str.Contains(align), "no align spec");
                     ENTER(ALIGN);
-                    options.pad = c;
+                    options.pad = opt[0];
                     options.alignment = align == '<' ? Align::LEFT : align == '^' ? Align::CENTER : Align::RIGHT;
                     opt.Advance(2);
                 }
@@ -983,128 +1134,338 @@ namespace Quasi::Text {
         return nullptr;
     }
 
-    template <class N>
-    OptionUsize NumberConversion::FloatConv<N>::ParseUntil(Str string, Out<N&> out, FloatParser::ParseOptions options) {
-        const bool isFixed = (options.format & FloatParser::ParseOptions::FIXED),
-                   isSci   = (options.format & FloatParser::ParseOptions::SCIENTIFIC);
+    namespace NumberConversion {
+        // every power of 10 that a double holds exactly
+        static constexpr f64 EXACT_POWERS_OF_10[] = {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+        };
 
-        bool negative = false, hasSign = true;
-        if (string.StartsWith('+')) string.Advance(1);
-        else if (string.StartsWith('-')) { negative = true; string.Advance(1); }
-        else hasSign = false;
+        // holds up to 800 digits times any power of 5 or 2 a float can need, which is under 4000 bits
+        using ParseBigInt = BigUInt<192>;
+
+        // compares digits * 10^exp10 with the midpoint between f and the float above it
+        template <Floating F>
+        static int CompareWithMidpoint(const ParseBigInt& digits, i32 exp10, F f) {
+            using Info = NumInfo<F>;
+            const u64 bits = Info::BitsOf(f);
+            const i32 biased = (i32)(bits >> Info::MANTISSA_BITS);
+            const u64 m = (bits & Info::MANTISSA_MASK) | (biased ? (u64)1 << Info::MANTISSA_BITS : 0);
+            const i32 exp2 = std::max(biased, 1) - (Info::MAX_EXP - 1) - (i32)Info::MANTISSA_BITS;
+
+            // the midpoint is (2m + 1) * 2^(exp2 - 1)
+            ParseBigInt lhs = digits, rhs { 2 * m + 1 };
+            if (exp10 >= 0) lhs.MulPow5(exp10);
+            else rhs.MulPow5(-exp10);
+            const i32 shift = exp10 - (exp2 - 1);
+            if (shift >= 0) lhs.ShiftLeft(shift);
+            else rhs.ShiftLeft(-shift);
+            return ParseBigInt::Compare(lhs, rhs);
+        }
+    }
 
-        N num;
-        const usize integerPart = ParseInteger(string, num);
+    OptionUsize NumberConversion::ParseDecimalNumber(Str string, Out<DecimalNumber&> out, FloatParser::ParseOptions options) {
+        const char* const begin = string.Data(), * const end = begin + string.Length();
+        const char* p = begin;
+        u64 mantissa = 0; // overflows on long inputs, in which case it gets recomputed
+
+        const auto parseDigits = [&] {
+            const char* const start = p;
+            while (end - p >= 8) {
+                const u64 digs = Memory::ReadU64Big(p) ^ 0x30303030'30303030;
+                if (!Bitwise::BytesAllWithinRange(digs, 0, 10)) break;
+                mantissa = mantissa * 100'000'000 + ParseDigits8(digs);
+                p += 8;
+            }
+            for (; p < end && Chr::IsDigit(*p); ++p) mantissa = mantissa * 10 + (u64)(*p - '0');
+            return Str::Slice(start, p - start);
+        };
 
-        if (string.Length() == integerPart) {
-            if (!isFixed) return nullptr;
-            out = negative ? -num : num;
-            return integerPart + hasSign;
+        DecimalNumber number;
+        number.integer = parseDigits();
+        if (p < end && *p == '.') {
+            ++p;
+            number.fraction = parseDigits();
         }
-
-        usize decimalPart = 0;
-        if (string[integerPart] == '.') {
-            N decimal = 0;
-            decimalPart = 1 + ParseDecimal(string.Skip(integerPart + 1), decimal);
-            num += decimal;
+        const usize digitCount = number.integer.Length() + number.fraction.Length();
+        if (digitCount == 0) return nullptr;
+
+        // like strtod, an e without any digits after it isnt part of the number
+        bool hasExponent = false;
+        if ((options.format & FloatParser::ParseOptions::SCIENTIFIC) && p < end && (*p | 0x20) == 'e') {
+            const char* e = p + 1;
+            bool negExp = false;
+            if (e < end && (*e == '+' || *e == '-')) negExp = *e++ == '-';
+            if (e < end && Chr::IsDigit(*e)) {
+                i32 exp = 0;
+                for (; e < end && Chr::IsDigit(*e); ++e)
+                    if (exp < 100'000) exp = exp * 10 + (*e - '0');
+                number.explicitExponent = negExp ? -exp : exp;
+                hasExponent = true;
+                p = e;
+            }
         }
-
-        const usize fixedPart = integerPart + decimalPart;
-
-        if (fixedPart == string.Length()) {
-            out = negative ? -num : num;
-            return string.Length() + hasSign;
+        if (!hasExponent && !(options.format & FloatParser::ParseOptions::FIXED)) return nullptr;
+
+        number.mantissa = mantissa;
+        number.exponent = number.explicitExponent - (i32)number.fraction.Length();
+
+        if (digitCount > 19) {
+            usize significant = digitCount;
+            for (const char* z = begin; z < p && (*z == '0' || *z == '.'); ++z) significant -= *z == '0';
+
+            if (significant > 19) {
+                constexpr u64 MIN_19_DIGITS = 1'000'000'000'000'000'000;
+                u64 m = 0;
+                const char* d = number.integer.Data(), * const intEnd = d + number.integer.Length();
+                for (; m < MIN_19_DIGITS && d < intEnd; ++d) m = m * 10 + (u64)(*d - '0');
+                if (m >= MIN_19_DIGITS) {
+                    number.exponent = number.explicitExponent + (i32)(intEnd - d);
+                } else {
+                    const char* f = number.fraction.Data(), * const fracEnd = f + number.fraction.Length();
+                    for (; m < MIN_19_DIGITS && f < fracEnd; ++f) m = m * 10 + (u64)(*f - '0');
+                    number.exponent = number.explicitExponent - (i32)(f - number.fraction.Data());
+                }
+                number.mantissa = m;
+                number.truncated = true;
+            }
         }
 
-        if (Chr::ToUpper(string[fixedPart]) == 'E' && isSci) {
-            const Str expStr = string.Skip(fixedPart + 1);
-            const OptionUsize expPart = ParseExponent(expStr, num);
-            if (!expPart) return nullptr;
+        out = number;
+        return (usize)(p - begin);
+    }
 
-            out = negative ? -num : num;
-            return hasSign + fixedPart + 1 + *expPart;
-        }
+    template <class N>
+    OptionUsize NumberConversion::FloatConv<N>::ParseUntil(Str string, Out<N&> out, FloatParser::ParseOptions options) {
+        bool negative = false;
+        usize signLen = 0;
+        if (string.StartsWith('+')) signLen = 1;
+        else if (string.StartsWith('-')) { negative = true; signLen = 1; }
+        const Str rest = string.Skip(signLen);
 
-        if (isFixed) return nullptr;
+        N num;
+        OptionUsize len = nullptr;
+        if (rest && (Chr::ToUpper(rest[0]) == 'I' || Chr::ToUpper(rest[0]) == 'N')) {
+            len = ParseNanOrInf(rest, num);
+        } else {
+            if ((options.format & FloatParser::ParseOptions::HEX) && (rest.StartsWith("0x") || rest.StartsWith("0X")))
+                if (const OptionUsize hexLen = ParseHex(rest.Skip(2), num)) len = 2 + *hexLen;
+            // "0x" on its own is just a 0 followed by an x
+            if (!len) {
+                DecimalNumber number;
+                len = ParseDecimalNumber(rest, number, options);
+                if (len) num = FromDecimal(number);
+            }
+        }
+        if (!len) return nullptr;
 
         out = negative ? -num : num;
-        return hasSign + fixedPart;
+        return signLen + *len;
     }
 
     template <class N>
-    usize NumberConversion::FloatConv<N>::ParseInteger(Str string, Out<N&> out) {
-        string = string.First(string.FindIf([] (char x) { return !Chr::IsDigit(x); }).UnwrapOr(string.Length()));
-        const usize totalLen = string.Length();
-        string = string.TrimStart('0');
-
-        if (string.Length() > NumInfo<N>::MAX_EXP10) {
-            out = (N)f32s::INFINITY;
-            return totalLen;
-        }
+    OptionUsize NumberConversion::FloatConv<N>::ParseHex(Str string, Out<N&> out) {
+        u64 mantissa = 0;
+        i32 exp2 = 0;
+        bool sticky = false;
+        usize i = 0, digitCount = 0;
+
+        // keeps 16 hex digits, which is at least 61 significant bits, enough that the rest only break ties
+        const auto addDigit = [&] (u32 digit, bool isFraction) {
+            if (mantissa >> 60) {
+                sticky |= digit != 0;
+                if (!isFraction) exp2 += 4;
+            } else {
+                mantissa = mantissa << 4 | digit;
+                if (isFraction) exp2 -= 4;
+            }
+        };
 
-        N num = 0;
-        usize i = 0;
-        for (; i < (string.Length() & ~3); i += 4) {
-            u32 dig = Memory::ReadU32Big(string.Data() + i);
-            dig ^= 0x30303030;
-            dig = ParseDigits4(dig);
-            num = num * N { 10'000 } + dig;
+        for (; i < string.Length() && Chr::IsHexDigit(string[i]); ++i, ++digitCount)
+            addDigit(Chr::ToHexDigit(string[i]), false);
+        if (i < string.Length() && string[i] == '.') {
+            ++i;
+            for (; i < string.Length() && Chr::IsHexDigit(string[i]); ++i, ++digitCount)
+                addDigit(Chr::ToHexDigit(string[i]), true);
         }
-        for (; i < string.Length(); ++i) {
-            num = num * N { 10 } + Chr::ToDigit(string[i]);
+        if (digitCount == 0) return nullptr;
+
+        if (i < string.Length() && (string[i] | 0x20) == 'p') {
+            usize j = i + 1;
+            bool negExp = false;
+            if (j < string.Length() && (string[j] == '+' || string[j] == '-')) negExp = string[j++] == '-';
+            if (j < string.Length() && Chr::IsDigit(string[j])) {
+                i32 exp = 0;
+                for (; j < string.Length() && Chr::IsDigit(string[j]); ++j)
+                    if (exp < 100'000) exp = exp * 10 + (string[j] - '0');
+                exp2 += negExp ? -exp : exp;
+                i = j;
+            }
         }
-        out = num;
-        return totalLen;
+
+        out = FromBinary(mantissa, exp2, sticky);
+        return i;
     }
 
     template <class N>
-    usize NumberConversion::FloatConv<N>::ParseDecimal(Str string, InOut<N&> out) {
-        string = string.First(string.FindIf([] (char x) { return !Chr::IsDigit(x); }).UnwrapOr(string.Length()));
-        const usize totalLen = string.Length();
-        string = string.TrimEnd('0');
-
-        N decimal = 1.0f;
-        usize i = 0;
-        for (; i < (string.Length() & ~3); i += 4) {
-            u32 dig = Memory::ReadU32Big(string.Data() + i);
-            dig ^= 0x30303030;
-            if (!dig) continue;
-            dig = ParseDigits4(dig);
-            decimal *= N { 0.0001 };
-            const N newOut = out + decimal * dig;
-            if (newOut == out) return totalLen;
-            out = newOut;
+    N NumberConversion::FloatConv<N>::FromDecimal(const DecimalNumber& number) {
+        using Info = NumInfo<N>;
+        // clinger's fast path, where the mantissa and the power of 10 are both exact,
+        // so a single correctly rounded operation gives the right answer
+        constexpr i32 MAX_EXACT_EXP10 = sizeof(N) == sizeof(f32) ? 10 : 22;
+        if (!number.truncated && number.mantissa <= (u64)1 << Info::DIGITS &&
+            -MAX_EXACT_EXP10 <= number.exponent && number.exponent <= MAX_EXACT_EXP10) {
+            const N m = (N)number.mantissa, pow10 = (N)EXACT_POWERS_OF_10[std::abs(number.exponent)];
+            return number.exponent < 0 ? m / pow10 : m * pow10;
         }
-        for (; i < string.Length(); ++i) {
-            decimal *= N { 0.1 };
-            if (string[i] == '0') continue;
-            const N newOut = out + decimal * Chr::ToDigit(string[i]);
-            if (newOut == out) return totalLen;
-            out = newOut;
+
+        N result;
+        if (FromDecimalFast(number.mantissa, number.exponent, result)) {
+            if (!number.truncated) return result;
+            // the dropped digits put the value somewhere between mantissa and mantissa + 1
+            N upper;
+            if (FromDecimalFast(number.mantissa + 1, number.exponent, upper) && upper == result) return result;
         }
-        return totalLen;
+        return FromDecimalSlow(number);
     }
 
+    // adapted from https://github.com/golang/go/blob/master/src/strconv/eisel_lemire.go
+    // which is based on "Number Parsing at a Gigabyte per Second" by Daniel Lemire
     template <class N>
-    OptionUsize NumberConversion::FloatConv<N>::ParseExponent(Str string, InOut<N&> out) {
-        if (!string) return nullptr;
+    bool NumberConversion::FloatConv<N>::FromDecimalFast(u64 mantissa, i32 exp10, Out<N&> out) {
+        using Info = NumInfo<N>;
+        using Bits = decltype(Info::BitsOf(N {}));
+        if (mantissa == 0 || exp10 < POW5_128_MIN_EXP) { out = 0; return true; }
+        if (exp10 > Info::MAX_EXP10) { out = Info::INFINITY; return true; }
+
+        // the product keeps the mantissa, a rounding bit and a possible leading zero in its top bits
+        constexpr u32 SHIFT = 64 - Info::MANTISSA_BITS - 3;
+        constexpr u64 LOW_MASK = ((u64)1 << SHIFT) - 1;
+
+        const u32 clz = std::countl_zero(mantissa);
+        mantissa <<= clz;
+        i64 exp2 = ((217706 * exp10) >> 16) + 64 + (Info::MAX_EXP - 1) - (i64)clz; // floor(log2(10^exp10))
+
+        const u64* pow5 = POW5_128[exp10 - POW5_128_MIN_EXP];
+        u64 lo, hi = MulHigh64(mantissa, pow5[0], lo);
+        // the lower bits could still carry into the result, so the next 64 bits of the power are needed
+        if ((hi & LOW_MASK) == LOW_MASK && lo + mantissa < mantissa) {
+            u64 lo2;
+            const u64 hi2 = MulHigh64(mantissa, pow5[1], lo2);
+            u64 mergedHi = hi, mergedLo = lo + hi2;
+            if (mergedLo < lo) ++mergedHi;
+            if ((mergedHi & LOW_MASK) == LOW_MASK && mergedLo + 1 == 0 && lo2 + mantissa < mantissa) return false;
+            hi = mergedHi;
+            lo = mergedLo;
+        }
 
-        bool negExp = false;
-        if (string.StartsWith('+')) string.Advance(1);
-        if (string.StartsWith('-')) { negExp = true; string.Advance(1); }
-        if (!string) return nullptr;
+        const u32 msb = hi >> 63;
+        u64 m = hi >> (msb + SHIFT);
+        exp2 -= 1 ^ msb;
 
-        i32 exp = 0;
-        usize i = 0;
+        // possibly exactly halfway, which the truncated power cant tell apart
+        if (lo == 0 && (hi & LOW_MASK) == 0 && (m & 3) == 1) return false;
 
-        for (; i < string.Length(); ++i) {
-            if (const Option d = Chr::TryToDigit(string[i])) {
-                if (exp < 10000) exp = exp * 10 + (i32)*d;
-            } else { out *= std::exp2(Math::LOG10_2 * (negExp ? -(float)exp : (float)exp)); return i; }
+        m += m & 1;
+        m >>= 1;
+        if (m >> (Info::MANTISSA_BITS + 1)) {
+            m >>= 1;
+            ++exp2;
         }
+        // subnormals and overflows are left to the slow path
+        if (exp2 <= 0 || exp2 >= ((i64)1 << Info::EXPONENT_BITS) - 1) return false;
 
-        out *= std::exp2(Math::LOG10_2 * (negExp ? -(float)exp : (float)exp));
-        return i;
+        out = Info::FromBits((Bits)((u64)exp2 << Info::MANTISSA_BITS | (m & Info::MANTISSA_MASK)));
+        return true;
+    }
+
+    template <class N>
+    N NumberConversion::FloatConv<N>::FromDecimalSlow(const DecimalNumber& number) {
+        using Info = NumInfo<N>;
+        // the longest exact decimal of a float is 767 significant digits,
+        // so past 800 digits all that matters is whether the rest are zero
+        constexpr u32 MAX_DIGITS = 800;
+
+        ParseBigInt digits { 0 };
+        i32 exp10 = number.explicitExponent - (i32)number.fraction.Length();
+        u32 count = 0, chunk = 0, chunkLen = 0;
+        bool droppedNonzero = false;
+        for (const Str part : { number.integer, number.fraction }) {
+            for (const char c : part) {
+                if (count == 0 && c == '0') continue;
+                if (count == MAX_DIGITS) {
+                    droppedNonzero |= c != '0';
+                    ++exp10;
+                    continue;
+                }
+                chunk = chunk * 10 + (u32)(c - '0');
+                ++count;
+                if (++chunkLen == 9) {
+                    digits.MulSmall(1'000'000'000);
+                    digits.AddSmall(chunk);
+                    chunk = chunkLen = 0;
+                }
+            }
+        }
+        if (chunkLen) {
+            digits.MulSmall((u32)Math::POWERS_OF_10[chunkLen]);
+            digits.AddSmall(chunk);
+        }
+        if (droppedNonzero) {
+            digits.MulSmall(10);
+            digits.AddSmall(1);
+            --exp10;
+        }
+        if (digits.IsZero()) return 0;
+
+        // start within a few ulps of the answer, then step towards it
+        f64 estimate = (f64)number.mantissa;
+        for (i32 e = number.exponent; e; ) {
+            const i32 step = std::clamp(e, -300, 300);
+            estimate *= std::pow(10.0, step);
+            e -= step;
+        }
+        N f = (N)std::min(estimate, (f64)Info::MAX);
+        while (true) {
+            const auto bits = Info::BitsOf(f);
+            const int above = CompareWithMidpoint(digits, exp10, f);
+            if (above > 0 || (above == 0 && (bits & 1))) {
+                if (f == Info::MAX) return Info::INFINITY;
+                f = Info::FromBits(bits + 1);
+                continue;
+            }
+            if (bits) {
+                const N prev = Info::FromBits(bits - 1);
+                const int below = CompareWithMidpoint(digits, exp10, prev);
+                if (below < 0 || (below == 0 && (bits & 1))) {
+                    f = prev;
+                    continue;
+                }
+            }
+            return f;
+        }
+    }
+
+    template <class N>
+    N NumberConversion::FloatConv<N>::FromBinary(u64 mantissa, i32 exp2, bool sticky) {
+        using Info = NumInfo<N>;
+        if (!mantissa) return 0;
+
+        const i32 width = 64 - std::countl_zero(mantissa);
+        const i32 top = exp2 + width - 1;
+        if (top >= Info::MAX_EXP) return Info::INFINITY;
+
+        // subnormals lose a bit of precision for every power of 2 below the smallest normal
+        const i32 precision = (i32)Info::DIGITS - std::max(Info::MIN_EXP - 1 - top, 0);
+        const i32 shift = width - precision;
+        if (shift <= 0) return std::ldexp((N)mantissa, exp2);
+        if (shift > 64) return 0;
+
+        u64 rounded = shift == 64 ? 0 : mantissa >> shift;
+        const u64 rest = shift == 64 ? mantissa : mantissa & (((u64)1 << shift) - 1),
+                  half = (u64)1 << (shift - 1);
+        if (rest > half || (rest == half && (sticky || (rounded & 1)))) ++rounded;
+        return std::ldexp((N)rounded, exp2 + shift);
     }
 
     template struct NumberConversion::FloatConv<float>;
@@ -40,7 +40,7 @@ namespace Quasi::Text {
             TextFormatOptions::Alignment alignment = TextFormatOptions::LEFT;
             char pad = ' ';
             bool showSign = false, shouldPadZero = false;
-            enum Mode { SCIENTIFIC, FIXED, GENERAL, SCI_CAP, GEN_CAP, PERCENTAGE } mode = FIXED;
+            enum Mode { SCIENTIFIC, FIXED, GENERAL, SCI_CAP, GEN_CAP, PERCENTAGE } mode = GENERAL;
         };
         static FormatOptions ConfigureOptions(Str opt);
         template <class N> static usize FormatTo(StringWriter sw, N num, const FormatOptions& options);
@@ -84,18 +84,36 @@ namespace Quasi::Text {
     struct FloatParser {
         struct ParseOptions {
             enum {
-                SCIENTIFIC = 1, FIXED = 2, GENERAL = SCIENTIFIC | FIXED,
+                SCIENTIFIC = 1, FIXED = 2, HEX = 4, GENERAL = SCIENTIFIC | FIXED | HEX,
             } format = GENERAL;
         };
     };
 
     namespace NumberConversion {
+        // a decimal float as written, the value being mantissa * 10^exponent
+        struct DecimalNumber {
+            u64 mantissa = 0; // the first 19 significant digits
+            i32 exponent = 0;
+            bool truncated = false; // if any digits past the first 19 were dropped
+            Str integer, fraction; // every digit, for when the mantissa isnt enough
+            i32 explicitExponent = 0;
+        };
+
+        OptionUsize ParseDecimalNumber(Str string, Out<DecimalNumber&> out, FloatParser::ParseOptions options);
+
         template <class N>
         struct FloatConv {
             static OptionUsize ParseUntil(Str string, Out<N&> out, FloatParser::ParseOptions options);
-            static usize ParseInteger(Str string, Out<N&> out);
-            static usize ParseDecimal(Str string, InOut<N&> out);
-            static OptionUsize ParseExponent(Str string, InOut<N&> out);
+            // parses the part after 0x, like 1.8p3
+            static OptionUsize ParseHex(Str string, Out<N&> out);
+
+            static N FromDecimal(const DecimalNumber& number);
+            // the eisel-lemire algorithm, which fails on the rare inputs it cant round correctly
+            static bool FromDecimalFast(u64 mantissa, i32 exp10, Out<N&> out);
+            // exact comparisons with big integers, used when the fast path fails
+            static N FromDecimalSlow(const DecimalNumber& number);
+            // rounds (mantissa + sticky) * 2^exp2, where sticky is any amount less than 1
+            static N FromBinary(u64 mantissa, i32 exp2, bool sticky);
         };
     }
 
@@ -137,14 +155,20 @@ namespace Quasi::Text {
         void WriteU64Octal  (StringWriter sw, u64 num, u32 octalDigits);
         void WriteU64Hex    (StringWriter sw, u64 num, u32 hexDigits, bool upperCase);
 
-        char* AddSign(f64 f, char* out, bool alwaysShowSign = false);
-        char* WriteFltDecimal(f64 f, char* out, u32 precision = ~0);
-        char* WriteFltSci(f64 f, char* out, u32 precision = ~0, char e = 'e', int log10 = i32s::MIN);
-        char* WriteFltFxd(f64 f, char* out, u32 width = 0, u32 precision = ~0, int log10 = i32s::MIN, char pad = ' ');
-        char* WriteFltGen(f64 f, char* out, u32 width = 0, u32 precision = ~0, char e = 'e');
+        u64 MulHigh64(u64 a, u64 b, u64& low);
+
+        // the shortest digits that still parse back to the same float, with value = digits * 10^exponent.
+        // f has to be finite and non-negative.
+        struct DecimalFloat {
+            u64 digits;
+            int exponent;
+        };
+        DecimalFloat ShortestDecimal(f32 f);
+        DecimalFloat ShortestDecimal(f64 f);
 
-        usize FormatFltSci  (StringWriter sw, f64 f, const FloatFormatter::FormatOptions& options);
-        usize FormatFltFxd  (StringWriter sw, f64 f, const FloatFormatter::FormatOptions& options);
+        // without a precision, floats are written with the shortest digits that round trip.
+        // with one, they are rounded exactly (half to even) from their binary value.
+        usize FormatFloating(StringWriter sw, f32 f, const FloatFormatter::FormatOptions& options);
         usize FormatFloating(StringWriter sw, f64 f, const FloatFormatter::FormatOptions& options);
     }
 
@@ -0,0 +1,335 @@
+#include "Search.h"
+
+#include <bit>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Quasi::Text {
+    namespace SearchDetails {
+        // a block of bytes that are compared all at once. Eq() sets every equal byte,
+        // and Bits() packs them into a mask where byte i is at bit i << SHIFT.
+#if defined(__AVX2__)
+        struct Block {
+            static constexpr usize WIDTH = 32;
+            static constexpr u32 SHIFT = 0;
+            using Mask = u32;
+            __m256i v;
+
+            static Block Load(const char* p) { return { _mm256_loadu_si256((const __m256i*)p) }; }
+            static Block Splat(char c) { return { _mm256_set1_epi8(c) }; }
+            Block Eq(Block other) const { return { _mm256_cmpeq_epi8(v, other.v) }; }
+            Block operator|(Block other) const { return { _mm256_or_si256(v, other.v) }; }
+            Block operator&(Block other) const { return { _mm256_and_si256(v, other.v) }; }
+            Mask Bits() const { return (u32)_mm256_movemask_epi8(v); }
+        };
+#elif defined(__SSE2__)
+        struct Block {
+            static constexpr usize WIDTH = 16;
+            static constexpr u32 SHIFT = 0;
+            using Mask = u32;
+            __m128i v;
+
+            static Block Load(const char* p) { return { _mm_loadu_si128((const __m128i*)p) }; }
+            static Block Splat(char c) { return { _mm_set1_epi8(c) }; }
+            Block Eq(Block other) const { return { _mm_cmpeq_epi8(v, other.v) }; }
+            Block operator|(Block other) const { return { _mm_or_si128(v, other.v) }; }
+            Block operator&(Block other) const { return { _mm_and_si128(v, other.v) }; }
+            Mask Bits() const { return (u32)_mm_movemask_epi8(v); }
+        };
+#else
+        struct Block {
+            static constexpr usize WIDTH = 8;
+            static constexpr u32 SHIFT = 3;
+            using Mask = u64;
+            u64 v;
+
+            static Block Load(const char* p) { return { Memory::ReadU64(p) }; }
+            static Block Splat(char c) { return { 0x0101010101010101 * (u8)c }; }
+            // the high bit of every equal byte. unlike the usual zero byte trick, this has no false positives
+            Block Eq(Block other) const {
+                constexpr u64 LOW7 = 0x7F7F7F7F7F7F7F7F;
+                const u64 x = v ^ other.v;
+                return { ~(((x & LOW7) + LOW7) | x | LOW7) };
+            }
+            Block operator|(Block other) const { return { v | other.v }; }
+            Block operator&(Block other) const { return { v & other.v }; }
+            Mask Bits() const { return v; }
+        };
+#endif
+        using Mask = Block::Mask;
+
+        static usize FirstIn(Mask m) { return (usize)std::countr_zero(m) >> Block::SHIFT; }
+        static usize LastIn (Mask m) { return (usize)(sizeof(Mask) * 8 - 1 - std::countl_zero(m)) >> Block::SHIFT; }
+        static Mask  ClearFirst(Mask m) { return m & (m - 1); }
+        static Mask  ClearLast (Mask m) { return m & ~((Mask)1 << (sizeof(Mask) * 8 - 1 - std::countl_zero(m))); }
+
+        // matches one of up to 4 bytes
+        struct ByteMatcher {
+            Block splats[4];
+            usize count;
+
+            ByteMatcher(Span<const char> bytes) : count(bytes.Length()) {
+                for (usize i = 0; i < count; ++i) splats[i] = Block::Splat(bytes[i]);
+            }
+            Mask operator()(const char* p) const {
+                const Block b = Block::Load(p);
+                Block eq = b.Eq(splats[0]);
+                for (usize i = 1; i < count; ++i) eq = eq | b.Eq(splats[i]);
+                return eq.Bits();
+            }
+        };
+
+        // the blocks are aligned to the end for the last few bytes, which rechecks some bytes instead of looping over them
+        static OptionUsize FindBlocks(const char* data, usize len, const auto& matchBlock, Predicate<char> auto&& matchByte) {
+            if (len < Block::WIDTH) {
+                for (usize i = 0; i < len; ++i) if (matchByte(data[i])) return i;
+                return nullptr;
+            }
+            usize i = 0;
+            for (; i + Block::WIDTH <= len; i += Block::WIDTH)
+                if (const Mask m = matchBlock(data + i)) return i + FirstIn(m);
+            if (i < len)
+                if (const Mask m = matchBlock(data + len - Block::WIDTH)) return len - Block::WIDTH + FirstIn(m);
+            return nullptr;
+        }
+
+        static OptionUsize RevFindBlocks(const char* data, usize len, const auto& matchBlock, Predicate<char> auto&& matchByte) {
+            if (len < Block::WIDTH) {
+                for (usize i = len; i --> 0; ) if (matchByte(data[i])) return i;
+                return nullptr;
+            }
+            usize i = len;
+            for (; i >= Block::WIDTH; i -= Block::WIDTH)
+                if (const Mask m = matchBlock(data + i - Block::WIDTH)) return i - Block::WIDTH + LastIn(m);
+            if (i > 0)
+                if (const Mask m = matchBlock(data)) return LastIn(m);
+            return nullptr;
+        }
+
+        // crochemore-perrin two-way matching, with a bad character shift on the last byte. based on musl's strstr.
+        // the wrapping arithmetic on ip and ms (which start at -1) is on purpose.
+        static OptionUsize TwoWay(const byte* h, usize n, const byte* needle, usize m) {
+            u64 byteset[4] = {};
+            usize shift[256];
+            for (usize i = 0; i < m; ++i) {
+                byteset[needle[i] >> 6] |= 1ull << (needle[i] & 63);
+                shift[needle[i]] = i + 1;
+            }
+
+            // the critical factorization is the later of the maximal suffixes for both orderings
+            usize ip = -1, jp = 0, k = 1, p = 1;
+            while (jp + k < m) {
+                if (needle[ip + k] == needle[jp + k]) {
+                    if (k == p) { jp += p; k = 1; } else ++k;
+                } else if (needle[ip + k] > needle[jp + k]) {
+                    jp += k; k = 1; p = jp - ip;
+                } else {
+                    ip = jp++; k = p = 1;
+                }
+            }
+            usize ms = ip;
+            const usize p0 = p;
+
+            ip = -1; jp = 0; k = p = 1;
+            while (jp + k < m) {
+                if (needle[ip + k] == needle[jp + k]) {
+                    if (k == p) { jp += p; k = 1; } else ++k;
+                } else if (needle[ip + k] < needle[jp + k]) {
+                    jp += k; k = 1; p = jp - ip;
+                } else {
+                    ip = jp++; k = p = 1;
+                }
+            }
+            if (ip + 1 > ms + 1) ms = ip;
+            else p = p0;
+
+            // a periodic needle remembers how much of its prefix already matched after each shift
+            usize mem0;
+            if (__builtin_memcmp(needle, needle + p, ms + 1) != 0) {
+                mem0 = 0;
+                p = std::max(ms, m - ms - 1) + 1;
+            } else {
+                mem0 = m - p;
+            }
+
+            usize mem = 0;
+            for (usize pos = 0; pos + m <= n; ) {
+                const byte* hay = h + pos;
+                const byte last = hay[m - 1];
+                if (!(byteset[last >> 6] >> (last & 63) & 1)) {
+                    pos += m;
+                    mem = 0;
+                    continue;
+                }
+                if ((k = m - shift[last])) {
+                    pos += std::max(k, mem);
+                    mem = 0;
+                    continue;
+                }
+
+                for (k = std::max(ms + 1, mem); k < m && needle[k] == hay[k]; ++k);
+                if (k < m) {
+                    pos += k - ms;
+                    mem = 0;
+                    continue;
+                }
+                for (k = ms + 1; k > mem && needle[k - 1] == hay[k - 1]; --k);
+                if (k <= mem) return pos;
+                pos += p;
+                mem = mem0;
+            }
+            return nullptr;
+        }
+    }
+
+    using namespace SearchDetails;
+
+    OptionUsize FindByte(const char* data, usize len, char c) {
+        const Block splat = Block::Splat(c);
+        return FindBlocks(data, len, [&] (const char* p) { return Block::Load(p).Eq(splat).Bits(); }, Cmp::Equals { c });
+    }
+
+    OptionUsize RevFindByte(const char* data, usize len, char c) {
+        const Block splat = Block::Splat(c);
+        return RevFindBlocks(data, len, [&] (const char* p) { return Block::Load(p).Eq(splat).Bits(); }, Cmp::Equals { c });
+    }
+
+    usize CountByte(const char* data, usize len, char c) {
+        const Block splat = Block::Splat(c);
+        usize count = 0, i = 0;
+        for (; i + Block::WIDTH <= len; i += Block::WIDTH)
+            count += std::popcount(Block::Load(data + i).Eq(splat).Bits());
+        for (; i < len; ++i) count += data[i] == c;
+        return count;
+    }
+
+    OptionUsize FindByteOf(const char* data, usize len, Span<const char> set) {
+        if (set.IsEmpty()) return nullptr;
+        if (set.Length() == 1) return FindByte(data, len, set[0]);
+        if (set.Length() > 4) {
+            const Chr::Set lookup { set };
+            for (usize i = 0; i < len; ++i) if (lookup(data[i])) return i;
+            return nullptr;
+        }
+        return FindBlocks(data, len, ByteMatcher { set }, [&] (char c) { return set.Contains(c); });
+    }
+
+    OptionUsize RevFindByteOf(const char* data, usize len, Span<const char> set) {
+        if (set.IsEmpty()) return nullptr;
+        if (set.Length() == 1) return RevFindByte(data, len, set[0]);
+        if (set.Length() > 4) {
+            const Chr::Set lookup { set };
+            for (usize i = len; i --> 0; ) if (lookup(data[i])) return i;
+            return nullptr;
+        }
+        return RevFindBlocks(data, len, ByteMatcher { set }, [&] (char c) { return set.Contains(c); });
+    }
+
+    OptionUsize FindSubstr(Str haystack, Str needle) {
+        const usize n = haystack.Length(), m = needle.Length();
+        if (m == 0) return 0;
+        if (m > n) return nullptr;
+        if (m == 1) return FindByte(haystack.Data(), n, needle[0]);
+
+        const char* h = haystack.Data();
+        const Block first = Block::Splat(needle.First()), last = Block::Splat(needle.Last());
+        const usize end = n - m + 1; // the number of positions the needle can be at
+        usize i = 0, work = 0;
+        for (; i + Block::WIDTH <= end; i += Block::WIDTH) {
+            Mask candidates = (Block::Load(h + i).Eq(first) & Block::Load(h + i + m - 1).Eq(last)).Bits();
+            for (; candidates; candidates = ClearFirst(candidates)) {
+                const usize j = i + FirstIn(candidates);
+                if (haystack.Substr(j, m) == needle) return j;
+                // too many false candidates, so the text is probably periodic
+                if ((work += m) > 8 * (j + Block::WIDTH)) {
+                    const OptionUsize rest = TwoWay((const byte*)h + j + 1, n - j - 1, (const byte*)needle.Data(), m);
+                    return rest ? OptionUsize { j + 1 + *rest } : nullptr;
+                }
+            }
+        }
+        for (; i < end; ++i)
+            if (h[i] == needle.First() && h[i + m - 1] == needle.Last() && haystack.Substr(i, m) == needle) return i;
+        return nullptr;
+    }
+
+    OptionUsize RevFindSubstr(Str haystack, Str needle) {
+        const usize n = haystack.Length(), m = needle.Length();
+        if (m == 0) return n;
+        if (m > n) return nullptr;
+        if (m == 1) return RevFindByte(haystack.Data(), n, needle[0]);
+
+        const char* h = haystack.Data();
+        const Block first = Block::Splat(needle.First()), last = Block::Splat(needle.Last());
+        usize i = n - m + 1; // one past the last position the needle can be at
+        for (; i >= Block::WIDTH; i -= Block::WIDTH) {
+            const usize base = i - Block::WIDTH;
+            Mask candidates = (Block::Load(h + base).Eq(first) & Block::Load(h + base + m - 1).Eq(last)).Bits();
+            for (; candidates; candidates = ClearLast(candidates)) {
+                const usize j = base + LastIn(candidates);
+                if (haystack.Substr(j, m) == needle) return j;
+            }
+        }
+        for (; i --> 0; )
+            if (h[i] == needle.First() && h[i + m - 1] == needle.Last() && haystack.Substr(i, m) == needle) return i;
+        return nullptr;
+    }
+
+    MultiFinder::MultiFinder(Span<const Str> needles) : needles(needles) {
+        u32 counts[256] = {};
+        for (usize j = 0; j < needles.Length(); ++j) {
+            if (needles[j].IsEmpty()) { if (!firstEmpty) firstEmpty = j; continue; }
+            ++counts[(byte)needles[j].First()];
+        }
+        for (usize b = 0; b < 256; ++b) {
+            groupStarts[b + 1] = groupStarts[b] + counts[b];
+            if (counts[b]) firstBytes.Push((char)b);
+        }
+
+        order.Resize(groupStarts[256], 0);
+        u32 fill[256];
+        Memory::MemCopyNoOverlap(fill, groupStarts, sizeof(fill));
+        for (usize j = 0; j < needles.Length(); ++j)
+            if (!needles[j].IsEmpty()) order[fill[(byte)needles[j].First()]++] = (u32)j;
+    }
+
+    OptionUsize MultiFinder::MatchAt(Str haystack, usize i) const {
+        const byte b = haystack[i];
+        const Str rest = haystack.Skip(i);
+        for (u32 g = groupStarts[b]; g < groupStarts[b + 1]; ++g) {
+            const u32 j = order[g];
+            // an earlier empty needle wins, as it matches everywhere
+            if (firstEmpty && j > *firstEmpty) break;
+            if (rest.StartsWith(needles[j])) return j;
+        }
+        return firstEmpty;
+    }
+
+    Tuple<OptionUsize, OptionUsize> MultiFinder::Find(Str haystack) const {
+        if (haystack.IsEmpty()) return { nullptr, nullptr };
+        if (firstEmpty) return { 0, MatchAt(haystack, 0) };
+
+        for (usize i = 0; i < haystack.Length(); ++i) {
+            const OptionUsize next = FindByteOf(haystack.Data() + i, haystack.Length() - i, firstBytes);
+            if (!next) break;
+            i += *next;
+            if (const OptionUsize j = MatchAt(haystack, i)) return { i, j };
+        }
+        return { nullptr, nullptr };
+    }
+
+    Tuple<OptionUsize, OptionUsize> MultiFinder::RevFind(Str haystack) const {
+        if (haystack.IsEmpty()) return { nullptr, nullptr };
+        if (firstEmpty) return { haystack.Length() - 1, MatchAt(haystack, haystack.Length() - 1) };
+
+        for (usize end = haystack.Length(); end > 0; ) {
+            const OptionUsize i = RevFindByteOf(haystack.Data(), end, firstBytes);
+            if (!i) break;
+            if (const OptionUsize j = MatchAt(haystack, *i)) return { *i, j };
+            end = *i;
+        }
+        return { nullptr, nullptr };
+    }
+}
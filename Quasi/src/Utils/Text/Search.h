@@ -0,0 +1,37 @@
+#pragma once
+#include "Utils/Str.h"
+#include "Utils/Vec.h"
+
+namespace Quasi::Text {
+    // memchr style byte searches, which Str's Find family goes through.
+    // they test 32 bytes at a time with avx2, 16 with sse2, and 8 packed in a u64 otherwise.
+    OptionUsize FindByte     (const char* data, usize len, char c);
+    OptionUsize RevFindByte  (const char* data, usize len, char c);
+    usize       CountByte    (const char* data, usize len, char c);
+    // sets of up to 4 bytes are vectorized too
+    OptionUsize FindByteOf   (const char* data, usize len, Span<const char> set);
+    OptionUsize RevFindByteOf(const char* data, usize len, Span<const char> set);
+
+    // checks the first and last byte of the needle at every position, and only compares the whole needle where both match.
+    // once the comparisons cost too much (like in periodic text), the rest is searched with two-way, which is linear.
+    OptionUsize FindSubstr   (Str haystack, Str needle);
+    // same filter in reverse, without the linear fallback
+    OptionUsize RevFindSubstr(Str haystack, Str needle);
+
+    // the leftmost (or rightmost) position where any of the needles start, and the first such needle.
+    // positions are filtered by the needles' first bytes, and only the needles starting with that byte are compared.
+    class MultiFinder {
+        Span<const Str> needles;
+        Vec<u32> order;          // needle indices grouped by first byte, in order within each group
+        u32 groupStarts[257] {}; // where each first byte's group starts in order
+        Vec<char> firstBytes;    // the distinct first bytes
+        OptionUsize firstEmpty;  // empty needles match anywhere
+    public:
+        explicit MultiFinder(Span<const Str> needles);
+
+        Tuple<OptionUsize, OptionUsize> Find   (Str haystack) const;
+        Tuple<OptionUsize, OptionUsize> RevFind(Str haystack) const;
+    private:
+        OptionUsize MatchAt(Str haystack, usize i) const;
+    };
+}
@@ -56,21 +56,25 @@ namespace Quasi {
 
     /// @brief A data structure that stores a continuous collection of an arbitrary amount of @p T s on the heap.
     /// @tparam T the element type to store
-    template <class T>
-    struct Vec : IContinuous<T, Vec<T>> {
+    /// @tparam A the allocator the memory comes from, the global heap by default.
+    /// Use @p Memory::AllocatorRef to back the vector with an arena (see Arena.h).
+    template <class T, class A>
+    struct Vec : IContinuous<T, Vec<T, A>> {
         friend ICollection<T, Vec>;
         friend IContinuous<T, Vec>;
     private:
         /// @brief the data
         T* data = nullptr;
         usize size = 0, capacity = 0;
+        /// @brief the allocator, which takes no space when it's stateless
+        [[no_unique_address]] A alloc {};
 
-        Vec(T* dat, usize s, usize cap) : data(dat), size(s), capacity(cap) {}
+        Vec(T* dat, usize s, usize cap, A alloc = {}) : data(dat), size(s), capacity(cap), alloc(alloc) {}
     public:
         Vec() = default;
-        ~Vec() { Memory::RangeDestruct(data, size); Memory::FreeRaw(data); /* dont destruct after size, capacity is uninit'ed */ }
-        Vec(Vec&& v) noexcept : data(v.data), size(v.size), capacity(v.capacity) { v.PretendClear(); }
-        Vec& operator=(Vec&& v) noexcept { this->~Vec(); data = v.data; size = v.size; capacity = v.capacity; v.PretendClear(); return *this; }
+        ~Vec() { Memory::RangeDestruct(data, size); alloc.Free(data, capacity * sizeof(T)); /* dont destruct after size, capacity is uninit'ed */ }
+        Vec(Vec&& v) noexcept : data(v.data), size(v.size), capacity(v.capacity), alloc(v.alloc) { v.PretendClear(); }
+        Vec& operator=(Vec&& v) noexcept { this->~Vec(); data = v.data; size = v.size; capacity = v.capacity; alloc = v.alloc; v.PretendClear(); return *this; }
     public:
         /// @brief Creates an empty Vec<T>.
         static Vec Empty() { return {}; }
@@ -79,8 +83,8 @@ namespace Quasi {
         /// @brief Creates a Vec<T> from a C-style array by copying the values.
         template <usize N> static Vec New(const T (&arr)[N]) { return New(Span<const T>::FromArray(arr)); }
         /// @brief Creates a Vec<T> from a Span<const T> by copy the values.
-        static Vec New(Span<const T> elms) {
-            Vec v = WithCap(elms.Length());
+        static Vec New(Span<const T> elms, A alloc = {}) {
+            Vec v = WithCap(elms.Length(), alloc);
             Memory::RangeConstructCopyNoOverlap(v.Data(), elms.Data(), elms.Length());
             v.size = elms.Length();
             return v;
@@ -89,26 +93,31 @@ namespace Quasi {
         static Vec FromIList(IList<T> elms) { return New(Spans::FromIList(elms)); }
         /// @brief Creates a Vec<T> from a Span<T> by moving the values.
         /// @warning After calling, @p movElms is invalid.
-        static Vec MoveNew(Span<T> movElms) {
-            Vec v = WithCap(movElms.Length());
+        static Vec MoveNew(Span<T> movElms, A alloc = {}) {
+            Vec v = WithCap(movElms.Length(), alloc);
             Memory::RangeConstructMoveNoOverlap(v.Data(), movElms.Data(), movElms.Length());
             v.size = movElms.Length();
             return v;
         }
 
         /// @brief Creates a Vec<T> from an ArrayBox<T>, using its memory as the contents of the vector.
-        static Vec FromBox(ArrayBox<T>& box) { return { box.Release(), box.Length(), box.Length() }; }
+        static Vec FromBox(ArrayBox<T>& box) requires Memory::IsGlobalAllocator<A> { return { box.Release(), box.Length(), box.Length() }; }
 
         /// @brief Creates a Vec<T> with pre-allocated memory, capable of storing @p cap elements but zero size.
-        static Vec WithCap (usize cap)  { return { cap  ? AllocateBuffer(cap)  : nullptr, 0, cap }; }
+        static Vec WithCap (usize cap, A alloc = {}) { return { cap ? (T*)alloc.Allocate(cap * sizeof(T), alignof(T)) : nullptr, 0, cap, alloc }; }
+        /// @brief Creates an empty Vec<T> that will allocate from @p alloc.
+        static Vec WithAllocator(A alloc) { return { nullptr, 0, 0, alloc }; }
         /// @brief Composes a Vec<T> out of its fundamental components: the data pointer, a size and capacity.
-        static Vec Compose(T* data, usize size, usize cap) { return { data, size, cap }; }
+        /// @p data must have been allocated by @p alloc.
+        static Vec Compose(T* data, usize size, usize cap, A alloc = {}) { return { data, size, cap, alloc }; }
         /// @brief Yields out its members variables: data, size and capacity, while clearing itself in the process.
         /// @warning the return value memory pointer is expected to be @b managed and @b freed by the user.
         [[nodiscard]] Tuple<T*, usize, usize> Decompose() { const usize prsize = size, prcap = capacity; return { Release(), prsize, prcap }; }
 
         /// @brief Creates a clone of itself. Useful for duplicating Vec<T>s for data processing.
-        Vec Clone() const { return New(this->AsSpan()); }
+        Vec Clone() const { return New(this->AsSpan(), alloc); }
+        /// @brief Returns the allocator the memory of this vector comes from.
+        const A& GetAllocator() const { return alloc; }
     protected:
         usize LengthImpl() const { return size; }
         T* DataImpl() { return data; }
@@ -141,41 +150,33 @@ namespace Quasi {
         /// @param buffer the new memory buffer to move to
         void MoveBuffer(T* buffer) {
             Vec::ShiftValues(buffer, data, size);
-            Memory::FreeRaw(data);
+            alloc.Free(data, capacity * sizeof(T));
             data = buffer;
         }
 
         /// @internal
         /// @brief Allocates & moves the element data to a memory buffer with a specified size.
+        /// Trivially relocatable elements are reallocated as raw bytes, which lets arenas grow the buffer in place.
         /// @param buffSize the new memory size
-        void AllocToNew(usize buffSize) { MoveBuffer(AllocateBuffer(buffSize)); capacity = buffSize; }
+        void AllocToNew(usize buffSize) {
+            if constexpr (Memory::TrivialRelocate<T>)
+                data = (T*)alloc.Reallocate(data, capacity * sizeof(T), buffSize * sizeof(T), alignof(T));
+            else
+                MoveBuffer(AllocateBuffer(buffSize));
+            capacity = buffSize;
+        }
 
         /// @internal
         /// @brief Moves values to an @b uninitialized memory region, while @b destructing the original values.
+        /// The regions may overlap. This is a single memmove for trivially relocatable types.
         /// @param newDest the destination for the elements
         /// @param in the input element data
         /// @param num the number of elements to move
-        static void ShiftValues(T* newDest, T* in, usize num) {
-            for (usize i = 0; i < num; ++i) {
-                Memory::ConstructAt(&newDest[i], std::move(in[i]));
-                in[i].~T();
-            }
-        }
-        /// @internal
-        /// @brief Moves values to an @b uninitialized memory region in @b reverse direction, while @b destructing the original values.
-        /// @param newDest the destination for the elements
-        /// @param in the input element data
-        /// @param num the number of elements to move
-        static void ShiftValuesRev(T* newDest, T* in, usize num) {
-            for (usize i = num; i --> 0; ) {
-                Memory::ConstructAt(&newDest[i], std::move(in[i]));
-                in[i].~T();
-            }
-        }
+        static void ShiftValues(T* newDest, T* in, usize num) { Memory::RangeRelocate(newDest, in, num); }
     public:
         /// @internal
         /// @brief Allocates a buffer of size @p size.
-        static T* AllocateBuffer(usize size) { return Memory::AllocateArrayUninit<T>(size); }
+        T* AllocateBuffer(usize size) { return (T*)alloc.Allocate(size * sizeof(T), alignof(T)); }
         /// @internal
         /// @brief Checks whether a vector can hold an extra `amount` elements without needing to resize.
         bool CanFit(usize amount) const { return size + amount <= capacity; }
@@ -244,10 +245,10 @@ namespace Quasi {
         void ShrinkTo(usize minimum) { AllocToNew(std::max(size, minimum)); }
 
         /// @brief Creates an @p ArrayBox<T> that owns this vector's original memory and with size @p this->Length().
-        [[nodiscard]] ArrayBox<T> IntoBox()      { return ArrayBox<T>::Own(Release(), size); }
+        [[nodiscard]] ArrayBox<T> IntoBox()      requires Memory::IsGlobalAllocator<A> { return ArrayBox<T>::Own(Release(), size); }
         /// @brief Creates an @p ArrayBox<T> that owns this vector's original memory and with size @p this->Capacity().
         /// @warning Does not waste any memory but <b>may contain uninitialized values</b>.
-        [[nodiscard]] ArrayBox<T> IntoBoxWhole() { return ArrayBox<T>::Own(Release(), capacity); } // releases
+        [[nodiscard]] ArrayBox<T> IntoBoxWhole() requires Memory::IsGlobalAllocator<A> { return ArrayBox<T>::Own(Release(), capacity); } // releases
 
         /// @brief Returns the memory chunk past the length that is not yet used by the vector in the form of a @p Span<T>.
         /// @warning This may hold <b>uninitialized memory</b>.
@@ -286,6 +287,7 @@ namespace Quasi {
         void Pop(usize index) {
             data[index].~T();
             Vec::ShiftValues(&data[index], &data[index + 1], size - index - 1);
+            --size;
         }
         /// @brief Pops the element at @p index of a vector and returns it.
         /// @param index the index of the element that should be popped
@@ -293,7 +295,6 @@ namespace Quasi {
         /// Use @p TryTake(...) instead unless you are @b certain that the vector is @b not empty
         T Take(usize index) {
             T out = std::move(data[index]);
-            data.~T();
             Pop(index);
             return out;
         }
@@ -328,7 +329,7 @@ namespace Quasi {
                 Push(std::move(obj));
             } else {
                 TryGrow(1);
-                Vec::ShiftValuesRev(&data[idx + 1], &data[idx], size - idx);
+                Vec::ShiftValues(&data[idx + 1], &data[idx], size - idx);
                 Memory::ConstructMoveAt(&data[idx], std::move(obj));
                 ++size;
             }
@@ -344,7 +345,7 @@ namespace Quasi {
                 Extend(vals);
             } else {
                 TryGrow(vals.Length());
-                Vec::ShiftValuesRev(&data[idx + vals.Length()], &data[idx], size - idx);
+                Vec::ShiftValues(&data[idx + vals.Length()], &data[idx], size - idx);
                 Memory::RangeConstructCopy(&data[idx], vals.Data(), vals.Length());
                 size += vals.Length();
             }
@@ -361,7 +362,7 @@ namespace Quasi {
                 ExtendMove(vals);
             } else {
                 TryGrow(vals.Length());
-                Vec::ShiftValuesRev(&data[idx + vals.Length()], &data[idx], size - idx);
+                Vec::ShiftValues(&data[idx + vals.Length()], &data[idx], size - idx);
                 Memory::RangeConstructMove(&data[idx], vals.Data(), vals.Length());
                 size += vals.Length();
             }
@@ -377,11 +378,12 @@ namespace Quasi {
         /// @param num the number of elements to replace
         /// @param values the values to replace the range with
         void Replace(usize start, usize num, Span<const T> values) {
+            // grow before anything is destructed, so that only live values get moved
+            if (values.Length() > num) TryGrow(values.Length() - num);
             Memory::RangeDestruct(&data[start], num);
             if (values.Length() > num) { // have to insert
                 const usize numToInsert = values.Length() - num;
-                TryGrow(numToInsert);
-                Vec::ShiftValuesRev(&data[start + values.Length()], &data[start + num], size - start - num);
+                Vec::ShiftValues(&data[start + values.Length()], &data[start + num], size - start - num);
                 size += numToInsert;
             } else if (values.Length() < num) { // have to erase
                 Vec::ShiftValues(&data[start + values.Length()], &data[start + num], size - start - num);
@@ -397,11 +399,12 @@ namespace Quasi {
         /// @param values the values to replace the range with
         /// @warning After calling, @p values is invalid.
         void ReplaceMove(usize start, usize num, Span<T> values) {
+            // grow before anything is destructed, so that only live values get moved
+            if (values.Length() > num) TryGrow(values.Length() - num);
             Memory::RangeDestruct(&data[start], num);
             if (values.Length() > num) { // have to insert
                 const usize numToInsert = values.Length() - num;
-                TryGrow(numToInsert);
-                Vec::ShiftValuesRev(&data[start + values.Length()], &data[start + num], size - start - num);
+                Vec::ShiftValues(&data[start + values.Length()], &data[start + num], size - start - num);
                 size += numToInsert;
             } else if (values.Length() < num) { // have to erase
                 Vec::ShiftValues(&data[start + values.Length()], &data[start + num], size - start - num);
@@ -422,16 +425,17 @@ namespace Quasi {
         /// @param values the values to replace the range with
         /// @returns the original values that were replaced
         Vec ReplaceAndTake(usize start, usize num, Span<const T> values) {
-            Vec original = MoveNew(this->Subspan(start, num));
+            // grow before anything is destructed, so that only live values get moved
+            if (values.Length() > num) TryGrow(values.Length() - num);
+            Vec original = MoveNew(this->Subspan(start, num), alloc);
             Memory::RangeDestruct(&data[start], num);
             if (values.Length() > num) { // have to insert
                 const usize numToInsert = values.Length() - num;
-                TryGrow(numToInsert);
-                Vec::ShiftValuesRev(&data[start + values.Length()], &data[start + num], size - start - num);
+                Vec::ShiftValues(&data[start + values.Length()], &data[start + num], size - start - num);
                 size += numToInsert;
             } else if (values.Length() < num) { // have to erase
                 Vec::ShiftValues(&data[start + values.Length()], &data[start + num], size - start - num);
-                size -= num;
+                size -= num - values.Length();
             }
             Memory::RangeConstructCopy(&data[start], values.Data(), values.Length());
             return original;
@@ -445,17 +449,18 @@ namespace Quasi {
         /// @returns the original values that were replaced
         /// @warning After calling, @p values is invalid.
         Vec ReplaceMoveAndTake(usize start, usize num, Span<T> values) {
-            Vec original = MoveNew(this->Subspan(start, num));
+            // grow before anything is destructed, so that only live values get moved
+            if (values.Length() > num) TryGrow(values.Length() - num);
+            Vec original = MoveNew(this->Subspan(start, num), alloc);
             Memory::RangeDestruct(&data[start], num);
             if (values.Length() == num) {
             } else if (values.Length() > num) { // have to insert
                 const usize numToInsert = values.Length() - num;
-                TryGrow(numToInsert);
-                Vec::ShiftValuesRev(&data[start + values.Length()], &data[start + num], size - start - num);
+                Vec::ShiftValues(&data[start + values.Length()], &data[start + num], size - start - num);
                 size += numToInsert;
             } else { // have to erase
                 Vec::ShiftValues(&data[start + values.Length()], &data[start + num], size - start - num);
-                size -= num;
+                size -= num - values.Length();
             }
             Memory::RangeConstructMove(&data[start], values.Data(), values.Length());
             return original;
@@ -496,15 +501,39 @@ namespace Quasi {
         /// @endcode
         /// @param pred the predicate to check the elements with.
         void Keep(Predicate<T> auto&& pred) {
-            usize slow = -1; // this will wrap to 0 when added
+            usize slow = 0;
+            for (usize i = 0; i < size; ++i) {
+                if (pred(data[i])) {
+                    if (slow != i) Memory::RelocateAt(&data[slow], &data[i]);
+                    ++slow;
+                } else data[i].~T();
+            }
+            size = slow;
+        }
+
+        /// @brief Removes the elements that pass a predicate and returns them, in a single pass. @n
+        /// Example:
+        /// @code
+        /// Vec<int> numbers = Vecs::New({ 2, 3, 5, 6, 7, 9 });
+        /// Vec<int> evens = numbers.DrainIf([] (int x) { return x % 2 == 0; });
+        /// // numbers == { 3, 5, 7, 9 } && evens == { 2, 6 }
+        /// @endcode
+        /// @param pred the predicate to check the elements with.
+        /// @return the removed elements, in their original order
+        Vec DrainIf(Predicate<T> auto&& pred) {
+            Vec drained = WithAllocator(alloc);
+            usize slow = 0;
             for (usize i = 0; i < size; ++i) {
                 if (pred(data[i])) {
-                    if (++slow == i) continue;
-                    Memory::ConstructMoveAt(&data[slow], std::move(data[i]));
+                    drained.TryGrow(1);
+                    Memory::RelocateAt(&drained.data[drained.size++], &data[i]);
+                } else {
+                    if (slow != i) Memory::RelocateAt(&data[slow], &data[i]);
+                    ++slow;
                 }
-                data[i].~T();
             }
-            size = slow + 1;
+            size = slow;
+            return drained;
         }
 
         /// @brief Removes the first instance of a particular item in the vector.
@@ -533,10 +562,8 @@ namespace Quasi {
             usize slow = 0;
             for (usize i = 1; i < size; ++i) {
                 if (!eq(data[slow], data[i])) {
-                    if (++slow == i) continue;
-                    Memory::ConstructMoveAt(&data[slow], std::move(data[i]));
-                }
-                data[i].~T();
+                    if (++slow != i) Memory::RelocateAt(&data[slow], &data[i]);
+                } else data[i].~T();
             }
             size = slow + 1;
         }
@@ -574,7 +601,7 @@ namespace Quasi {
         /// @param num the number of elements to remove
         Vec EraseAndTake(usize begin, usize num) {
             if (begin >= size || num == 0) return Empty();
-            Vec erased = Vec::MoveNew(this->Subspan(begin, num));
+            Vec erased = Vec::MoveNew(this->Subspan(begin, num), alloc);
             Memory::RangeDestruct(&data[begin], num);
             Vec::ShiftValues(&data[begin], &data[begin + num], size - begin - num);
             size -= num;
@@ -591,7 +618,7 @@ namespace Quasi {
         /// @param index the index to split the vector at
         /// @return the tail of the original vector as a new one
         Vec SplitOff(usize index) {
-            Vec tail = Vec::MoveNew(this->SubspanMut(index));
+            Vec tail = Vec::MoveNew(this->SubspanMut(index), alloc);
             Memory::RangeDestruct(&data[index], size - index);
             size = index;
             return tail;
@@ -642,6 +669,10 @@ namespace Quasi {
         }
     };
 
+    namespace Memory {
+        template <class T, class A> constexpr bool EnableTrivialRelocate<Vec<T, A>> = TrivialCopy<A>;
+    }
+
     template <class T, class Super> Vec<RemConst<T>> IContinuous<T, Super>::CollectToVec() const { return Vec<RemConst<T>>::New(*this); }
     template <class T, class Super> Vec<RemConst<T>> IContinuous<T, Super>::MoveToVec() requires IsMut<T> { return Vec<RemConst<T>>::MoveNew(*this); }
     template <class T, class Super> Vec<RemConst<T>> IContinuous<T, Super>::Repeat(usize num) const {